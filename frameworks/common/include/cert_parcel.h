@@ -16,8 +16,10 @@
 #ifndef DLP_CERT_PARCEL_H
 #define DLP_CERT_PARCEL_H
 
+#include <memory>
 #include <string>
 #include <vector>
+#include "dlp_shared_memory.h"
 #include "parcel.h"
 
 namespace OHOS {
@@ -42,6 +44,11 @@ public:
     std::string realFileType;
     std::string fileId;
     int32_t allowedOpenCount = 0;
+
+private:
+    // keeps the memfd of large certs alive until this parcel is released
+    mutable std::shared_ptr<DlpSharedMemory> certHolder_;
+    mutable std::shared_ptr<DlpSharedMemory> offlineCertHolder_;
 };
 } // namespace DlpPermission
 } // namespace Security
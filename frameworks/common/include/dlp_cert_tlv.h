@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_CERT_TLV_H
+#define DLP_CERT_TLV_H
+
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Binary cert envelope:
+ *   header: magic(4) | version(2) | reserved(2)
+ *   record: tag(2) | length(4) | value(length)
+ * All integers are little-endian. Unknown tags are skipped by readers so
+ * newer writers can append records without breaking older readers.
+ */
+constexpr uint32_t DLP_CERT_TLV_MAGIC = 0x544C5044;  // "DPLT"
+constexpr uint16_t DLP_CERT_TLV_VERSION = 1;
+constexpr uint32_t DLP_CERT_TLV_HEADER_SIZE = 8;
+constexpr uint32_t DLP_CERT_TLV_RECORD_HEAD_SIZE = 6;
+
+enum DlpCertTlvTag : uint16_t {
+    DLP_CERT_TLV_TAG_ENC_DATA = 1,
+    DLP_CERT_TLV_TAG_ACCOUNT_TYPE = 2,
+};
+
+class DlpTlvWriter {
+public:
+    explicit DlpTlvWriter(std::vector<uint8_t>& out) : out_(out) {}
+    ~DlpTlvWriter() = default;
+
+    void WriteHeader();
+    void WriteUint32(uint16_t tag, uint32_t value);
+    void WriteBytes(uint16_t tag, const uint8_t* data, uint32_t len);
+
+private:
+    void AppendUint16(uint16_t value);
+    void AppendUint32(uint32_t value);
+
+    std::vector<uint8_t>& out_;
+};
+
+class DlpTlvReader {
+public:
+    DlpTlvReader(const uint8_t* data, uint32_t len) : data_(data), len_(len) {}
+    ~DlpTlvReader() = default;
+
+    bool ReadHeader();
+    // value points into the source buffer, valid as long as the buffer is
+    bool Next(uint16_t& tag, const uint8_t*& value, uint32_t& len);
+    bool AtEnd() const
+    {
+        return pos_ == len_;
+    }
+
+private:
+    const uint8_t* data_;
+    uint32_t len_;
+    uint32_t pos_ = 0;
+};
+
+bool IsDlpCertTlv(const uint8_t* data, uint32_t len);
+bool ReadTlvUint32(const uint8_t* value, uint32_t len, uint32_t& out);
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_CERT_TLV_H
@@ -72,6 +72,7 @@ enum DLPErrCode : int32_t {
     DLP_PARSE_ERROR_NOT_SUPPORT_FILE_TYPE = -123,
     DLP_PARSE_ERROR_ACCOUNT_PERSONAL = -124,
     DLP_PARSE_ERROR_GENERATE_FILEID_ERROR = -125,
+    DLP_PARSE_ERROR_OPERATION_CANCELED = -126,
 
     DLP_FUSE_ERROR_VALUE_INVALID = -200,
     DLP_FUSE_ERROR_DLP_FILE_NULL = -201,
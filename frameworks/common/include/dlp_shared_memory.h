@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_SHARED_MEMORY_H
+#define DLP_SHARED_MEMORY_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "parcel.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+// buffers at or above this size are passed as a sealed memfd instead of inline parcel data
+constexpr uint32_t DLP_SHARED_MEMORY_THRESHOLD = 64 * 1024;
+
+class DlpSharedMemory {
+public:
+    ~DlpSharedMemory();
+    static std::shared_ptr<DlpSharedMemory> Create(const std::vector<uint8_t>& buff);
+
+    int GetFd() const
+    {
+        return fd_;
+    }
+
+    uint32_t GetSize() const
+    {
+        return size_;
+    }
+
+private:
+    DlpSharedMemory() = default;
+    DlpSharedMemory(const DlpSharedMemory&) = delete;
+    DlpSharedMemory& operator=(const DlpSharedMemory&) = delete;
+
+    int fd_ = -1;
+    uint32_t size_ = 0;
+    void* addr_ = nullptr;
+};
+
+/*
+ * Write buff into data, inline when it is small, through a sealed memfd otherwise.
+ * The sender-side mapping is kept alive by holder and zeroed when holder is released,
+ * so holder must outlive the transaction that carries data.
+ */
+bool WriteSharedBuffer(Parcel& data, const std::vector<uint8_t>& buff, std::shared_ptr<DlpSharedMemory>& holder);
+/*
+ * Read a buffer written by WriteSharedBuffer. A shared region is mapped read only and copied once into buff, the
+ * memfd saves the inline copy into the parcel, not the copy out of it. A buffer over maxSize is rejected with
+ * DLP_SERVICE_ERROR_VALUE_INVALID, a malformed one with DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL.
+ */
+int32_t ReadSharedBuffer(Parcel& data, std::vector<uint8_t>& buff, uint32_t maxSize);
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_SHARED_MEMORY_H
@@ -14,6 +14,7 @@
  */
 
 #include "cert_parcel.h"
+#include "dlp_permission.h"
 #include "dlp_permission_log.h"
 
 namespace OHOS {
@@ -46,16 +47,16 @@ bool CertParcel::Marshalling(Parcel& data) const
         DLP_LOG_ERROR(LABEL, "cert size %{public}zu exceeds limit", this->cert.size());
         return false;
     }
-    if (!data.WriteUInt8Vector(this->cert)) {
-        DLP_LOG_ERROR(LABEL, "Write uint8 vector fail");
+    if (!WriteSharedBuffer(data, this->cert, this->certHolder_)) {
+        DLP_LOG_ERROR(LABEL, "Write cert fail");
         return false;
     }
     if (this->offlineCert.size() > MAX_CERT_SIZE) {
         DLP_LOG_ERROR(LABEL, "offlineCert size %{public}zu exceeds limit", this->offlineCert.size());
         return false;
     }
-    if (!data.WriteUInt8Vector(this->offlineCert)) {
-        DLP_LOG_ERROR(LABEL, "Write uint8 offlineCert vector fail");
+    if (!WriteSharedBuffer(data, this->offlineCert, this->offlineCertHolder_)) {
+        DLP_LOG_ERROR(LABEL, "Write offlineCert fail");
         return false;
     }
     if (!data.WriteBool(this->needCheckCustomProperty)) {
@@ -136,22 +137,14 @@ CertParcel* CertParcel::Unmarshalling(Parcel& data)
         DLP_LOG_ERROR(LABEL, "Read contactAccount fail");
         return FreeCertParcel(parcel);
     }
-    if (!data.ReadUInt8Vector(&parcel->cert)) {
+    if (ReadSharedBuffer(data, parcel->cert, MAX_CERT_SIZE) != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Read cert fail");
         return FreeCertParcel(parcel);
     }
-    if (parcel->cert.size() > MAX_CERT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "cert size %{public}zu exceeds limit", parcel->cert.size());
-        return FreeCertParcel(parcel);
-    }
-    if (!data.ReadUInt8Vector(&parcel->offlineCert)) {
+    if (ReadSharedBuffer(data, parcel->offlineCert, MAX_CERT_SIZE) != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Read offlineCert fail");
         return FreeCertParcel(parcel);
     }
-    if (parcel->offlineCert.size() > MAX_CERT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "offlineCert size %{public}zu exceeds limit", parcel->offlineCert.size());
-        return FreeCertParcel(parcel);
-    }
     if (!data.ReadBool(parcel->needCheckCustomProperty)) {
         DLP_LOG_ERROR(LABEL, "Read needCheckCustomProperty fail");
         return FreeCertParcel(parcel);
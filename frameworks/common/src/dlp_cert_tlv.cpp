@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_cert_tlv.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+static const uint32_t BYTE_BITS = 8;
+static const uint32_t UINT16_BYTES = 2;
+static const uint32_t UINT32_BYTES = 4;
+static const uint32_t VERSION_OFFSET = 4;
+}
+
+static uint16_t LoadUint16(const uint8_t* data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << BYTE_BITS));
+}
+
+static uint32_t LoadUint32(const uint8_t* data)
+{
+    uint32_t value = 0;
+    for (uint32_t i = UINT32_BYTES; i > 0; i--) {
+        value = (value << BYTE_BITS) | data[i - 1];
+    }
+    return value;
+}
+
+void DlpTlvWriter::AppendUint16(uint16_t value)
+{
+    for (uint32_t i = 0; i < UINT16_BYTES; i++) {
+        out_.push_back(static_cast<uint8_t>(value >> (i * BYTE_BITS)));
+    }
+}
+
+void DlpTlvWriter::AppendUint32(uint32_t value)
+{
+    for (uint32_t i = 0; i < UINT32_BYTES; i++) {
+        out_.push_back(static_cast<uint8_t>(value >> (i * BYTE_BITS)));
+    }
+}
+
+void DlpTlvWriter::WriteHeader()
+{
+    AppendUint32(DLP_CERT_TLV_MAGIC);
+    AppendUint16(DLP_CERT_TLV_VERSION);
+    AppendUint16(0);
+}
+
+void DlpTlvWriter::WriteUint32(uint16_t tag, uint32_t value)
+{
+    AppendUint16(tag);
+    AppendUint32(UINT32_BYTES);
+    AppendUint32(value);
+}
+
+void DlpTlvWriter::WriteBytes(uint16_t tag, const uint8_t* data, uint32_t len)
+{
+    AppendUint16(tag);
+    AppendUint32(len);
+    if (data != nullptr && len > 0) {
+        out_.insert(out_.end(), data, data + len);
+    }
+}
+
+bool DlpTlvReader::ReadHeader()
+{
+    if (!IsDlpCertTlv(data_, len_)) {
+        return false;
+    }
+    pos_ = DLP_CERT_TLV_HEADER_SIZE;
+    return true;
+}
+
+bool DlpTlvReader::Next(uint16_t& tag, const uint8_t*& value, uint32_t& len)
+{
+    if (len_ - pos_ < DLP_CERT_TLV_RECORD_HEAD_SIZE) {
+        return false;
+    }
+    tag = LoadUint16(data_ + pos_);
+    len = LoadUint32(data_ + pos_ + UINT16_BYTES);
+    pos_ += DLP_CERT_TLV_RECORD_HEAD_SIZE;
+    if (len > len_ - pos_) {
+        pos_ = len_;
+        return false;
+    }
+    value = data_ + pos_;
+    pos_ += len;
+    return true;
+}
+
+bool IsDlpCertTlv(const uint8_t* data, uint32_t len)
+{
+    if (data == nullptr || len < DLP_CERT_TLV_HEADER_SIZE) {
+        return false;
+    }
+    return LoadUint32(data) == DLP_CERT_TLV_MAGIC && LoadUint16(data + VERSION_OFFSET) == DLP_CERT_TLV_VERSION;
+}
+
+bool ReadTlvUint32(const uint8_t* value, uint32_t len, uint32_t& out)
+{
+    if (value == nullptr || len != UINT32_BYTES) {
+        return false;
+    }
+    out = LoadUint32(value);
+    return true;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_shared_memory.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dlp_permission.h"
+#include "dlp_permission_log.h"
+#include "ipc_file_descriptor.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpSharedMemory" };
+static const char* SHARED_MEMORY_NAME = "dlp_cert";
+#ifndef F_SEAL_FUTURE_WRITE
+static constexpr int F_SEAL_FUTURE_WRITE = 0x0010;
+#endif
+static constexpr int REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+static constexpr int WRITE_SEALS = F_SEAL_WRITE | F_SEAL_FUTURE_WRITE;
+}
+
+DlpSharedMemory::~DlpSharedMemory()
+{
+    if (addr_ != nullptr) {
+        (void)memset_s(addr_, size_, 0, size_);
+        (void)munmap(addr_, size_);
+        addr_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        (void)close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::shared_ptr<DlpSharedMemory> DlpSharedMemory::Create(const std::vector<uint8_t>& buff)
+{
+    if (buff.empty() || buff.size() > UINT32_MAX) {
+        return nullptr;
+    }
+    std::shared_ptr<DlpSharedMemory> memory(new (std::nothrow) DlpSharedMemory());
+    if (memory == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Alloc shared memory fail");
+        return nullptr;
+    }
+    memory->size_ = static_cast<uint32_t>(buff.size());
+    memory->fd_ = memfd_create(SHARED_MEMORY_NAME, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memory->fd_ < 0) {
+        DLP_LOG_ERROR(LABEL, "memfd_create fail, errno=%{public}d", errno);
+        return nullptr;
+    }
+    if (ftruncate(memory->fd_, memory->size_) != 0) {
+        DLP_LOG_ERROR(LABEL, "ftruncate fail, errno=%{public}d", errno);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, memory->size_, PROT_READ | PROT_WRITE, MAP_SHARED, memory->fd_, 0);
+    if (addr == MAP_FAILED) {
+        DLP_LOG_ERROR(LABEL, "mmap fail, errno=%{public}d", errno);
+        return nullptr;
+    }
+    memory->addr_ = addr;
+    if (memcpy_s(memory->addr_, memory->size_, buff.data(), buff.size()) != EOK) {
+        DLP_LOG_ERROR(LABEL, "memcpy_s fail");
+        return nullptr;
+    }
+    // The writable mapping survives F_SEAL_FUTURE_WRITE, so the sender can still zero it on release.
+    if (fcntl(memory->fd_, F_ADD_SEALS, REQUIRED_SEALS | F_SEAL_FUTURE_WRITE) != 0) {
+        DLP_LOG_ERROR(LABEL, "add seals fail, errno=%{public}d", errno);
+        return nullptr;
+    }
+    return memory;
+}
+
+bool WriteSharedBuffer(Parcel& data, const std::vector<uint8_t>& buff, std::shared_ptr<DlpSharedMemory>& holder)
+{
+    holder = nullptr;
+    if (buff.size() >= DLP_SHARED_MEMORY_THRESHOLD) {
+        holder = DlpSharedMemory::Create(buff);
+    }
+    if (holder == nullptr) {
+        return data.WriteBool(false) && data.WriteUInt8Vector(buff);
+    }
+    sptr<IPCFileDescriptor> descriptor = new (std::nothrow) IPCFileDescriptor(holder->GetFd());
+    if (descriptor == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Alloc fd descriptor fail");
+        return false;
+    }
+    if (!data.WriteBool(true) || !data.WriteUint32(holder->GetSize())) {
+        DLP_LOG_ERROR(LABEL, "Write shared memory header fail");
+        return false;
+    }
+    if (!data.WriteObject<IPCFileDescriptor>(descriptor)) {
+        DLP_LOG_ERROR(LABEL, "Write shared memory fd fail");
+        return false;
+    }
+    return true;
+}
+
+static bool CheckSharedFd(int fd, uint32_t size)
+{
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS || (seals & WRITE_SEALS) == 0) {
+        DLP_LOG_ERROR(LABEL, "Shared memory is not sealed, seals=%{public}d", seals);
+        return false;
+    }
+    // size is fixed by the seals, so the mapping below can not fault on truncation
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(size)) {
+        DLP_LOG_ERROR(LABEL, "Shared memory size invalid");
+        return false;
+    }
+    return true;
+}
+
+static bool CopyFromSharedFd(int fd, uint32_t size, std::vector<uint8_t>& buff)
+{
+    if (!CheckSharedFd(fd, size)) {
+        return false;
+    }
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        DLP_LOG_ERROR(LABEL, "mmap fail, errno=%{public}d", errno);
+        return false;
+    }
+    const uint8_t* begin = static_cast<const uint8_t*>(addr);
+    buff.assign(begin, begin + size);
+    (void)munmap(addr, size);
+    return true;
+}
+
+int32_t ReadSharedBuffer(Parcel& data, std::vector<uint8_t>& buff, uint32_t maxSize)
+{
+    bool isShared = false;
+    if (!data.ReadBool(isShared)) {
+        DLP_LOG_ERROR(LABEL, "Read shared flag fail");
+        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+    }
+    if (!isShared) {
+        if (!data.ReadUInt8Vector(&buff)) {
+            DLP_LOG_ERROR(LABEL, "Read uint8 vector fail");
+            return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+        }
+        if (buff.size() > maxSize) {
+            DLP_LOG_ERROR(LABEL, "Buffer size %{public}zu exceeds limit %{public}u", buff.size(), maxSize);
+            buff.clear();
+            return DLP_SERVICE_ERROR_VALUE_INVALID;
+        }
+        return DLP_OK;
+    }
+    uint32_t size = 0;
+    if (!data.ReadUint32(size)) {
+        DLP_LOG_ERROR(LABEL, "Read shared memory size fail");
+        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+    }
+    if (size == 0 || size > maxSize) {
+        DLP_LOG_ERROR(LABEL, "Shared memory size %{public}u exceeds limit %{public}u", size, maxSize);
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    sptr<IPCFileDescriptor> descriptor = data.ReadObject<IPCFileDescriptor>();
+    if (descriptor == nullptr || descriptor->GetFd() < 0) {
+        DLP_LOG_ERROR(LABEL, "Read shared memory fd fail");
+        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+    }
+    int fd = dup(descriptor->GetFd());
+    if (fd < 0) {
+        DLP_LOG_ERROR(LABEL, "dup fail, errno=%{public}d", errno);
+        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+    }
+    bool res = CopyFromSharedFd(fd, size, buff);
+    (void)close(fd);
+    return res ? DLP_OK : DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -16,6 +16,7 @@
 #ifndef I_DLP_SANDBOX_STATE_CHANGE_CALLBACK_H
 #define I_DLP_SANDBOX_STATE_CHANGE_CALLBACK_H
 
+#include <vector>
 #include "dlp_sandbox_callback_info.h"
 #include "iremote_broker.h"
 
@@ -27,8 +28,16 @@ public:
     DECLARE_INTERFACE_DESCRIPTOR(u"ohos.security.IDlpSandboxStateChangeCallback");
 
     virtual void DlpSandboxStateChangeCallback(DlpSandboxCallbackInfo &result) = 0;
+    // Sent as one request by the proxy; delivered to the receiver one change at a time.
+    virtual void DlpSandboxStateChangeBatchCallback(std::vector<DlpSandboxCallbackInfo> &results)
+    {
+        for (auto &result : results) {
+            DlpSandboxStateChangeCallback(result);
+        }
+    }
     enum {
         DLP_SANDBOX_STATE_CHANGE = 0,
+        DLP_SANDBOX_STATE_CHANGE_BATCH = 1,
     };
 };
 } // namespace DlpPermission
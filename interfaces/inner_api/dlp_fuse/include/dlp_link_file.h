@@ -57,6 +57,15 @@ public:
     void setDlpFilePtr(const std::shared_ptr<DlpFile>& dlpFile)
     {
         std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+        // open writers go on with the new file, the old one is committed
+        if (openWriters_ > 0 && dlpFile_ != dlpFile) {
+            if (dlpFile_ != nullptr) {
+                (void)dlpFile_->SetCommitDeferred(false);
+            }
+            if (dlpFile != nullptr) {
+                (void)dlpFile->SetCommitDeferred(true);
+            }
+        }
         dlpFile_ = dlpFile;
     };
 
@@ -66,6 +75,20 @@ public:
     }
 
     int32_t Truncate(uint64_t modifySize);
+    // Grows the file to size, a larger file is left as it is.
+    int32_t Allocate(uint64_t size);
+    static bool IsAllocateSizeValid(uint64_t size)
+    {
+        return size < DLP_MAX_CONTENT_SIZE;
+    }
+
+    // Writable opens of the link file. While one is open the dlp file is committed on flush, fsync and the last
+    // release instead of after every write.
+    void OpenWriter();
+    int32_t ReleaseWriter();
+    int32_t Flush(bool syncData);
+    // The link file leaves the directory: commits, and writes commit at once from now on.
+    int32_t FinishWriters();
 
     void stopLink()
     {
@@ -85,6 +108,25 @@ public:
         return fileStat_;
     };
 
+    // Inode number and generation the manager gave the link file.
+    void SetInode(uint64_t ino, uint64_t generation)
+    {
+        std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+        ino_ = ino;
+        generation_ = generation;
+        fileStat_.st_ino = static_cast<ino_t>(ino);
+    };
+
+    uint64_t GetInode() const
+    {
+        return ino_;
+    };
+
+    uint64_t GetGeneration() const
+    {
+        return generation_;
+    };
+
 private:
     std::string dlpLinkName_;
     std::shared_ptr<DlpFile> dlpFile_;
@@ -94,6 +136,10 @@ private:
     std::shared_mutex linkRwMutex_;
     bool stopLinkFlag_;
     std::atomic<bool> hasRead_;
+    std::atomic<uint64_t> ino_ { 0 };
+    std::atomic<uint64_t> generation_ { 0 };
+    uint32_t openWriters_ = 0;  // guarded by linkRwMutex_
+    bool writersFinished_ = false;  // guarded by linkRwMutex_
 };
 }  // namespace DlpPermission
 }  // namespace Security
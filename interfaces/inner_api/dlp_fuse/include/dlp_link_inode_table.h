@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_LINK_INODE_TABLE_H
+#define DLP_LINK_INODE_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fuse_lowlevel.h>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+class DlpLinkFile;
+
+/*
+ * Inode numbers of the link files. A link file takes a slot of a fixed array, its inode is the slot number in the
+ * low INDEX_BITS and the generation of the slot above them; the root directory keeps inode 1. A slot is handed out
+ * again only after its file is freed, with the next generation, so an inode number the kernel still holds from a
+ * forgotten file never reaches the new one.
+ *
+ * Lookups take no lock: a FUSE request pins the slot for as long as it uses the file. Erasing a slot never waits,
+ * the slot is freed and its file released by Erase if no request pins it, or else by the last Unpin. Only taking
+ * and freeing a slot lock the free list.
+ */
+class DlpLinkInodeTable final {
+public:
+    static constexpr fuse_ino_t FIRST_INODE = 2;
+    static constexpr uint32_t INDEX_BITS = 16;
+    using ReleaseFunc = void (*)(DlpLinkFile* node);
+
+    DlpLinkInodeTable(uint32_t capacity, ReleaseFunc release);
+    DlpLinkInodeTable(const DlpLinkInodeTable&) = delete;
+    DlpLinkInodeTable& operator=(const DlpLinkInodeTable&) = delete;
+
+    // Gives node a slot, false if there is none left.
+    bool Insert(DlpLinkFile* node, fuse_ino_t& ino, uint64_t& generation);
+
+    // The linked file of ino, pinned until Unpin; nullptr if ino is not a linked file.
+    DlpLinkFile* Pin(fuse_ino_t ino);
+
+    // Ends a Pin; the last one of an erased slot frees it.
+    void Unpin(fuse_ino_t ino);
+
+    // The file of ino, whether it is still linked or only held by the kernel; not pinned.
+    DlpLinkFile* Find(fuse_ino_t ino) const;
+
+    // The file of ino left the directory, requests can no longer pin it.
+    void Unlink(fuse_ino_t ino);
+
+    // Takes ino out of the table. Its file is released now if no request pins it, else by the last Unpin.
+    void Erase(fuse_ino_t ino);
+
+private:
+    // pins holds the pin count, with ERASED set once the slot is erased and FREED once it is freed.
+    static constexpr uint32_t ERASED = 1U << 31;
+    static constexpr uint32_t FREED = 1U << 30;
+    static constexpr uint32_t PIN_MASK = FREED - 1;
+
+    struct Slot {
+        std::atomic<fuse_ino_t> ino { 0 };
+        std::atomic<DlpLinkFile*> node { nullptr };
+        std::atomic<bool> linked { false };
+        std::atomic<uint32_t> pins { 0 };
+        uint32_t generation = 0;  // guarded by freeLock_
+    };
+
+    void Release(Slot& slot);
+
+    // Frees an erased slot no one pins; of the callers racing for it, only one does.
+    void TryFree(Slot& slot);
+
+    Slot* SlotOf(fuse_ino_t ino) const;
+
+    const uint32_t capacity_;
+    const ReleaseFunc release_;
+    std::unique_ptr<Slot[]> slots_;
+    std::mutex freeLock_;
+    std::vector<uint32_t> freeSlots_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_LINK_INODE_TABLE_H
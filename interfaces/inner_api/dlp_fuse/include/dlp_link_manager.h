@@ -19,6 +19,7 @@
 #include <string>
 #include "dlp_file.h"
 #include "dlp_link_file.h"
+#include "dlp_link_inode_table.h"
 #include "rwlock.h"
 
 #include <fuse_lowlevel.h>
@@ -38,7 +39,10 @@ public:
     int32_t ReplaceDlpLinkFile(const std::shared_ptr<DlpFile>& filePtr, const std::string& dlpLinkName);
     int32_t DeleteDlpLinkFile(const std::shared_ptr<DlpFile>& filePtr);
     DlpLinkFile* LookUpDlpLinkFile(const std::string& dlpLinkName);
+    // The linked file of ino, pinned for one request until UnpinDlpLinkFile; it is not freed while pinned.
     DlpLinkFile* LookUpDlpLinkFileByIno(fuse_ino_t ino);
+    void UnpinDlpLinkFile(fuse_ino_t ino);
+    void ForgetDlpLinkFile(fuse_ino_t ino, uint64_t nlookup);
     void DumpDlpLinkFile(std::vector<DlpLinkFileInfo>& linkList);
     void ReleaseDlpLinkFile(DlpLinkFile* node);
 
@@ -48,6 +52,7 @@ private:
 
     OHOS::Utils::RWLock dlpLinkMapLock_;
     std::unordered_map<std::string, DlpLinkFile*> dlpLinkFileNameMap_;
+    DlpLinkInodeTable inodeTable_;
 };
 }  // namespace DlpPermission
 }  // namespace Security
@@ -19,14 +19,19 @@
 #include <condition_variable>
 #include <fuse_i.h>
 #include <fuse_lowlevel.h>
+#include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 #include "dlp_link_file.h"
 #include "rwlock.h"
 
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
+// Largest read and write the daemon negotiates with the kernel, also the block size it reports.
+static constexpr uint32_t FUSE_MAX_IO_SIZE = 1024 * 1024;
+
 typedef struct DirAddParams {
     fuse_req_t req;
     char *directBuf;
@@ -52,6 +57,11 @@ public:
     static void NotifyDaemonDisable(void);
     static void InitRootFileStat(void);
     static void FuseFsDaemonThread(int fuseFd);
+    // Drops what the kernel caches of ino, and the entry of name in the root dir unless name is empty. Requests are
+    // merged and sent in batches by a thread of their own, a notification can wait for kernel requests on the inode
+    // that wait for the caller.
+    static void InvalidateLinkFile(fuse_ino_t ino, const std::string& name);
+    static void InvalidateThread(struct fuse_session* se);
 
     static std::condition_variable daemonEnableCv_;
     static enum DaemonStatus daemonStatus_;
@@ -60,6 +70,10 @@ public:
     static bool init_;
     static std::mutex initMutex_;
     static struct fuse_lowlevel_ops fuseDaemonOper_;
+    static std::mutex invalMutex_;
+    static std::condition_variable invalCv_;
+    static std::map<fuse_ino_t, std::string> invalPending_;
+    static bool invalRunning_;
 };
 }  // namespace DlpPermission
 }  // namespace Security
@@ -15,6 +15,8 @@
 
 #include "dlp_link_file.h"
 
+#include <cerrno>
+#include <cstring>
 #include <securec.h>
 #include "dlp_fuse_utils.h"
 #include "dlp_permission.h"
@@ -47,7 +49,6 @@ DlpLinkFile::DlpLinkFile(const std::string& dlpLinkName, const std::shared_ptr<D
     : dlpLinkName_(dlpLinkName), dlpFile_(dlpFile), refcount_(1), stopLinkFlag_(false), hasRead_(false)
 {
     (void)memset_s(&fileStat_, sizeof(fileStat_), 0, sizeof(fileStat_));
-    fileStat_.st_ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(this));
     if (dlpFile != nullptr) {
         uint32_t fileMode =
             (dlpFile->GetAuthPerm() == DLPFileAccess::READ_ONLY) ? DEFAULT_INODE_RO_ACCESS : DEFAULT_INODE_RW_ACCESS;
@@ -56,6 +57,7 @@ DlpLinkFile::DlpLinkFile(const std::string& dlpLinkName, const std::shared_ptr<D
         fileStat_.st_mode = 0;
     }
     fileStat_.st_nlink = 1;
+    fileStat_.st_blksize = FUSE_MAX_IO_SIZE;
     fileStat_.st_uid = getuid();
     fileStat_.st_gid = getgid();
 
@@ -137,6 +139,89 @@ int32_t DlpLinkFile::Truncate(uint64_t modifySize)
     return res;
 }
 
+int32_t DlpLinkFile::Allocate(uint64_t size)
+{
+    std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+    if (stopLinkFlag_) {
+        DLP_LOG_INFO(LABEL, "linkFile is stopping link");
+        return DLP_LINK_FILE_NOT_ALLOW_OPERATE;
+    }
+    if (!IsAllocateSizeValid(size)) {
+        DLP_LOG_ERROR(LABEL, "Allocate fail, size %{public}s is invalid", std::to_string(size).c_str());
+        return DLP_FUSE_ERROR_VALUE_INVALID;
+    }
+    if (dlpFile_ == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Allocate link file fail, dlp file is null");
+        return DLP_FUSE_ERROR_DLP_FILE_NULL;
+    }
+    uint64_t curSize = dlpFile_->GetFsContentSize();
+    if (curSize == INVALID_FILE_SIZE) {
+        DLP_LOG_ERROR(LABEL, "Allocate link file fail, content size invalid");
+        return DLP_FUSE_ERROR_VALUE_INVALID;
+    }
+    if (size <= curSize) {
+        return DLP_OK;
+    }
+    int32_t res = dlpFile_->Truncate(size);
+    if (res < 0) {
+        DLP_LOG_ERROR(LABEL, "Allocate %{public}s file fail, res=%{public}d", std::to_string(size).c_str(), res);
+        return res;
+    }
+    DlpFuseUtils::UpdateCurrTimeStat(&fileStat_.st_mtim);
+    return DLP_OK;
+}
+
+void DlpLinkFile::OpenWriter()
+{
+    std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+    if (writersFinished_) {
+        return;
+    }
+    if (openWriters_++ == 0 && dlpFile_ != nullptr) {
+        (void)dlpFile_->SetCommitDeferred(true);
+    }
+}
+
+int32_t DlpLinkFile::ReleaseWriter()
+{
+    std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+    if (openWriters_ == 0 || --openWriters_ > 0 || dlpFile_ == nullptr) {
+        return DLP_OK;
+    }
+    int32_t res = dlpFile_->SetCommitDeferred(false);
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Commit link file on last release fail, res=%{public}d", res);
+    }
+    return res;
+}
+
+int32_t DlpLinkFile::Flush(bool syncData)
+{
+    std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+    if (dlpFile_ == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Flush link file fail, dlp file is null");
+        return DLP_FUSE_ERROR_DLP_FILE_NULL;
+    }
+    int32_t res = dlpFile_->DlpFileCommit();
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Flush link file fail, res=%{public}d", res);
+        return res;
+    }
+    if (syncData && fsync(dlpFile_->dlpFd_) != 0) {
+        DLP_LOG_ERROR(LABEL, "Sync link file fail, %{public}s", strerror(errno));
+        return DLP_FUSE_ERROR_OPERATE_FAIL;
+    }
+    return DLP_OK;
+}
+
+int32_t DlpLinkFile::FinishWriters()
+{
+    std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
+    writersFinished_ = true;
+    openWriters_ = 0;
+    return (dlpFile_ != nullptr) ? dlpFile_->SetCommitDeferred(false) : DLP_OK;
+}
+
 void DlpLinkFile::UpdateAtimeStat()
 {
     std::unique_lock<std::shared_mutex> lock(linkRwMutex_);
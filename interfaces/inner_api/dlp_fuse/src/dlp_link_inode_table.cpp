@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_link_inode_table.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+DlpLinkInodeTable::DlpLinkInodeTable(uint32_t capacity, ReleaseFunc release)
+    : capacity_(capacity), release_(release), slots_(new Slot[capacity])
+{
+    freeSlots_.reserve(capacity);
+    for (uint32_t i = capacity; i > 0; i--) {
+        freeSlots_.push_back(i - 1);
+    }
+}
+
+bool DlpLinkInodeTable::Insert(DlpLinkFile* node, fuse_ino_t& ino, uint64_t& generation)
+{
+    std::lock_guard<std::mutex> lock(freeLock_);
+    if (node == nullptr || freeSlots_.empty()) {
+        return false;
+    }
+    uint32_t index = freeSlots_.back();
+    freeSlots_.pop_back();
+    Slot& slot = slots_[index];
+    slot.generation = (slot.generation == UINT32_MAX) ? 1 : slot.generation + 1;
+    generation = slot.generation;
+    ino = (static_cast<fuse_ino_t>(slot.generation) << INDEX_BITS) | (index + FIRST_INODE);
+    slot.node.store(node);
+    slot.linked.store(true);
+    // keeps the pins of lookups racing with the reuse, they drop them again
+    slot.pins.fetch_and(PIN_MASK);
+    slot.ino.store(ino);
+    return true;
+}
+
+DlpLinkFile* DlpLinkInodeTable::Pin(fuse_ino_t ino)
+{
+    Slot* slot = SlotOf(ino);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+    slot->pins.fetch_add(1);
+    if (slot->ino.load() != ino || !slot->linked.load()) {
+        Release(*slot);
+        return nullptr;
+    }
+    return slot->node.load();
+}
+
+void DlpLinkInodeTable::Unpin(fuse_ino_t ino)
+{
+    Slot* slot = SlotOf(ino);
+    if (slot != nullptr) {
+        Release(*slot);
+    }
+}
+
+DlpLinkFile* DlpLinkInodeTable::Find(fuse_ino_t ino) const
+{
+    const Slot* slot = SlotOf(ino);
+    return (slot != nullptr && slot->ino.load() == ino) ? slot->node.load() : nullptr;
+}
+
+void DlpLinkInodeTable::Unlink(fuse_ino_t ino)
+{
+    Slot* slot = SlotOf(ino);
+    if (slot != nullptr && slot->ino.load() == ino) {
+        slot->linked.store(false);
+    }
+}
+
+void DlpLinkInodeTable::Erase(fuse_ino_t ino)
+{
+    Slot* slot = SlotOf(ino);
+    fuse_ino_t expected = ino;
+    if (slot == nullptr || !slot->ino.compare_exchange_strong(expected, 0)) {
+        return;
+    }
+    slot->linked.store(false);
+    if ((slot->pins.fetch_or(ERASED) & PIN_MASK) == 0) {
+        TryFree(*slot);
+    }
+}
+
+void DlpLinkInodeTable::Release(Slot& slot)
+{
+    if (slot.pins.fetch_sub(1) == (ERASED | 1)) {
+        TryFree(slot);
+    }
+}
+
+void DlpLinkInodeTable::TryFree(Slot& slot)
+{
+    uint32_t expected = ERASED;
+    if (!slot.pins.compare_exchange_strong(expected, ERASED | FREED)) {
+        return;
+    }
+    DlpLinkFile* node = slot.node.exchange(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(freeLock_);
+        freeSlots_.push_back(static_cast<uint32_t>(&slot - slots_.get()));
+    }
+    if (node != nullptr && release_ != nullptr) {
+        release_(node);
+    }
+}
+
+DlpLinkInodeTable::Slot* DlpLinkInodeTable::SlotOf(fuse_ino_t ino) const
+{
+    fuse_ino_t slotNo = ino & ((static_cast<fuse_ino_t>(1) << INDEX_BITS) - 1);
+    if (slotNo < FIRST_INODE || slotNo - FIRST_INODE >= capacity_) {
+        return nullptr;
+    }
+    return &slots_[slotNo - FIRST_INODE];
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
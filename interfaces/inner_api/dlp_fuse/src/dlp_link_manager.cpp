@@ -18,6 +18,7 @@
 #include "dlp_fuse_fd.h"
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
+#include "fuse_daemon.h"
 
 namespace OHOS {
 namespace Security {
@@ -26,9 +27,14 @@ namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpLinkManager"};
 static const int MAX_FILE_NAME_LEN = 256;
 static constexpr uint32_t MAX_DLP_LINK_SIZE = 1000; // max open link file
+
+void DeleteLinkFile(DlpLinkFile* node)
+{
+    delete node;
+}
 }
 
-DlpLinkManager::DlpLinkManager()
+DlpLinkManager::DlpLinkManager() : inodeTable_(MAX_DLP_LINK_SIZE, DeleteLinkFile)
 {}
 
 DlpLinkManager::~DlpLinkManager()
@@ -89,6 +95,15 @@ int32_t DlpLinkManager::AddDlpLinkFile(const std::shared_ptr<DlpFile>& filePtr,
         return DLP_FUSE_ERROR_MEMORY_OPERATE_FAIL;
     }
 
+    fuse_ino_t ino = 0;
+    uint64_t generation = 0;
+    if (!inodeTable_.Insert(node, ino, generation)) {
+        DLP_LOG_ERROR(LABEL, "Add link file fail, no inode left");
+        delete node;
+        return DLP_FUSE_ERROR_TOO_MANY_LINK_FILE;
+    }
+    node->SetInode(ino, generation);
+
     DLP_LOG_INFO(LABEL, "Add link file succ, file name %{private}s", dlpLinkName.c_str());
     dlpLinkFileNameMap_[dlpLinkName] = node;
     filePtr->SetLinkStatus();
@@ -111,6 +126,8 @@ int32_t DlpLinkManager::StopDlpLinkFile(const std::shared_ptr<DlpFile>& filePtr)
         }
         if (filePtr == node->GetDlpFilePtr()) {
             node->stopLink();
+            // the file is handed back, with the changes of writers still open
+            (void)node->Flush(false);
             filePtr->RemoveLinkStatus();
             DLP_LOG_INFO(LABEL, "Stop link file success, file name %{private}s", node->GetLinkName().c_str());
             return DLP_OK;
@@ -166,6 +183,7 @@ int32_t DlpLinkManager::ReplaceDlpLinkFile(const std::shared_ptr<DlpFile>& fileP
                 return DLP_FUSE_ERROR_DLP_FILE_NULL;
             }
             node->setDlpFilePtr(filePtr);
+            FuseDaemon::InvalidateLinkFile(node->GetInode(), "");
             DLP_LOG_INFO(LABEL, "Replace link file success, file name %{private}s", dlpLinkName.c_str());
             return DLP_OK;
         }
@@ -180,24 +198,42 @@ int32_t DlpLinkManager::DeleteDlpLinkFile(const std::shared_ptr<DlpFile>& filePt
         return DLP_FUSE_ERROR_DLP_FILE_NULL;
     }
 
-    Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(dlpLinkMapLock_);
-    for (auto iter = dlpLinkFileNameMap_.begin(); iter != dlpLinkFileNameMap_.end(); iter++) {
-        DlpLinkFile* tmp = iter->second;
-        if (tmp != nullptr && filePtr == tmp->GetDlpFilePtr()) {
-            filePtr->RemoveLinkStatus();
-            dlpLinkFileNameMap_.erase(iter);
-            if (tmp->SubAndCheckZeroRef(1)) {
-                DLP_LOG_INFO(LABEL, "Delete link file %{private}s ok", tmp->GetLinkName().c_str());
-                delete tmp;
-            } else {
-                DLP_LOG_INFO(LABEL, "Link file %{private}s is still referenced by kernel, only remove it from map",
-                    tmp->GetLinkName().c_str());
+    DlpLinkFile* tmp = nullptr;
+    fuse_ino_t ino = 0;
+    {
+        Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(dlpLinkMapLock_);
+        for (auto iter = dlpLinkFileNameMap_.begin(); iter != dlpLinkFileNameMap_.end(); iter++) {
+            if (iter->second != nullptr && filePtr == iter->second->GetDlpFilePtr()) {
+                ino = iter->second->GetInode();
+                // the pin keeps the file alive if the kernel forgets it once the lock is released
+                tmp = inodeTable_.Pin(ino);
+                if (tmp == nullptr) {
+                    break;
+                }
+                filePtr->RemoveLinkStatus();
+                FuseDaemon::InvalidateLinkFile(ino, iter->first);
+                dlpLinkFileNameMap_.erase(iter);
+                inodeTable_.Unlink(ino);
+                break;
             }
-            return DLP_OK;
         }
     }
-    DLP_LOG_ERROR(LABEL, "Delete link file fail, it does not exist.");
-    return DLP_FUSE_ERROR_LINKFILE_NOT_EXIST;
+    if (tmp == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Delete link file fail, it does not exist.");
+        return DLP_FUSE_ERROR_LINKFILE_NOT_EXIST;
+    }
+
+    // committing the writers' changes may take long, lookups and creates do not wait for it
+    (void)tmp->FinishWriters();
+    if (tmp->SubAndCheckZeroRef(1)) {
+        DLP_LOG_INFO(LABEL, "Delete link file %{private}s ok", tmp->GetLinkName().c_str());
+        inodeTable_.Erase(ino);
+    } else {
+        DLP_LOG_INFO(LABEL, "Link file %{private}s is still referenced by kernel, only remove it from map",
+            tmp->GetLinkName().c_str());
+    }
+    inodeTable_.Unpin(ino);
+    return DLP_OK;
 }
 
 void DlpLinkManager::ReleaseDlpLinkFile(DlpLinkFile* node)
@@ -207,48 +243,57 @@ void DlpLinkManager::ReleaseDlpLinkFile(DlpLinkFile* node)
     }
 
     Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(dlpLinkMapLock_);
-    for (auto iter = dlpLinkFileNameMap_.begin(); iter != dlpLinkFileNameMap_.end(); iter++) {
-        if (node == iter->second) {
-            dlpLinkFileNameMap_.erase(iter);
-            break;
-        }
+    auto iter = dlpLinkFileNameMap_.find(node->GetLinkName());
+    if (iter != dlpLinkFileNameMap_.end() && iter->second == node) {
+        dlpLinkFileNameMap_.erase(iter);
     }
-    delete node;
+    inodeTable_.Erase(node->GetInode());
 }
 
 DlpLinkFile* DlpLinkManager::LookUpDlpLinkFile(const std::string& dlpLinkName)
 {
     Utils::UniqueReadGuard<Utils::RWLock> infoGuard(dlpLinkMapLock_);
-    for (auto iter = dlpLinkFileNameMap_.begin(); iter != dlpLinkFileNameMap_.end(); ++iter) {
-        if (dlpLinkName == iter->first) {
-            DlpLinkFile* node = iter->second;
-            if (node == nullptr) {
-                DLP_LOG_ERROR(LABEL, "Look up link file fail, file %{private}s found but file ptr is null",
-                    dlpLinkName.c_str());
-                return nullptr;
-            }
-            if (!node->IncreaseRef()) {
-                DLP_LOG_ERROR(LABEL, "Look up link file fail, increase ref failed for %{private}s",
-                    dlpLinkName.c_str());
-                return nullptr;
-            }
-            return node;
-        }
+    auto iter = dlpLinkFileNameMap_.find(dlpLinkName);
+    if (iter == dlpLinkFileNameMap_.end()) {
+        DLP_LOG_ERROR(LABEL, "Look up link file fail, file %{private}s not exist", dlpLinkName.c_str());
+        return nullptr;
+    }
+    DlpLinkFile* node = iter->second;
+    if (node == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Look up link file fail, file %{private}s found but file ptr is null",
+            dlpLinkName.c_str());
+        return nullptr;
     }
-    DLP_LOG_ERROR(LABEL, "Look up link file fail, file %{private}s not exist", dlpLinkName.c_str());
-    return nullptr;
+    if (!node->IncreaseRef()) {
+        DLP_LOG_ERROR(LABEL, "Look up link file fail, increase ref failed for %{private}s", dlpLinkName.c_str());
+        return nullptr;
+    }
+    return node;
 }
 
 DlpLinkFile* DlpLinkManager::LookUpDlpLinkFileByIno(fuse_ino_t ino)
 {
-    DlpLinkFile* target = reinterpret_cast<DlpLinkFile*>(static_cast<uintptr_t>(ino));
-    Utils::UniqueReadGuard<Utils::RWLock> infoGuard(dlpLinkMapLock_);
-    for (auto& [name, node] : dlpLinkFileNameMap_) {
-        if (node == target) {
-            return node;
-        }
+    return inodeTable_.Pin(ino);
+}
+
+void DlpLinkManager::UnpinDlpLinkFile(fuse_ino_t ino)
+{
+    inodeTable_.Unpin(ino);
+}
+
+void DlpLinkManager::ForgetDlpLinkFile(fuse_ino_t ino, uint64_t nlookup)
+{
+    DlpLinkFile* node = inodeTable_.Find(ino);
+    if (node == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Forget link file fail, wrong ino");
+        return;
+    }
+    DLP_LOG_DEBUG(LABEL, "Forget link file name %{private}s nlookup %{public}u",
+        node->GetLinkName().c_str(), static_cast<uint32_t>(nlookup));
+    if (node->SubAndCheckZeroRef(static_cast<int>(nlookup))) {
+        DLP_LOG_INFO(LABEL, "Link file reference is less than 0, delete link file ok");
+        ReleaseDlpLinkFile(node);
     }
-    return nullptr;
 }
 
 void DlpLinkManager::DumpDlpLinkFile(std::vector<DlpLinkFileInfo>& linkList)
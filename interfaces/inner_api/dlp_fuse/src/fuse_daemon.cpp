@@ -15,9 +15,12 @@
 
 #include "fuse_daemon.h"
 
+#include <atomic>
+#include <fcntl.h>
 #include <pthread.h>
 #include <securec.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <vector>
@@ -49,21 +52,60 @@ std::mutex FuseDaemon::daemonEnableMtx_;
 struct stat FuseDaemon::rootFileStat_;
 bool FuseDaemon::init_ = false;
 std::mutex FuseDaemon::initMutex_;
+std::mutex FuseDaemon::invalMutex_;
+std::condition_variable FuseDaemon::invalCv_;
+std::map<fuse_ino_t, std::string> FuseDaemon::invalPending_;
+bool FuseDaemon::invalRunning_ = false;
 
-// caller need to check ino == ROOT_INODE
-static DlpLinkFile* GetFileNode(fuse_ino_t ino)
-{
-    DlpLinkManager* manager = DlpFuseHelper::GetDlpLinkManagerInstance();
-    if (manager == nullptr) {
-        return nullptr;
+namespace {
+// Pins the link file of ino for one request, a delete racing with the request frees the file once it is done.
+class FileNodeRef final {
+public:
+    explicit FileNodeRef(fuse_ino_t ino) : ino_(ino), manager_(DlpFuseHelper::GetDlpLinkManagerInstance())
+    {
+        if (manager_ != nullptr) {
+            node_ = manager_->LookUpDlpLinkFileByIno(ino);
+        }
+    }
+
+    ~FileNodeRef()
+    {
+        if (node_ != nullptr) {
+            manager_->UnpinDlpLinkFile(ino_);
+        }
+    }
+
+    DlpLinkFile* Get() const
+    {
+        return node_;
     }
-    return manager->LookUpDlpLinkFileByIno(ino);
+
+private:
+    DISALLOW_COPY_AND_MOVE(FileNodeRef);
+
+    fuse_ino_t ino_;
+    DlpLinkManager* manager_;
+    DlpLinkFile* node_ = nullptr;
+};
+
+// State of one open of a link file, kept in fi->fh from open to release.
+struct FuseFileHandle {
+    bool writable;
+};
+
+FuseFileHandle* GetFileHandle(const struct fuse_file_info* fi)
+{
+    return (fi != nullptr) ? reinterpret_cast<FuseFileHandle*>(static_cast<uintptr_t>(fi->fh)) : nullptr;
 }
 
-fuse_ino_t GetFileInode(DlpLinkFile* node)
+void CloseFileHandle(DlpLinkFile* dlp, FuseFileHandle* handle)
 {
-    return static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(node));
+    if (handle != nullptr && handle->writable && dlp != nullptr) {
+        (void)dlp->ReleaseWriter();
+    }
+    delete handle;
 }
+}  // namespace
 
 static void FuseDaemonLookup(fuse_req_t req, fuse_ino_t parent, const char* name)
 {
@@ -103,7 +145,8 @@ static void FuseDaemonLookup(fuse_req_t req, fuse_ino_t parent, const char* name
         fuse_reply_err(req, ENOENT);
     } else {
         DLP_LOG_DEBUG(LABEL, "Look up link file succ, file %{public}s found", name);
-        fep.ino = GetFileInode(node);
+        fep.ino = node->GetInode();
+        fep.generation = node->GetGeneration();
         fep.attr = node->GetLinkStat();
         fuse_reply_entry(req, &fep);
     }
@@ -119,7 +162,8 @@ static void FuseDaemonGetattr(fuse_req_t req, fuse_ino_t ino, struct fuse_file_i
         return;
     }
 
-    DlpLinkFile* dlp = GetFileNode(ino);
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = ref.Get();
     if (dlp == nullptr) {
         DLP_LOG_ERROR(LABEL, "Get link file attr fail, wrong ino");
         fuse_reply_err(req, ENOENT);
@@ -139,33 +183,58 @@ static void FuseDaemonOpen(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info
         return;
     }
 
-    DlpLinkFile* dlp = GetFileNode(ino);
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = ref.Get();
     if (dlp == nullptr) {
         DLP_LOG_ERROR(LABEL, "Open link file fail, wrong ino");
         fuse_reply_err(req, ENOENT);
         return;
     }
+    FuseFileHandle* handle = nullptr;
+    if (fi != nullptr) {
+        handle = new (std::nothrow) FuseFileHandle { (static_cast<uint32_t>(fi->flags) & O_ACCMODE) != O_RDONLY };
+        if (handle == nullptr) {
+            DLP_LOG_ERROR(LABEL, "Open link file fail, alloc file handle fail");
+            fuse_reply_err(req, ENOMEM);
+            return;
+        }
+        if (handle->writable) {
+            dlp->OpenWriter();
+        }
+    }
+    bool truncated = false;
     if ((fi != nullptr) && (static_cast<uint32_t>(fi->flags) & O_TRUNC) != 0) {
         int32_t ret = dlp->Truncate(0);
         if (ret != DLP_OK) {
             DLP_LOG_ERROR(LABEL, "Open link file with truncate fail, ret=%{public}d", ret);
+            CloseFileHandle(dlp, handle);
             fuse_reply_err(req, EINVAL);
             return;
         }
+        truncated = true;
         DLP_LOG_INFO(LABEL, "Open link file with truncate succ");
     }
 
-    fuse_reply_open(req, fi);
+    if (fi != nullptr) {
+        fi->fh = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+        // changes made around the mount invalidate the cache, so it can outlive the open
+        fi->keep_cache = truncated ? 0 : 1;
+    }
+    if (fuse_reply_open(req, fi) != 0) {
+        // the open was interrupted, no release will come for it
+        CloseFileHandle(dlp, handle);
+        return;
+    }
     dlp->UpdateAtimeStat();
 }
 
-static DlpLinkFile* GetValidFileNode(fuse_req_t req, fuse_ino_t ino)
+static DlpLinkFile* GetValidFileNode(fuse_req_t req, fuse_ino_t ino, const FileNodeRef& ref)
 {
     if (ino == ROOT_INODE) {
         fuse_reply_err(req, ENOENT);
         return nullptr;
     }
-    DlpLinkFile* dlp = GetFileNode(ino);
+    DlpLinkFile* dlp = ref.Get();
     if (dlp == nullptr) {
         fuse_reply_err(req, EBADF);
         return nullptr;
@@ -190,7 +259,8 @@ static void FuseDaemonRead(fuse_req_t req, fuse_ino_t ino, size_t size, off_t of
         fuse_reply_err(req, EINVAL);
         return;
     }
-    DlpLinkFile* dlp = GetValidFileNode(req, ino);
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = GetValidFileNode(req, ino, ref);
     if (dlp == nullptr) {
         DLP_LOG_ERROR(LABEL, "Read link file fail, wrong ino");
         return;
@@ -227,7 +297,8 @@ static void FuseDaemonWrite(
         fuse_reply_err(req, EINVAL);
         return;
     }
-    DlpLinkFile* dlp = GetValidFileNode(req, ino);
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = GetValidFileNode(req, ino, ref);
     if (dlp == nullptr) {
         DLP_LOG_ERROR(LABEL, "Write link file fail, wrong ino");
         return;
@@ -251,21 +322,122 @@ static void FuseDaemonForget(fuse_req_t req, fuse_ino_t ino, uint64_t nlookup)
         return;
     }
 
-    DlpLinkFile* dlp = reinterpret_cast<DlpLinkFile*>(static_cast<uintptr_t>(ino));
-    if (dlp == nullptr) {
-        DLP_LOG_ERROR(LABEL, "Forgot link file fail, wrong ino");
+    DlpLinkManager* manager = DlpFuseHelper::GetDlpLinkManagerInstance();
+    if (manager == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Get instance failed.");
         fuse_reply_none(req);
         return;
     }
-    DLP_LOG_DEBUG(LABEL, "Forget link file name %{private}s nlookup %{public}u",
-        dlp->GetLinkName().c_str(), static_cast<uint32_t>(nlookup));
-    if (dlp->SubAndCheckZeroRef(nlookup)) {
-        DLP_LOG_INFO(LABEL, "Link file reference is less than 0, delete link file ok");
-        delete dlp;
-    }
+    manager->ForgetDlpLinkFile(ino, nlookup);
     fuse_reply_none(req);
 }
 
+static void FuseDaemonFlush(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi)
+{
+    FuseFileHandle* handle = GetFileHandle(fi);
+    // closing a read only open leaves the changes of the writers pending
+    if (handle == nullptr || !handle->writable) {
+        fuse_reply_err(req, 0);
+        return;
+    }
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = GetValidFileNode(req, ino, ref);
+    if (dlp == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Flush link file fail, wrong ino");
+        return;
+    }
+    int32_t ret = dlp->Flush(false);
+    fuse_reply_err(req, (ret == DLP_OK) ? 0 : EIO);
+}
+
+static void FuseDaemonRelease(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi)
+{
+    FuseFileHandle* handle = GetFileHandle(fi);
+    if (handle != nullptr && handle->writable) {
+        // a deleted link file has been committed and counts no writers any more
+        FileNodeRef ref(ino);
+        CloseFileHandle(ref.Get(), handle);
+    } else {
+        delete handle;
+    }
+    if (fi != nullptr) {
+        fi->fh = 0;
+    }
+    fuse_reply_err(req, 0);
+}
+
+static void FuseDaemonFsync(fuse_req_t req, fuse_ino_t ino, int datasync, struct fuse_file_info* fi)
+{
+    (void)datasync;
+    (void)fi;
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = GetValidFileNode(req, ino, ref);
+    if (dlp == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Fsync link file fail, wrong ino");
+        return;
+    }
+    int32_t ret = dlp->Flush(true);
+    fuse_reply_err(req, (ret == DLP_OK) ? 0 : EIO);
+}
+
+static void FuseDaemonStatfs(fuse_req_t req, fuse_ino_t ino)
+{
+    struct statvfs fsStat;
+    (void)memset_s(&fsStat, sizeof(fsStat), 0, sizeof(fsStat));
+    // a link file has the space of the file system of its dlp file
+    std::shared_ptr<DlpFile> filePtr = nullptr;
+    if (ino != ROOT_INODE) {
+        FileNodeRef ref(ino);
+        filePtr = (ref.Get() != nullptr) ? ref.Get()->GetDlpFilePtr() : nullptr;
+    }
+    if (filePtr == nullptr || fstatvfs(filePtr->dlpFd_, &fsStat) != 0) {
+        // the root only bounds the content of one link file
+        (void)memset_s(&fsStat, sizeof(fsStat), 0, sizeof(fsStat));
+        fsStat.f_frsize = FUSE_MAX_IO_SIZE;
+        fsStat.f_blocks = DLP_MAX_CONTENT_SIZE / FUSE_MAX_IO_SIZE;
+        fsStat.f_bfree = fsStat.f_blocks;
+        fsStat.f_bavail = fsStat.f_blocks;
+    }
+    fsStat.f_bsize = FUSE_MAX_IO_SIZE;
+    fsStat.f_namemax = MAX_FILE_NAME_LEN;
+    fuse_reply_statfs(req, &fsStat);
+}
+
+static void FuseDaemonFallocate(fuse_req_t req, fuse_ino_t ino, int mode, off_t offset, off_t length,
+    struct fuse_file_info* fi)
+{
+    (void)fi;
+    if ((static_cast<uint32_t>(mode) & ~static_cast<uint32_t>(FALLOC_FL_KEEP_SIZE)) != 0) {
+        DLP_LOG_ERROR(LABEL, "Fallocate link file fail, mode %{public}d not support", mode);
+        fuse_reply_err(req, EOPNOTSUPP);
+        return;
+    }
+    if (offset < 0 || length <= 0) {
+        fuse_reply_err(req, EINVAL);
+        return;
+    }
+    // both are below INT64_MAX, the sum can not wrap
+    uint64_t size = static_cast<uint64_t>(offset) + static_cast<uint64_t>(length);
+    if (!DlpLinkFile::IsAllocateSizeValid(size)) {
+        DLP_LOG_ERROR(LABEL, "Fallocate link file fail, size %{public}s too large", std::to_string(size).c_str());
+        fuse_reply_err(req, EFBIG);
+        return;
+    }
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlp = GetValidFileNode(req, ino, ref);
+    if (dlp == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Fallocate link file fail, wrong ino");
+        return;
+    }
+    // content is encrypted as it is written, there is no room to reserve ahead, only the size to grow
+    if ((static_cast<uint32_t>(mode) & FALLOC_FL_KEEP_SIZE) != 0) {
+        fuse_reply_err(req, 0);
+        return;
+    }
+    int32_t ret = dlp->Allocate(size);
+    fuse_reply_err(req, (ret == DLP_OK) ? 0 : EIO);
+}
+
 static int AddDirentry(DirAddParams& param)
 {
     size_t shouldSize = fuse_add_direntry(param.req, nullptr, 0, param.entryName.c_str(), nullptr, 0);
@@ -408,7 +580,8 @@ void FuseDaemonSetAttr(fuse_req_t req, fuse_ino_t ino, struct stat *attr, int to
         return;
     }
 
-    DlpLinkFile* dlpLink = GetFileNode(ino);
+    FileNodeRef ref(ino);
+    DlpLinkFile* dlpLink = ref.Get();
     if (dlpLink == nullptr) {
         DLP_LOG_ERROR(LABEL, "Set link file attr fail, wrong ino");
         fuse_reply_err(req, ENOENT);
@@ -450,6 +623,9 @@ static void FuseDaemonInit(void *userdata, struct fuse_conn_info *conn)
         return;
     }
     conn->want |= FUSE_CAP_WRITEBACK_CACHE;
+    // max_read is fixed by the mount; reads are bounded by the request pages, which follow max_write
+    conn->max_write = FUSE_MAX_IO_SIZE;
+    conn->max_readahead = FUSE_MAX_IO_SIZE;
 }
 
 struct fuse_lowlevel_ops FuseDaemon::fuseDaemonOper_ = {
@@ -461,7 +637,12 @@ struct fuse_lowlevel_ops FuseDaemon::fuseDaemonOper_ = {
     .open = FuseDaemonOpen,
     .read = FuseDaemonRead,
     .write = FuseDaemonWrite,
+    .flush = FuseDaemonFlush,
+    .release = FuseDaemonRelease,
+    .fsync = FuseDaemonFsync,
     .readdir = FuseDaemonReadDir,
+    .statfs = FuseDaemonStatfs,
+    .fallocate = FuseDaemonFallocate,
 };
 
 struct stat* FuseDaemon::GetRootFileStat()
@@ -514,6 +695,42 @@ int FuseDaemon::WaitDaemonEnable(void)
     return DLP_FUSE_ERROR_OPERATE_FAIL;
 }
 
+void FuseDaemon::InvalidateLinkFile(fuse_ino_t ino, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(invalMutex_);
+    if (!invalRunning_) {
+        return;
+    }
+    std::string& pendingName = invalPending_[ino];
+    if (!name.empty()) {
+        pendingName = name;
+    }
+    invalCv_.notify_one();
+}
+
+void FuseDaemon::InvalidateThread(struct fuse_session* se)
+{
+    while (true) {
+        std::map<fuse_ino_t, std::string> batch;
+        {
+            std::unique_lock<std::mutex> lock(invalMutex_);
+            invalCv_.wait(lock, [] { return !invalRunning_ || !invalPending_.empty(); });
+            if (!invalRunning_) {
+                return;
+            }
+            batch.swap(invalPending_);
+        }
+        for (const auto& item : batch) {
+            if (!item.second.empty()) {
+                (void)fuse_lowlevel_notify_inval_entry(se, ROOT_INODE, item.second.c_str(), item.second.size());
+            }
+            // a freed inode is unknown to the kernel, the notification fails harmlessly
+            (void)fuse_lowlevel_notify_inval_inode(se, item.first, 0, 0);
+        }
+        DLP_LOG_DEBUG(LABEL, "Invalidate %{public}zu link files in kernel cache", batch.size());
+    }
+}
+
 void FuseDaemon::FuseFsDaemonThread(int fuseFd)
 {
     struct stat fileStat;
@@ -551,11 +768,23 @@ void FuseDaemon::FuseFsDaemonThread(int fuseFd)
     }
 
     InitRootFileStat();
+    {
+        std::lock_guard<std::mutex> lock(invalMutex_);
+        invalPending_.clear();
+        invalRunning_ = true;
+    }
+    std::thread invalThread([se] { InvalidateThread(se); });
     NotifyDaemonEnable();
 
     if (fuse_session_loop(se) != 0) {
         DLP_LOG_ERROR(LABEL, "Fuse fs daemon exit, fuse session loop end");
     }
+    {
+        std::lock_guard<std::mutex> lock(invalMutex_);
+        invalRunning_ = false;
+        invalCv_.notify_all();
+    }
+    invalThread.join();
 
     fuse_session_destroy(se);
     fuse_opt_free_args(&args);
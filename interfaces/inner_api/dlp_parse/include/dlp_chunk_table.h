@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_CHUNK_TABLE_H
+#define DLP_CHUNK_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Key stream generations of the CHUNK_SIZE chunks of a raw dlp file content. Chunk c of generation g is encrypted
+ * with the counter stream of nonce(g) starting at block c * CHUNK_SIZE / 16; nonce(0) is the file iv, so a file
+ * that was never rewritten is all generation 0 and has no table. Every rewrite of a chunk moves it to a generation
+ * it has not used, so no counter block encrypts two different plaintexts.
+ *
+ * Chunks sharing a generation are kept as one run. Encoded form, ending right before the sparse map if any, else
+ * right before the raw file trailer:
+ *     [first(4) end(4) generation(4)] * count, count(4), nextGeneration(4), magic(4)
+ */
+class DlpChunkTable {
+public:
+    struct Run {
+        uint32_t first;
+        uint32_t end;
+        uint32_t generation;
+    };
+
+    static constexpr uint32_t CHUNK_SIZE = 4096;
+    static constexpr uint32_t MAGIC = 0x43504c44;  // "DLPC"
+    static constexpr uint32_t FOOTER_SIZE = 3 * sizeof(uint32_t);
+    static constexpr uint32_t RUN_SIZE = 3 * sizeof(uint32_t);
+    static constexpr uint32_t MAX_RUNS = 1024;
+    static constexpr uint32_t FIRST_GENERATION = 1;
+
+    // Whether the file has left the single stream layout; the table is kept from then on, even without runs.
+    bool IsUsed() const;
+    const std::vector<Run>& GetRuns() const;
+    void Clear();
+    // The next write may not extend the chunks last renewed, e.g. because part of them was cut off.
+    void ResetAppend();
+    static uint32_t ChunkOf(uint64_t offset);
+    static uint32_t ChunkEndOf(uint64_t offset);
+    uint32_t GetGeneration(uint32_t chunk) const;
+    // First chunk after chunk that may have another generation.
+    uint32_t GetGenerationEnd(uint32_t chunk) const;
+    /*
+     * Chunks [first, end) are about to be encrypted. A pure append starting in the chunk where the last renewed
+     * chunks end keeps their generation, since none of the bytes it encrypts has been encrypted with it; any other
+     * write takes a generation none of the chunks has used. False when the generations run out.
+     */
+    bool Renew(uint32_t first, uint32_t end, bool append);
+    // Restores the runs of before after a failed write; generations handed out meanwhile stay used.
+    void RollBack(const DlpChunkTable& before);
+    // The content now holds chunkCount chunks.
+    void Truncate(uint32_t chunkCount);
+    // The two neighbouring runs whose merge re-encrypts the fewest chunks, false if there are less than two.
+    bool GetCheapestMerge(uint32_t& first, uint32_t& end) const;
+    uint32_t GetEncodedSize() const;
+    // buf holds GetEncodedSize() bytes.
+    void Encode(uint8_t* buf) const;
+    // footer holds the FOOTER_SIZE bytes before the table end. False if they are not a table footer.
+    static bool ParseFooter(const uint8_t* footer, uint32_t& count, uint32_t& nextGeneration);
+    // data holds count encoded runs. False if they are not sorted, disjoint runs of chunkCount chunks.
+    bool Decode(const uint8_t* data, uint32_t count, uint32_t nextGeneration, uint32_t chunkCount);
+
+private:
+    // The first run ending after chunk.
+    std::vector<Run>::const_iterator Find(uint32_t chunk) const;
+    void Assign(uint32_t first, uint32_t end, uint32_t generation);
+
+    std::vector<Run> runs_;
+    uint32_t nextGeneration_ = FIRST_GENERATION;
+    // Generation and end of the chunks last renewed, while a write appending to them may keep the generation.
+    uint32_t appendGeneration_ = 0;
+    uint32_t appendEnd_ = 0;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_CHUNK_TABLE_H
@@ -63,6 +63,22 @@ typedef struct {
     uint64_t adLen;
 } HIAE_CipherCtx;
 
+typedef int32_t (*HIAEInitFunc)(HIAE_CipherCtx *ctx, const uint8_t *key, const uint32_t keyLen,
+    const uint8_t *iv, const uint32_t ivLen);
+typedef int32_t (*HIAEClearFunc)(HIAE_CipherCtx *ctx);
+typedef int32_t (*HIAEEncryptUpdateFunc)(HIAE_CipherCtx *ctx, const uint8_t *in, const uint32_t inLen,
+    uint8_t *out, uint32_t *outLen);
+typedef int32_t (*HIAEDecryptUpdateFunc)(HIAE_CipherCtx *ctx, const uint8_t *in, const uint32_t inLen,
+    uint8_t *out, uint32_t *outLen);
+
+/* Entry points of the HIAE library, valid while a reference taken by InitDlpHIAEMgr is held. */
+typedef struct {
+    HIAEInitFunc init;
+    HIAEClearFunc clear;
+    HIAEEncryptUpdateFunc encryptUpdate;
+    HIAEDecryptUpdateFunc decryptUpdate;
+} DlpHIAEFuncTable;
+
 enum DlpKeySize {
     DLP_AES_KEY_SIZE_128 = 128,
     DLP_AES_KEY_SIZE_192 = 192,
@@ -119,14 +135,26 @@ int32_t DlpOpensslAesDecrypt(const struct DlpBlob* key, const struct DlpUsageSpe
 
 int32_t DlpCtrModeIncreaeIvCounter(struct DlpBlob& iv, uint32_t count);
 
+int32_t DlpCtrModeDeriveIv(struct DlpBlob& iv, uint32_t generation);
+
 int32_t DlpHmacEncodeForRaw(const DlpBlob& key, int32_t fd, uint64_t fileSize, DlpBlob& out);
 
 int32_t DlpHmacEncode(const DlpBlob& key, int32_t fd, DlpBlob& out);
 
+int32_t DlpHmacStreamInit(const DlpBlob& key, void** ctx);
+
+int32_t DlpHmacStreamUpdate(void* ctx, const uint8_t* data, uint32_t len);
+
+int32_t DlpHmacStreamFinal(void* ctx, DlpBlob& out);
+
+void DlpHmacStreamFree(void* ctx);
+
 int32_t InitDlpHIAEMgr(void);
 
 void ClearDlpHIAEMgr(void);
 
+int32_t GetDlpHIAEFuncTable(DlpHIAEFuncTable *table);
+
 int32_t DlpHIAEEncrypt(const struct DlpBlob *key, const struct DlpUsageSpec *usageSpec, const uint32_t inLen,
     const uint8_t *message, uint8_t *cipherText);
 
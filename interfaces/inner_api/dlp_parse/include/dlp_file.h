@@ -16,14 +16,20 @@
 #ifndef INTERFACES_INNER_API_DLP_FILE_H
 #define INTERFACES_INNER_API_DLP_FILE_H
 
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <sys/types.h>
 #include "dlp_crypt.h"
 #include "permission_policy.h"
 
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
+class DlpJobControl;
+class IDlpIoBackend;
+
 static constexpr uint64_t INVALID_FILE_SIZE = 0x0fffffffffffffff;
 static constexpr uint32_t DLP_BUFF_LEN = 1024 * 1024; // 1M
 static constexpr uint32_t IV_SIZE = 16;
@@ -144,6 +150,26 @@ enum VALID_KEY_SIZE {
     } while (0)                                                         \
 
 
+/*
+ * Pull-based plaintext input for generating a dlp file without a seekable fd.
+ * Read returns the number of bytes copied into buf, 0 at end of stream, -1 on error.
+ */
+class DlpPlainSource {
+public:
+    virtual ~DlpPlainSource() = default;
+    virtual ssize_t Read(uint8_t* buf, uint32_t size) = 0;
+};
+
+class DlpFdPlainSource : public DlpPlainSource {
+public:
+    explicit DlpFdPlainSource(int32_t fd) : fd_(fd) {}
+    ~DlpFdPlainSource() override = default;
+    ssize_t Read(uint8_t* buf, uint32_t size) override;
+
+private:
+    int32_t fd_;
+};
+
 class DlpFile {
 public:
     DlpFile(int32_t dlpFd, const std::string &realType);
@@ -170,10 +196,16 @@ public:
     virtual int32_t Truncate(uint64_t size) = 0;
     virtual int32_t UpdateDlpFileContentSize() = 0;
     virtual int32_t GenFile(int32_t inPlainFileFd) = 0;
+    virtual int32_t GenFileFromSource(DlpPlainSource& source) = 0;
     virtual int32_t ProcessDlpFile() = 0;
     virtual int32_t DoDlpContentCryptyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset,
                                                 uint64_t inFileLen, bool isEncrypt) = 0;
     virtual int32_t GetLocalAccountName(std::string& account) const;
+    // Finishes the file after writes and truncates whose commit was deferred: the archive of a zip file, the tail
+    // and hmac of a raw file.
+    virtual int32_t DlpFileCommit() = 0;
+    // While deferred, writes and truncates leave the file to DlpFileCommit; ending the deferral commits.
+    int32_t SetCommitDeferred(bool deferred);
 
     void GetPolicy(PermissionPolicy& policy) const
     {
@@ -295,6 +327,20 @@ public:
         return nickNameMask_;
     };
 
+    void SetJobControl(const std::shared_ptr<DlpJobControl>& jobControl)
+    {
+        std::lock_guard<std::recursive_mutex> lock(opMutex_);
+        jobControl_ = jobControl;
+    };
+
+    void SetIoBackend(const std::shared_ptr<IDlpIoBackend>& io)
+    {
+        std::lock_guard<std::recursive_mutex> lock(opMutex_);
+        if (io != nullptr) {
+            io_ = io;
+        }
+    };
+
     int32_t dlpFd_;
     friend class DlpRawFile;
     friend class DlpZipFile;
@@ -311,10 +357,24 @@ private:
     virtual int32_t WriteFirstBlockData(uint64_t offset, void* buf, uint32_t size) = 0;
     virtual int32_t FillHoleData(uint64_t holeStart, uint64_t holeSize);
     virtual int32_t DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size) = 0;
+    static int32_t FillFromSource(DlpPlainSource& source, uint8_t* buf, uint32_t size, uint32_t& filled);
+    int32_t EncryptFromSource(DlpPlainSource& source, int32_t outFd, uint64_t maxSize,
+        uint64_t& contentSize, struct DlpBlob& hmac);
+    void StartJob(uint64_t totalSize);
+    bool IsJobCancelled() const;
+    void ReportJobProgress(uint64_t processedSize);
+    using ContentCryptFunc = std::function<int32_t(struct DlpBlob& in, struct DlpBlob& out, uint64_t offset)>;
+    int32_t CryptContentWithIo(int32_t inFd, int32_t outFd, uint64_t inOffset, uint64_t inFileLen,
+        const ContentCryptFunc& crypt, bool skipReadOnlyOut);
+    int32_t HmacContentWithIo(int32_t fd, uint64_t offset, uint64_t size, struct DlpBlob& out,
+        const std::vector<uint8_t>& extra = {});
 
     mutable std::recursive_mutex opMutex_;
+    std::shared_ptr<DlpJobControl> jobControl_ = nullptr;
+    std::shared_ptr<IDlpIoBackend> io_;
     std::string realType_;
     bool isFuseLink_;
+    bool commitDeferred_ = false;
     DLPFileAccess authPerm_;
     int32_t encDataFd_;
 
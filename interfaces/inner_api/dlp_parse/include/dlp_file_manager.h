@@ -24,21 +24,24 @@
 #include "dlp_crypt.h"
 #include "dlp_file.h"
 #include "permission_policy.h"
-#include "rwlock.h"
 
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
+class DlpFileRegistry;
+
 class DlpFileManager final {
 public:
     struct DlpFileMes {
         int32_t plainFileFd;
         int32_t dlpFileFd;
         std::string realFileType;
+        DlpPlainSource* source = nullptr;
+        std::shared_ptr<DlpJobControl> jobControl = nullptr;
     };
 
     static DlpFileManager& GetInstance();
-    ~DlpFileManager() {};
+    ~DlpFileManager();
 
     int32_t GenZipDlpFile(DlpFileMes& dlpFileMes, const DlpProperty& property,
                           std::shared_ptr<DlpFile>& filePtr, const std::string& workDir);
@@ -47,12 +50,16 @@ public:
 
     int32_t GenerateDlpFile(
         int32_t plainFileFd, int32_t dlpFileFd, const DlpProperty& property, std::shared_ptr<DlpFile>& filePtr,
-        const std::string& workDir);
+        const std::string& workDir, const std::shared_ptr<DlpJobControl>& jobControl = nullptr);
+    int32_t GenerateDlpFileFromSource(
+        DlpPlainSource& source, int32_t dlpFileFd, const DlpProperty& property, std::shared_ptr<DlpFile>& filePtr,
+        const std::string& workDir, const std::shared_ptr<DlpJobControl>& jobControl = nullptr);
 
     int32_t OpenDlpFile(int32_t dlpFileFd, std::shared_ptr<DlpFile>& filePtr, const std::string& workDir,
         const std::string& appId);
     int32_t CloseDlpFile(const std::shared_ptr<DlpFile>& dlpFile);
-    int32_t RecoverDlpFile(std::shared_ptr<DlpFile>& file, int32_t plainFd) const;
+    int32_t RecoverDlpFile(std::shared_ptr<DlpFile>& file, int32_t plainFd,
+        const std::shared_ptr<DlpJobControl>& jobControl = nullptr) const;
     int32_t SetDlpFileParams(std::shared_ptr<DlpFile>& filePtr, const DlpProperty& property) const;
     int32_t DlpRawHmacCheckAndUpdate(std::shared_ptr<DlpFile>& filePtr, const std::vector<uint8_t>& offlineCert,
         const int32_t &allowedOpenCount);
@@ -67,10 +74,14 @@ public:
         sptr<CertParcel>& certParcel);
 
 private:
-    DlpFileManager() {};
+    static constexpr uint32_t MAX_DLP_FILE_SIZE = 1000; // max open dlp file
+
+    DlpFileManager();
     DISALLOW_COPY_AND_MOVE(DlpFileManager);
 
     int32_t AddDlpFileNode(const std::shared_ptr<DlpFile>& filePtr);
+    int32_t GenerateDlpFileByMes(DlpFileMes& dlpFileMes, const DlpProperty& property,
+        std::shared_ptr<DlpFile>& filePtr, const std::string& workDir);
     int32_t RemoveDlpFileNode(const std::shared_ptr<DlpFile>& filePtr);
     std::shared_ptr<DlpFile> GetDlpFile(int32_t dlpFd);
     int32_t GenerateCertData(const PermissionPolicy& policy, struct DlpBlob& certData) const;
@@ -85,8 +96,7 @@ private:
         struct DlpUsageSpec& usage, struct DlpBlob& hmacKey) const;
     void CleanTempBlob(struct DlpBlob& key, struct DlpCipherParam** tagIv, struct DlpBlob& hmacKey) const;
     std::mutex g_offlineLock_;
-    OHOS::Utils::RWLock g_DlpMapLock_;
-    std::unordered_map<int32_t, std::shared_ptr<DlpFile>> g_DlpFileMap_;
+    std::unique_ptr<DlpFileRegistry> dlpFileRegistry_;
 };
 }  // namespace DlpPermission
 }  // namespace Security
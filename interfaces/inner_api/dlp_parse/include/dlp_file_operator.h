@@ -40,10 +40,12 @@ public:
     ~EnterpriseSpaceDlpPermissionKit();
     int32_t EncryptDlpFile(DlpProperty property, CustomProperty customProperty, int32_t plainFileFd, int32_t dlpFileFd);
     uint32_t DecryptRawDlpFileAndGetAccountType(int32_t dlpFileFd);
-    int32_t DecryptEnterpriseDlpFile(int32_t plainFileFd, int32_t dlpFileFd, int32_t decryptType);
+    int32_t DecryptEnterpriseDlpFile(int32_t plainFileFd, int32_t dlpFileFd, int32_t decryptType,
+        const std::shared_ptr<DlpJobControl>& jobControl = nullptr);
     int32_t EncryptEnterpriseDlpFile(DlpProperty property, CustomProperty customProperty,
         int32_t plainFileFd, int32_t dlpFileFd);
-    int32_t DecryptDlpFile(int32_t plainFileFd, int32_t dlpFileFd);
+    int32_t DecryptDlpFile(int32_t plainFileFd, int32_t dlpFileFd,
+        const std::shared_ptr<DlpJobControl>& jobControl = nullptr);
     int32_t QueryDlpFileProperty(int32_t dlpFileFd, std::string &policyJsonString);
 };
 
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_FILE_REGISTRY_H
+#define DLP_FILE_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "dlp_file.h"
+#include "rwlock.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Open dlp files of the process, keyed by dlp fd. The files are spread over SHARD_NUM shards by fd, each behind its
+ * own reader biased lock, so lookups never wait for each other and an open or close only holds up the files of its
+ * shard. The open count is kept apart, the capacity check reads no shard.
+ *
+ * A file is removed by identity: a stale object whose fd was closed and reused cannot drop the file opened on it
+ * since.
+ */
+class DlpFileRegistry {
+public:
+    static constexpr uint32_t SHARD_NUM = 16;
+
+    explicit DlpFileRegistry(uint32_t capacity);
+    DlpFileRegistry(const DlpFileRegistry&) = delete;
+    DlpFileRegistry& operator=(const DlpFileRegistry&) = delete;
+
+    int32_t Add(const std::shared_ptr<DlpFile>& file);
+    int32_t Remove(const std::shared_ptr<DlpFile>& file);
+    std::shared_ptr<DlpFile> Get(int32_t dlpFd);
+    uint32_t Size() const;
+    void Clear();
+
+private:
+    struct Shard {
+        Utils::RWLock lock;
+        std::unordered_map<int32_t, std::shared_ptr<DlpFile>> files;
+    };
+
+    // Open fds are small and handed out in order, their low bits spread them evenly.
+    Shard& ShardOf(int32_t dlpFd);
+
+    const uint32_t capacity_;
+    std::atomic<uint32_t> count_ { 0 };
+    Shard shards_[SHARD_NUM];
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_FILE_REGISTRY_H
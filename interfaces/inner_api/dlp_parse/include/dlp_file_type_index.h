@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_FILE_TYPE_INDEX_H
+#define DLP_FILE_TYPE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Suffix table compiled once from the file type maps. A suffix of up to KEY_MAX_LEN ascii characters is packed,
+ * lower-cased, into one integer key, so a lookup is a hash and a few compares, without building any string.
+ */
+class DlpFileTypeIndex {
+public:
+    enum Feature : uint32_t {
+        SUPPORT_DLP = 1,  // in FILE_TYPE_MAP, may be protected
+        RAW_TYPE = 2,     // in TYPE_TO_NUM_MAP, has a raw file type number
+        HIAE = 4,         // may be encrypted with HIAE
+        MIME_TYPE = 8,    // has a mime type
+    };
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t features = 0;
+        uint32_t typeNum = 0;
+        std::string suffix;
+        std::string fileType;
+        std::string mimeType;
+    };
+
+    DlpFileTypeIndex(const std::unordered_map<std::string, std::string>& fileTypeMap,
+        const std::unordered_map<std::string, uint32_t>& typeToNumMap, const std::vector<std::string>& hiaeTypes,
+        const std::unordered_map<std::string, std::string>& suffixMimeTypeMap = {});
+    // byMimeType_ points into slots_.
+    DlpFileTypeIndex(const DlpFileTypeIndex&) = delete;
+    DlpFileTypeIndex& operator=(const DlpFileTypeIndex&) = delete;
+
+    // Entry of suffix (any case) that has all of features, nullptr if there is none.
+    const Entry* Find(const std::string& suffix, uint32_t features = 0) const;
+
+    /*
+     * Entry of the longest prefix of suffix, between PREFIX_MIN_LEN and PREFIX_MAX_LEN characters, that has all of
+     * features. A suffix taken from a uri name may carry trailing characters after the real type.
+     */
+    const Entry* FindPrefix(const std::string& suffix, uint32_t features = 0) const;
+
+    const Entry* FindByMimeType(const std::string& mimeType) const;
+
+    static constexpr size_t KEY_MAX_LEN = 8;
+    static constexpr size_t PREFIX_MIN_LEN = 2;
+    static constexpr size_t PREFIX_MAX_LEN = 5;
+
+private:
+    const Entry* FindKey(uint64_t key, uint32_t features) const;
+
+    std::vector<Entry> slots_;
+    size_t mask_ = 0;
+    std::unordered_map<std::string, const Entry*> byMimeType_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_FILE_TYPE_INDEX_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_HIAE_ENGINE_H
+#define DLP_HIAE_ENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dlp_crypt.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * HIAE crypt of a whole content window per call. The content is cut into BLOCK_SIZE blocks counted from the window
+ * offset, block i is crypted on its own with the file iv advanced by (offset + i * BLOCK_SIZE) / 16 counters, the
+ * layout the raw file content always had. The library entry points are resolved once and the context is reused,
+ * so a window costs no lock, allocation or lookup per block.
+ *
+ * Blocks are independent, so with more than one worker a large window is split between threads, each with its own
+ * context. The threads are started on first use and kept until SetWorkers lowers the count or the engine is
+ * destroyed, not started per window. Calls on one engine are not thread safe, the owning file serializes them.
+ */
+class DlpHIAEEngine {
+public:
+    static constexpr uint32_t BLOCK_SIZE = 4 * 1024;
+    static constexpr uint32_t IV_LEN = 16;
+    static constexpr uint32_t COUNTER_SIZE = 16;
+    static constexpr uint32_t MAX_WORKERS = 4;
+    // Below this many blocks per worker the threads cost more than they save.
+    static constexpr uint32_t MIN_WORKER_BLOCKS = 32;
+
+    DlpHIAEEngine();
+    DlpHIAEEngine(const DlpHIAEEngine&) = delete;
+    DlpHIAEEngine& operator=(const DlpHIAEEngine&) = delete;
+    ~DlpHIAEEngine();
+
+    // Loads the HIAE library, the engine keeps it loaded until it is destroyed.
+    int32_t Init(const struct DlpBlob& key, const struct DlpBlob& iv);
+    // Uses entry points the caller keeps valid.
+    int32_t Init(const DlpHIAEFuncTable& funcs, const struct DlpBlob& key, const struct DlpBlob& iv);
+    // Whether the engine crypts with this key and iv.
+    bool Matches(const struct DlpBlob& key, const struct DlpBlob& iv) const;
+    void SetWorkers(uint32_t workers);
+    // in and out hold size bytes of the content at offset, which is counter aligned.
+    int32_t Crypt(const uint8_t* in, uint8_t* out, uint32_t size, uint64_t offset, bool isEncrypt);
+
+private:
+    class Worker;
+
+    int32_t CryptBlocks(HIAE_CipherCtx& ctx, const uint8_t* in, uint8_t* out, uint32_t size, uint64_t offset,
+        bool isEncrypt) const;
+
+    DlpHIAEFuncTable funcs_ = { nullptr, nullptr, nullptr, nullptr };
+    std::vector<uint8_t> key_;
+    std::vector<uint8_t> iv_;
+    HIAE_CipherCtx ctx_ = { { 0 }, 0, 0 };
+    uint32_t workers_ = 1;
+    std::vector<std::unique_ptr<Worker>> pool_;  // the threads besides the calling one, at most workers_ - 1
+    bool ready_ = false;
+    bool hasLibRef_ = false;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_HIAE_ENGINE_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_IO_BACKEND_H
+#define DLP_IO_BACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+#include "dlp_crypt.h"
+#ifdef DLP_PARSE_IO_URING
+#include <mutex>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+#endif
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct DlpIoRequest {
+    int32_t fd;
+    uint8_t* buf;
+    uint32_t size;
+    uint64_t offset;
+    ssize_t result;  // bytes transferred, or -errno
+};
+
+/*
+ * Positional file I/O of dlp content. No request moves a file offset, so requests at different offsets of one fd
+ * need no ordering between them. Submit may keep up to GetQueueDepth() requests in flight and returns once all of
+ * them are complete; a read stops short only at the end of the file.
+ */
+class IDlpIoBackend {
+public:
+    virtual ~IDlpIoBackend() = default;
+    virtual const char* GetName() const = 0;
+    virtual uint32_t GetQueueDepth() const = 0;
+    // Sets the result of every request, true if each one transferred its whole size.
+    virtual bool Submit(DlpIoRequest* reqs, uint32_t count, bool isWrite) = 0;
+
+    // Single requests with the pread/pwrite contract: -1 and errno on failure.
+    ssize_t Read(int32_t fd, void* buf, uint32_t size, uint64_t offset);
+    ssize_t Write(int32_t fd, const void* buf, uint32_t size, uint64_t offset);
+
+protected:
+    // Finishes req from done bytes on with pread/pwrite.
+    static ssize_t TransferRest(const DlpIoRequest& req, uint32_t done, bool isWrite);
+
+private:
+    ssize_t SubmitOne(int32_t fd, void* buf, uint32_t size, uint64_t offset, bool isWrite);
+};
+
+// pread/pwrite, with requests that continue one another on the same fd merged into one preadv/pwritev.
+class DlpPosixIoBackend : public IDlpIoBackend {
+public:
+    static constexpr uint32_t MAX_MERGED_IOV = 16;
+
+    const char* GetName() const override;
+    uint32_t GetQueueDepth() const override;
+    bool Submit(DlpIoRequest* reqs, uint32_t count, bool isWrite) override;
+
+private:
+    static bool Transfer(DlpIoRequest* reqs, uint32_t count, bool isWrite);
+};
+
+#ifdef DLP_PARSE_IO_URING
+/*
+ * io_uring through the raw syscalls, one ring per backend. A batch of up to QUEUE_DEPTH requests is queued and
+ * reaped with as few io_uring_enter calls as the kernel allows. Batches of one backend are serialized.
+ */
+class DlpUringIoBackend : public IDlpIoBackend {
+public:
+    static constexpr uint32_t QUEUE_DEPTH = 4;
+
+    DlpUringIoBackend();
+    ~DlpUringIoBackend() override;
+    DlpUringIoBackend(const DlpUringIoBackend&) = delete;
+    DlpUringIoBackend& operator=(const DlpUringIoBackend&) = delete;
+
+    // False if the kernel refused the ring; the backend must not be used then.
+    bool IsReady() const;
+    const char* GetName() const override;
+    uint32_t GetQueueDepth() const override;
+    bool Submit(DlpIoRequest* reqs, uint32_t count, bool isWrite) override;
+
+private:
+    static void* Map(int ringFd, size_t size, off_t offset);
+    static void Unmap(void* addr, size_t size);
+    void Release();
+    bool SubmitBatch(DlpIoRequest* reqs, uint32_t count, bool isWrite);
+    uint32_t Reap(DlpIoRequest* reqs, uint32_t count);
+
+    std::mutex mutex_;
+    int ringFd_ = -1;
+    bool broken_ = false;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    uint32_t* sqTail_ = nullptr;
+    uint32_t* sqArray_ = nullptr;
+    uint32_t sqMask_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    uint32_t* cqHead_ = nullptr;
+    uint32_t* cqTail_ = nullptr;
+    uint32_t cqMask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+    struct iovec iov_[QUEUE_DEPTH];
+};
+#endif
+
+// Backend for a new dlp file: io_uring when it is built in and the kernel allows it, pread/pwrite otherwise.
+std::shared_ptr<IDlpIoBackend> CreateDlpIoBackend();
+
+// HMAC of size bytes of fd from offset followed by extra, read one batch of queue depth chunks at a time.
+int32_t HmacContentWithIo(IDlpIoBackend& io, const DlpBlob& key, int32_t fd, uint64_t offset, uint64_t size,
+    DlpBlob& out, const std::vector<uint8_t>& extra = {});
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_IO_BACKEND_H
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_INNER_API_DLP_JOB_CONTROL_H
+#define INTERFACES_INNER_API_DLP_JOB_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct DlpJobProgress {
+    uint64_t processedSize = 0;
+    uint64_t totalSize = 0;  // 0 when the size is not known up front, e.g. a stream source
+    uint64_t bytesPerSecond = 0;
+    bool finished = false;  // the last report of the job, sent whether it succeeded or not
+};
+
+using DlpJobProgressCallback = std::function<void(const DlpJobProgress& progress)>;
+
+/*
+ * Shared between the caller and a long-running file operation. The crypt loops check IsCancelled between
+ * buffers and report progress after each one; the callback runs on the worker thread.
+ */
+class DlpJobControl {
+public:
+    DlpJobControl() = default;
+    ~DlpJobControl() = default;
+
+    void Cancel();
+    bool IsCancelled() const;
+    void SetProgressCallback(const DlpJobProgressCallback& callback);
+    void Start(uint64_t totalSize);
+    void ReportProgress(uint64_t processedSize);
+    // Reports the job as done with the size it last reported; called once the operation returns.
+    void Finish();
+
+private:
+    void Report(uint64_t processedSize, bool finished);
+
+    static constexpr uint64_t MS_PER_SECOND = 1000;
+    std::atomic<bool> cancelled_ { false };
+    std::mutex mutex_;
+    DlpJobProgressCallback callback_ = nullptr;
+    uint64_t totalSize_ = 0;
+    uint64_t processedSize_ = 0;
+    std::chrono::steady_clock::time_point startTime_ = std::chrono::steady_clock::now();
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // INTERFACES_INNER_API_DLP_JOB_CONTROL_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_MAPPED_CONTENT_H
+#define DLP_MAPPED_CONTENT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Read only mapping of the encrypted content of a dlp file, for opens that can never write it. Reads are copied out
+ * of the mapping with no syscall; a sequential reader gets MADV_SEQUENTIAL and the next window prefetched with
+ * MADV_WILLNEED, a random one the normal readahead.
+ *
+ * A file truncated under the mapping raises SIGBUS on the lost pages. Copies run under a guard: the process wide
+ * handler jumps back out of a guarded copy, which then fails and drops the mapping, and hands any other SIGBUS to
+ * the handler installed before it. Only a plain memory copy runs under the guard, so the jump never leaves code
+ * that holds resources.
+ */
+class DlpMappedContent {
+public:
+    static constexpr uint64_t PREFETCH_SIZE = 1024 * 1024;
+    // Reads in a row, each starting where the previous one ended, that make the reader sequential.
+    static constexpr uint32_t SEQUENTIAL_READS = 4;
+
+    DlpMappedContent() = default;
+    DlpMappedContent(const DlpMappedContent&) = delete;
+    DlpMappedContent& operator=(const DlpMappedContent&) = delete;
+    ~DlpMappedContent();
+
+    // Maps size bytes of fd at offset. False if the range cannot be mapped, the fd is then read as before.
+    bool Map(int32_t fd, uint64_t offset, uint64_t size);
+    void Unmap();
+    bool IsMapped() const;
+    uint64_t GetSize() const;
+    // Copies the size bytes at offset into buf. False if they are not mapped, or if the file shrank under them, in
+    // which case the mapping is dropped.
+    bool Copy(uint64_t offset, uint8_t* buf, uint32_t size);
+
+private:
+    void Advise(uint64_t offset, uint32_t size);
+    // Asks for the window at content offset start to be read ahead.
+    void Prefetch(uint64_t start);
+
+    uint8_t* base_ = nullptr;  // page aligned start of the mapping
+    size_t mapLen_ = 0;
+    const uint8_t* data_ = nullptr;  // first mapped content byte
+    uint64_t size_ = 0;
+    uint64_t pageSize_ = 0;
+    uint64_t lastEnd_ = 0;
+    uint32_t sequentialReads_ = 0;
+    bool sequentialAdvice_ = false;
+    uint64_t prefetchedEnd_ = 0;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_MAPPED_CONTENT_H
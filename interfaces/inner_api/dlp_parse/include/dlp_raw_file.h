@@ -21,6 +21,11 @@
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
+class DlpChunkTable;
+class DlpHIAEEngine;
+class DlpMappedContent;
+class DlpRawMetadataReader;
+class DlpSparseMap;
 
 class DlpRawFile : public DlpFile {
 public:
@@ -29,6 +34,7 @@ public:
     int32_t UpdateCertAndText(const std::vector<uint8_t>& cert, struct DlpBlob certBlob);
     int32_t SetEncryptCert(const struct DlpBlob& cert);
     int32_t GenFile(int32_t inPlainFileFd);
+    int32_t GenFileFromSource(DlpPlainSource& source);
     int32_t RemoveDlpPermission(int outPlainFileFd);
     int32_t DlpFileRead(uint64_t offset, void* buf, uint32_t size, bool& hasRead, int32_t uid);
     int32_t DlpFileWrite(uint64_t offset, void* buf, uint32_t size);
@@ -47,11 +53,13 @@ public:
     int32_t ProcessDlpFile();
     int32_t SetContactAccount(const std::string& contactAccount);
     int32_t Truncate(uint64_t size);
+    int32_t DlpFileCommit();
     int32_t setAlgType(int32_t inPlainFileFd, const std::string& realFileType);
     int32_t DoDlpHIAECryptOperation(struct DlpBlob& message1, struct DlpBlob& message2,
         uint64_t offset, bool isEncrypt);
     int32_t DoDlpContentCryptyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset,
                                                 uint64_t inFileLen, bool isEncrypt);
+    int32_t EnableMappedRead(void);
 
 private:
     bool IsValidEnterpriseDlpHeader(const struct DlpHeader& head, uint32_t dlpHeaderSize);
@@ -60,6 +68,10 @@ private:
     int32_t GetRawDlpHmac(void);
     int32_t DoWriteHmacAndCert(uint32_t hmacStrLen, std::string& hmacStr);
     int32_t DoHmacAndCrypty(int32_t inPlainFileFd, off_t fileLen);
+    int32_t SetHmacAndHexString(struct DlpBlob& out, std::string& hmacStr);
+    int32_t WriteHeaderAndContactAccount();
+    int32_t PrepareRawHead(uint64_t txtSize);
+    int32_t WriteRawFilePrefix();
     int32_t GenFileInRaw(int32_t inPlainFileFd);
     int32_t RemoveDlpPermissionInRaw(int32_t outPlainFileFd);
     int32_t DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size);
@@ -72,13 +84,43 @@ private:
     int32_t WriteFileIdPlaintextProcess(void);
     int32_t WriteRawFileProperty(void);
     int32_t ReadNickNameMask(void);
-    int32_t ReadFileId(void);
     int32_t ComputeContentHmac(uint64_t contentSize, std::string& hmacHexStr);
+    int32_t GetHmacHexString(std::string& hmacHexStr) const;
     int32_t WriteRawFileTailAndHeader(std::string& hmacStr, uint32_t hmacStrLen);
-    int32_t RebuildRawFileTail(void);
+    int32_t RebuildRawFileTail(bool updateHmac = true);
+    int32_t UpdateRawFileHmac(void);
+    int32_t CutRawFileTail(void);
+    int32_t FinishContentChange(void);
+    int32_t FillHoleData(uint64_t holeStart, uint64_t holeSize);
+    int32_t FitTailMaps(void);
+    int32_t ReadSparseMap(void);
+    int32_t ReadChunkTable(void);
+    std::vector<uint8_t> EncodeTailMaps(void) const;
+    uint32_t GetRawFormatVersion(void) const;
+    int32_t GetCutContentSize(uint64_t& contentSize) const;
+    int32_t DoGenerationCryptOperation(struct DlpBlob& message1, struct DlpBlob& message2,
+        uint64_t offset, uint32_t generation, bool isEncrypt);
+    int32_t DoChunkCryptOperation(const DlpChunkTable& table, struct DlpBlob& message1,
+        struct DlpBlob& message2, uint64_t offset, bool isEncrypt);
+    int32_t DecryptContent(const DlpChunkTable& table, uint64_t offset, uint8_t* enBuf, uint8_t* deBuf,
+        uint32_t size);
+    int32_t DoChunkFileWrite(uint64_t offset, const uint8_t* buf, uint32_t size);
+    int32_t ReencryptChunks(uint32_t first, uint32_t end, bool fillHoles);
+    int32_t PrepareHIAEEngine(void);
+    int32_t DecryptMappedData(uint64_t offset, void* buf, uint32_t size, bool& isMapped);
+    int32_t DecryptBlob(struct DlpBlob& message1, struct DlpBlob& message2, uint64_t offset);
 
     struct DlpHeader head_;
     bool hiaeInit_;
+    bool hasTailMaps_ = false;  // the file was opened with RAW_TAIL_MAP_VERSION
+    std::unique_ptr<DlpRawMetadataReader> metaReader_;  // open while the metadata is parsed
+    std::unique_ptr<DlpSparseMap> sparse_;  // holes of the content, kept in the tail
+    std::unique_ptr<DlpChunkTable> chunks_;  // key stream generations of the content, kept in the tail
+    std::unique_ptr<DlpHIAEEngine> hiaeEngine_;  // created on the first HIAE crypt
+    std::unique_ptr<DlpMappedContent> mapped_;  // content of a read only open, read without syscalls
+    std::vector<uint8_t> mapCipher_;  // cipher text copied out of mapped_
+    bool tailCut_ = false;  // the file ends with the content, the tail is written back by RebuildRawFileTail
+    bool hmacStale_ = false;  // the tail holds the hmac of older content, DlpFileCommit computes it again
 };
 }  // namespace DlpPermission
 }  // namespace Security
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_RAW_METADATA_READER_H
+#define DLP_RAW_METADATA_READER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct DlpRawTrailer {
+    std::string nickNameMask;
+    int32_t countdown = 0;
+    bool waterMarkConfig = false;
+    int32_t allowedOpenCount = 0;
+    std::string fileIdPlaintext;
+};
+
+/*
+ * Metadata reads of one raw dlp file. Ranges fetched with Prefetch stay in memory until Close, so the header, the
+ * hmac and cert, and the trailer each cost one pread however many fields are parsed from them; a field outside
+ * every fetched range is read on its own. All reads are positional and leave the file offset alone.
+ */
+class DlpRawMetadataReader {
+public:
+    // nickNameMask(40) countdown(4) waterMark(4) flag(4) allowedOpenCount(4) fileId(46), at the end of the file.
+    static constexpr uint32_t TRAILER_SIZE = 102;
+    static constexpr uint32_t NICK_NAME_MASK_SIZE = 40;
+    static constexpr uint32_t FILEID_SIZE = 46;
+    // Ranges closer than this are fetched with one read.
+    static constexpr uint64_t MERGE_GAP = 4096;
+
+    struct Range {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    /*
+     * Keeps the reader open for one call when no caller above has opened it. The cursor then starts at the file
+     * offset and is written back to it at the end, as if the fields had been read with read().
+     */
+    class Scope {
+    public:
+        Scope(DlpRawMetadataReader& reader, int32_t fd);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        DlpRawMetadataReader& reader_;
+        bool owner_ = false;
+    };
+
+    DlpRawMetadataReader() = default;
+    ~DlpRawMetadataReader();
+    DlpRawMetadataReader(const DlpRawMetadataReader&) = delete;
+    DlpRawMetadataReader& operator=(const DlpRawMetadataReader&) = delete;
+
+    bool Open(int32_t fd, uint64_t cursor = 0);
+    // The fetched ranges may hold the cert, they are wiped before being freed.
+    void Close();
+    bool IsOpen() const;
+    uint64_t GetFileLen() const;
+    uint64_t GetCursor() const;
+    void Seek(uint64_t offset);
+    // preads since the last Open, still available after Close.
+    uint32_t GetReadCount() const;
+    // Fetches the parts of ranges inside the file that are not held yet.
+    void Prefetch(const std::vector<Range>& ranges);
+    // [offset, offset + size) of the file, nullptr if it is empty or not all there. Valid until Close.
+    const uint8_t* View(uint64_t offset, uint64_t size);
+    bool ReadAt(uint64_t offset, void* buf, uint64_t size);
+    bool ReadAt(uint64_t offset, std::string& str, uint64_t size);
+    // Reads at the cursor and moves past the field, for fields that follow one another.
+    bool Read(void* buf, uint64_t size);
+    bool Read(std::string& str, uint64_t size);
+    bool ReadTrailer(DlpRawTrailer& trailer);
+    // data holds TRAILER_SIZE bytes. allowedOpenCount is only stored when flag is 1; older files with a fileId
+    // but no flag may be opened once.
+    static void ParseTrailer(const uint8_t* data, DlpRawTrailer& trailer);
+
+private:
+    struct Region {
+        uint64_t offset;
+        std::vector<uint8_t> data;
+    };
+
+    const uint8_t* Find(uint64_t offset, uint64_t size) const;
+    // A region keeps its buffer when regions_ grows, so earlier views stay valid.
+    const uint8_t* Load(uint64_t offset, uint64_t size);
+
+    int32_t fd_ = -1;
+    uint64_t fileLen_ = 0;
+    uint64_t cursor_ = 0;
+    uint32_t readCount_ = 0;
+    std::vector<Region> regions_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_RAW_METADATA_READER_H
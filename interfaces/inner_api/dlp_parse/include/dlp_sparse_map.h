@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_SPARSE_MAP_H
+#define DLP_SPARSE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Content ranges of a raw dlp file that were never written: they are filesystem holes, read as plaintext zeros and
+ * are not decrypted. The ranges are sorted, disjoint and not adjacent.
+ *
+ * Encoded form, ending right before the raw file trailer:
+ *     [start(8) end(8)] * count, count(4), magic(4)
+ * Files without holes carry no map, their tail is the same as before.
+ */
+class DlpSparseMap {
+public:
+    struct Region {
+        uint64_t start;
+        uint64_t end;
+    };
+
+    static constexpr uint32_t MAGIC = 0x53504c44;  // "DLPS"
+    static constexpr uint32_t FOOTER_SIZE = 2 * sizeof(uint32_t);
+    static constexpr uint32_t REGION_SIZE = 2 * sizeof(uint64_t);
+    static constexpr uint32_t MAX_REGIONS = 256;
+
+    bool Empty() const;
+    const std::vector<Region>& GetRegions() const;
+    void Clear();
+    void Add(uint64_t start, uint64_t end);
+    void Remove(uint64_t start, uint64_t end);
+    void Truncate(uint64_t size);
+    // Whether [start, end) lies in one hole.
+    bool Covers(uint64_t start, uint64_t end) const;
+    // buf holds content [offset, offset + size), the bytes of it that lie in a hole are zeroed.
+    void ZeroHoles(uint64_t offset, uint8_t* buf, uint64_t size) const;
+    // Index of the smallest hole, the first one to give up when the map has to shrink.
+    size_t GetSmallest() const;
+    uint32_t GetEncodedSize() const;
+    // buf holds GetEncodedSize() bytes.
+    void Encode(uint8_t* buf) const;
+    // footer holds the FOOTER_SIZE bytes before the trailer. False if they are not a map footer.
+    static bool ParseFooter(const uint8_t* footer, uint32_t& count);
+    // data holds count encoded regions. False if they are not sorted, disjoint holes of a content of contentSize.
+    bool Decode(const uint8_t* data, uint32_t count, uint64_t contentSize);
+
+private:
+    std::vector<Region> regions_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_SPARSE_MAP_H
@@ -22,6 +22,7 @@
 #include "iservice_registry.h"
 #include "os_account_manager.h"
 #include "file_operator.h"
+#include "dlp_file_type_index.h"
 
 namespace OHOS {
 namespace Security {
@@ -489,6 +490,7 @@ public:
     static bool GetBundleInfoWithBundleName(const std::string &bundleName, int32_t flag,
         AppExecFwk::BundleInfo &bundleInfo, int32_t userId);
     static bool GetFileType(const std::string& realFileType);
+    static const DlpFileTypeIndex& GetFileTypeIndex();
     static bool GetAppIdFromToken(std::string& appId);
     static bool GetAppIdentifierFromToken(std::string& appIdentifier);
     static bool GetUserIdByForegroundAccount(int32_t &userId);
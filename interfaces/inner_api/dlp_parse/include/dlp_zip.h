@@ -25,6 +25,12 @@ namespace Security {
 namespace DlpPermission {
     int32_t AddBuffToZip(const void *buf, uint32_t size, const char *nameInZip, const char *zipName);
     int32_t AddFileContextToZip(int32_t fd, const char *nameInZip, const char *zipName);
+    zipFile CreateZipInFd(int32_t fd, void** outOpaque);
+    int32_t CloseZipInFd(zipFile zf, void* opaque);
+    int32_t AddBuffToOpenedZip(zipFile zf, const void *buf, uint32_t size, const char *nameInZip);
+    int32_t OpenEntryInZip(zipFile zf, const char *nameInZip);
+    int32_t WriteEntryInZip(zipFile zf, const void *buf, uint32_t size);
+    int32_t CloseEntryInZip(zipFile zf);
     int32_t UnzipSpecificFile(int32_t fd, const char *nameInZip, const char *unZipName);
     bool IsZipFile(int32_t fd);
     bool CheckUnzipFileInfo(int32_t fd);
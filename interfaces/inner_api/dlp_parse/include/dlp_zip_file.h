@@ -16,6 +16,8 @@
 #ifndef INTERFACES_INNER_API_DLP_ZIP_FILE_H
 #define INTERFACES_INNER_API_DLP_ZIP_FILE_H
 
+#include <functional>
+#include <memory>
 #include "dlp_file.h"
 
 namespace OHOS {
@@ -29,6 +31,7 @@ public:
     int32_t UpdateCertAndText(const std::vector<uint8_t>& cert, struct DlpBlob certBlob);
     int32_t SetEncryptCert(const struct DlpBlob& cert);
     int32_t GenFile(int32_t inPlainFileFd);
+    int32_t GenFileFromSource(DlpPlainSource& source);
     int32_t RemoveDlpPermission(int outPlainFileFd);
     int32_t DlpFileRead(uint64_t offset, void* buf, uint32_t size, bool& hasRead, int32_t uid);
     int32_t DlpFileWrite(uint64_t offset, void* buf, uint32_t size);
@@ -41,20 +44,32 @@ public:
     int32_t ProcessDlpFile();
     int32_t SetContactAccount(const std::string& contactAccount);
     int32_t Truncate(uint64_t size);
+    int32_t DlpFileCommit();
     int32_t DoDlpContentCryptyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset,
                                                 uint64_t inFileLen, bool isEncrypt);
 private:
-    int32_t DoDlpContentCopyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset, uint64_t inFileLen);
     int32_t UpdateDlpFileContentSize();
     bool ParseDlpInfo();
     bool ParseCert();
     bool ParseEncData();
-    int32_t GenEncData(int32_t inPlainFileFd);
-    int32_t GenFileInZip(int32_t inPlainFileFd);
+    // A window of the content on its way from the plaintext to the archive.
+    struct EncWindow {
+        std::unique_ptr<uint8_t[]> plain;
+        std::unique_ptr<uint8_t[]> cipher;
+        uint32_t size = 0;
+    };
+    using EncWindowSink = std::function<int32_t(const uint8_t* data, uint32_t size)>;
+    class EncWorker;
+    using EncWorkers = std::vector<std::unique_ptr<EncWorker>>;
+    int32_t CreateEncDataFile(void);
+    int32_t EncryptEncWindow(EncWindow& window, uint64_t offset, EncWorkers& workers);
+    int32_t ReadEncWindow(DlpPlainSource* source, uint64_t offset, EncWindow& window, EncWorkers& workers);
+    int32_t StreamEncData(DlpPlainSource* source, const EncWindowSink& sink);
+    int32_t GenGeneralInfo(std::string& info);
+    int32_t GenFileInZip(int32_t inPlainFileFd, DlpPlainSource* source = nullptr);
     int32_t RemoveDlpPermissionInZip(int32_t outPlainFileFd);
     int32_t GetHmacVal(int32_t encFile, std::string& hmacStr);
     int32_t GenerateHmacVal(int32_t encFile, struct DlpBlob& out);
-    int32_t AddGeneralInfoToBuff(int32_t encFile);
     int32_t DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size);
     int32_t WriteFirstBlockData(uint64_t offset, void* buf, uint32_t size);
     int32_t DecryptPrefixingData(uint32_t prefixingSize, uint64_t alignOffset, uint8_t* enBuf, uint8_t* deBuf);
@@ -64,6 +79,7 @@ private:
     std::string dirIndex_;
     uint32_t certSize_;
     std::vector<std::string> extraInfo_;
+    bool contentDirty_ = false;  // the archive misses content changes
 };
 }  // namespace DlpPermission
 }  // namespace Security
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_chunk_table.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+uint8_t* Store(uint8_t* pos, uint32_t value)
+{
+    return std::copy_n(reinterpret_cast<const uint8_t*>(&value), sizeof(uint32_t), pos);
+}
+
+uint32_t Load(const uint8_t* pos)
+{
+    uint32_t value = 0;
+    std::copy_n(pos, sizeof(uint32_t), reinterpret_cast<uint8_t*>(&value));
+    return value;
+}
+} // namespace
+
+bool DlpChunkTable::IsUsed() const
+{
+    return nextGeneration_ > FIRST_GENERATION;
+}
+
+const std::vector<DlpChunkTable::Run>& DlpChunkTable::GetRuns() const
+{
+    return runs_;
+}
+
+void DlpChunkTable::Clear()
+{
+    runs_.clear();
+    nextGeneration_ = FIRST_GENERATION;
+    ResetAppend();
+}
+
+void DlpChunkTable::ResetAppend()
+{
+    appendGeneration_ = 0;
+    appendEnd_ = 0;
+}
+
+uint32_t DlpChunkTable::ChunkOf(uint64_t offset)
+{
+    return static_cast<uint32_t>(offset / CHUNK_SIZE);
+}
+
+uint32_t DlpChunkTable::ChunkEndOf(uint64_t offset)
+{
+    return static_cast<uint32_t>((offset + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+uint32_t DlpChunkTable::GetGeneration(uint32_t chunk) const
+{
+    auto iter = Find(chunk);
+    return (iter != runs_.end() && iter->first <= chunk) ? iter->generation : 0;
+}
+
+uint32_t DlpChunkTable::GetGenerationEnd(uint32_t chunk) const
+{
+    auto iter = Find(chunk);
+    if (iter == runs_.end()) {
+        return UINT32_MAX;
+    }
+    return (iter->first <= chunk) ? iter->end : iter->first;
+}
+
+bool DlpChunkTable::Renew(uint32_t first, uint32_t end, bool append)
+{
+    if (first >= end) {
+        return true;
+    }
+    bool extend = append && appendEnd_ != 0 && first + 1 >= appendEnd_ && first <= appendEnd_ &&
+        (first == appendEnd_ || GetGeneration(first) == appendGeneration_);
+    if (!extend) {
+        if (nextGeneration_ == UINT32_MAX) {
+            return false;
+        }
+        appendGeneration_ = nextGeneration_++;
+    }
+    appendEnd_ = end;
+    Assign(first, end, appendGeneration_);
+    return true;
+}
+
+void DlpChunkTable::RollBack(const DlpChunkTable& before)
+{
+    runs_ = before.runs_;
+    ResetAppend();
+}
+
+void DlpChunkTable::Truncate(uint32_t chunkCount)
+{
+    while (!runs_.empty() && runs_.back().first >= chunkCount) {
+        runs_.pop_back();
+    }
+    if (!runs_.empty() && runs_.back().end > chunkCount) {
+        runs_.back().end = chunkCount;
+    }
+    ResetAppend();
+}
+
+bool DlpChunkTable::GetCheapestMerge(uint32_t& first, uint32_t& end) const
+{
+    if (runs_.size() < 2) {
+        return false;
+    }
+    size_t best = 0;
+    for (size_t i = 1; i + 1 < runs_.size(); i++) {
+        if (runs_[i + 1].end - runs_[i].first < runs_[best + 1].end - runs_[best].first) {
+            best = i;
+        }
+    }
+    first = runs_[best].first;
+    end = runs_[best + 1].end;
+    return true;
+}
+
+uint32_t DlpChunkTable::GetEncodedSize() const
+{
+    return IsUsed() ? static_cast<uint32_t>(runs_.size()) * RUN_SIZE + FOOTER_SIZE : 0;
+}
+
+void DlpChunkTable::Encode(uint8_t* buf) const
+{
+    uint8_t* pos = buf;
+    for (const auto& run : runs_) {
+        pos = Store(pos, run.first);
+        pos = Store(pos, run.end);
+        pos = Store(pos, run.generation);
+    }
+    pos = Store(pos, static_cast<uint32_t>(runs_.size()));
+    pos = Store(pos, nextGeneration_);
+    (void)Store(pos, MAGIC);
+}
+
+bool DlpChunkTable::ParseFooter(const uint8_t* footer, uint32_t& count, uint32_t& nextGeneration)
+{
+    count = Load(footer);
+    nextGeneration = Load(footer + sizeof(uint32_t));
+    return Load(footer + 2 * sizeof(uint32_t)) == MAGIC && count <= MAX_RUNS &&
+        nextGeneration > FIRST_GENERATION;
+}
+
+bool DlpChunkTable::Decode(const uint8_t* data, uint32_t count, uint32_t nextGeneration, uint32_t chunkCount)
+{
+    std::vector<Run> runs;
+    runs.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* pos = data + i * RUN_SIZE;
+        Run run = { Load(pos), Load(pos + sizeof(uint32_t)), Load(pos + 2 * sizeof(uint32_t)) };
+        if (run.first >= run.end || run.end > chunkCount || run.generation < FIRST_GENERATION ||
+            run.generation >= nextGeneration || (i > 0 && run.first < runs.back().end)) {
+            return false;
+        }
+        runs.push_back(run);
+    }
+    runs_.swap(runs);
+    nextGeneration_ = nextGeneration;
+    ResetAppend();
+    return true;
+}
+
+std::vector<DlpChunkTable::Run>::const_iterator DlpChunkTable::Find(uint32_t chunk) const
+{
+    return std::upper_bound(runs_.begin(), runs_.end(), chunk,
+        [](uint32_t pos, const Run& run) { return pos < run.end; });
+}
+
+void DlpChunkTable::Assign(uint32_t first, uint32_t end, uint32_t generation)
+{
+    std::vector<Run> runs;
+    runs.reserve(runs_.size() + 2);
+    bool placed = false;
+    auto place = [&runs, &placed, first, end, generation]() {
+        if (!runs.empty() && runs.back().end == first && runs.back().generation == generation) {
+            runs.back().end = end;
+        } else {
+            runs.push_back({ first, end, generation });
+        }
+        placed = true;
+    };
+    for (const auto& run : runs_) {
+        if (run.end <= first) {
+            runs.push_back(run);
+            continue;
+        }
+        if (run.first < first) {
+            runs.push_back({ run.first, first, run.generation });
+        }
+        if (!placed && run.first >= first) {
+            place();
+        }
+        if (run.end > end) {
+            Run rest = { std::max(run.first, end), run.end, run.generation };
+            if (!placed) {
+                place();
+            }
+            if (runs.back().end == rest.first && runs.back().generation == rest.generation) {
+                runs.back().end = rest.end;
+            } else {
+                runs.push_back(rest);
+            }
+        }
+    }
+    if (!placed) {
+        place();
+    }
+    runs_.swap(runs);
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
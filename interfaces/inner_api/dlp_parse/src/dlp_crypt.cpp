@@ -16,15 +16,19 @@
 #include "dlp_crypt.h"
 #include <cstdio>
 #include <cstdlib>
+#include <cerrno>
 #include <dlfcn.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <openssl/rand.h>
+#include <openssl/sha.h>
 #include <securec.h>
 #include <string>
+#include <sys/stat.h>
 #include <thread>
 #include <unistd.h>
+#include "dlp_io_backend.h"
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
 
@@ -33,7 +37,6 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_
 static const uint32_t BYTE_LEN = 8;
 const uint32_t HMAC_SIZE = 32;
 const uint32_t SHA256_KEY_LEN = 32;
-const uint32_t BUFFER_SIZE = 1048576;
 static const uint32_t AES_IV_SIZE = 16;
 static int32_t g_hIAECnt = 0;
 
@@ -45,14 +48,6 @@ static const std::string DLP_HIAE_SDK_PATH_32_BIT = "/system/lib/platformsdk/lib
 static const std::string DLP_HIAE_SDK_PATH_64_BIT = "/system/lib64/platformsdk/libdlp_credential_alg_hiae.z.so";
 static const size_t LENGTH_FOR_64_BIT = 8;
 
-typedef int32_t (*HIAEInitFunc)(HIAE_CipherCtx *ctx, const uint8_t *key, const uint32_t keyLen,
-    const uint8_t *iv, const uint32_t ivLen);
-typedef int32_t (*HIAEClearFunc)(HIAE_CipherCtx *ctx);
-typedef int32_t (*HIAEEncryptUpdateFunc)(HIAE_CipherCtx *ctx, const uint8_t *in, const uint32_t inLen,
-    uint8_t *out, uint32_t *outLen);
-typedef int32_t (*HIAEDecryptUpdateFunc)(HIAE_CipherCtx *ctx, const uint8_t *in, const uint32_t inLen,
-    uint8_t *out, uint32_t *outLen);
-
 typedef struct DlpHIAEMgrHandleT {
     HIAEInitFunc hIAEInit;
     HIAEClearFunc hIAEClear;
@@ -142,6 +137,20 @@ int32_t InitDlpHIAEMgr(void)
     return DLP_OK;
 }
 
+int32_t GetDlpHIAEFuncTable(DlpHIAEFuncTable *table)
+{
+    std::lock_guard<std::mutex> lock(g_lockDlpHIAESdk);
+    if (table == nullptr || g_dlpHIAEMgrHandle == nullptr) {
+        DLP_LOG_ERROR(LABEL, "HIAE Handle is null");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    table->init = g_dlpHIAEMgrHandle->hIAEInit;
+    table->clear = g_dlpHIAEMgrHandle->hIAEClear;
+    table->encryptUpdate = g_dlpHIAEMgrHandle->hIAEEncryptUpdate;
+    table->decryptUpdate = g_dlpHIAEMgrHandle->hIAEDecryptUpdate;
+    return DLP_OK;
+}
+
 static int32_t AlgHIAEInit(HIAE_CipherCtx *ctx, const uint8_t *key, const uint32_t keyLen,
     const uint8_t *iv, const uint32_t ivLen)
 {
@@ -619,6 +628,27 @@ int32_t DlpCtrModeIncreaeIvCounter(struct DlpBlob& iv, uint32_t count)
     return DLP_OK;
 }
 
+int32_t DlpCtrModeDeriveIv(struct DlpBlob& iv, uint32_t generation)
+{
+    if (iv.data == nullptr || iv.size == 0 || iv.size > AES_IV_SIZE) {
+        DLP_LOG_ERROR(LABEL, "param error");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    uint8_t input[AES_IV_SIZE + sizeof(uint32_t)] = {0};
+    if (memcpy_s(input, sizeof(input), iv.data, iv.size) != EOK ||
+        memcpy_s(input + iv.size, sizeof(input) - iv.size, &generation, sizeof(uint32_t)) != EOK) {
+        DLP_LOG_ERROR(LABEL, "copy iv failed");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    uint8_t digest[SHA256_DIGEST_LENGTH] = {0};
+    if (EVP_Digest(input, iv.size + sizeof(uint32_t), digest, nullptr, EVP_sha256(), nullptr) != 1) {
+        DLP_LOG_ERROR(LABEL, "derive iv failed");
+        return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
+    }
+    return (memcpy_s(iv.data, iv.size, digest, iv.size) == EOK) ? DLP_OK : DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+}
+
+// The content starts at the current offset of fd, which is left right after it as a read would.
 int32_t DlpHmacEncodeForRaw(const DlpBlob& key, int32_t fd, uint64_t fileSize, DlpBlob& out)
 {
     if ((key.data == nullptr) || (key.size != SHA256_KEY_LEN)) {
@@ -629,87 +659,85 @@ int32_t DlpHmacEncodeForRaw(const DlpBlob& key, int32_t fd, uint64_t fileSize, D
         DLP_LOG_ERROR(LABEL, "Output blob invalid, size %{public}u", out.size);
         return DLP_PARSE_ERROR_DIGEST_INVALID;
     }
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    if (pos < 0) {
+        DLP_LOG_ERROR(LABEL, "Get file offset fail, errno %{public}d", errno);
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    int32_t ret = HmacContentWithIo(*CreateDlpIoBackend(), key, fd, static_cast<uint64_t>(pos), fileSize, out);
+    if (ret == DLP_OK) {
+        (void)lseek(fd, pos + static_cast<off_t>(fileSize), SEEK_SET);
+    }
+    return ret;
+}
+
+int32_t DlpHmacEncode(const DlpBlob& key, int32_t fd, DlpBlob& out)
+{
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    struct stat fileStat;
+    if (pos < 0 || fstat(fd, &fileStat) != 0) {
+        DLP_LOG_ERROR(LABEL, "Get file size fail, errno %{public}d", errno);
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    uint64_t size = (fileStat.st_size > pos) ? static_cast<uint64_t>(fileStat.st_size - pos) : 0;
+    return DlpHmacEncodeForRaw(key, fd, size, out);
+}
 
-    HMAC_CTX* ctx = HMAC_CTX_new();
-    if (ctx == nullptr) {
+int32_t DlpHmacStreamInit(const DlpBlob& key, void** ctx)
+{
+    if ((key.data == nullptr) || (key.size != SHA256_KEY_LEN) || ctx == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Key blob invalid, size %{public}u", key.size);
+        return DLP_PARSE_ERROR_DIGEST_INVALID;
+    }
+    HMAC_CTX* hmacCtx = HMAC_CTX_new();
+    if (hmacCtx == nullptr) {
         DLP_LOG_ERROR(LABEL, "HMAC_CTX is null");
         return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
     }
-    if (HMAC_Init_ex(ctx, key.data, key.size, EVP_sha256(), nullptr) != 1) {
+    if (HMAC_Init_ex(hmacCtx, key.data, key.size, EVP_sha256(), nullptr) != 1) {
         DLP_LOG_ERROR(LABEL, "HMAC_Init failed");
-        HMAC_CTX_free(ctx);
+        HMAC_CTX_free(hmacCtx);
         return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
     }
+    *ctx = hmacCtx;
+    return DLP_OK;
+}
 
-    auto buf = std::make_unique<unsigned char[]>(BUFFER_SIZE);
-    uint64_t inOffset = 0;
-    while (inOffset < fileSize) {
-        uint32_t readLen = ((fileSize - inOffset) < BUFFER_SIZE) ? (fileSize - inOffset) : BUFFER_SIZE;
-        ssize_t readSize = read(fd, buf.get(), readLen);
-        if (static_cast<uint32_t>(readSize) != readLen) {
-            DLP_LOG_ERROR(LABEL, "HMAC_Init readLen err: %{public}d", readLen);
-            HMAC_CTX_free(ctx);
-            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-        }
-
-        if (HMAC_Update(ctx, buf.get(), readLen) != 1) {
-            DLP_LOG_ERROR(LABEL, "HMAC_Update failed");
-            HMAC_CTX_free(ctx);
-            return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
-        }
-
-        inOffset += readLen;
+int32_t DlpHmacStreamUpdate(void* ctx, const uint8_t* data, uint32_t len)
+{
+    if (ctx == nullptr || (data == nullptr && len != 0)) {
+        DLP_LOG_ERROR(LABEL, "HMAC stream params invalid");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-
-    if (HMAC_Final(ctx, out.data, &out.size) != 1) {
-        DLP_LOG_ERROR(LABEL, "HMAC_Final failed");
-        HMAC_CTX_free(ctx);
+    if (len == 0) {
+        return DLP_OK;
+    }
+    if (HMAC_Update(static_cast<HMAC_CTX*>(ctx), data, len) != 1) {
+        DLP_LOG_ERROR(LABEL, "HMAC_Update failed");
         return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
     }
-
-    HMAC_CTX_free(ctx);
     return DLP_OK;
 }
 
-int32_t DlpHmacEncode(const DlpBlob& key, int32_t fd, DlpBlob& out)
+int32_t DlpHmacStreamFinal(void* ctx, DlpBlob& out)
 {
-    if ((key.data == nullptr) || (key.size != SHA256_KEY_LEN)) {
-        DLP_LOG_ERROR(LABEL, "Key blob invalid, size %{public}u", key.size);
-        return DLP_PARSE_ERROR_DIGEST_INVALID;
-    }
-    if ((out.data == nullptr) || (out.size < HMAC_SIZE)) {
+    if (ctx == nullptr || (out.data == nullptr) || (out.size < HMAC_SIZE)) {
         DLP_LOG_ERROR(LABEL, "Output blob invalid, size %{public}u", out.size);
         return DLP_PARSE_ERROR_DIGEST_INVALID;
     }
-
-    HMAC_CTX* ctx = HMAC_CTX_new();
-    if (ctx == nullptr) {
-        DLP_LOG_ERROR(LABEL, "HMAC_CTX is null");
-        return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
-    }
-    if (HMAC_Init_ex(ctx, key.data, key.size, EVP_sha256(), nullptr) != 1) {
-        DLP_LOG_ERROR(LABEL, "HMAC_Init failed");
-        HMAC_CTX_free(ctx);
-        return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
-    }
-
-    auto buf = std::make_unique<unsigned char[]>(BUFFER_SIZE);
-    int32_t readSize;
-    while ((readSize = read(fd, buf.get(), BUFFER_SIZE)) > 0) {
-        if (HMAC_Update(ctx, buf.get(), readSize) != 1) {
-            DLP_LOG_ERROR(LABEL, "HMAC_Update failed");
-            HMAC_CTX_free(ctx);
-            return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
-        }
-    }
-    if (HMAC_Final(ctx, out.data, &out.size) != 1) {
+    if (HMAC_Final(static_cast<HMAC_CTX*>(ctx), out.data, &out.size) != 1) {
         DLP_LOG_ERROR(LABEL, "HMAC_Final failed");
-        HMAC_CTX_free(ctx);
         return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
     }
-    HMAC_CTX_free(ctx);
     return DLP_OK;
 }
+
+void DlpHmacStreamFree(void* ctx)
+{
+    if (ctx != nullptr) {
+        HMAC_CTX_free(static_cast<HMAC_CTX*>(ctx));
+    }
+}
 #ifdef __cplusplus
 }
 #endif
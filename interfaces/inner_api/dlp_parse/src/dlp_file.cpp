@@ -18,11 +18,14 @@
 #include <cstdlib>
 #include <fcntl.h>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include "dlp_io_backend.h"
+#include "dlp_job_control.h"
 #include "dlp_permission.h"
 #include "dlp_permission_kit.h"
 #include "dlp_permission_public_interface.h"
@@ -43,6 +46,34 @@ using Defer = std::shared_ptr<void>;
 namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpFile"};
 const uint32_t FIRST = 1;
+
+// read/write in request order for fds without an offset (pipes, sockets), with the IDlpIoBackend::Submit contract.
+bool SubmitSequential(DlpIoRequest* reqs, uint32_t count, bool isWrite)
+{
+    bool complete = true;
+    for (uint32_t i = 0; i < count && complete; i++) {
+        uint32_t done = 0;
+        int32_t err = 0;
+        while (done < reqs[i].size) {
+            ssize_t ret = isWrite ? write(reqs[i].fd, reqs[i].buf + done, reqs[i].size - done) :
+                read(reqs[i].fd, reqs[i].buf + done, reqs[i].size - done);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret < 0) {
+                err = errno;
+                break;
+            }
+            if (ret == 0) {
+                break;
+            }
+            done += static_cast<uint32_t>(ret);
+        }
+        reqs[i].result = (done == 0 && err != 0) ? -err : static_cast<ssize_t>(done);
+        complete = (done == reqs[i].size);
+    }
+    return complete;
+}
 } // namespace
 
 DlpFile::DlpFile(int32_t dlpFd, const std::string &realType)
@@ -74,6 +105,7 @@ DlpFile::DlpFile(int32_t dlpFd, const std::string &realType)
     waterMarkConfig_ = false;
     countdown_ = false;
     nickNameMask_ = "";
+    io_ = CreateDlpIoBackend();
 }
 
 DlpFile::~DlpFile() = default;
@@ -292,6 +324,13 @@ bool DlpFile::NeedAdapter()
     return version_ == FIRST && CURRENT_VERSION != FIRST;
 }
 
+int32_t DlpFile::SetCommitDeferred(bool deferred)
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    commitDeferred_ = deferred;
+    return deferred ? DLP_OK : DlpFileCommit();
+}
+
 void DlpFile::GetEncryptCert(struct DlpBlob& cert) const
 {
     cert.data = cert_.data;
@@ -385,6 +424,240 @@ int32_t DlpFile::DoDlpBlockCryptOperation(struct DlpBlob& message1, struct DlpBl
     return DLP_OK;
 }
 
+ssize_t DlpFdPlainSource::Read(uint8_t* buf, uint32_t size)
+{
+    ssize_t readLen;
+    do {
+        readLen = read(fd_, buf, size);
+    } while (readLen < 0 && errno == EINTR);
+    return (readLen < 0) ? -1 : readLen;
+}
+
+int32_t DlpFile::FillFromSource(DlpPlainSource& source, uint8_t* buf, uint32_t size, uint32_t& filled)
+{
+    filled = 0;
+    while (filled < size) {
+        ssize_t readLen = source.Read(buf + filled, size - filled);
+        if (readLen < 0 || static_cast<uint64_t>(readLen) > size - filled) {
+            DLP_LOG_ERROR(LABEL, "read plain source failed, ret %{public}zd", readLen);
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        if (readLen == 0) {
+            break;
+        }
+        filled += static_cast<uint32_t>(readLen);
+    }
+    return DLP_OK;
+}
+
+int32_t DlpFile::EncryptFromSource(DlpPlainSource& source, int32_t outFd, uint64_t maxSize,
+    uint64_t& contentSize, struct DlpBlob& hmac)
+{
+    contentSize = 0;
+    struct DlpBlob message;
+    struct DlpBlob outMessage;
+    if (PrepareBuff(message, outMessage) != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "prepare buff failed");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    Defer p(nullptr, [&](...) {
+        (void)memset_s(message.data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
+        delete[] message.data;
+        delete[] outMessage.data;
+    });
+    void* hmacCtx = nullptr;
+    int32_t ret = DlpHmacStreamInit(cipher_.hmacKey, &hmacCtx);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    Defer p2(nullptr, [&](...) {
+        DlpHmacStreamFree(hmacCtx);
+    });
+
+    uint32_t readLen = DLP_BUFF_LEN;
+    StartJob(0);
+    // Only the last chunk may be shorter than DLP_BUFF_LEN, so cipher offsets stay DLP_BLOCK_SIZE aligned.
+    while (readLen == DLP_BUFF_LEN) {
+        if (IsJobCancelled()) {
+            DLP_LOG_INFO(LABEL, "job cancelled");
+            return DLP_PARSE_ERROR_OPERATION_CANCELED;
+        }
+        ret = FillFromSource(source, message.data, DLP_BUFF_LEN, readLen);
+        if (ret != DLP_OK) {
+            return ret;
+        }
+        if (readLen == 0) {
+            break;
+        }
+        if (readLen > maxSize - contentSize) {
+            DLP_LOG_ERROR(LABEL, "plain source exceeds max content size");
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        message.size = readLen;
+        outMessage.size = readLen;
+        ret = DoDlpBlockCryptOperation(message, outMessage, contentSize, true);
+        if (ret != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "do crypt operation fail");
+            return ret;
+        }
+        ret = DlpHmacStreamUpdate(hmacCtx, outMessage.data, readLen);
+        if (ret != DLP_OK) {
+            return ret;
+        }
+        if (write(outFd, outMessage.data, readLen) != static_cast<ssize_t>(readLen)) {
+            DLP_LOG_ERROR(LABEL, "write fd failed, %{public}s", strerror(errno));
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        contentSize += readLen;
+        ReportJobProgress(contentSize);
+    }
+    return DlpHmacStreamFinal(hmacCtx, hmac);
+}
+
+void DlpFile::StartJob(uint64_t totalSize)
+{
+    if (jobControl_ != nullptr) {
+        jobControl_->Start(totalSize);
+    }
+}
+
+bool DlpFile::IsJobCancelled() const
+{
+    return jobControl_ != nullptr && jobControl_->IsCancelled();
+}
+
+void DlpFile::ReportJobProgress(uint64_t processedSize)
+{
+    if (jobControl_ != nullptr) {
+        jobControl_->ReportProgress(processedSize);
+    }
+}
+
+/*
+ * Reads, crypts and writes the content one batch of queue depth chunks at a time, so the backend can keep the
+ * reads (then the writes) of a batch in flight together. Both fds are used from their current offsets, where the
+ * content is, and are left after it as if it had been copied with read and write. An fd that cannot seek (a pipe)
+ * is read or written in order with read and write instead.
+ */
+int32_t DlpFile::CryptContentWithIo(int32_t inFd, int32_t outFd, uint64_t inOffset, uint64_t inFileLen,
+    const ContentCryptFunc& crypt, bool skipReadOnlyOut)
+{
+    StartJob((inFileLen > inOffset) ? (inFileLen - inOffset) : 0);
+    if (inOffset >= inFileLen) {
+        return DLP_OK;
+    }
+    bool inIsStream = false;
+    off_t inPos = lseek(inFd, 0, SEEK_CUR);
+    if (inPos == static_cast<off_t>(-1)) {
+        if (errno != ESPIPE) {
+            DLP_LOG_ERROR(LABEL, "get in fd offset failed, %{public}s", strerror(errno));
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        inIsStream = true;
+        inPos = 0;
+    }
+    uint32_t depth = (io_->GetQueueDepth() > 0) ? io_->GetQueueDepth() : 1;
+    std::vector<struct DlpBlob> inBuffs;
+    std::vector<struct DlpBlob> outBuffs;
+    Defer p(nullptr, [&](...) {
+        for (size_t i = 0; i < inBuffs.size(); i++) {
+            (void)memset_s(inBuffs[i].data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
+            (void)memset_s(outBuffs[i].data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
+            delete[] inBuffs[i].data;
+            delete[] outBuffs[i].data;
+        }
+    });
+    for (uint32_t i = 0; i < depth; i++) {
+        struct DlpBlob message;
+        struct DlpBlob outMessage;
+        if (PrepareBuff(message, outMessage) != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "prepare buff failed");
+            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+        inBuffs.push_back(message);
+        outBuffs.push_back(outMessage);
+    }
+
+    uint64_t contentStart = inOffset;
+    bool outIsStream = false;
+    off_t outPos = static_cast<off_t>(-1);
+    std::vector<DlpIoRequest> reqs(depth);
+    while (inOffset < inFileLen) {
+        if (IsJobCancelled()) {
+            DLP_LOG_INFO(LABEL, "job cancelled");
+            return DLP_PARSE_ERROR_OPERATION_CANCELED;
+        }
+        uint32_t count = 0;
+        uint64_t batchEnd = inOffset;
+        for (; count < depth && batchEnd < inFileLen; count++) {
+            uint32_t readLen = ((inFileLen - batchEnd) < DLP_BUFF_LEN) ? (inFileLen - batchEnd) : DLP_BUFF_LEN;
+            reqs[count] = { inFd, inBuffs[count].data, readLen, inPos + batchEnd - contentStart, 0 };
+            batchEnd += readLen;
+        }
+        bool readDone = inIsStream ? SubmitSequential(reqs.data(), count, false) :
+            io_->Submit(reqs.data(), count, false);
+        if (!readDone) {
+            DLP_LOG_ERROR(LABEL, "Read size do not equal readLen");
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        // Implicit condition: DLP_BUFF_LEN must be DLP_BLOCK_SIZE aligned
+        for (uint32_t i = 0; i < count; i++) {
+            inBuffs[i].size = reqs[i].size;
+            outBuffs[i].size = reqs[i].size;
+            int32_t ret = crypt(inBuffs[i], outBuffs[i], reqs[i].offset - inPos);
+            if (ret != DLP_OK) {
+                DLP_LOG_ERROR(LABEL, "do crypt operation fail");
+                return ret;
+            }
+        }
+
+        int32_t writeErr = 0;
+        if (outPos == static_cast<off_t>(-1)) {
+            outPos = lseek(outFd, 0, SEEK_CUR);
+            writeErr = (outPos == static_cast<off_t>(-1)) ? errno : 0;
+            if (writeErr == ESPIPE) {
+                outIsStream = true;
+                outPos = 0;
+                writeErr = 0;
+            }
+        }
+        for (uint32_t i = 0; i < count && writeErr == 0; i++) {
+            reqs[i] = { outFd, outBuffs[i].data, reqs[i].size, reqs[i].offset - inPos + outPos, 0 };
+        }
+        bool writeDone = (writeErr != 0) || (outIsStream ? SubmitSequential(reqs.data(), count, true) :
+            io_->Submit(reqs.data(), count, true));
+        if (!writeDone) {
+            writeErr = EIO;
+            for (uint32_t i = 0; i < count && writeErr == EIO; i++) {
+                writeErr = (reqs[i].result < 0) ? static_cast<int32_t>(-reqs[i].result) : writeErr;
+            }
+        }
+        if (writeErr != 0) {
+            DLP_LOG_ERROR(LABEL, "write fd failed, %{public}s", strerror(writeErr));
+            if (skipReadOnlyOut && writeErr == EBADF) {
+                DLP_LOG_DEBUG(LABEL, "this dlp fd is readonly, unable write.");
+                return DLP_OK;
+            }
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        inOffset = batchEnd;
+        ReportJobProgress(inOffset - contentStart);
+    }
+    if (!inIsStream) {
+        (void)lseek(inFd, inPos + inOffset - contentStart, SEEK_SET);
+    }
+    if (outPos != static_cast<off_t>(-1) && !outIsStream) {
+        (void)lseek(outFd, outPos + inOffset - contentStart, SEEK_SET);
+    }
+    return DLP_OK;
+}
+
+int32_t DlpFile::HmacContentWithIo(int32_t fd, uint64_t offset, uint64_t size, struct DlpBlob& out,
+    const std::vector<uint8_t>& extra)
+{
+    return DlpPermission::HmacContentWithIo(*io_, cipher_.hmacKey, fd, offset, size, out, extra);
+}
+
 int32_t DlpFile::FillHoleData(uint64_t holeStart, uint64_t holeSize)
 {
     DLP_LOG_INFO(LABEL, "Need create a hole filled with 0s, hole start %{public}s size %{public}s",
@@ -210,20 +210,16 @@ static bool IsDlpFileName(const std::string& dlpFileName)
     return true;
 }
 
+static const DlpFileTypeIndex& GetMimeTypeIndex()
+{
+    static const DlpFileTypeIndex index(FILE_TYPE_MAP, TYPE_TO_NUM_MAP, { DLP_HIAE_TYPE }, SUFFIX_MIMETYPE_MAP);
+    return index;
+}
+
 static std::string GetMimeTypeBySuffix(const std::string& suffix)
 {
-    std::string lower = DlpUtils::ToLowerString(suffix);
-    for (size_t len = MAX_REALY_TYPE_LENGTH; len >= MIN_REALY_TYPE_LENGTH; len--) {
-        if (len > lower.size()) {
-            continue;
-        }
-        std::string newStr = lower.substr(0, len);
-        auto iter = SUFFIX_MIMETYPE_MAP.find(newStr);
-        if (iter != SUFFIX_MIMETYPE_MAP.end()) {
-            return iter->second;
-        }
-    }
-    return DEFAULT_STRING;
+    auto entry = GetMimeTypeIndex().FindPrefix(suffix, DlpFileTypeIndex::MIME_TYPE);
+    return (entry != nullptr) ? entry->mimeType : DEFAULT_STRING;
 }
 
 static bool IsValidDlpHeader(const struct DlpHeader& head)
@@ -291,7 +287,8 @@ bool DlpFileKits::IsDlpFile(int32_t dlpFd)
             DLP_LOG_ERROR(LABEL, "can not read dlpHeaderSize, %{public}s", strerror(errno));
             break;
         }
-        if (version != CURRENT_VERSION || dlpHeaderSize < sizeof(struct DlpHeader) ||
+        bool knownVersion = (version == CURRENT_VERSION || version == RAW_TAIL_MAP_VERSION);
+        if (!knownVersion || dlpHeaderSize < sizeof(struct DlpHeader) ||
             dlpHeaderSize > ENTERPRISE_HEAD_MAX) {
             DLP_LOG_ERROR(LABEL, "version or dlpHeaderSize is error");
             break;
@@ -459,13 +456,8 @@ static std::string GetRealFileType(const AAFwk::Want &want)
         return DEFAULT_STRINGS;
     }
 
-    std::string realSuffix = DEFAULT_STRING;
-    for (const auto& p : SUFFIX_MIMETYPE_MAP) {
-        if (p.second == realMimeType) {
-            realSuffix = p.first;
-            break;
-        }
-    }
+    auto entry = GetMimeTypeIndex().FindByMimeType(realMimeType);
+    std::string realSuffix = (entry != nullptr) ? entry->suffix : DEFAULT_STRING;
     std::string fileType = DlpUtils::GetFileTypeBySuffix(realSuffix, false);
     if (fileType == DEFAULT_STRING) {
         DLP_LOG_ERROR(LABEL, "%{public}s is not support dlp.", realSuffix.c_str());
@@ -24,6 +24,8 @@
 
 #include "dlp_crypt.h"
 #include "dlp_file.h"
+#include "dlp_file_registry.h"
+#include "dlp_job_control.h"
 #include "dlp_raw_file.h"
 #include "dlp_zip_file.h"
 #include "dlp_zip.h"
@@ -44,7 +46,6 @@ namespace Security {
 namespace DlpPermission {
 namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpFileManager"};
-static constexpr uint32_t MAX_DLP_FILE_SIZE = 1000; // max open dlp file
 static constexpr uint32_t DECRYPTTYPEFORUSER = 2;
 const std::string PATH_CACHE = "/cache";
 const std::string SUPPORT_PHOTO_DLP = "support_photo_dlp";
@@ -58,24 +59,23 @@ static const std::string SGVERSION = "1";
 #endif
 }
 
+DlpFileManager::DlpFileManager() : dlpFileRegistry_(std::make_unique<DlpFileRegistry>(MAX_DLP_FILE_SIZE)) {}
+
+DlpFileManager::~DlpFileManager() {}
+
 int32_t DlpFileManager::AddDlpFileNode(const std::shared_ptr<DlpFile>& filePtr)
 {
     if (filePtr == nullptr) {
         DLP_LOG_ERROR(LABEL, "Add dlp file node failed, filePtr is null");
         return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-    Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(this->g_DlpMapLock_);
-    if (g_DlpFileMap_.size() >= MAX_DLP_FILE_SIZE) {
+    int32_t res = dlpFileRegistry_->Add(filePtr);
+    if (res == DLP_PARSE_ERROR_TOO_MANY_OPEN_DLP_FILE) {
         DLP_LOG_ERROR(LABEL, "Add dlp file node failed, too many files");
-        return DLP_PARSE_ERROR_TOO_MANY_OPEN_DLP_FILE;
-    }
-    auto iter = g_DlpFileMap_.find(filePtr->dlpFd_);
-    if (iter != g_DlpFileMap_.end()) {
+    } else if (res != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Add dlp file node fail, fd %{public}d already exist", filePtr->dlpFd_);
-        return DLP_PARSE_ERROR_FILE_ALREADY_OPENED;
     }
-    g_DlpFileMap_[filePtr->dlpFd_] = filePtr;
-    return DLP_OK;
+    return res;
 }
 
 int32_t DlpFileManager::RemoveDlpFileNode(const std::shared_ptr<DlpFile>& filePtr)
@@ -84,28 +84,16 @@ int32_t DlpFileManager::RemoveDlpFileNode(const std::shared_ptr<DlpFile>& filePt
         DLP_LOG_ERROR(LABEL, "Remove dlp file node fail, filePtr is null");
         return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-    Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(this->g_DlpMapLock_);
-    for (auto iter = g_DlpFileMap_.begin(); iter != g_DlpFileMap_.end(); iter++) {
-        if (filePtr->dlpFd_ == iter->first) {
-            g_DlpFileMap_.erase(iter);
-            return DLP_OK;
-        }
+    int32_t res = dlpFileRegistry_->Remove(filePtr);
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Remove dlp file node fail, fd %{public}d not exist", filePtr->dlpFd_);
     }
-
-    DLP_LOG_ERROR(LABEL, "Remove dlp file node fail, fd %{public}d not exist", filePtr->dlpFd_);
-    return DLP_PARSE_ERROR_FILE_NOT_OPENED;
+    return res;
 }
 
 std::shared_ptr<DlpFile> DlpFileManager::GetDlpFile(int32_t dlpFd)
 {
-    Utils::UniqueReadGuard<Utils::RWLock> infoGuard(this->g_DlpMapLock_);
-    for (auto iter = g_DlpFileMap_.begin(); iter != g_DlpFileMap_.end(); iter++) {
-        if (dlpFd == iter->first) {
-            return iter->second;
-        }
-    }
-
-    return nullptr;
+    return dlpFileRegistry_->Get(dlpFd);
 }
 
 int32_t DlpFileManager::GenerateCertData(const PermissionPolicy& policy, struct DlpBlob& certData) const
@@ -462,6 +450,18 @@ static std::string GetFileSuffix(const std::string& fileName)
     return DlpUtils::ToLowerString(fileName.substr(escapeLocate + 1));
 }
 
+static int32_t GenFileWithJob(std::shared_ptr<DlpFile>& filePtr, const DlpFileManager::DlpFileMes& dlpFileMes)
+{
+    filePtr->SetJobControl(dlpFileMes.jobControl);
+    int32_t result = (dlpFileMes.source != nullptr) ? filePtr->GenFileFromSource(*dlpFileMes.source) :
+        filePtr->GenFile(dlpFileMes.plainFileFd);
+    filePtr->SetJobControl(nullptr);
+    if (result == DLP_PARSE_ERROR_OPERATION_CANCELED && ftruncate(dlpFileMes.dlpFileFd, 0) != 0) {
+        DLP_LOG_ERROR(LABEL, "clean cancelled dlp file fail, %{public}s", strerror(errno));
+    }
+    return result;
+}
+
 int32_t DlpFileManager::GenRawDlpFile(DlpFileMes& dlpFileMes, const DlpProperty& property,
                                       std::shared_ptr<DlpFile>& filePtr)
 {
@@ -472,7 +472,7 @@ int32_t DlpFileManager::GenRawDlpFile(DlpFileMes& dlpFileMes, const DlpProperty&
         return result;
     }
 
-    result = filePtr->GenFile(dlpFileMes.plainFileFd);
+    result = GenFileWithJob(filePtr, dlpFileMes);
     if (result != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Generate dlp file fail, errno=%{public}d", result);
         return result;
@@ -510,7 +510,7 @@ int32_t DlpFileManager::GenZipDlpFile(DlpFileMes& dlpFileMes, const DlpProperty&
         DLP_LOG_ERROR(LABEL, "SetDlpFileParams fail, errno=%{public}d", result);
         return result;
     }
-    result = filePtr->GenFile(dlpFileMes.plainFileFd);
+    result = GenFileWithJob(filePtr, dlpFileMes);
     if (result != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "GenFile fail, errno=%{public}d", result);
         return result;
@@ -518,25 +518,10 @@ int32_t DlpFileManager::GenZipDlpFile(DlpFileMes& dlpFileMes, const DlpProperty&
     return AddDlpFileNode(filePtr);
 }
 
-int32_t DlpFileManager::GenerateDlpFile(
-    int32_t plainFileFd, int32_t dlpFileFd, const DlpProperty& property, std::shared_ptr<DlpFile>& filePtr,
-    const std::string& workDir)
+int32_t DlpFileManager::GenerateDlpFileByMes(DlpFileMes& dlpFileMes, const DlpProperty& property,
+    std::shared_ptr<DlpFile>& filePtr, const std::string& workDir)
 {
-    if (plainFileFd < 0 || dlpFileFd < 0) {
-        DLP_LOG_ERROR(LABEL, "fd invalid, plainFileFd: %{public}d, dlpFileFd: %{public}d", plainFileFd, dlpFileFd);
-        return DLP_PARSE_ERROR_FD_ERROR;
-    }
-
-    off_t fileLen = lseek(plainFileFd, 0, SEEK_END);
-    if (fileLen == static_cast<off_t>(-1) || static_cast<uint64_t>(fileLen) > DLP_MAX_CONTENT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "fileLen invalid");
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    if (lseek(plainFileFd, 0, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "lseek invalid, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-
+    int32_t dlpFileFd = dlpFileMes.dlpFileFd;
     if (GetDlpFile(dlpFileFd) != nullptr) {
         DLP_LOG_ERROR(LABEL, "Generate dlp file fail, dlp file has generated, if you want to rebuild, close it first");
         return DLP_PARSE_ERROR_FILE_ALREADY_OPENED;
@@ -560,7 +545,7 @@ int32_t DlpFileManager::GenerateDlpFile(
         DLP_LOG_ERROR(LABEL, "GetFileTypeBySuffix fail");
         return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-    DlpFileMes dlpFileMes = {plainFileFd, dlpFileFd, realFileType};
+    dlpFileMes.realFileType = realFileType;
     if ((fileType == SUPPORT_PHOTO_DLP || fileType == SUPPORT_VIDEO_DLP || fileType == SUPPORT_AUDIO_DLP ||
         fileType == SUPPORT_DOCUMENT_DLP) && property.ownerAccountType == CLOUD_ACCOUNT) {
         return GenRawDlpFile(dlpFileMes, property, filePtr);
@@ -568,6 +553,47 @@ int32_t DlpFileManager::GenerateDlpFile(
     return GenZipDlpFile(dlpFileMes, property, filePtr, workDir);
 }
 
+int32_t DlpFileManager::GenerateDlpFile(
+    int32_t plainFileFd, int32_t dlpFileFd, const DlpProperty& property, std::shared_ptr<DlpFile>& filePtr,
+    const std::string& workDir, const std::shared_ptr<DlpJobControl>& jobControl)
+{
+    if (plainFileFd < 0 || dlpFileFd < 0) {
+        DLP_LOG_ERROR(LABEL, "fd invalid, plainFileFd: %{public}d, dlpFileFd: %{public}d", plainFileFd, dlpFileFd);
+        return DLP_PARSE_ERROR_FD_ERROR;
+    }
+
+    off_t fileLen = lseek(plainFileFd, 0, SEEK_END);
+    if (fileLen == static_cast<off_t>(-1) && errno == ESPIPE) {
+        // pipes and sockets cannot be sized up front, encrypt them as a stream instead
+        DLP_LOG_INFO(LABEL, "plain fd is not seekable, generate from stream");
+        DlpFdPlainSource source(plainFileFd);
+        return GenerateDlpFileFromSource(source, dlpFileFd, property, filePtr, workDir, jobControl);
+    }
+    if (fileLen == static_cast<off_t>(-1) || static_cast<uint64_t>(fileLen) > DLP_MAX_CONTENT_SIZE) {
+        DLP_LOG_ERROR(LABEL, "fileLen invalid");
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    if (lseek(plainFileFd, 0, SEEK_SET) == static_cast<off_t>(-1)) {
+        DLP_LOG_ERROR(LABEL, "lseek invalid, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+
+    DlpFileMes dlpFileMes = {plainFileFd, dlpFileFd, "", nullptr, jobControl};
+    return GenerateDlpFileByMes(dlpFileMes, property, filePtr, workDir);
+}
+
+int32_t DlpFileManager::GenerateDlpFileFromSource(
+    DlpPlainSource& source, int32_t dlpFileFd, const DlpProperty& property, std::shared_ptr<DlpFile>& filePtr,
+    const std::string& workDir, const std::shared_ptr<DlpJobControl>& jobControl)
+{
+    if (dlpFileFd < 0) {
+        DLP_LOG_ERROR(LABEL, "fd invalid, dlpFileFd: %{public}d", dlpFileFd);
+        return DLP_PARSE_ERROR_FD_ERROR;
+    }
+    DlpFileMes dlpFileMes = {-1, dlpFileFd, "", &source, jobControl};
+    return GenerateDlpFileByMes(dlpFileMes, property, filePtr, workDir);
+}
+
 int32_t DlpFileManager::DlpRawHmacCheckAndUpdate(std::shared_ptr<DlpFile>& filePtr,
                                                  const std::vector<uint8_t>& offlineCert,
                                                  const int32_t &allowedOpenCount)
@@ -805,7 +831,12 @@ int32_t DlpFileManager::OpenRawDlpFile(int32_t dlpFileFd, std::shared_ptr<DlpFil
         DLP_LOG_ERROR(LABEL, "ParseRawDlpFile fail, errno=%{public}d", result);
         return result;
     }
-    return DlpRawHmacCheckAndUpdate(filePtr, certParcel->offlineCert, filePtr->GetAllowedOpenCount());
+    result = DlpRawHmacCheckAndUpdate(filePtr, certParcel->offlineCert, filePtr->GetAllowedOpenCount());
+    if (result == DLP_OK && filePtr->GetAuthPerm() == DLPFileAccess::READ_ONLY) {
+        // Viewers read the content through a mapping, the fd is still read if it cannot be mapped.
+        (void)std::static_pointer_cast<DlpRawFile>(filePtr)->EnableMappedRead();
+    }
+    return result;
 }
 
 static int32_t SetEnterpriseInfoForDlpFileAndCheck(int32_t dlpFileFd, std::shared_ptr<DlpFile>& filePtr,
@@ -982,20 +1013,12 @@ int32_t DlpFileManager::OpenDlpFile(int32_t dlpFileFd, std::shared_ptr<DlpFile>&
         DLP_LOG_ERROR(LABEL, "Open dlp file fail, fd %{public}d has opened", dlpFileFd);
         return DLP_OK;
     }
-    std::string lower = DlpUtils::ToLowerString(realSuffix);
-    std::string realType = lower;
+    std::string realType = DlpUtils::ToLowerString(realSuffix);
     if (isFromUriName) {
-        for (size_t len = MAX_REALY_TYPE_LENGTH; len >= MIN_REALY_TYPE_LENGTH; len--) {
-            if (len > lower.size()) {
-                continue;
-            }
-            std::string newStr = lower.substr(0, len);
-            auto iter = FILE_TYPE_MAP.find(newStr);
-            if (iter != FILE_TYPE_MAP.end()) {
-                realType = newStr;
-                DLP_LOG_INFO(LABEL, "Assign realType newStr %{public}s", newStr.c_str());
-                break;
-            }
+        auto entry = DlpUtils::GetFileTypeIndex().FindPrefix(realType, DlpFileTypeIndex::SUPPORT_DLP);
+        if (entry != nullptr) {
+            realType = entry->suffix;
+            DLP_LOG_INFO(LABEL, "Assign realType newStr %{public}s", realType.c_str());
         }
     }
     if (IsZipFile(dlpFileFd)) {
@@ -1017,7 +1040,8 @@ int32_t DlpFileManager::CloseDlpFile(const std::shared_ptr<DlpFile>& dlpFile)
     return RemoveDlpFileNode(dlpFile);
 }
 
-int32_t DlpFileManager::RecoverDlpFile(std::shared_ptr<DlpFile>& filePtr, int32_t plainFd) const
+int32_t DlpFileManager::RecoverDlpFile(std::shared_ptr<DlpFile>& filePtr, int32_t plainFd,
+    const std::shared_ptr<DlpJobControl>& jobControl) const
 {
     if (filePtr == nullptr) {
         DLP_LOG_ERROR(LABEL, "Recover dlp file fail, dlp obj is null");
@@ -1028,7 +1052,13 @@ int32_t DlpFileManager::RecoverDlpFile(std::shared_ptr<DlpFile>& filePtr, int32_
         return DLP_PARSE_ERROR_FD_ERROR;
     }
 
-    return filePtr->RemoveDlpPermission(plainFd);
+    filePtr->SetJobControl(jobControl);
+    int32_t result = filePtr->RemoveDlpPermission(plainFd);
+    filePtr->SetJobControl(nullptr);
+    if (result == DLP_PARSE_ERROR_OPERATION_CANCELED && ftruncate(plainFd, 0) != 0) {
+        DLP_LOG_ERROR(LABEL, "clean cancelled plain file fail, %{public}s", strerror(errno));
+    }
+    return result;
 }
 
 DlpFileManager& DlpFileManager::GetInstance()
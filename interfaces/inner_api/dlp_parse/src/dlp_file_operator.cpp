@@ -26,9 +26,11 @@
 #include "securec.h"
 
 #include "cert_parcel.h"
+#include "dlp_cert_tlv.h"
 #include "dlp_crypt.h"
 #include "dlp_zip.h"
 #include "dlp_file_manager.h"
+#include "dlp_job_control.h"
 #include "dlp_permission.h"
 #include "dlp_permission_kit.h"
 #include "dlp_permission_log.h"
@@ -273,19 +275,8 @@ int32_t EnterpriseSpaceDlpPermissionKit::EnterpriseSpacePrepareWorkDir(int32_t d
         rmdir(realWorkDir.c_str());
         return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-    std::string lower = DlpUtils::ToLowerString(realSuffix);
-    std::string realType = "";
-    for (size_t len = MAX_REALY_TYPE_LENGTH; len >= MIN_REALY_TYPE_LENGTH; len--) {
-        if (len > lower.size()) {
-            continue;
-        }
-        std::string newStr = lower.substr(0, len);
-        auto iter = FILE_TYPE_MAP.find(newStr);
-        if (iter != FILE_TYPE_MAP.end()) {
-            realType = newStr;
-            break;
-        }
-    }
+    auto entry = DlpUtils::GetFileTypeIndex().FindPrefix(realSuffix, DlpFileTypeIndex::SUPPORT_DLP);
+    std::string realType = (entry != nullptr) ? entry->suffix : "";
     filePtr = std::make_shared<DlpZipFile>(dlpFileFd, realWorkDir, timeStamp, realType);
     return DLP_OK;
 }
@@ -404,8 +395,29 @@ int32_t EnterpriseSpaceDlpPermissionKit::EncryptDlpFile(DlpProperty property,
     return DLP_OK;
 }
 
+static uint32_t GetAccountTypeFromTlvCert(const std::string& cert)
+{
+    DlpTlvReader reader(reinterpret_cast<const uint8_t*>(cert.data()), cert.size());
+    if (!reader.ReadHeader()) {
+        return INVALID_ACCOUNT;
+    }
+    uint16_t tag = 0;
+    const uint8_t* value = nullptr;
+    uint32_t len = 0;
+    while (reader.Next(tag, value, len)) {
+        uint32_t accountType = 0;
+        if (tag == DLP_CERT_TLV_TAG_ACCOUNT_TYPE && ReadTlvUint32(value, len, accountType)) {
+            return accountType;
+        }
+    }
+    return INVALID_ACCOUNT;
+}
+
 uint32_t GetAccountTypeFromCert(std::string cert)
 {
+    if (IsDlpCertTlv(reinterpret_cast<const uint8_t*>(cert.data()), cert.size())) {
+        return GetAccountTypeFromTlvCert(cert);
+    }
     auto jsonObj = nlohmann::json::parse(cert, nullptr, false);
     if (jsonObj.is_discarded() || (!jsonObj.is_object())) {
         return INVALID_ACCOUNT;
@@ -468,7 +480,7 @@ uint32_t EnterpriseSpaceDlpPermissionKit::DecryptRawDlpFileAndGetAccountType(int
 }
 
 int32_t EnterpriseSpaceDlpPermissionKit::DecryptEnterpriseDlpFile(int32_t plainFileFd,
-    int32_t dlpFileFd, int32_t decryptType)
+    int32_t dlpFileFd, int32_t decryptType, const std::shared_ptr<DlpJobControl>& jobControl)
 {
     std::shared_ptr<DlpFile> filePtr = nullptr;
     bool isFromUriName;
@@ -486,7 +498,7 @@ int32_t EnterpriseSpaceDlpPermissionKit::DecryptEnterpriseDlpFile(int32_t plainF
         DLP_LOG_ERROR(LABEL, "Enterprise space prepare workDir fail, errno=%{public}d", result);
         return result;
     }
-    result = DlpFileManager::GetInstance().RecoverDlpFile(filePtr, plainFileFd);
+    result = DlpFileManager::GetInstance().RecoverDlpFile(filePtr, plainFileFd, jobControl);
     if (result != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "RecoverDlpFile fail, errno=%{public}d", result);
         return result;
@@ -494,7 +506,8 @@ int32_t EnterpriseSpaceDlpPermissionKit::DecryptEnterpriseDlpFile(int32_t plainF
     return DLP_OK;
 }
 
-int32_t EnterpriseSpaceDlpPermissionKit::DecryptDlpFile(int32_t plainFileFd, int32_t dlpFileFd)
+int32_t EnterpriseSpaceDlpPermissionKit::DecryptDlpFile(int32_t plainFileFd, int32_t dlpFileFd,
+    const std::shared_ptr<DlpJobControl>& jobControl)
 {
     DLP_LOG_INFO(LABEL, "Start decrypt dlp file from enterprise space service.");
     if (plainFileFd < 0 || dlpFileFd < 0) {
@@ -503,7 +516,7 @@ int32_t EnterpriseSpaceDlpPermissionKit::DecryptDlpFile(int32_t plainFileFd, int
     }
     if (!IsZipFile(dlpFileFd) && DecryptRawDlpFileAndGetAccountType(dlpFileFd) == ENTERPRISE_ACCOUNT) {
         int32_t decryptType = DECRYPTTYPEFORCLIENT;
-        return DecryptEnterpriseDlpFile(plainFileFd, dlpFileFd, decryptType);
+        return DecryptEnterpriseDlpFile(plainFileFd, dlpFileFd, decryptType, jobControl);
     }
     
     std::shared_ptr<DlpFile> filePtr = nullptr;
@@ -520,7 +533,7 @@ int32_t EnterpriseSpaceDlpPermissionKit::DecryptDlpFile(int32_t plainFileFd, int
         return result;
     }
 
-    result = DlpFileManager::GetInstance().RecoverDlpFile(filePtr, plainFileFd);
+    result = DlpFileManager::GetInstance().RecoverDlpFile(filePtr, plainFileFd, jobControl);
     if (result != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "recover dlp file fail with enterprise space.");
         return result;
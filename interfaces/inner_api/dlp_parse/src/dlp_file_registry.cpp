@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_file_registry.h"
+
+#include "dlp_permission.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+DlpFileRegistry::DlpFileRegistry(uint32_t capacity) : capacity_(capacity) {}
+
+int32_t DlpFileRegistry::Add(const std::shared_ptr<DlpFile>& file)
+{
+    Shard& shard = ShardOf(file->dlpFd_);
+    Utils::UniqueWriteGuard<Utils::RWLock> guard(shard.lock);
+    if (count_.fetch_add(1) >= capacity_) {
+        count_.fetch_sub(1);
+        return DLP_PARSE_ERROR_TOO_MANY_OPEN_DLP_FILE;
+    }
+    if (!shard.files.emplace(file->dlpFd_, file).second) {
+        count_.fetch_sub(1);
+        return DLP_PARSE_ERROR_FILE_ALREADY_OPENED;
+    }
+    return DLP_OK;
+}
+
+int32_t DlpFileRegistry::Remove(const std::shared_ptr<DlpFile>& file)
+{
+    Shard& shard = ShardOf(file->dlpFd_);
+    Utils::UniqueWriteGuard<Utils::RWLock> guard(shard.lock);
+    auto iter = shard.files.find(file->dlpFd_);
+    if (iter == shard.files.end() || iter->second != file) {
+        return DLP_PARSE_ERROR_FILE_NOT_OPENED;
+    }
+    shard.files.erase(iter);
+    count_.fetch_sub(1);
+    return DLP_OK;
+}
+
+std::shared_ptr<DlpFile> DlpFileRegistry::Get(int32_t dlpFd)
+{
+    Shard& shard = ShardOf(dlpFd);
+    Utils::UniqueReadGuard<Utils::RWLock> guard(shard.lock);
+    auto iter = shard.files.find(dlpFd);
+    return (iter != shard.files.end()) ? iter->second : nullptr;
+}
+
+uint32_t DlpFileRegistry::Size() const
+{
+    return count_.load();
+}
+
+void DlpFileRegistry::Clear()
+{
+    for (auto& shard : shards_) {
+        Utils::UniqueWriteGuard<Utils::RWLock> guard(shard.lock);
+        count_.fetch_sub(static_cast<uint32_t>(shard.files.size()));
+        shard.files.clear();
+    }
+}
+
+DlpFileRegistry::Shard& DlpFileRegistry::ShardOf(int32_t dlpFd)
+{
+    return shards_[static_cast<uint32_t>(dlpFd) % SHARD_NUM];
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
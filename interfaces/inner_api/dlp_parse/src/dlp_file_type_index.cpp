@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_file_type_index.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+const size_t MIN_CAPACITY = 16;
+const size_t LOAD_FACTOR_INVERSE = 2;
+const uint32_t BITS_PER_CHAR = 8;
+const uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+const uint32_t HASH_SHIFT = 32;
+
+bool Pack(const char* data, size_t len, uint64_t& key)
+{
+    if (len == 0 || len > DlpFileTypeIndex::KEY_MAX_LEN) {
+        return false;
+    }
+    key = 0;
+    for (size_t i = 0; i < len; i++) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c == 0) {
+            return false;
+        }
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<unsigned char>(c - 'A' + 'a');
+        }
+        key |= static_cast<uint64_t>(c) << (i * BITS_PER_CHAR);
+    }
+    return true;
+}
+
+size_t Hash(uint64_t key)
+{
+    uint64_t hash = key * HASH_MULTIPLIER;
+    return static_cast<size_t>(hash ^ (hash >> HASH_SHIFT));
+}
+} // namespace
+
+DlpFileTypeIndex::DlpFileTypeIndex(const std::unordered_map<std::string, std::string>& fileTypeMap,
+    const std::unordered_map<std::string, uint32_t>& typeToNumMap, const std::vector<std::string>& hiaeTypes,
+    const std::unordered_map<std::string, std::string>& suffixMimeTypeMap)
+{
+    std::unordered_map<uint64_t, Entry> entries;
+    auto getEntry = [&entries](const std::string& suffix) -> Entry* {
+        uint64_t key = 0;
+        if (!Pack(suffix.data(), suffix.size(), key)) {
+            return nullptr;
+        }
+        Entry& entry = entries[key];
+        entry.key = key;
+        entry.suffix = suffix;
+        return &entry;
+    };
+    for (const auto& item : fileTypeMap) {
+        Entry* entry = getEntry(item.first);
+        if (entry != nullptr) {
+            entry->features |= SUPPORT_DLP;
+            entry->fileType = item.second;
+        }
+    }
+    for (const auto& item : typeToNumMap) {
+        Entry* entry = getEntry(item.first);
+        if (entry != nullptr) {
+            entry->features |= RAW_TYPE;
+            entry->typeNum = item.second;
+        }
+    }
+    for (const auto& type : hiaeTypes) {
+        Entry* entry = getEntry(type);
+        if (entry != nullptr) {
+            entry->features |= HIAE;
+        }
+    }
+    for (const auto& item : suffixMimeTypeMap) {
+        Entry* entry = getEntry(item.first);
+        if (entry != nullptr) {
+            entry->features |= MIME_TYPE;
+            entry->mimeType = item.second;
+        }
+    }
+    size_t capacity = MIN_CAPACITY;
+    while (capacity < entries.size() * LOAD_FACTOR_INVERSE) {
+        capacity <<= 1;
+    }
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+    for (auto& item : entries) {
+        size_t slot = Hash(item.first) & mask_;
+        while (slots_[slot].key != 0) {
+            slot = (slot + 1) & mask_;
+        }
+        slots_[slot] = std::move(item.second);
+    }
+    // A mime type shared by several suffixes resolves to the first of them in suffixMimeTypeMap.
+    for (const auto& item : suffixMimeTypeMap) {
+        const Entry* entry = Find(item.first, MIME_TYPE);
+        if (entry != nullptr) {
+            byMimeType_.emplace(item.second, entry);
+        }
+    }
+}
+
+const DlpFileTypeIndex::Entry* DlpFileTypeIndex::Find(const std::string& suffix, uint32_t features) const
+{
+    uint64_t key = 0;
+    if (!Pack(suffix.data(), suffix.size(), key)) {
+        return nullptr;
+    }
+    return FindKey(key, features);
+}
+
+const DlpFileTypeIndex::Entry* DlpFileTypeIndex::FindPrefix(const std::string& suffix, uint32_t features) const
+{
+    size_t len = suffix.size() < PREFIX_MAX_LEN ? suffix.size() : PREFIX_MAX_LEN;
+    uint64_t key = 0;
+    if (len < PREFIX_MIN_LEN || !Pack(suffix.data(), len, key)) {
+        return nullptr;
+    }
+    for (; len >= PREFIX_MIN_LEN; len--) {
+        uint64_t prefixKey = (len == KEY_MAX_LEN) ? key : (key & ((1ULL << (len * BITS_PER_CHAR)) - 1));
+        const Entry* entry = FindKey(prefixKey, features);
+        if (entry != nullptr) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+const DlpFileTypeIndex::Entry* DlpFileTypeIndex::FindByMimeType(const std::string& mimeType) const
+{
+    auto iter = byMimeType_.find(mimeType);
+    return (iter != byMimeType_.end()) ? iter->second : nullptr;
+}
+
+const DlpFileTypeIndex::Entry* DlpFileTypeIndex::FindKey(uint64_t key, uint32_t features) const
+{
+    for (size_t slot = Hash(key) & mask_; slots_[slot].key != 0; slot = (slot + 1) & mask_) {
+        if (slots_[slot].key == key) {
+            return ((slots_[slot].features & features) == features) ? &slots_[slot] : nullptr;
+        }
+    }
+    return nullptr;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
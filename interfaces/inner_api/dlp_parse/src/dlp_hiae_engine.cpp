@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_hiae_engine.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "dlp_permission.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+// A thread kept by the engine across Crypt calls, running the jobs posted to it one at a time.
+class DlpHIAEEngine::Worker {
+public:
+    Worker() : thread_([this]() { Loop(); }) {}
+
+    ~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // The worker must be idle: a job is posted only after Wait returned for the previous one.
+    void Post(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = std::move(job);
+        }
+        cv_.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return job_ == nullptr; });
+    }
+
+private:
+    void Loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stop_ || job_ != nullptr; });
+            if (job_ == nullptr) {
+                return;
+            }
+            std::function<void()> job = job_;
+            lock.unlock();
+            job();
+            lock.lock();
+            job_ = nullptr;
+            cv_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::function<void()> job_ = nullptr;
+    bool stop_ = false;
+    std::thread thread_;  // declared last, so it starts with the rest initialized
+};
+
+DlpHIAEEngine::DlpHIAEEngine() = default;
+
+DlpHIAEEngine::~DlpHIAEEngine()
+{
+    pool_.clear();
+    (void)memset_s(key_.data(), key_.size(), 0, key_.size());
+    (void)memset_s(&ctx_, sizeof(ctx_), 0, sizeof(ctx_));
+    if (hasLibRef_) {
+        ClearDlpHIAEMgr();
+    }
+}
+
+int32_t DlpHIAEEngine::Init(const struct DlpBlob& key, const struct DlpBlob& iv)
+{
+    if (!hasLibRef_) {
+        int32_t ret = InitDlpHIAEMgr();
+        if (ret != DLP_OK) {
+            return ret;
+        }
+        hasLibRef_ = true;
+    }
+    DlpHIAEFuncTable funcs;
+    int32_t ret = GetDlpHIAEFuncTable(&funcs);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    return Init(funcs, key, iv);
+}
+
+int32_t DlpHIAEEngine::Init(const DlpHIAEFuncTable& funcs, const struct DlpBlob& key, const struct DlpBlob& iv)
+{
+    if (funcs.init == nullptr || funcs.clear == nullptr || funcs.encryptUpdate == nullptr ||
+        funcs.decryptUpdate == nullptr || key.data == nullptr || key.size == 0 || iv.data == nullptr ||
+        iv.size != IV_LEN) {
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    funcs_ = funcs;
+    (void)memset_s(key_.data(), key_.size(), 0, key_.size());
+    key_.assign(key.data, key.data + key.size);
+    iv_.assign(iv.data, iv.data + iv.size);
+    ready_ = true;
+    return DLP_OK;
+}
+
+bool DlpHIAEEngine::Matches(const struct DlpBlob& key, const struct DlpBlob& iv) const
+{
+    return ready_ && key.data != nullptr && iv.data != nullptr &&
+        std::equal(key.data, key.data + key.size, key_.begin(), key_.end()) &&
+        std::equal(iv.data, iv.data + iv.size, iv_.begin(), iv_.end());
+}
+
+void DlpHIAEEngine::SetWorkers(uint32_t workers)
+{
+    workers_ = std::min(std::max(workers, 1U), MAX_WORKERS);
+    if (pool_.size() >= workers_) {
+        pool_.resize(workers_ - 1);
+    }
+}
+
+int32_t DlpHIAEEngine::Crypt(const uint8_t* in, uint8_t* out, uint32_t size, uint64_t offset, bool isEncrypt)
+{
+    if (!ready_ || in == nullptr || out == nullptr || size == 0 || offset % COUNTER_SIZE != 0) {
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    uint32_t blockNum = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint32_t workers = std::min(workers_, blockNum / MIN_WORKER_BLOCKS);
+    if (workers <= 1) {
+        return CryptBlocks(ctx_, in, out, size, offset, isEncrypt);
+    }
+    uint32_t perWorker = (blockNum + workers - 1) / workers;
+    uint32_t posted = 1;
+    while (posted < workers && posted * perWorker < blockNum) {
+        posted++;
+    }
+    while (pool_.size() + 1 < posted) {
+        std::unique_ptr<Worker> worker(new (std::nothrow) Worker());
+        if (worker == nullptr) {
+            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+        pool_.push_back(std::move(worker));
+    }
+    std::vector<int32_t> results(posted, DLP_OK);
+    for (uint32_t i = 1; i < posted; i++) {
+        uint32_t start = i * perWorker * BLOCK_SIZE;
+        uint32_t end = std::min(std::min((i + 1) * perWorker, blockNum) * BLOCK_SIZE, size);
+        pool_[i - 1]->Post([this, &results, i, in, out, start, end, offset, isEncrypt]() {
+            HIAE_CipherCtx ctx = { { 0 }, 0, 0 };
+            results[i] = CryptBlocks(ctx, in + start, out + start, end - start, offset + start, isEncrypt);
+            (void)memset_s(&ctx, sizeof(ctx), 0, sizeof(ctx));
+        });
+    }
+    results[0] = CryptBlocks(ctx_, in, out, std::min(perWorker * BLOCK_SIZE, size), offset, isEncrypt);
+    for (uint32_t i = 1; i < posted; i++) {
+        pool_[i - 1]->Wait();
+    }
+    auto failed = std::find_if(results.begin(), results.end(), [](int32_t ret) { return ret != DLP_OK; });
+    return (failed == results.end()) ? DLP_OK : *failed;
+}
+
+int32_t DlpHIAEEngine::CryptBlocks(HIAE_CipherCtx& ctx, const uint8_t* in, uint8_t* out, uint32_t size,
+    uint64_t offset, bool isEncrypt) const
+{
+    uint8_t ivData[IV_LEN];
+    struct DlpBlob iv = { .size = IV_LEN, .data = ivData };
+    for (uint32_t pos = 0; pos < size; pos += BLOCK_SIZE) {
+        uint32_t blockLen = std::min(size - pos, BLOCK_SIZE);
+        std::copy(iv_.begin(), iv_.end(), ivData);
+        (void)DlpCtrModeIncreaeIvCounter(iv, static_cast<uint32_t>(offset / COUNTER_SIZE));
+        (void)DlpCtrModeIncreaeIvCounter(iv, pos / COUNTER_SIZE);
+        int32_t ret = funcs_.init(&ctx, key_.data(), key_.size(), ivData, IV_LEN);
+        if (ret == DLP_OK) {
+            uint32_t outLen = blockLen;
+            ret = isEncrypt ? funcs_.encryptUpdate(&ctx, in + pos, blockLen, out + pos, &outLen) :
+                funcs_.decryptUpdate(&ctx, in + pos, blockLen, out + pos, &outLen);
+        }
+        (void)funcs_.clear(&ctx);
+        if (ret != DLP_OK) {
+            return DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR;
+        }
+    }
+    return DLP_OK;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
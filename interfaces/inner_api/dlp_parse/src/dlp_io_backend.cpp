@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_io_backend.h"
+#include <cerrno>
+#include <new>
+#include <unistd.h>
+#include "dlp_permission.h"
+#include "dlp_permission_log.h"
+#ifdef DLP_PARSE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "securec.h"
+#endif
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpIoBackend"};
+static constexpr uint32_t HMAC_READ_LEN = 1024 * 1024;
+}
+
+ssize_t IDlpIoBackend::Read(int32_t fd, void* buf, uint32_t size, uint64_t offset)
+{
+    return SubmitOne(fd, buf, size, offset, false);
+}
+
+ssize_t IDlpIoBackend::Write(int32_t fd, const void* buf, uint32_t size, uint64_t offset)
+{
+    return SubmitOne(fd, const_cast<void*>(buf), size, offset, true);
+}
+
+ssize_t IDlpIoBackend::TransferRest(const DlpIoRequest& req, uint32_t done, bool isWrite)
+{
+    while (done < req.size) {
+        ssize_t ret = isWrite ? pwrite(req.fd, req.buf + done, req.size - done, req.offset + done) :
+            pread(req.fd, req.buf + done, req.size - done, req.offset + done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            return (done > 0) ? static_cast<ssize_t>(done) : -errno;
+        }
+        if (ret == 0) {
+            break;
+        }
+        done += static_cast<uint32_t>(ret);
+    }
+    return static_cast<ssize_t>(done);
+}
+
+ssize_t IDlpIoBackend::SubmitOne(int32_t fd, void* buf, uint32_t size, uint64_t offset, bool isWrite)
+{
+    DlpIoRequest req = { fd, static_cast<uint8_t*>(buf), size, offset, 0 };
+    (void)Submit(&req, 1, isWrite);
+    if (req.result < 0) {
+        errno = static_cast<int>(-req.result);
+        return -1;
+    }
+    return req.result;
+}
+
+const char* DlpPosixIoBackend::GetName() const
+{
+    return "posix";
+}
+
+uint32_t DlpPosixIoBackend::GetQueueDepth() const
+{
+    return 1;
+}
+
+bool DlpPosixIoBackend::Submit(DlpIoRequest* reqs, uint32_t count, bool isWrite)
+{
+    bool complete = true;
+    uint32_t begin = 0;
+    while (begin < count) {
+        uint32_t end = begin + 1;
+        while (end < count && end - begin < MAX_MERGED_IOV && reqs[end].fd == reqs[begin].fd &&
+            reqs[end].offset == reqs[end - 1].offset + reqs[end - 1].size) {
+            end++;
+        }
+        complete = Transfer(reqs + begin, end - begin, isWrite) && complete;
+        begin = end;
+    }
+    return complete;
+}
+
+bool DlpPosixIoBackend::Transfer(DlpIoRequest* reqs, uint32_t count, bool isWrite)
+{
+    ssize_t ret = 0;
+    if (count == 1) {
+        reqs[0].result = TransferRest(reqs[0], 0, isWrite);
+        return reqs[0].result == static_cast<ssize_t>(reqs[0].size);
+    }
+    struct iovec iov[MAX_MERGED_IOV];
+    for (uint32_t i = 0; i < count; i++) {
+        iov[i].iov_base = reqs[i].buf;
+        iov[i].iov_len = reqs[i].size;
+    }
+    do {
+        ret = isWrite ? pwritev(reqs[0].fd, iov, static_cast<int>(count), static_cast<off_t>(reqs[0].offset)) :
+            preadv(reqs[0].fd, iov, static_cast<int>(count), static_cast<off_t>(reqs[0].offset));
+    } while (ret < 0 && errno == EINTR);
+    bool complete = true;
+    for (uint32_t i = 0; i < count; i++) {
+        if (ret < 0) {
+            reqs[i].result = -errno;
+            complete = false;
+            continue;
+        }
+        uint32_t done = (static_cast<uint64_t>(ret) < reqs[i].size) ? static_cast<uint32_t>(ret) : reqs[i].size;
+        ret -= static_cast<ssize_t>(done);
+        // A short transfer is finished request by request; a read that hits the end leaves the rest at 0.
+        reqs[i].result = (done < reqs[i].size) ? TransferRest(reqs[i], done, isWrite) : done;
+        complete = (reqs[i].result == static_cast<ssize_t>(reqs[i].size)) && complete;
+    }
+    return complete;
+}
+
+#ifdef DLP_PARSE_IO_URING
+DlpUringIoBackend::DlpUringIoBackend()
+{
+    struct io_uring_params params;
+    (void)memset_s(&params, sizeof(params), 0, sizeof(params));
+    int ringFd = static_cast<int>(syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params));
+    if (ringFd < 0) {
+        return;
+    }
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = (cqRingSize_ > sqRingSize_) ? cqRingSize_ : sqRingSize_;
+    }
+    sqRing_ = Map(ringFd, sqRingSize_, IORING_OFF_SQ_RING);
+    cqRing_ = singleMmap ? sqRing_ : Map(ringFd, cqRingSize_, IORING_OFF_CQ_RING);
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = Map(ringFd, sqesSize_, IORING_OFF_SQES);
+    if (sqRing_ == nullptr || cqRing_ == nullptr || sqes == nullptr) {
+        Unmap(sqes, sqesSize_);
+        ringFd_ = ringFd;
+        Release();
+        return;
+    }
+    auto sqBase = static_cast<uint8_t*>(sqRing_);
+    auto cqBase = static_cast<uint8_t*>(cqRing_);
+    sqTail_ = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.tail);
+    sqMask_ = *reinterpret_cast<uint32_t*>(sqBase + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.array);
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+    cqHead_ = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.head);
+    cqTail_ = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<uint32_t*>(cqBase + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cqBase + params.cq_off.cqes);
+    ringFd_ = ringFd;
+}
+
+DlpUringIoBackend::~DlpUringIoBackend()
+{
+    Unmap(sqes_, sqesSize_);
+    Release();
+}
+
+bool DlpUringIoBackend::IsReady() const
+{
+    return ringFd_ >= 0;
+}
+
+const char* DlpUringIoBackend::GetName() const
+{
+    return "io_uring";
+}
+
+uint32_t DlpUringIoBackend::GetQueueDepth() const
+{
+    return QUEUE_DEPTH;
+}
+
+bool DlpUringIoBackend::Submit(DlpIoRequest* reqs, uint32_t count, bool isWrite)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool complete = true;
+    for (uint32_t begin = 0; begin < count; begin += QUEUE_DEPTH) {
+        uint32_t batch = (count - begin < QUEUE_DEPTH) ? (count - begin) : QUEUE_DEPTH;
+        if (broken_) {
+            for (uint32_t i = begin; i < begin + batch; i++) {
+                reqs[i].result = TransferRest(reqs[i], 0, isWrite);
+                complete = (reqs[i].result == static_cast<ssize_t>(reqs[i].size)) && complete;
+            }
+            continue;
+        }
+        complete = SubmitBatch(reqs + begin, batch, isWrite) && complete;
+    }
+    return complete;
+}
+
+void* DlpUringIoBackend::Map(int ringFd, size_t size, off_t offset)
+{
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    return (addr == MAP_FAILED) ? nullptr : addr;
+}
+
+void DlpUringIoBackend::Unmap(void* addr, size_t size)
+{
+    if (addr != nullptr) {
+        (void)munmap(addr, size);
+    }
+}
+
+void DlpUringIoBackend::Release()
+{
+    if (cqRing_ != sqRing_) {
+        Unmap(cqRing_, cqRingSize_);
+    }
+    Unmap(sqRing_, sqRingSize_);
+    sqRing_ = nullptr;
+    cqRing_ = nullptr;
+    sqes_ = nullptr;
+    if (ringFd_ >= 0) {
+        (void)close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+bool DlpUringIoBackend::SubmitBatch(DlpIoRequest* reqs, uint32_t count, bool isWrite)
+{
+    uint32_t tail = *sqTail_;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = (tail + i) & sqMask_;
+        struct io_uring_sqe* sqe = &sqes_[index];
+        (void)memset_s(sqe, sizeof(*sqe), 0, sizeof(*sqe));
+        iov_[i].iov_base = reqs[i].buf;
+        iov_[i].iov_len = reqs[i].size;
+        sqe->opcode = isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = reqs[i].fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&iov_[i]);
+        sqe->len = 1;
+        sqe->off = reqs[i].offset;
+        sqe->user_data = i;
+        sqArray_[index] = index;
+        reqs[i].result = -EIO;
+    }
+    __atomic_store_n(sqTail_, tail + count, __ATOMIC_RELEASE);
+
+    uint32_t toSubmit = count;
+    uint32_t reaped = 0;
+    while (reaped < count) {
+        long ret = syscall(__NR_io_uring_enter, ringFd_, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            break;
+        }
+        if (ret > 0) {
+            toSubmit -= (static_cast<uint32_t>(ret) < toSubmit) ? static_cast<uint32_t>(ret) : toSubmit;
+        }
+        reaped += Reap(reqs, count);
+    }
+    if (reaped < count) {
+        // The ring failed: take back what the kernel has not seen and finish the batch with pread/pwrite. Once
+        // a request is lost in flight the ring is not used again.
+        __atomic_store_n(sqTail_, tail + count - toSubmit, __ATOMIC_RELEASE);
+        broken_ = broken_ || (toSubmit < count);
+    }
+    bool complete = true;
+    for (uint32_t i = 0; i < count; i++) {
+        ssize_t result = reqs[i].result;
+        bool needRest = (result == -EIO && reaped < count) ||
+            (result >= 0 && static_cast<uint32_t>(result) < reqs[i].size && (isWrite || result > 0));
+        if (needRest) {
+            reqs[i].result = TransferRest(reqs[i], (result > 0) ? static_cast<uint32_t>(result) : 0, isWrite);
+        }
+        complete = (reqs[i].result == static_cast<ssize_t>(reqs[i].size)) && complete;
+    }
+    return complete;
+}
+
+uint32_t DlpUringIoBackend::Reap(DlpIoRequest* reqs, uint32_t count)
+{
+    uint32_t head = *cqHead_;
+    uint32_t tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    uint32_t reaped = 0;
+    for (; head != tail; head++) {
+        const struct io_uring_cqe& cqe = cqes_[head & cqMask_];
+        if (cqe.user_data < count) {
+            reqs[cqe.user_data].result = cqe.res;
+            reaped++;
+        }
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+#endif
+
+std::shared_ptr<IDlpIoBackend> CreateDlpIoBackend()
+{
+#ifdef DLP_PARSE_IO_URING
+    auto uring = std::make_shared<DlpUringIoBackend>();
+    if (uring->IsReady()) {
+        return uring;
+    }
+#endif
+    static std::shared_ptr<IDlpIoBackend> posix = std::make_shared<DlpPosixIoBackend>();
+    return posix;
+}
+
+int32_t HmacContentWithIo(IDlpIoBackend& io, const DlpBlob& key, int32_t fd, uint64_t offset, uint64_t size,
+    DlpBlob& out, const std::vector<uint8_t>& extra)
+{
+    void* hmacCtx = nullptr;
+    int32_t ret = DlpHmacStreamInit(key, &hmacCtx);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    uint32_t depth = (io.GetQueueDepth() > 0) ? io.GetQueueDepth() : 1;
+    std::vector<std::unique_ptr<uint8_t[]>> buffs;
+    for (uint32_t i = 0; i < depth; i++) {
+        std::unique_ptr<uint8_t[]> buff(new (std::nothrow) uint8_t[HMAC_READ_LEN]);
+        if (buff == nullptr) {
+            DLP_LOG_ERROR(LABEL, "New memory fail");
+            DlpHmacStreamFree(hmacCtx);
+            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+        buffs.push_back(std::move(buff));
+    }
+
+    std::vector<DlpIoRequest> reqs(depth);
+    uint64_t done = 0;
+    while (done < size && ret == DLP_OK) {
+        uint32_t count = 0;
+        for (; count < depth && done < size; count++) {
+            uint32_t len = ((size - done) < HMAC_READ_LEN) ? (size - done) : HMAC_READ_LEN;
+            reqs[count] = { fd, buffs[count].get(), len, offset + done, 0 };
+            done += len;
+        }
+        if (!io.Submit(reqs.data(), count, false)) {
+            DLP_LOG_ERROR(LABEL, "read content for hmac failed");
+            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+            break;
+        }
+        for (uint32_t i = 0; i < count && ret == DLP_OK; i++) {
+            ret = DlpHmacStreamUpdate(hmacCtx, reqs[i].buf, reqs[i].size);
+        }
+    }
+    if (ret == DLP_OK && !extra.empty()) {
+        ret = DlpHmacStreamUpdate(hmacCtx, extra.data(), static_cast<uint32_t>(extra.size()));
+    }
+    if (ret == DLP_OK) {
+        ret = DlpHmacStreamFinal(hmacCtx, out);
+    }
+    DlpHmacStreamFree(hmacCtx);
+    return ret;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
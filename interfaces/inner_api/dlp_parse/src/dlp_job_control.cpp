@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_job_control.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+void DlpJobControl::Cancel()
+{
+    cancelled_.store(true);
+}
+
+bool DlpJobControl::IsCancelled() const
+{
+    return cancelled_.load();
+}
+
+void DlpJobControl::SetProgressCallback(const DlpJobProgressCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+}
+
+void DlpJobControl::Start(uint64_t totalSize)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    totalSize_ = totalSize;
+    processedSize_ = 0;
+    startTime_ = std::chrono::steady_clock::now();
+}
+
+void DlpJobControl::ReportProgress(uint64_t processedSize)
+{
+    Report(processedSize, false);
+}
+
+void DlpJobControl::Finish()
+{
+    uint64_t processedSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        processedSize = processedSize_;
+    }
+    Report(processedSize, true);
+}
+
+void DlpJobControl::Report(uint64_t processedSize, bool finished)
+{
+    DlpJobProgressCallback callback;
+    DlpJobProgress progress;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        processedSize_ = processedSize;
+        if (callback_ == nullptr) {
+            return;
+        }
+        callback = callback_;
+        progress.processedSize = processedSize;
+        progress.totalSize = totalSize_;
+        progress.finished = finished;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime_).count();
+        if (elapsed > 0) {
+            progress.bytesPerSecond = processedSize * MS_PER_SECOND / static_cast<uint64_t>(elapsed);
+        }
+    }
+    callback(progress);
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_mapped_content.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <csignal>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "securec.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+struct FaultGuard {
+    const uint8_t* start;
+    const uint8_t* end;
+    sigjmp_buf env;
+};
+
+FaultGuard*& ActiveGuard()
+{
+    static thread_local FaultGuard* guard = nullptr;
+    return guard;
+}
+
+struct sigaction& PrevSigbusAction()
+{
+    static struct sigaction action;
+    return action;
+}
+
+void OnSigbus(int32_t sig, siginfo_t* info, void* context)
+{
+    FaultGuard* guard = ActiveGuard();
+    const uint8_t* addr = static_cast<const uint8_t*>(info->si_addr);
+    if (guard != nullptr && addr >= guard->start && addr < guard->end) {
+        siglongjmp(guard->env, 1);
+    }
+    const struct sigaction& prev = PrevSigbusAction();
+    if ((prev.sa_flags & SA_SIGINFO) != 0) {
+        prev.sa_sigaction(sig, info, context);
+    } else if (prev.sa_handler == SIG_DFL || prev.sa_handler == SIG_IGN) {
+        // The faulting access runs again when the handler returns and meets the default action.
+        (void)signal(sig, SIG_DFL);
+    } else {
+        prev.sa_handler(sig);
+    }
+}
+
+// SA_NODEFER keeps SIGBUS unblocked in the handler, so the jump needs no signal mask restore.
+void InstallSigbusHandler()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        struct sigaction action = {};
+        action.sa_sigaction = OnSigbus;
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        (void)sigemptyset(&action.sa_mask);
+        (void)sigaction(SIGBUS, &action, &PrevSigbusAction());
+    });
+}
+} // namespace
+
+DlpMappedContent::~DlpMappedContent()
+{
+    Unmap();
+}
+
+bool DlpMappedContent::Map(int32_t fd, uint64_t offset, uint64_t size)
+{
+    Unmap();
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (fd < 0 || size == 0 || pageSize <= 0) {
+        return false;
+    }
+    pageSize_ = static_cast<uint64_t>(pageSize);
+    uint64_t mapOffset = offset / pageSize_ * pageSize_;
+    uint64_t mapLen = offset - mapOffset + size;
+    if (mapLen > SIZE_MAX || mapOffset > static_cast<uint64_t>(INT64_MAX)) {
+        return false;
+    }
+    InstallSigbusHandler();
+    void* addr = mmap(nullptr, static_cast<size_t>(mapLen), PROT_READ, MAP_SHARED, fd,
+        static_cast<off_t>(mapOffset));
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(addr);
+    mapLen_ = static_cast<size_t>(mapLen);
+    data_ = base_ + (offset - mapOffset);
+    size_ = size;
+    Prefetch(0);
+    return true;
+}
+
+void DlpMappedContent::Unmap()
+{
+    if (base_ != nullptr) {
+        (void)munmap(base_, mapLen_);
+    }
+    base_ = nullptr;
+    data_ = nullptr;
+    mapLen_ = 0;
+    size_ = 0;
+    lastEnd_ = 0;
+    sequentialReads_ = 0;
+    sequentialAdvice_ = false;
+    prefetchedEnd_ = 0;
+}
+
+bool DlpMappedContent::IsMapped() const
+{
+    return base_ != nullptr;
+}
+
+uint64_t DlpMappedContent::GetSize() const
+{
+    return size_;
+}
+
+bool DlpMappedContent::Copy(uint64_t offset, uint8_t* buf, uint32_t size)
+{
+    if (base_ == nullptr || buf == nullptr || offset > size_ || size > size_ - offset) {
+        return false;
+    }
+    FaultGuard guard = { data_ + offset, data_ + offset + size, {} };
+    FaultGuard* outer = ActiveGuard();
+    if (sigsetjmp(guard.env, 0) != 0) {
+        ActiveGuard() = outer;
+        Unmap();
+        return false;
+    }
+    ActiveGuard() = &guard;
+    (void)memcpy_s(buf, size, data_ + offset, size);
+    ActiveGuard() = outer;
+    Advise(offset, size);
+    return true;
+}
+
+void DlpMappedContent::Advise(uint64_t offset, uint32_t size)
+{
+    bool sequential = offset == lastEnd_;
+    lastEnd_ = offset + size;
+    sequentialReads_ = sequential ? sequentialReads_ + 1 : 0;
+    bool wantSequential = sequentialReads_ >= SEQUENTIAL_READS;
+    if (wantSequential != sequentialAdvice_) {
+        (void)madvise(base_, mapLen_, wantSequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+        sequentialAdvice_ = wantSequential;
+    }
+    if (!sequential) {
+        prefetchedEnd_ = 0;
+    } else if (wantSequential && lastEnd_ + PREFETCH_SIZE > prefetchedEnd_) {
+        Prefetch(std::max(prefetchedEnd_, lastEnd_));
+    }
+}
+
+void DlpMappedContent::Prefetch(uint64_t start)
+{
+    if (start >= size_) {
+        return;
+    }
+    uint64_t end = std::min(start + PREFETCH_SIZE, size_);
+    uint64_t pageStart = static_cast<uint64_t>(data_ - base_) + start;
+    pageStart = pageStart / pageSize_ * pageSize_;
+    (void)madvise(base_ + pageStart, static_cast<size_t>(static_cast<uint64_t>(data_ - base_) + end - pageStart),
+        MADV_WILLNEED);
+    prefetchedEnd_ = end;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
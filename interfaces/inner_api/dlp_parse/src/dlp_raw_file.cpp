@@ -23,7 +23,14 @@
 #include <sstream>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
+#include "dlp_chunk_table.h"
+#include "dlp_hiae_engine.h"
+#include "dlp_io_backend.h"
+#include "dlp_mapped_content.h"
+#include "dlp_raw_metadata_reader.h"
+#include "dlp_sparse_map.h"
 #include "dlp_permission.h"
 #include "dlp_permission_kit.h"
 #include "dlp_permission_public_interface.h"
@@ -46,19 +53,32 @@ const uint32_t FILE_HEAD = 8;
 const uint32_t HMAC_SIZE = 32;
 const uint32_t MAX_CERT_SIZE = 30 * 1024;
 const std::string DEFAULT_STRINGS = "";
-// nickNameMask(40) waterMark(4) flag(4) allowedOpenCount(4) fileid(46)
-const int32_t FILEID_SIZE = 46;
-const int32_t FILEID_SIZE_OPPOSITE = -46;
+// nickNameMask(40) countdown(4) waterMark(4) flag(4) allowedOpenCount(4) fileid(46)
 const int32_t COUNTDOWN_OPPOSITE = -62;
 const int32_t NICK_NAME_MASK_OPPOSITE = -102;
 const int32_t NICK_NAME_MASK_SIZE = 40;
 const int32_t ENTERPRISE_INFO_SIZE = 12;
 const int32_t EVENTID_MAX_SIZE = 20;
+// Covers the version, the header and the contact account of most files.
+const uint64_t HEAD_PREFETCH_SIZE = 4096;
+// Covers the trailer and the largest sparse map and chunk table in front of it.
+const uint64_t TAIL_PREFETCH_SIZE = DlpRawMetadataReader::TRAILER_SIZE + DlpSparseMap::FOOTER_SIZE +
+    DlpSparseMap::MAX_REGIONS * DlpSparseMap::REGION_SIZE + DlpChunkTable::FOOTER_SIZE +
+    DlpChunkTable::MAX_RUNS * DlpChunkTable::RUN_SIZE;
+// Holes smaller than this are still filled with encrypted zeros rather than tracked.
+const uint64_t SPARSE_MIN_HOLE_SIZE = HOLE_BUFF_SIZE;
+
+// The cert, the chunk table, the sparse map and the trailer share the MAX_CERT_SIZE bytes behind the hmac.
+uint32_t GetTailMapCapacity(uint32_t certSize)
+{
+    uint64_t reserved = static_cast<uint64_t>(certSize) + DlpRawMetadataReader::TRAILER_SIZE;
+    return (reserved < MAX_CERT_SIZE) ? static_cast<uint32_t>(MAX_CERT_SIZE - reserved) : 0;
+}
 } // namespace
 
-static int32_t GetFileSize(int32_t fd, uint64_t& fileLen);
-
-DlpRawFile::DlpRawFile(int32_t dlpFd, const std::string &realType) : DlpFile(dlpFd, realType)
+DlpRawFile::DlpRawFile(int32_t dlpFd, const std::string &realType) : DlpFile(dlpFd, realType),
+    metaReader_(std::make_unique<DlpRawMetadataReader>()), sparse_(std::make_unique<DlpSparseMap>()),
+    chunks_(std::make_unique<DlpChunkTable>()), mapped_(std::make_unique<DlpMappedContent>())
 {
     head_.magic = DLP_FILE_MAGIC;
     head_.fileType = 0;
@@ -194,8 +214,9 @@ int32_t DlpRawFile::ParseRawDlpHeader(uint64_t fileLen, uint32_t dlpHeaderSize)
         return DLP_PARSE_ERROR_FD_ERROR;
     }
 
-    if (read(dlpFd_, &head_, dlpHeaderSize) != dlpHeaderSize) {
-        DLP_LOG_ERROR(LABEL, "can not read dlp file head, %{public}s", strerror(errno));
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    if (!metaReader_->Read(&head_, dlpHeaderSize)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file head");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
     if (!IsValidDlpHeader(head_)) {
@@ -234,58 +255,37 @@ int32_t DlpRawFile::ParseRawDlpHeader(uint64_t fileLen, uint32_t dlpHeaderSize)
 
 int32_t DlpRawFile::ParseEnterpriseEventId()
 {
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
     uint32_t idSize = 0;
-    if (read(dlpFd_, &idSize, sizeof(uint32_t)) != sizeof(uint32_t) || idSize > EVENTID_MAX_SIZE) {
-        DLP_LOG_ERROR(LABEL, "can not read eventId size , %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FD_ERROR;
-    }
-    uint8_t *buff = new (std::nothrow) uint8_t[idSize + 1];
-    if (buff == nullptr) {
-        DLP_LOG_ERROR(LABEL, "buff is null");
+    if (!metaReader_->Read(&idSize, sizeof(uint32_t)) || idSize > EVENTID_MAX_SIZE) {
+        DLP_LOG_ERROR(LABEL, "can not read eventId size");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    (void)memset_s(buff, idSize + 1, 0, idSize + 1);
-    if (read(dlpFd_, buff, idSize) != idSize) {
-        delete []buff;
-        DLP_LOG_ERROR(LABEL, "can not read dlp file eventId, %{public}s", strerror(errno));
+    if (!metaReader_->Read(eventId_, idSize)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file eventId");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    char *char_buffer = reinterpret_cast<char *>(buff);
-    std::string str(char_buffer, idSize);
-    delete []buff;
-    buff = nullptr;
-    eventId_ = str;
     return DLP_OK;
 }
 
 int32_t DlpRawFile::ParseEnterpriseFileIdInner(uint32_t fileIdSize)
 {
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
     uint32_t idSize = 0;
-    if (read(dlpFd_, &idSize, sizeof(uint32_t)) != sizeof(uint32_t) || idSize > fileIdSize) {
-        DLP_LOG_ERROR(LABEL, "can not read fileid size , %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FD_ERROR;
-    }
-    uint8_t *buff = new (std::nothrow)uint8_t[idSize + 1];
-    if (buff == nullptr) {
-        DLP_LOG_ERROR(LABEL, "buff is null");
+    if (!metaReader_->Read(&idSize, sizeof(uint32_t)) || idSize > fileIdSize) {
+        DLP_LOG_ERROR(LABEL, "can not read fileid size");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    (void)memset_s(buff, idSize + 1, 0, idSize + 1);
-    if (read(dlpFd_, buff, idSize) != idSize) {
-        delete []buff;
-        DLP_LOG_ERROR(LABEL, "can not read dlp file cert, %{public}s", strerror(errno));
+    if (!metaReader_->Read(fileId_, idSize)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file fileId");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    char *char_buffer = reinterpret_cast<char *>(buff);
-    std::string str(char_buffer, idSize);
-    delete []buff;
-    buff = nullptr;
-    fileId_ = str;
     return DLP_OK;
 }
 
 int32_t DlpRawFile::ParseEnterpriseFileId(uint64_t fileLen, uint32_t fileIdSize)
 {
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
     if (ParseEnterpriseFileIdInner(fileIdSize) != DLP_OK || ParseEnterpriseEventId() != DLP_OK) {
         return DLP_PARSE_ERROR_FD_ERROR;
     }
@@ -324,8 +324,9 @@ int32_t DlpRawFile::ParseEnterpriseRawDlpHeader(uint64_t fileLen, uint32_t dlpHe
         DLP_LOG_ERROR(LABEL, "file size is error");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    if (read(dlpFd_, &head_, sizeof(head_)) != sizeof(head_)) {
-        DLP_LOG_ERROR(LABEL, "can not read version_ or dlpHeaderSize, %{public}s", strerror(errno));
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    if (!metaReader_->Read(&head_, sizeof(head_))) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file head");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
     if (!IsValidEnterpriseDlpHeader(head_, dlpHeaderSize)) {
@@ -333,26 +334,14 @@ int32_t DlpRawFile::ParseEnterpriseRawDlpHeader(uint64_t fileLen, uint32_t dlpHe
         return DLP_PARSE_ERROR_FD_ERROR;
     }
     uint32_t idSize = 0;
-    if (read(dlpFd_, &idSize, sizeof(uint32_t)) != sizeof(uint32_t) || idSize > dlpHeaderSize - FILE_HEAD) {
-        DLP_LOG_ERROR(LABEL, "can not read appid size , %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FD_ERROR;
-    }
-    uint8_t *buff = new (std::nothrow)uint8_t[idSize + 1];
-    if (buff == nullptr) {
-        DLP_LOG_ERROR(LABEL, "buff is null");
+    if (!metaReader_->Read(&idSize, sizeof(uint32_t)) || idSize > dlpHeaderSize - FILE_HEAD) {
+        DLP_LOG_ERROR(LABEL, "can not read appid size");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    (void)memset_s(buff, idSize + 1, 0, idSize + 1);
-    if (read(dlpFd_, buff, idSize) != idSize) {
-        delete []buff;
-        DLP_LOG_ERROR(LABEL, "can not read dlp file cert, %{public}s", strerror(errno));
+    if (!metaReader_->Read(appId_, idSize)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file appId");
         return DLP_PARSE_ERROR_FD_ERROR;
     }
-    char *char_buffer = reinterpret_cast<char *>(buff);
-    std::string str(char_buffer, idSize);
-    delete []buff;
-    buff = nullptr;
-    appId_ = str;
     return ParseEnterpriseFileId(fileLen, dlpHeaderSize - idSize - FILE_HEAD);
 }
 
@@ -369,29 +358,39 @@ int32_t DlpRawFile::CheckDlpFile()
         return DLP_PARSE_ERROR_FILE_LINKING;
     }
 
-    if (lseek(dlpFd_, 0, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "seek dlp file start failed, %{public}s", strerror(errno));
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    if (!metaReader_->IsOpen() || metaReader_->GetFileLen() > DLP_MAX_RAW_CONTENT_SIZE) {
+        DLP_LOG_ERROR(LABEL, "get file size failed");
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    uint64_t fileLen = 0;
-    int32_t ret = GetFileSize(dlpFd_, fileLen);
-    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    if (fileLen <= FILE_HEAD || fileLen > DLP_MAX_RAW_CONTENT_SIZE) {
+    uint64_t fileLen = metaReader_->GetFileLen();
+    if (fileLen <= FILE_HEAD) {
         DLP_LOG_ERROR(LABEL, "dlp file error");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
-
-    if (read(dlpFd_, &version_, sizeof(uint32_t)) != sizeof(uint32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read dlp file version_, %{public}s", strerror(errno));
+    metaReader_->Seek(0);
+    metaReader_->Prefetch({ { 0, HEAD_PREFETCH_SIZE } });
+    if (!metaReader_->Read(&version_, sizeof(uint32_t))) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file version_");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
+    // Apart from the tail maps the file is laid out as in CURRENT_VERSION.
+    hasTailMaps_ = (version_ == RAW_TAIL_MAP_VERSION);
+    if (hasTailMaps_) {
+        version_ = CURRENT_VERSION;
+    }
+    if (version_ > CURRENT_VERSION) {
+        DLP_LOG_ERROR(LABEL, "version_ > CURRENT_VERSION");
+        return DLP_PARSE_ERROR_FILE_VERSION_BIGGER_THAN_CURRENT;
+    }
     uint32_t dlpHeaderSize = 0;
 
-    if (read(dlpFd_, &dlpHeaderSize, sizeof(uint32_t)) != sizeof(uint32_t) ||
-        dlpHeaderSize < sizeof(struct DlpHeader)) {
-        DLP_LOG_ERROR(LABEL, "can not read dlp file dlpHeaderSize, %{public}s", strerror(errno));
+    if (!metaReader_->Read(&dlpHeaderSize, sizeof(uint32_t)) || dlpHeaderSize < sizeof(struct DlpHeader)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp file dlpHeaderSize");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
+    // An enterprise header may outgrow the first read.
+    metaReader_->Prefetch({ { 0, static_cast<uint64_t>(FILE_HEAD) + std::min(dlpHeaderSize, MAX_CERT_SIZE) } });
 
     if (version_ == CURRENT_VERSION && dlpHeaderSize == sizeof(struct DlpHeader)) {
         return ParseRawDlpHeader(fileLen, dlpHeaderSize);
@@ -407,16 +406,10 @@ uint32_t DlpRawFile::GetOfflineCertSize(void)
 
 int32_t DlpRawFile::WriteHmacProcess(void)
 {
-    LSEEK_AND_CHECK(dlpFd_, head_.hmacOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    uint8_t *tempBufHmacStr = new (std::nothrow) uint8_t[head_.hmacSize + 1];
-    if (tempBufHmacStr == nullptr) {
-        DLP_LOG_ERROR(LABEL, "new tempBuf failed");
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    (void)memset_s(tempBufHmacStr, head_.hmacSize + 1, 0, head_.hmacSize + 1);
-    if (read(dlpFd_, tempBufHmacStr, head_.hmacSize) != (ssize_t)head_.hmacSize) {
-        DLP_LOG_ERROR(LABEL, "can not read tempBufHmacStr, %{public}s", strerror(errno));
-        delete[] tempBufHmacStr;
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    const uint8_t* hmacStr = metaReader_->View(head_.hmacOffset, head_.hmacSize);
+    if (hmacStr == nullptr) {
+        DLP_LOG_ERROR(LABEL, "can not read hmac");
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
 
@@ -425,100 +418,42 @@ int32_t DlpRawFile::WriteHmacProcess(void)
     hmac_.data = new (std::nothrow) uint8_t[hmac_.size];
     if (hmac_.data == nullptr) {
         DLP_LOG_ERROR(LABEL, "new hmac size failed");
-        delete[] tempBufHmacStr;
         return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
     }
 
-    if (HexStringToByte((char *)tempBufHmacStr, head_.hmacSize, hmac_.data, hmac_.size) != DLP_OK) {
-        delete[] tempBufHmacStr;
+    if (HexStringToByte(reinterpret_cast<const char*>(hmacStr), head_.hmacSize, hmac_.data, hmac_.size) != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "HexStringToByte failed");
         return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    delete[] tempBufHmacStr;
     return DLP_OK;
 }
 
 int32_t DlpRawFile::ReadNickNameMask(void)
 {
-    uint8_t *tmpBuf = new (std::nothrow)uint8_t[NICK_NAME_MASK_SIZE];
-    if (tmpBuf == nullptr) {
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    if (lseek(dlpFd_, NICK_NAME_MASK_OPPOSITE, SEEK_END) == static_cast<off_t>(-1)) {
-        delete[] tmpBuf;
-        DLP_LOG_ERROR(LABEL, "lseek nickNameMask invalid");
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    if (read(dlpFd_, tmpBuf, NICK_NAME_MASK_SIZE) != NICK_NAME_MASK_SIZE) {
-        delete[] tmpBuf;
-        DLP_LOG_ERROR(LABEL, "can not read nickNameMask, %{public}s", strerror(errno));
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    DlpRawTrailer trailer;
+    if (!metaReader_->ReadTrailer(trailer)) {
+        DLP_LOG_ERROR(LABEL, "can not read nickNameMask");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
-    nickNameMask_ = std::string(tmpBuf, tmpBuf + NICK_NAME_MASK_SIZE);
-    delete[] tmpBuf;
-    return DLP_OK;
-}
-
-int32_t DlpRawFile::ReadFileId(void)
-{
-    int32_t flag = 0;
-    if (read(dlpFd_, &flag, sizeof(int32_t)) != sizeof(int32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read flag, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-    }
-    allowedOpenCount_ = 0;
-    if (flag == 1) {
-        if (read(dlpFd_, &allowedOpenCount_, sizeof(int32_t)) != sizeof(int32_t)) {
-            DLP_LOG_ERROR(LABEL, "can not read allowedOpenCount, %{public}s", strerror(errno));
-            return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-        }
-    }
-    uint8_t *tmpBuf = new (std::nothrow)uint8_t[FILEID_SIZE];
-    if (tmpBuf == nullptr) {
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    if (lseek(dlpFd_, FILEID_SIZE_OPPOSITE, SEEK_END) == static_cast<off_t>(-1)) {
-        delete[] tmpBuf;
-        DLP_LOG_ERROR(LABEL, "get fileid fileLen invalid");
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    if (read(dlpFd_, tmpBuf, FILEID_SIZE) != FILEID_SIZE) {
-        delete[] tmpBuf;
-        DLP_LOG_ERROR(LABEL, "can not read fileId, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-    }
-    fileIdPlaintext_ = std::string(tmpBuf, tmpBuf + FILEID_SIZE);
-    if (tmpBuf[0] != 0 && flag == 0) {
-        allowedOpenCount_ = 1;
-    }
-
-    delete[] tmpBuf;
+    nickNameMask_ = trailer.nickNameMask;
     return DLP_OK;
 }
 
 int32_t DlpRawFile::WriteFileIdPlaintextProcess(void)
 {
-    int32_t res = ReadNickNameMask();
-    if (res != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "ReadNickNameMask failed");
-        return res;
-    }
-    if (lseek(dlpFd_, COUNTDOWN_OPPOSITE, SEEK_END) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "get to waterConfig invalid");
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    countdown_ = 0;
-    if (read(dlpFd_, &countdown_, sizeof(int32_t)) != sizeof(int32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read countdown, %{public}s", strerror(errno));
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    DlpRawTrailer trailer;
+    if (!metaReader_->ReadTrailer(trailer)) {
+        DLP_LOG_ERROR(LABEL, "can not read raw file property");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
-    int32_t waterMarkTmp = 0;
-    if (read(dlpFd_, &waterMarkTmp, sizeof(int32_t)) != sizeof(int32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read waterMarkConfig, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-    }
-    waterMarkConfig_ = (waterMarkTmp == 1);
-    return ReadFileId();
+    nickNameMask_ = trailer.nickNameMask;
+    countdown_ = trailer.countdown;
+    waterMarkConfig_ = trailer.waterMarkConfig;
+    allowedOpenCount_ = trailer.allowedOpenCount;
+    fileIdPlaintext_ = trailer.fileIdPlaintext;
+    return DLP_OK;
 }
 
 int32_t DlpRawFile::GetRawDlpHmac(void)
@@ -533,29 +468,20 @@ int32_t DlpRawFile::GetRawDlpHmac(void)
 
 int32_t DlpRawFile::ReadContactAccountAndOfflineCert()
 {
-    if (accountType_ != ENTERPRISE_ACCOUNT) {
-        LSEEK_AND_CHECK(dlpFd_, head_.contactAccountOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_FORMAT_ERROR, LABEL);
-        uint8_t *tmpBuf = new (std::nothrow)uint8_t[head_.contactAccountSize];
-        if (tmpBuf == nullptr) {
-            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-        }
-        if (read(dlpFd_, tmpBuf, head_.contactAccountSize) != (ssize_t)head_.contactAccountSize) {
-            delete[] tmpBuf;
-            DLP_LOG_ERROR(LABEL, "can not read dlp contact account, %{public}s", strerror(errno));
-            return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-        }
-        contactAccount_ = std::string(tmpBuf, tmpBuf + head_.contactAccountSize);
-        delete[] tmpBuf;
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    if (accountType_ != ENTERPRISE_ACCOUNT &&
+        !metaReader_->ReadAt(head_.contactAccountOffset, contactAccount_, head_.contactAccountSize)) {
+        DLP_LOG_ERROR(LABEL, "can not read dlp contact account");
+        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
     if (head_.offlineCertSize != 0 && head_.offlineCertSize == head_.certSize) {
-        LSEEK_AND_CHECK(dlpFd_, head_.offlineCertOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_FORMAT_ERROR, LABEL);
         uint8_t *tmpBuf = new (std::nothrow)uint8_t[head_.offlineCertSize];
         if (tmpBuf == nullptr) {
             return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
         }
-        if (read(dlpFd_, tmpBuf, head_.offlineCertSize) != (ssize_t)head_.offlineCertSize) {
+        if (!metaReader_->ReadAt(head_.offlineCertOffset, tmpBuf, head_.offlineCertSize)) {
             delete[] tmpBuf;
-            DLP_LOG_ERROR(LABEL, "can not read dlp offlineCert, %{public}s", strerror(errno));
+            DLP_LOG_ERROR(LABEL, "can not read dlp offlineCert");
             return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
         }
         CleanBlobParam(offlineCert_);
@@ -568,18 +494,25 @@ int32_t DlpRawFile::ReadContactAccountAndOfflineCert()
 int32_t DlpRawFile::ProcessDlpFile()
 {
     std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    // The head, the hmac with the certs and the trailer are each read once, every field is parsed from memory.
+    (void)metaReader_->Open(dlpFd_);
+    Defer closeReader(nullptr, [this](...) { metaReader_->Close(); });
     int32_t ret = CheckDlpFile();
     if (ret != DLP_OK) {
         return ret;
     }
-    LSEEK_AND_CHECK(dlpFd_, head_.certOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_FORMAT_ERROR, LABEL);
+    uint64_t fileLen = metaReader_->GetFileLen();
+    metaReader_->Prefetch({ { head_.contactAccountOffset, head_.contactAccountSize },
+        { head_.hmacOffset, head_.hmacSize }, { head_.certOffset, head_.certSize },
+        { head_.offlineCertOffset, head_.offlineCertSize },
+        { fileLen - std::min<uint64_t>(fileLen, TAIL_PREFETCH_SIZE), TAIL_PREFETCH_SIZE } });
     uint8_t* buf = new (std::nothrow)uint8_t[head_.certSize];
     if (buf == nullptr) {
         return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
     }
-    if (read(dlpFd_, buf, head_.certSize) != (ssize_t)head_.certSize) {
+    if (!metaReader_->ReadAt(head_.certOffset, buf, head_.certSize)) {
         delete[] buf;
-        DLP_LOG_ERROR(LABEL, "can not read dlp file cert, %{public}s", strerror(errno));
+        DLP_LOG_ERROR(LABEL, "can not read dlp file cert");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
     CleanBlobParam(cert_);
@@ -589,7 +522,100 @@ int32_t DlpRawFile::ProcessDlpFile()
     if (ret != DLP_OK) {
         return ret;
     }
-    return GetRawDlpHmac();
+    ret = GetRawDlpHmac();
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    ret = ReadSparseMap();
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    return ReadChunkTable();
+}
+
+int32_t DlpRawFile::ReadSparseMap(void)
+{
+    sparse_->Clear();
+    if (!hasTailMaps_) {
+        return DLP_OK;
+    }
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    // The map ends right before the trailer, older files have cert padding zeros there.
+    uint64_t mapBegin = head_.certOffset + head_.certSize;
+    uint64_t mapEnd = metaReader_->GetFileLen() - std::min<uint64_t>(metaReader_->GetFileLen(),
+        DlpRawMetadataReader::TRAILER_SIZE);
+    if (mapEnd < mapBegin || mapEnd - mapBegin < DlpSparseMap::FOOTER_SIZE) {
+        return DLP_OK;
+    }
+    const uint8_t* footer = metaReader_->View(mapEnd - DlpSparseMap::FOOTER_SIZE, DlpSparseMap::FOOTER_SIZE);
+    uint32_t count = 0;
+    if (footer == nullptr || !DlpSparseMap::ParseFooter(footer, count)) {
+        return DLP_OK;
+    }
+    uint64_t regionsSize = static_cast<uint64_t>(count) * DlpSparseMap::REGION_SIZE;
+    if (mapEnd - mapBegin - DlpSparseMap::FOOTER_SIZE < regionsSize) {
+        DLP_LOG_ERROR(LABEL, "sparse map overlaps the cert");
+        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
+    }
+    const uint8_t* regions = metaReader_->View(mapEnd - DlpSparseMap::FOOTER_SIZE - regionsSize, regionsSize);
+    if (regions == nullptr || !sparse_->Decode(regions, count, head_.txtSize)) {
+        DLP_LOG_ERROR(LABEL, "sparse map is invalid");
+        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
+    }
+    return DLP_OK;
+}
+
+int32_t DlpRawFile::ReadChunkTable(void)
+{
+    chunks_->Clear();
+    if (!hasTailMaps_) {
+        return DLP_OK;
+    }
+    DlpRawMetadataReader::Scope scope(*metaReader_, dlpFd_);
+    // The table ends right before the sparse map, files never rewritten have none.
+    uint64_t tableBegin = head_.certOffset + head_.certSize;
+    uint64_t tableEnd = metaReader_->GetFileLen() - std::min<uint64_t>(metaReader_->GetFileLen(),
+        DlpRawMetadataReader::TRAILER_SIZE + sparse_->GetEncodedSize());
+    if (tableEnd < tableBegin || tableEnd - tableBegin < DlpChunkTable::FOOTER_SIZE) {
+        return DLP_OK;
+    }
+    const uint8_t* footer = metaReader_->View(tableEnd - DlpChunkTable::FOOTER_SIZE, DlpChunkTable::FOOTER_SIZE);
+    uint32_t count = 0;
+    uint32_t nextGeneration = 0;
+    if (footer == nullptr || !DlpChunkTable::ParseFooter(footer, count, nextGeneration)) {
+        return DLP_OK;
+    }
+    uint64_t runsSize = static_cast<uint64_t>(count) * DlpChunkTable::RUN_SIZE;
+    if (tableEnd - tableBegin - DlpChunkTable::FOOTER_SIZE < runsSize) {
+        DLP_LOG_ERROR(LABEL, "chunk table overlaps the cert");
+        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
+    }
+    const uint8_t* runs = (runsSize == 0) ? footer :
+        metaReader_->View(tableEnd - DlpChunkTable::FOOTER_SIZE - runsSize, runsSize);
+    if (runs == nullptr ||
+        !chunks_->Decode(runs, count, nextGeneration, DlpChunkTable::ChunkEndOf(head_.txtSize))) {
+        DLP_LOG_ERROR(LABEL, "chunk table is invalid");
+        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
+    }
+    return DLP_OK;
+}
+
+std::vector<uint8_t> DlpRawFile::EncodeTailMaps(void) const
+{
+    std::vector<uint8_t> encoded(chunks_->GetEncodedSize() + sparse_->GetEncodedSize());
+    if (chunks_->IsUsed()) {
+        chunks_->Encode(encoded.data());
+    }
+    if (!sparse_->Empty()) {
+        sparse_->Encode(encoded.data() + chunks_->GetEncodedSize());
+    }
+    return encoded;
+}
+
+// Files without tail maps keep the version older readers accept.
+uint32_t DlpRawFile::GetRawFormatVersion(void) const
+{
+    return (chunks_->IsUsed() || !sparse_->Empty()) ? RAW_TAIL_MAP_VERSION : version_;
 }
 
 int32_t DlpRawFile::SetEncryptCert(const struct DlpBlob& cert)
@@ -626,6 +652,10 @@ int32_t DlpRawFile::UpdateCertAndText(const std::vector<uint8_t>& cert, struct D
     // version 1 single file auto convert to version 2 zip file, set version
     head_.offlineCertSize = cert.size();
     head_.certSize = cert.size();
+    // a tail cut off by deferred changes is written back whole, with the new cert
+    if (tailCut_) {
+        return RebuildRawFileTail();
+    }
 
     LSEEK_AND_CHECK(dlpFd_, FILE_HEAD, SEEK_SET, DLP_PARSE_ERROR_FILE_FORMAT_ERROR, LABEL);
     if (write(dlpFd_, &head_, sizeof(struct DlpHeader)) != sizeof(struct DlpHeader)) {
@@ -637,6 +667,15 @@ int32_t DlpRawFile::UpdateCertAndText(const std::vector<uint8_t>& cert, struct D
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
 
+    // A larger cert would run into the tail maps, rewrite the whole tail so that they are shrunk as needed.
+    if (chunks_->GetEncodedSize() + sparse_->GetEncodedSize() > GetTailMapCapacity(head_.certSize)) {
+        if (ftruncate(dlpFd_, head_.hmacOffset) == -1) {
+            DLP_LOG_ERROR(LABEL, "ftruncate to remove tail failed, %{private}s", strerror(errno));
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        return RebuildRawFileTail();
+    }
+
     LSEEK_AND_CHECK(dlpFd_, head_.offlineCertOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_FORMAT_ERROR, LABEL);
     if (write(dlpFd_, certBlob.data, certBlob.size) != (ssize_t)head_.offlineCertSize) {
         DLP_LOG_ERROR(LABEL, "write dlp cert data failed, %{public}s", strerror(errno));
@@ -645,20 +684,6 @@ int32_t DlpRawFile::UpdateCertAndText(const std::vector<uint8_t>& cert, struct D
     return DLP_OK;
 }
 
-static int32_t GetFileSize(int32_t fd, uint64_t& fileLen)
-{
-    int32_t ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    off_t readLen = lseek(fd, 0, SEEK_END);
-    if (readLen == static_cast<off_t>(-1) || static_cast<uint64_t>(readLen) > DLP_MAX_RAW_CONTENT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "get file size failed, %{public}s", strerror(errno));
-    } else {
-        fileLen = static_cast<uint64_t>(readLen);
-        ret = DLP_OK;
-    }
-    LSEEK_AND_CHECK(fd, 0, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    return ret;
-}
-
 int32_t DlpRawFile::WriteRawFileProperty()
 {
     if (lseek(dlpFd_, NICK_NAME_MASK_OPPOSITE, SEEK_END) == static_cast<off_t>(-1)) {
@@ -722,6 +747,15 @@ int32_t DlpRawFile::DoWriteHmacAndCert(uint32_t hmacStrLen, std::string& hmacStr
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
     (void)memset_s(buffer, MAX_CERT_SIZE - head_.certSize, 0, MAX_CERT_SIZE - head_.certSize);
+    std::vector<uint8_t> tailMaps = EncodeTailMaps();
+    if (tailMaps.size() > GetTailMapCapacity(head_.certSize)) {
+        DLP_LOG_ERROR(LABEL, "tail maps do not fit behind the cert");
+        delete[] buffer;
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    // The maps end where WriteRawFileProperty starts the trailer.
+    std::copy(tailMaps.begin(), tailMaps.end(), buffer + (MAX_CERT_SIZE - head_.certSize -
+        DlpRawMetadataReader::TRAILER_SIZE - tailMaps.size()));
     if (write(dlpFd_, buffer, MAX_CERT_SIZE - head_.certSize) != (ssize_t)(MAX_CERT_SIZE - head_.certSize)) {
         DLP_LOG_ERROR(LABEL, "write buffer is error");
         delete[] buffer;
@@ -731,14 +765,35 @@ int32_t DlpRawFile::DoWriteHmacAndCert(uint32_t hmacStrLen, std::string& hmacStr
     return WriteRawFileProperty();
 }
 
+int32_t DlpRawFile::SetHmacAndHexString(struct DlpBlob& out, std::string& hmacStr)
+{
+    hmac_.size = out.size;
+    hmac_.data = out.data;
+    uint32_t hmacHexLen = hmac_.size * BYTE_TO_HEX_OPER_LENGTH + 1;
+    char* hmacHex = new (std::nothrow) char[hmacHexLen];
+    if (hmacHex == nullptr) {
+        DLP_LOG_ERROR(LABEL, "New memory fail");
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    int32_t ret = ByteToHexString(hmac_.data, hmac_.size, hmacHex, hmacHexLen);
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "ByteToHexString error");
+        FreeCharBuffer(hmacHex, hmacHexLen);
+        return ret;
+    }
+    hmacStr = hmacHex;
+    FreeCharBuffer(hmacHex, hmacHexLen);
+    return DLP_OK;
+}
+
 int32_t DlpRawFile::DoHmacAndCrypty(int32_t inPlainFileFd, off_t fileLen)
 {
-    if (DoDlpContentCryptyOperation(inPlainFileFd, dlpFd_, 0, fileLen, true) != DLP_OK) {
+    int32_t ret = DoDlpContentCryptyOperation(inPlainFileFd, dlpFd_, 0, fileLen, true);
+    if (ret != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "DoDlpContentCryptyOperation error");
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        return (ret == DLP_PARSE_ERROR_OPERATION_CANCELED) ? ret : DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    LSEEK_AND_CHECK(dlpFd_, head_.txtOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    DLP_LOG_DEBUG(LABEL, "begin DlpHmacEncode");
+    DLP_LOG_DEBUG(LABEL, "begin HmacContentWithIo");
     uint8_t* outBuf = new (std::nothrow) uint8_t[HMAC_SIZE];
     if (outBuf == nullptr) {
         DLP_LOG_ERROR(LABEL, "New memory fail");
@@ -748,34 +803,23 @@ int32_t DlpRawFile::DoHmacAndCrypty(int32_t inPlainFileFd, off_t fileLen)
         .size = HMAC_SIZE,
         .data = outBuf,
     };
-    int32_t ret = DlpHmacEncode(cipher_.hmacKey, dlpFd_, out);
+    ret = HmacContentWithIo(dlpFd_, head_.txtOffset, static_cast<uint64_t>(fileLen), out);
     if (ret != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "DlpHmacEncode fail: %{public}d", ret);
+        DLP_LOG_ERROR(LABEL, "HmacContentWithIo fail: %{public}d", ret);
         CleanBlobParam(out);
         return ret;
     }
-    hmac_.size = out.size;
-    hmac_.data = out.data;
-    uint32_t hmacHexLen = hmac_.size * BYTE_TO_HEX_OPER_LENGTH + 1;
-    char* hmacHex = new (std::nothrow) char[hmacHexLen];
-    if (hmacHex == nullptr) {
-        DLP_LOG_ERROR(LABEL, "New memory fail");
-        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    ret = ByteToHexString(hmac_.data, hmac_.size, hmacHex, hmacHexLen);
+    std::string hmacStr;
+    ret = SetHmacAndHexString(out, hmacStr);
     if (ret != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "ByteToHexString error");
-        FreeCharBuffer(hmacHex, hmacHexLen);
         return ret;
     }
-    std::string hmacStr = hmacHex;
-    FreeCharBuffer(hmacHex, hmacHexLen);
     uint32_t hmacStrLen = hmacStr.size();
     LSEEK_AND_CHECK(dlpFd_, head_.hmacOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
     return DoWriteHmacAndCert(hmacStrLen, hmacStr);
 }
 
-int32_t DlpRawFile::DoWriteHeaderAndContactAccount(int32_t inPlainFileFd, uint64_t fileLen)
+int32_t DlpRawFile::WriteHeaderAndContactAccount()
 {
     if (write(dlpFd_, &head_, sizeof(struct DlpHeader)) != sizeof(struct DlpHeader)) {
         DLP_LOG_ERROR(LABEL, "write dlp head failed, %{public}s", strerror(errno));
@@ -816,26 +860,30 @@ int32_t DlpRawFile::DoWriteHeaderAndContactAccount(int32_t inPlainFileFd, uint64
             return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
         }
     }
+    return DLP_OK;
+}
+
+int32_t DlpRawFile::DoWriteHeaderAndContactAccount(int32_t inPlainFileFd, uint64_t fileLen)
+{
+    int32_t ret = WriteHeaderAndContactAccount();
+    if (ret != DLP_OK) {
+        return ret;
+    }
     DLP_LOG_DEBUG(LABEL, "begin DoHmacAndCrypty");
     return DoHmacAndCrypty(inPlainFileFd, fileLen);
 }
 
-int32_t DlpRawFile::GenFileInRaw(int32_t inPlainFileFd)
+int32_t DlpRawFile::PrepareRawHead(uint64_t txtSize)
 {
-    off_t fileLen = lseek(inPlainFileFd, 0, SEEK_END);
-    if (fileLen == static_cast<off_t>(-1) || static_cast<uint64_t>(fileLen) > DLP_MAX_RAW_CONTENT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "can not get dlp file len, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
+    sparse_->Clear();
+    chunks_->Clear();
     if (accountType_ == ENTERPRISE_ACCOUNT) {
-        eventId_ = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>
-            (std::chrono::system_clock::now().time_since_epoch()).count());
         head_.contactAccountSize = 0;
         head_.contactAccountOffset = FILE_HEAD + sizeof(DlpHeader) + appId_.size() +
             fileId_.size() + eventId_.size() + ENTERPRISE_INFO_SIZE;
         head_.txtOffset = head_.contactAccountOffset + head_.contactAccountSize;
     }
-    head_.txtSize = static_cast<uint64_t>(fileLen);
+    head_.txtSize = txtSize;
     head_.hmacOffset = head_.txtOffset + head_.txtSize;
     head_.hmacSize = HMAC_SIZE * BYTE_TO_HEX_OPER_LENGTH;
     head_.certOffset = head_.hmacOffset + head_.hmacSize;
@@ -848,23 +896,24 @@ int32_t DlpRawFile::GenFileInRaw(int32_t inPlainFileFd)
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
     head_.fileType = iter->second;
+    return DLP_OK;
+}
+
+int32_t DlpRawFile::WriteRawFilePrefix()
+{
     // clean dlpFile
     if (ftruncate(dlpFd_, 0) == -1) {
         DLP_LOG_ERROR(LABEL, "truncate dlp file to zero failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
 
-    if (lseek(inPlainFileFd, 0, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "seek plain file start failed, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-
     if (lseek(dlpFd_, 0, SEEK_SET) == static_cast<off_t>(-1)) {
         DLP_LOG_ERROR(LABEL, "seek dlp file start failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
 
-    if (write(dlpFd_, &version_, sizeof(uint32_t)) != sizeof(uint32_t)) {
+    uint32_t version = GetRawFormatVersion();
+    if (write(dlpFd_, &version, sizeof(uint32_t)) != sizeof(uint32_t)) {
         DLP_LOG_ERROR(LABEL, "write dlp dlpHeaderSize failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
@@ -874,6 +923,38 @@ int32_t DlpRawFile::GenFileInRaw(int32_t inPlainFileFd)
         DLP_LOG_ERROR(LABEL, "write dlp dlpHeaderSize failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
+    return DLP_OK;
+}
+
+static void GenerateEventId(std::string& eventId)
+{
+    eventId = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+int32_t DlpRawFile::GenFileInRaw(int32_t inPlainFileFd)
+{
+    off_t fileLen = lseek(inPlainFileFd, 0, SEEK_END);
+    if (fileLen == static_cast<off_t>(-1) || static_cast<uint64_t>(fileLen) > DLP_MAX_RAW_CONTENT_SIZE) {
+        DLP_LOG_ERROR(LABEL, "can not get dlp file len, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    if (accountType_ == ENTERPRISE_ACCOUNT) {
+        GenerateEventId(eventId_);
+    }
+    int32_t ret = PrepareRawHead(static_cast<uint64_t>(fileLen));
+    if (ret != DLP_OK) {
+        return ret;
+    }
+
+    if (lseek(inPlainFileFd, 0, SEEK_SET) == static_cast<off_t>(-1)) {
+        DLP_LOG_ERROR(LABEL, "seek plain file start failed, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    ret = WriteRawFilePrefix();
+    if (ret != DLP_OK) {
+        return ret;
+    }
     return DoWriteHeaderAndContactAccount(inPlainFileFd, head_.txtSize);
 }
 
@@ -894,6 +975,65 @@ int32_t DlpRawFile::GenFile(int32_t inPlainFileFd)
     return GenFileInRaw(inPlainFileFd);
 }
 
+int32_t DlpRawFile::GenFileFromSource(DlpPlainSource& source)
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    if (dlpFd_ < 0 || !IsValidCipher(cipher_.encKey, cipher_.usageSpec, cipher_.hmacKey)) {
+        DLP_LOG_ERROR(LABEL, "params is error");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    // The length is unknown up front, so HIAE (only chosen for very large media) is never picked here.
+    head_.algType = DLP_MODE_CTR;
+    if (accountType_ == ENTERPRISE_ACCOUNT) {
+        GenerateEventId(eventId_);
+    }
+    int32_t ret = PrepareRawHead(0);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    ret = WriteRawFilePrefix();
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    ret = WriteHeaderAndContactAccount();
+    if (ret != DLP_OK) {
+        return ret;
+    }
+
+    uint8_t* outBuf = new (std::nothrow) uint8_t[HMAC_SIZE];
+    if (outBuf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "New memory fail");
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    struct DlpBlob out = {
+        .size = HMAC_SIZE,
+        .data = outBuf,
+    };
+    uint64_t txtSize = 0;
+    ret = EncryptFromSource(source, dlpFd_, DLP_MAX_RAW_CONTENT_SIZE, txtSize, out);
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "EncryptFromSource fail: %{public}d", ret);
+        CleanBlobParam(out);
+        return ret;
+    }
+    // offsets behind the content are only known now, write the tail and patch the header
+    ret = PrepareRawHead(txtSize);
+    if (ret != DLP_OK) {
+        CleanBlobParam(out);
+        return ret;
+    }
+    std::string hmacStr;
+    ret = SetHmacAndHexString(out, hmacStr);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    ret = WriteRawFileTailAndHeader(hmacStr, hmacStr.size());
+    if (ret == DLP_OK) {
+        (void)fsync(dlpFd_);
+    }
+    return ret;
+}
+
 int32_t DlpRawFile::RemoveDlpPermissionInRaw(int32_t outPlainFileFd)
 {
     off_t fileLen = lseek(dlpFd_, 0, SEEK_END);
@@ -960,11 +1100,6 @@ int32_t DlpRawFile::DlpFileRead(uint64_t offset, void* buf, uint32_t size, bool&
     uint64_t prefixingSize = offset - alignOffset;
     uint64_t alignSize = size + prefixingSize;
 
-    if (lseek(opFd, head_.txtOffset + alignOffset, SEEK_SET) == -1) {
-        DLP_LOG_ERROR(LABEL, "lseek dlp file failed. %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-
     int32_t res = DecryptAndCopyData(alignSize, prefixingSize, alignOffset, buf, size);
     if (res > 0 && !hasRead) {
         int32_t ret = DlpPermissionKit::SetReadFlag(uid);
@@ -979,9 +1114,20 @@ int32_t DlpRawFile::DlpFileRead(uint64_t offset, void* buf, uint32_t size, bool&
 int32_t DlpRawFile::DecryptAndCopyData(uint64_t alignSize, uint64_t prefixingSize,
     uint64_t alignOffset, void* buf, uint32_t size)
 {
+    if (sparse_->Covers(alignOffset + prefixingSize, alignOffset + prefixingSize + size)) {
+        (void)memset_s(buf, size, 0, size);
+        return static_cast<int32_t>(size);
+    }
+    if (mapped_->IsMapped()) {
+        bool isMapped = false;
+        int32_t res = DecryptMappedData(alignOffset + prefixingSize, buf, size, isMapped);
+        if (isMapped) {
+            return res;
+        }
+    }
     auto encBuff = std::make_unique<uint8_t[]>(alignSize);
     auto outBuff = std::make_unique<uint8_t[]>(alignSize);
-    int32_t readLen = read(dlpFd_, encBuff.get(), alignSize);
+    int32_t readLen = io_->Read(dlpFd_, encBuff.get(), alignSize, head_.txtOffset + alignOffset);
     if (readLen == -1) {
         DLP_LOG_ERROR(LABEL, "read buff fail, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -993,17 +1139,13 @@ int32_t DlpRawFile::DecryptAndCopyData(uint64_t alignSize, uint64_t prefixingSiz
     uint32_t decryptLen = static_cast<uint32_t>(readLen);
     struct DlpBlob message1 = {.size = decryptLen, .data = encBuff.get()};
     struct DlpBlob message2 = {.size = decryptLen, .data = outBuff.get()};
-    int32_t res;
-    if (head_.algType == DLP_MODE_CTR) {
-        res = DoDlpBlockCryptOperation(message1, message2, alignOffset, false);
-    } else {
-        res = DoDlpHIAECryptOperation(message1, message2, alignOffset, false);
-    }
+    int32_t res = DecryptBlob(message1, message2, alignOffset);
     if (res != DLP_OK) {
         (void)memset_s(outBuff.get(), alignSize, 0, alignSize);
         DLP_LOG_ERROR(LABEL, "decrypt fail");
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
+    sparse_->ZeroHoles(alignOffset, outBuff.get(), message2.size);
 
     if (memcpy_s(buf, size, outBuff.get() + prefixingSize, message2.size - prefixingSize) != EOK) {
         (void)memset_s(outBuff.get(), alignSize, 0, alignSize);
@@ -1014,9 +1156,92 @@ int32_t DlpRawFile::DecryptAndCopyData(uint64_t alignSize, uint64_t prefixingSiz
     return static_cast<int32_t>(message2.size - prefixingSize);
 }
 
+int32_t DlpRawFile::DecryptBlob(struct DlpBlob& message1, struct DlpBlob& message2, uint64_t offset)
+{
+    if (head_.algType == DLP_MODE_CTR) {
+        return DoChunkCryptOperation(*chunks_, message1, message2, offset, false);
+    }
+    return DoDlpHIAECryptOperation(message1, message2, offset, false);
+}
+
+/*
+ * Maps the content of a file opened read only, its reads then copy the cipher text out of the mapping and decrypt
+ * it straight into the caller buffer. Files that can be written keep reading through the fd, so a write never has
+ * to be kept coherent with the mapping.
+ */
+int32_t DlpRawFile::EnableMappedRead(void)
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    if (authPerm_ != DLPFileAccess::READ_ONLY) {
+        DLP_LOG_ERROR(LABEL, "only read only files are mapped, perm %{public}d", authPerm_);
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    if (dlpFd_ < 0 || head_.txtSize == 0) {
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    if (!mapped_->Map(dlpFd_, head_.txtOffset, head_.txtSize)) {
+        DLP_LOG_INFO(LABEL, "map content failed, read through the fd, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    return DLP_OK;
+}
+
+// Reads content [offset, offset + size) from the mapping. isMapped is false if it has to be read through the fd.
+int32_t DlpRawFile::DecryptMappedData(uint64_t offset, void* buf, uint32_t size, bool& isMapped)
+{
+    uint64_t contentSize = mapped_->GetSize();
+    if (offset >= contentSize) {
+        isMapped = true;
+        return 0;
+    }
+    uint32_t readLen = static_cast<uint32_t>(std::min<uint64_t>(size, contentSize - offset));
+    uint64_t alignOffset = offset / DLP_BLOCK_SIZE * DLP_BLOCK_SIZE;
+    uint32_t prefixingSize = static_cast<uint32_t>(offset - alignOffset);
+    uint32_t cipherLen = prefixingSize + readLen;
+    if (mapCipher_.size() < cipherLen) {
+        mapCipher_.resize(cipherLen);
+    }
+    if (!mapped_->Copy(alignOffset, mapCipher_.data(), cipherLen)) {
+        DLP_LOG_ERROR(LABEL, "content shrank under the mapping, read through the fd");
+        return DLP_OK;
+    }
+    isMapped = true;
+
+    // A read starting inside a block decrypts that block aside, the rest lands in buf directly.
+    uint8_t* out = static_cast<uint8_t*>(buf);
+    uint32_t done = 0;
+    if (prefixingSize != 0) {
+        uint8_t block[DLP_BLOCK_SIZE] = { 0 };
+        uint32_t blockLen = std::min(cipherLen, DLP_BLOCK_SIZE);
+        struct DlpBlob message1 = { .size = blockLen, .data = mapCipher_.data() };
+        struct DlpBlob message2 = { .size = blockLen, .data = block };
+        int32_t res = DecryptBlob(message1, message2, alignOffset);
+        if (res == DLP_OK) {
+            done = blockLen - prefixingSize;
+            res = (memcpy_s(out, size, block + prefixingSize, done) == EOK) ? DLP_OK :
+                DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+        (void)memset_s(block, sizeof(block), 0, sizeof(block));
+        if (res != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "decrypt mapped block fail");
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+    }
+    if (done < readLen) {
+        struct DlpBlob message1 = { .size = readLen - done, .data = mapCipher_.data() + prefixingSize + done };
+        struct DlpBlob message2 = { .size = readLen - done, .data = out + done };
+        if (DecryptBlob(message1, message2, offset + done) != DLP_OK) {
+            (void)memset_s(out, size, 0, size);
+            DLP_LOG_ERROR(LABEL, "decrypt mapped data fail");
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+    }
+    sparse_->ZeroHoles(offset, out, readLen);
+    return static_cast<int32_t>(readLen);
+}
+
 int32_t DlpRawFile::ComputeContentHmac(uint64_t contentSize, std::string& hmacHexStr)
 {
-    LSEEK_AND_CHECK(dlpFd_, head_.txtOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
     uint8_t* outBuf = new (std::nothrow) uint8_t[HMAC_SIZE];
     if (outBuf == nullptr) {
         DLP_LOG_ERROR(LABEL, "New memory fail");
@@ -1026,8 +1251,8 @@ int32_t DlpRawFile::ComputeContentHmac(uint64_t contentSize, std::string& hmacHe
         .size = HMAC_SIZE,
         .data = outBuf,
     };
-    if (DlpHmacEncodeForRaw(cipher_.hmacKey, dlpFd_, contentSize, out) != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "DlpHmacEncodeForRaw fail");
+    if (HmacContentWithIo(dlpFd_, head_.txtOffset, contentSize, out, EncodeTailMaps()) != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "HmacContentWithIo fail");
         CleanBlobParam(out);
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
@@ -1037,12 +1262,20 @@ int32_t DlpRawFile::ComputeContentHmac(uint64_t contentSize, std::string& hmacHe
     }
     hmac_.size = out.size;
     hmac_.data = out.data;
- 
+    return GetHmacHexString(hmacHexStr);
+}
+
+// The hmac last computed for the content, zeros if there is none yet.
+int32_t DlpRawFile::GetHmacHexString(std::string& hmacHexStr) const
+{
+    if (hmac_.data == nullptr || hmac_.size * BYTE_TO_HEX_OPER_LENGTH != head_.hmacSize) {
+        hmacHexStr.assign(head_.hmacSize, '0');
+        return DLP_OK;
+    }
     uint32_t hmacHexLen = hmac_.size * BYTE_TO_HEX_OPER_LENGTH + 1;
     char* hmacHex = new (std::nothrow) char[hmacHexLen];
     if (hmacHex == nullptr) {
         DLP_LOG_ERROR(LABEL, "New memory fail");
-        CleanBlobParam(out);
         return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
     }
     int32_t ret = ByteToHexString(hmac_.data, hmac_.size, hmacHex, hmacHexLen);
@@ -1070,6 +1303,12 @@ int32_t DlpRawFile::WriteRawFileTailAndHeader(std::string& hmacStr, uint32_t hma
         return result;
     }
  
+    // The version follows the tail maps, so a file is upgraded by the first change that needs them.
+    uint32_t version = GetRawFormatVersion();
+    if (pwrite(dlpFd_, &version, sizeof(version), 0) != sizeof(version)) {
+        DLP_LOG_ERROR(LABEL, "write version failed, %{private}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
     if (lseek(dlpFd_, FILE_HEAD, SEEK_SET) == static_cast<off_t>(-1)) {
         DLP_LOG_ERROR(LABEL, "lseek header failed, %{private}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -1078,12 +1317,12 @@ int32_t DlpRawFile::WriteRawFileTailAndHeader(std::string& hmacStr, uint32_t hma
         DLP_LOG_ERROR(LABEL, "write header failed, %{private}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
- 
-    (void)fsync(dlpFd_);
     return DLP_OK;
 }
  
-int32_t DlpRawFile::RebuildRawFileTail()
+// Writes the tail back behind the content. Without updateHmac it keeps the hmac of older content, to be redone on
+// the commit, and the file is not synced.
+int32_t DlpRawFile::RebuildRawFileTail(bool updateHmac)
 {
     struct stat fileStat;
     int32_t ret = fstat(dlpFd_, &fileStat);
@@ -1111,9 +1350,14 @@ int32_t DlpRawFile::RebuildRawFileTail()
     head_.hmacOffset = head_.txtOffset + contentSize;
     head_.certOffset = head_.hmacOffset + head_.hmacSize;
     head_.offlineCertOffset = head_.hmacOffset + head_.hmacSize;
+    ret = FitTailMaps();
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "FitTailMaps failed");
+        return ret;
+    }
  
     std::string hmacStr;
-    ret = ComputeContentHmac(contentSize, hmacStr);
+    ret = updateHmac ? ComputeContentHmac(contentSize, hmacStr) : GetHmacHexString(hmacStr);
     if (ret != DLP_OK) {
         return ret;
     }
@@ -1122,13 +1366,77 @@ int32_t DlpRawFile::RebuildRawFileTail()
     if (ret != DLP_OK) {
         return ret;
     }
+    tailCut_ = false;
+    hmacStale_ = !updateHmac;
+    if (updateHmac) {
+        (void)fsync(dlpFd_);
+    }
     DLP_LOG_INFO(LABEL, "RebuildRawFileTail success, contentSize=%{public}s", std::to_string(contentSize).c_str());
     return DLP_OK;
 }
 
+// Only the hmac in a tail written back by a deferred change is out of date, it is computed and written in place.
+int32_t DlpRawFile::UpdateRawFileHmac()
+{
+    std::string hmacStr;
+    int32_t ret = ComputeContentHmac(head_.txtSize, hmacStr);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    if (hmacStr.size() != head_.hmacSize) {
+        DLP_LOG_ERROR(LABEL, "hmac size %{public}zu does not fit the tail", hmacStr.size());
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    LSEEK_AND_CHECK(dlpFd_, head_.hmacOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    if (write(dlpFd_, hmacStr.c_str(), hmacStr.size()) != static_cast<ssize_t>(hmacStr.size())) {
+        DLP_LOG_ERROR(LABEL, "write hmac failed, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    hmacStale_ = false;
+    (void)fsync(dlpFd_);
+    return DLP_OK;
+}
+
+int32_t DlpRawFile::CutRawFileTail()
+{
+    if (tailCut_) {
+        return DLP_OK;
+    }
+    if (ftruncate(dlpFd_, head_.hmacOffset) == -1) {
+        DLP_LOG_ERROR(LABEL, "ftruncate to remove tail failed, %{private}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    tailCut_ = true;
+    return DLP_OK;
+}
+
+// A deferred change writes the tail back as well, only computing its hmac is left to DlpFileCommit.
+int32_t DlpRawFile::FinishContentChange()
+{
+    return RebuildRawFileTail(!commitDeferred_);
+}
+
+int32_t DlpRawFile::DlpFileCommit()
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    int32_t ret = DLP_OK;
+    if (tailCut_) {
+        ret = RebuildRawFileTail();
+    } else if (hmacStale_) {
+        ret = UpdateRawFileHmac();
+    }
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Commit raw file tail failed, ret=%{public}d", ret);
+    }
+    return ret;
+}
+
 uint64_t DlpRawFile::GetFsContentSize() const
 {
     std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    if (tailCut_) {
+        return head_.txtSize;
+    }
     struct stat fileStat;
     int32_t opFd = dlpFd_;
     int32_t ret = fstat(opFd, &fileStat);
@@ -1177,7 +1485,7 @@ int32_t DlpRawFile::DecryptPrefixingData(uint32_t prefixingSize, uint64_t alignO
     if (prefixingSize == 0) {
         return DLP_OK;
     }
-    int32_t readLen = read(dlpFd_, enBuf, prefixingSize);
+    int32_t readLen = io_->Read(dlpFd_, enBuf, prefixingSize, head_.txtOffset + alignOffset);
     if (readLen == -1) {
         DLP_LOG_ERROR(LABEL, "read first block prefixing fail, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -1189,6 +1497,7 @@ int32_t DlpRawFile::DecryptPrefixingData(uint32_t prefixingSize, uint64_t alignO
         DLP_LOG_ERROR(LABEL, "decrypt appending bytes fail, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_CRYPT_FAIL;
     }
+    sparse_->ZeroHoles(alignOffset, deBuf, decryptSize);
     return DLP_OK;
 }
 
@@ -1222,13 +1531,7 @@ int32_t DlpRawFile::WriteFirstBlockData(uint64_t offset, void* buf, uint32_t siz
             break;
         }
 
-        if (lseek(dlpFd_, head_.txtOffset + alignOffset, SEEK_SET) == static_cast<off_t>(-1)) {
-            DLP_LOG_ERROR(LABEL, "lseek failed, %{public}s", strerror(errno));
-            res = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-
-        if (write(dlpFd_, enBuf, writtenSize) != (ssize_t)writtenSize) {
+        if (io_->Write(dlpFd_, enBuf, writtenSize, head_.txtOffset + alignOffset) != (ssize_t)writtenSize) {
             DLP_LOG_ERROR(LABEL, "write failed, %{public}s", strerror(errno));
             res = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
             break;
@@ -1240,16 +1543,161 @@ int32_t DlpRawFile::WriteFirstBlockData(uint64_t offset, void* buf, uint32_t siz
     return res;
 }
 
-int32_t DlpRawFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
+int32_t DlpRawFile::DoGenerationCryptOperation(struct DlpBlob& message1, struct DlpBlob& message2,
+    uint64_t offset, uint32_t generation, bool isEncrypt)
 {
-    int32_t opFd = dlpFd_;
-    uint64_t alignOffset = (offset / DLP_BLOCK_SIZE * DLP_BLOCK_SIZE);
-    if (lseek(opFd, head_.txtOffset + alignOffset, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "lseek dlp file offset %{public}s failed, %{public}s",
-            std::to_string(head_.txtOffset + offset).c_str(), strerror(errno));
+    if (generation == 0) {
+        return DoDlpBlockCryptOperation(message1, message2, offset, isEncrypt);
+    }
+    if (offset % DLP_BLOCK_SIZE != 0 || message1.data == nullptr || message1.size == 0 ||
+        message2.data == nullptr || message2.size == 0) {
+        DLP_LOG_ERROR(LABEL, "params is error");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    struct DlpUsageSpec spec;
+    if (DupUsageSpec(spec) != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "spec dup failed");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    int32_t ret = DlpCtrModeDeriveIv(spec.algParam->iv, generation);
+    if (ret == DLP_OK) {
+        DlpCtrModeIncreaeIvCounter(spec.algParam->iv, static_cast<uint32_t>(offset / DLP_BLOCK_SIZE));
+        ret = isEncrypt ? DlpOpensslAesEncrypt(&cipher_.encKey, &spec, &message1, &message2) :
+            DlpOpensslAesDecrypt(&cipher_.encKey, &spec, &message1, &message2);
+    }
+    delete[] spec.algParam->iv.data;
+    delete spec.algParam;
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "do chunk crypt fail");
+        return DLP_PARSE_ERROR_CRYPT_FAIL;
+    }
+    return DLP_OK;
+}
+
+// Crypts content at offset with one call per stretch of chunks sharing a generation in table.
+int32_t DlpRawFile::DoChunkCryptOperation(const DlpChunkTable& table, struct DlpBlob& message1,
+    struct DlpBlob& message2, uint64_t offset, bool isEncrypt)
+{
+    if (table.GetRuns().empty()) {
+        return DoDlpBlockCryptOperation(message1, message2, offset, isEncrypt);
+    }
+    if (message1.data == nullptr || message2.data == nullptr || message2.size < message1.size) {
+        DLP_LOG_ERROR(LABEL, "params is error");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    uint32_t done = 0;
+    while (done < message1.size) {
+        uint64_t pos = offset + done;
+        uint32_t chunk = DlpChunkTable::ChunkOf(pos);
+        uint64_t stretchEnd = static_cast<uint64_t>(table.GetGenerationEnd(chunk)) * DlpChunkTable::CHUNK_SIZE;
+        uint32_t len = static_cast<uint32_t>(std::min<uint64_t>(stretchEnd - pos, message1.size - done));
+        struct DlpBlob in = { .size = len, .data = message1.data + done };
+        struct DlpBlob out = { .size = len, .data = message2.data + done };
+        int32_t ret = DoGenerationCryptOperation(in, out, pos, table.GetGeneration(chunk), isEncrypt);
+        if (ret != DLP_OK) {
+            return ret;
+        }
+        done += len;
+    }
+    return DLP_OK;
+}
+
+// The tail has been cut off by the caller, the file ends with the content.
+int32_t DlpRawFile::GetCutContentSize(uint64_t& contentSize) const
+{
+    struct stat fileStat;
+    if (fstat(dlpFd_, &fileStat) != 0 || static_cast<uint64_t>(fileStat.st_size) < head_.txtOffset) {
+        DLP_LOG_ERROR(LABEL, "get content size failed, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    contentSize = static_cast<uint64_t>(fileStat.st_size) - head_.txtOffset;
+    return DLP_OK;
+}
+
+// Plain content [offset, offset + size), offset is DLP_BLOCK_SIZE aligned and the range lies in the content.
+int32_t DlpRawFile::DecryptContent(const DlpChunkTable& table, uint64_t offset, uint8_t* enBuf, uint8_t* deBuf,
+    uint32_t size)
+{
+    if (io_->Read(dlpFd_, enBuf, size, head_.txtOffset + offset) != static_cast<ssize_t>(size)) {
+        DLP_LOG_ERROR(LABEL, "read content fail, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    struct DlpBlob message1 = { .size = size, .data = enBuf };
+    struct DlpBlob message2 = { .size = size, .data = deBuf };
+    int32_t ret = DoChunkCryptOperation(table, message1, message2, offset, false);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    sparse_->ZeroHoles(offset, deBuf, size);
+    return DLP_OK;
+}
+
+/*
+ * Re-encrypts the chunks touched by the write with a generation they have not used. Only the bytes around the
+ * write in its first and last chunk are read back, a write of whole chunks is encrypted and written as it is.
+ */
+int32_t DlpRawFile::DoChunkFileWrite(uint64_t offset, const uint8_t* buf, uint32_t size)
+{
+    uint64_t contentSize = 0;
+    if (GetCutContentSize(contentSize) != DLP_OK) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    uint64_t end = offset + size;
+    uint64_t spanStart = static_cast<uint64_t>(DlpChunkTable::ChunkOf(offset)) * DlpChunkTable::CHUNK_SIZE;
+    uint64_t spanEnd = std::min<uint64_t>(
+        static_cast<uint64_t>(DlpChunkTable::ChunkEndOf(end)) * DlpChunkTable::CHUNK_SIZE, std::max(end, contentSize));
+    uint32_t spanLen = static_cast<uint32_t>(spanEnd - spanStart);
+    std::unique_ptr<uint8_t[]> enBuf(new (std::nothrow) uint8_t[spanLen]);
+    std::unique_ptr<uint8_t[]> deBuf(new (std::nothrow) uint8_t[spanLen]);
+    if (enBuf == nullptr || deBuf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "alloc write buffer fail");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    Defer p(nullptr, [&](...) { (void)memset_s(deBuf.get(), spanLen, 0, spanLen); });
+
+    uint32_t headLen = static_cast<uint32_t>(offset - spanStart);
+    if (headLen > 0 && DecryptContent(*chunks_, spanStart, enBuf.get(), deBuf.get(), headLen) != DLP_OK) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    uint64_t keepEnd = std::min(spanEnd, contentSize);
+    if (keepEnd > end) {
+        uint64_t tailStart = end / DLP_BLOCK_SIZE * DLP_BLOCK_SIZE;
+        uint32_t tailPos = static_cast<uint32_t>(tailStart - spanStart);
+        if (DecryptContent(*chunks_, tailStart, enBuf.get() + tailPos, deBuf.get() + tailPos,
+            static_cast<uint32_t>(keepEnd - tailStart)) != DLP_OK) {
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+    }
+    if (memcpy_s(deBuf.get() + headLen, spanLen - headLen, buf, size) != EOK) {
+        DLP_LOG_ERROR(LABEL, "copy write buffer failed");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+
+    DlpChunkTable before = *chunks_;
+    if (!chunks_->Renew(DlpChunkTable::ChunkOf(spanStart), DlpChunkTable::ChunkEndOf(spanEnd),
+        offset == contentSize)) {
+        DLP_LOG_ERROR(LABEL, "chunk generations are used up");
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    struct DlpBlob message1 = { .size = spanLen, .data = deBuf.get() };
+    struct DlpBlob message2 = { .size = spanLen, .data = enBuf.get() };
+    if (DoChunkCryptOperation(*chunks_, message1, message2, spanStart, true) != DLP_OK ||
+        io_->Write(dlpFd_, enBuf.get(), spanLen, head_.txtOffset + spanStart) != static_cast<ssize_t>(spanLen)) {
+        DLP_LOG_ERROR(LABEL, "write chunks failed, %{public}s", strerror(errno));
+        chunks_->RollBack(before);
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
+    sparse_->Remove(spanStart, spanEnd);
+    return static_cast<int32_t>(size);
+}
 
+int32_t DlpRawFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
+{
+    if (head_.algType == DLP_MODE_CTR) {
+        return DoChunkFileWrite(offset, static_cast<uint8_t *>(buf), size);
+    }
+    int32_t opFd = dlpFd_;
+    uint64_t alignOffset = (offset / DLP_BLOCK_SIZE * DLP_BLOCK_SIZE);
     /* write first block data, if it may be not aligned */
     int32_t writenSize = WriteFirstBlockData(offset, static_cast<uint8_t *>(buf), size);
     if (writenSize < 0) {
@@ -1257,6 +1705,7 @@ int32_t DlpRawFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
     if (static_cast<uint32_t>(writenSize) >= size) {
+        sparse_->Remove(offset, offset + static_cast<uint64_t>(writenSize));
         return writenSize;
     }
 
@@ -1279,15 +1728,122 @@ int32_t DlpRawFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         return ret;
     }
 
-    ret = write(opFd, writeBuff, restBlocksSize);
+    ret = io_->Write(opFd, writeBuff, restBlocksSize, head_.txtOffset + alignOffset + DLP_BLOCK_SIZE);
     delete[] writeBuff;
     if (ret != static_cast<int32_t>(restBlocksSize)) {
         DLP_LOG_ERROR(LABEL, "write buff failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
+    sparse_->Remove(offset, offset + size);
     return ret + static_cast<int32_t>(writenSize);
 }
 
+int32_t DlpRawFile::FillHoleData(uint64_t holeStart, uint64_t holeSize)
+{
+    if (holeSize < SPARSE_MIN_HOLE_SIZE) {
+        return DlpFile::FillHoleData(holeStart, holeSize);
+    }
+    // The caller has cut the tail off, so the file ends at holeStart and growing it leaves a filesystem hole.
+    DLP_LOG_INFO(LABEL, "Leave a sparse hole, hole start %{public}s size %{public}s",
+        std::to_string(holeStart).c_str(), std::to_string(holeSize).c_str());
+    if (ftruncate(dlpFd_, static_cast<off_t>(head_.txtOffset + holeStart + holeSize)) == -1) {
+        DLP_LOG_ERROR(LABEL, "ftruncate to grow content failed, %{private}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    sparse_->Add(holeStart, holeStart + holeSize);
+    return DLP_OK;
+}
+
+/*
+ * Moves chunks [first, end) to one new generation. Chunks wholly inside a hole read as zeros whatever their
+ * generation, they are only written, as encrypted zeros, when fillHoles is set.
+ */
+int32_t DlpRawFile::ReencryptChunks(uint32_t first, uint32_t end, bool fillHoles)
+{
+    uint64_t contentSize = 0;
+    if (GetCutContentSize(contentSize) != DLP_OK) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    uint64_t start = static_cast<uint64_t>(first) * DlpChunkTable::CHUNK_SIZE;
+    uint64_t stop = std::min<uint64_t>(static_cast<uint64_t>(end) * DlpChunkTable::CHUNK_SIZE, contentSize);
+    std::unique_ptr<uint8_t[]> enBuf(new (std::nothrow) uint8_t[DLP_BUFF_LEN]);
+    std::unique_ptr<uint8_t[]> deBuf(new (std::nothrow) uint8_t[DLP_BUFF_LEN]);
+    if (enBuf == nullptr || deBuf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "alloc reencrypt buffer fail");
+        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    Defer p(nullptr, [&](...) { (void)memset_s(deBuf.get(), DLP_BUFF_LEN, 0, DLP_BUFF_LEN); });
+    DlpChunkTable before = *chunks_;
+    if (!chunks_->Renew(first, end, false)) {
+        DLP_LOG_ERROR(LABEL, "chunk generations are used up");
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    for (uint64_t pos = start; pos < stop; pos += DLP_BUFF_LEN) {
+        uint32_t len = static_cast<uint32_t>(std::min<uint64_t>(DLP_BUFF_LEN, stop - pos));
+        struct DlpBlob message1 = { .size = len, .data = deBuf.get() };
+        struct DlpBlob message2 = { .size = len, .data = enBuf.get() };
+        if (DecryptContent(before, pos, enBuf.get(), deBuf.get(), len) != DLP_OK ||
+            DoChunkCryptOperation(*chunks_, message1, message2, pos, true) != DLP_OK) {
+            chunks_->RollBack(before);
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        // Stretches of chunks outside the holes are written at once.
+        uint64_t bufEnd = pos + len;
+        uint64_t writeStart = pos;
+        for (uint64_t chunkPos = pos; writeStart < bufEnd; chunkPos += DlpChunkTable::CHUNK_SIZE) {
+            uint64_t chunkEnd = std::min<uint64_t>(chunkPos + DlpChunkTable::CHUNK_SIZE, bufEnd);
+            bool inHole = !fillHoles && chunkPos < bufEnd && sparse_->Covers(chunkPos, chunkEnd);
+            if (chunkPos < bufEnd && !inHole) {
+                continue;
+            }
+            uint64_t writeEnd = std::min(chunkPos, bufEnd);
+            if (writeEnd > writeStart && io_->Write(dlpFd_, enBuf.get() + (writeStart - pos), writeEnd - writeStart,
+                head_.txtOffset + writeStart) != static_cast<ssize_t>(writeEnd - writeStart)) {
+                DLP_LOG_ERROR(LABEL, "write chunks failed, %{public}s", strerror(errno));
+                chunks_->RollBack(before);
+                return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+            }
+            sparse_->Remove(writeStart, writeEnd);
+            writeStart = std::max(chunkEnd, writeEnd);
+        }
+    }
+    return DLP_OK;
+}
+
+/*
+ * Merges chunk runs and fills the smallest holes with encrypted zeros until the chunk table and the sparse map fit
+ * in front of the trailer.
+ */
+int32_t DlpRawFile::FitTailMaps(void)
+{
+    uint32_t capacity = GetTailMapCapacity(head_.certSize);
+    while (true) {
+        bool tooManyRuns = chunks_->GetRuns().size() > DlpChunkTable::MAX_RUNS;
+        bool tooManyHoles = sparse_->GetRegions().size() > DlpSparseMap::MAX_REGIONS;
+        if (!tooManyRuns && !tooManyHoles && chunks_->GetEncodedSize() + sparse_->GetEncodedSize() <= capacity) {
+            return DLP_OK;
+        }
+        uint32_t first = 0;
+        uint32_t end = 0;
+        int32_t ret;
+        if (!tooManyHoles && chunks_->GetCheapestMerge(first, end)) {
+            ret = ReencryptChunks(first, end, false);
+        } else if (!sparse_->Empty()) {
+            // One generation for the whole hole, rather than one per piece of a plain fill.
+            DlpSparseMap::Region region = sparse_->GetRegions()[sparse_->GetSmallest()];
+            ret = (head_.algType == DLP_MODE_CTR) ? ReencryptChunks(DlpChunkTable::ChunkOf(region.start),
+                DlpChunkTable::ChunkEndOf(region.end), true) :
+                DlpFile::FillHoleData(region.start, region.end - region.start);
+        } else {
+            DLP_LOG_ERROR(LABEL, "chunk table does not fit behind the cert");
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        if (ret != DLP_OK) {
+            return ret;
+        }
+    }
+}
+
 int32_t DlpRawFile::DlpFileWrite(uint64_t offset, void* buf, uint32_t size)
 {
     std::lock_guard<std::recursive_mutex> lock(opMutex_);
@@ -1295,6 +1851,7 @@ int32_t DlpRawFile::DlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         DLP_LOG_ERROR(LABEL, "Dlp file is readonly, write failed");
         return DLP_PARSE_ERROR_FILE_READ_ONLY;
     }
+    mapped_->Unmap();
     int32_t opFd = dlpFd_;
     if (buf == nullptr || size == 0 || size > DLP_FUSE_MAX_BUFFLEN ||
         (offset >= DLP_MAX_RAW_CONTENT_SIZE - size) ||
@@ -1309,8 +1866,7 @@ int32_t DlpRawFile::DlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         std::to_string(head_.hmacOffset).c_str());
     // Always remove tail before writing to ensure RebuildRawFileTail can correctly
     // calculate contentSize from fileSize (without tail padding the size)
-    if (ftruncate(opFd, head_.hmacOffset) == -1) {
-        DLP_LOG_ERROR(LABEL, "ftruncate to remove tail failed, %{private}s", strerror(errno));
+    if (CutRawFileTail() != DLP_OK) {
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
  
@@ -1324,8 +1880,8 @@ int32_t DlpRawFile::DlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         return res;
     }
  
-    // Rebuild tail: recompute HMAC, rewrite cert+properties, update header, fsync
-    int32_t tailRes = RebuildRawFileTail();
+    // Rebuild tail: rewrite hmac+cert+properties, update header; the hmac is recomputed now or on the commit
+    int32_t tailRes = FinishContentChange();
     if (tailRes != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "RebuildRawFileTail failed");
         return tailRes;
@@ -1342,6 +1898,7 @@ int32_t DlpRawFile::Truncate(uint64_t size)
         DLP_LOG_ERROR(LABEL, "Dlp file is readonly, truncate failed");
         return DLP_PARSE_ERROR_FILE_READ_ONLY;
     }
+    mapped_->Unmap();
     int32_t opFd = dlpFd_;
     if (opFd < 0 || size >= DLP_MAX_CONTENT_SIZE) {
         DLP_LOG_ERROR(LABEL, "Param invalid");
@@ -1360,12 +1917,14 @@ int32_t DlpRawFile::Truncate(uint64_t size)
             DLP_LOG_ERROR(LABEL, "ftruncate failed, %{private}s", strerror(errno));
             return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
         }
+        tailCut_ = true;
+        sparse_->Truncate(size);
+        chunks_->Truncate(DlpChunkTable::ChunkEndOf(size));
         // Rebuild tail: recompute HMAC, rewrite cert+properties, update header, fsync
-        res = RebuildRawFileTail();
+        res = FinishContentChange();
     } else if (size > curSize) {
         // Remove tail before expanding content to avoid overwriting tail data
-        if (ftruncate(opFd, head_.hmacOffset) == -1) {
-            DLP_LOG_ERROR(LABEL, "ftruncate to remove tail failed, %{private}s", strerror(errno));
+        if (CutRawFileTail() != DLP_OK) {
             return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
         }
         res = FillHoleData(curSize, size - curSize);
@@ -1374,7 +1933,7 @@ int32_t DlpRawFile::Truncate(uint64_t size)
             return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
         }
         // Rebuild tail after expanding content
-        res = RebuildRawFileTail();
+        res = FinishContentChange();
     } else {
         DLP_LOG_INFO(LABEL, "Truncate file size equals origin file");
     }
@@ -1390,12 +1949,15 @@ int32_t DlpRawFile::Truncate(uint64_t size)
 int32_t DlpRawFile::HmacCheck()
 {
     std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    // the hmac of deferred changes is only computed on the commit
+    if (DlpFileCommit() != DLP_OK) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
     DLP_LOG_DEBUG(LABEL, "start HmacCheck, dlpVersion = %{public}d", version_);
     if (version_ < HMAC_VERSION) {
         DLP_LOG_INFO(LABEL, "no hmac check");
         return DLP_OK;
     }
-    LSEEK_AND_CHECK(dlpFd_, head_.txtOffset, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
 
     uint8_t* outBuf = new (std::nothrow) uint8_t[HMAC_SIZE];
     if (outBuf == nullptr) {
@@ -1407,13 +1969,13 @@ int32_t DlpRawFile::HmacCheck()
         .data = outBuf,
     };
 
-    DLP_LOG_DEBUG(LABEL, "start DlpHmacEncodeForRaw");
-    if (DlpHmacEncodeForRaw(cipher_.hmacKey, dlpFd_, head_.txtSize, out) != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "DlpHmacEncodeForRaw fail");
+    DLP_LOG_DEBUG(LABEL, "start HmacContentWithIo");
+    if (HmacContentWithIo(dlpFd_, head_.txtOffset, head_.txtSize, out, EncodeTailMaps()) != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "HmacContentWithIo fail");
         CleanBlobParam(out);
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    DLP_LOG_DEBUG(LABEL, "end DlpHmacEncodeForRaw");
+    DLP_LOG_DEBUG(LABEL, "end HmacContentWithIo");
 
     if ((out.size == 0 && hmac_.size == 0) ||
         (out.size == hmac_.size && CRYPTO_memcmp(hmac_.data, out.data, out.size) == 0)) {
@@ -1448,6 +2010,26 @@ int32_t DlpRawFile::setAlgType(int32_t inPlainFileFd, const std::string& realFil
     return DLP_OK;
 }
 
+int32_t DlpRawFile::PrepareHIAEEngine(void)
+{
+    if (cipher_.usageSpec.algParam == nullptr) {
+        DLP_LOG_ERROR(LABEL, "cipher is invalid");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+    const struct DlpBlob& iv = cipher_.usageSpec.algParam->iv;
+    if (hiaeEngine_ != nullptr && hiaeEngine_->Matches(cipher_.encKey, iv)) {
+        return DLP_OK;
+    }
+    if (hiaeEngine_ == nullptr) {
+        hiaeEngine_ = std::make_unique<DlpHIAEEngine>();
+    }
+    int32_t ret = hiaeEngine_->Init(cipher_.encKey, iv);
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "init HIAE engine failed, ret: %{public}d", ret);
+    }
+    return ret;
+}
+
 int32_t DlpRawFile::DoDlpHIAECryptOperation(struct DlpBlob& message1, struct DlpBlob& message2,
     uint64_t offset, bool isEncrypt)
 {
@@ -1460,37 +2042,14 @@ int32_t DlpRawFile::DoDlpHIAECryptOperation(struct DlpBlob& message1, struct Dlp
         DLP_LOG_ERROR(LABEL, "params is error");
         return DLP_PARSE_ERROR_VALUE_INVALID;
     }
-
-    uint32_t counterIndex = offset / DLP_BLOCK_SIZE;
-    struct DlpUsageSpec spec;
-    if (DupUsageSpec(spec) != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "spec dup failed");
+    if (PrepareHIAEEngine() != DLP_OK) {
         return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
     }
-    DlpCtrModeIncreaeIvCounter(spec.algParam->iv, counterIndex);
-
-    int32_t ret = DLP_OK;
-    uint32_t blockOffset = 0;
-    uint32_t blockNum = (message1.size + HIAE_BLOCK_SIZE - 1) / HIAE_BLOCK_SIZE;
-    for (uint32_t i = 0; i < blockNum; ++i) {
-        uint64_t blockLen =
-            ((message1.size - blockOffset) < HIAE_BLOCK_SIZE) ? (message1.size - blockOffset) : HIAE_BLOCK_SIZE;
-        
-        ret = isEncrypt ? DlpHIAEEncrypt(&cipher_.encKey, &spec, blockLen,
-            message1.data + blockOffset, message2.data + blockOffset)
-            : DlpHIAEDecrypt(&cipher_.encKey, &spec, blockLen,
-            message1.data + blockOffset, message2.data + blockOffset);
-        if (ret != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "do HIAE crypt operation failed, ret: %{public}d", ret);
-            break;
-        }
-
-        DlpCtrModeIncreaeIvCounter(spec.algParam->iv, HIAE_BLOCK_SIZE / DLP_BLOCK_SIZE);
-        blockOffset += blockLen;
+    int32_t ret = hiaeEngine_->Crypt(message1.data, message2.data, message1.size, offset, isEncrypt);
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "do HIAE crypt operation failed, ret: %{public}d", ret);
     }
     message2.size = message1.size;
-    delete[] spec.algParam->iv.data;
-    delete spec.algParam;
     return ret;
 }
 
@@ -1517,52 +2076,36 @@ int32_t DlpRawFile::DoDlpContentCryptyOperation(int32_t inFd, int32_t outFd, uin
     if (head_.algType == DLP_MODE_HIAE) {
         hiaeInit_ = true;
     }
-    struct DlpBlob message;
-    struct DlpBlob outMessage;
-    if (PrepareBuff(message, outMessage) != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "prepare buff failed");
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+#ifdef SUPPORT_DLP_CREDENTIAL
+    // A whole content pass is worth spreading the HIAE blocks of each window over several threads.
+    if (head_.algType == DLP_MODE_HIAE && PrepareHIAEEngine() == DLP_OK) {
+        hiaeEngine_->SetWorkers(std::thread::hardware_concurrency());
     }
-    uint64_t dlpContentOffset = inOffset;
-    int32_t ret = DLP_OK;
-    while (inOffset < inFileLen) {
-        uint32_t readLen = ((inFileLen - inOffset) < DLP_BUFF_LEN) ? (inFileLen - inOffset) : DLP_BUFF_LEN;
-        (void)memset_s(message.data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
-        (void)memset_s(outMessage.data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
-        if (read(inFd, message.data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "Read size do not equal readLen");
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
+    Defer resetWorkers(nullptr, [this](...) {
+        if (hiaeEngine_ != nullptr) {
+            hiaeEngine_->SetWorkers(1);
         }
-        message.size = readLen;
-        outMessage.size = readLen;
-        // Implicit condition: DLP_BUFF_LEN must be DLP_BLOCK_SIZE aligned
-        if (head_.algType == DLP_MODE_CTR) {
-            ret = DoDlpBlockCryptOperation(message, outMessage, inOffset - dlpContentOffset, isEncrypt);
+    });
+#endif
+    bool fromContent = !isEncrypt && inFd == dlpFd_;
+    bool zeroHoles = fromContent && !sparse_->Empty();
+    auto crypt = [this, isEncrypt, fromContent, zeroHoles](struct DlpBlob& message, struct DlpBlob& outMessage,
+        uint64_t offset) {
+        int32_t ret;
+        if (head_.algType != DLP_MODE_CTR) {
+            ret = DoDlpHIAECryptOperation(message, outMessage, offset, isEncrypt);
+        } else if (fromContent) {
+            ret = DoChunkCryptOperation(*chunks_, message, outMessage, offset, isEncrypt);
         } else {
-            ret = DoDlpHIAECryptOperation(message, outMessage, inOffset - dlpContentOffset, isEncrypt);
+            ret = DoDlpBlockCryptOperation(message, outMessage, offset, isEncrypt);
         }
-        
-        if (ret != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "do crypt operation fail");
-            break;
+        if (ret == DLP_OK && zeroHoles) {
+            sparse_->ZeroHoles(offset, outMessage.data, outMessage.size);
         }
-
-        if (write(outFd, outMessage.data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "write fd failed, %{public}s", strerror(errno));
-            if (dlpFd_ != -1 && errno == EBADF) {
-                DLP_LOG_DEBUG(LABEL, "this dlp fd is readonly, unable write.");
-                break;
-            }
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-        inOffset += readLen;
-    }
-
-    delete[] message.data;
-    delete[] outMessage.data;
-    return ret;
+        return ret;
+    };
+    // A dlp file opened read only cannot be written back, decrypting it for reading still succeeds.
+    return CryptContentWithIo(inFd, outFd, inOffset, inFileLen, crypt, dlpFd_ != -1);
 }
 }  // namespace DlpPermission
 }  // namespace Security
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_raw_metadata_reader.h"
+
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "securec.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+const uint32_t COUNTDOWN_POS = DlpRawMetadataReader::NICK_NAME_MASK_SIZE;
+const uint32_t WATERMARK_POS = COUNTDOWN_POS + sizeof(int32_t);
+const uint32_t FLAG_POS = WATERMARK_POS + sizeof(int32_t);
+const uint32_t ALLOWED_OPEN_COUNT_POS = FLAG_POS + sizeof(int32_t);
+const uint32_t FILEID_POS = DlpRawMetadataReader::TRAILER_SIZE - DlpRawMetadataReader::FILEID_SIZE;
+
+int32_t LoadInt32(const uint8_t* data)
+{
+    int32_t value = 0;
+    std::copy_n(data, sizeof(int32_t), reinterpret_cast<uint8_t*>(&value));
+    return value;
+}
+} // namespace
+
+DlpRawMetadataReader::Scope::Scope(DlpRawMetadataReader& reader, int32_t fd) : reader_(reader)
+{
+    if (reader_.IsOpen() || fd < 0) {
+        return;
+    }
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    owner_ = (pos != static_cast<off_t>(-1)) && reader_.Open(fd, static_cast<uint64_t>(pos));
+}
+
+DlpRawMetadataReader::Scope::~Scope()
+{
+    if (owner_) {
+        (void)lseek(reader_.fd_, static_cast<off_t>(reader_.cursor_), SEEK_SET);
+        reader_.Close();
+    }
+}
+
+DlpRawMetadataReader::~DlpRawMetadataReader()
+{
+    Close();
+}
+
+bool DlpRawMetadataReader::Open(int32_t fd, uint64_t cursor)
+{
+    Close();
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0 || fileStat.st_size < 0) {
+        return false;
+    }
+    fd_ = fd;
+    fileLen_ = static_cast<uint64_t>(fileStat.st_size);
+    cursor_ = cursor;
+    readCount_ = 0;
+    return true;
+}
+
+void DlpRawMetadataReader::Close()
+{
+    for (auto& region : regions_) {
+        (void)memset_s(region.data.data(), region.data.size(), 0, region.data.size());
+    }
+    regions_.clear();
+    fd_ = -1;
+    fileLen_ = 0;
+    cursor_ = 0;
+}
+
+bool DlpRawMetadataReader::IsOpen() const
+{
+    return fd_ >= 0;
+}
+
+uint64_t DlpRawMetadataReader::GetFileLen() const
+{
+    return fileLen_;
+}
+
+uint64_t DlpRawMetadataReader::GetCursor() const
+{
+    return cursor_;
+}
+
+void DlpRawMetadataReader::Seek(uint64_t offset)
+{
+    cursor_ = offset;
+}
+
+uint32_t DlpRawMetadataReader::GetReadCount() const
+{
+    return readCount_;
+}
+
+void DlpRawMetadataReader::Prefetch(const std::vector<Range>& ranges)
+{
+    std::vector<Range> pending;
+    for (const auto& range : ranges) {
+        if (range.size == 0 || range.offset >= fileLen_) {
+            continue;
+        }
+        uint64_t size = std::min(range.size, fileLen_ - range.offset);
+        if (Find(range.offset, size) == nullptr) {
+            pending.push_back({ range.offset, size });
+        }
+    }
+    std::sort(pending.begin(), pending.end(),
+        [](const Range& left, const Range& right) { return left.offset < right.offset; });
+    size_t i = 0;
+    while (i < pending.size()) {
+        uint64_t begin = pending[i].offset;
+        uint64_t end = begin + pending[i].size;
+        for (++i; i < pending.size() && pending[i].offset <= end + MERGE_GAP; ++i) {
+            end = std::max(end, pending[i].offset + pending[i].size);
+        }
+        (void)Load(begin, end - begin);
+    }
+}
+
+const uint8_t* DlpRawMetadataReader::View(uint64_t offset, uint64_t size)
+{
+    if (fd_ < 0 || size == 0 || offset > fileLen_ || size > fileLen_ - offset) {
+        return nullptr;
+    }
+    const uint8_t* data = Find(offset, size);
+    return (data != nullptr) ? data : Load(offset, size);
+}
+
+bool DlpRawMetadataReader::ReadAt(uint64_t offset, void* buf, uint64_t size)
+{
+    if (size == 0) {
+        return IsOpen();
+    }
+    const uint8_t* data = View(offset, size);
+    if (data == nullptr) {
+        return false;
+    }
+    std::copy_n(data, size, static_cast<uint8_t*>(buf));
+    return true;
+}
+
+bool DlpRawMetadataReader::ReadAt(uint64_t offset, std::string& str, uint64_t size)
+{
+    if (size == 0) {
+        str.clear();
+        return IsOpen();
+    }
+    const uint8_t* data = View(offset, size);
+    if (data == nullptr) {
+        return false;
+    }
+    str.assign(reinterpret_cast<const char*>(data), size);
+    return true;
+}
+
+bool DlpRawMetadataReader::Read(void* buf, uint64_t size)
+{
+    if (!ReadAt(cursor_, buf, size)) {
+        return false;
+    }
+    cursor_ += size;
+    return true;
+}
+
+bool DlpRawMetadataReader::Read(std::string& str, uint64_t size)
+{
+    if (!ReadAt(cursor_, str, size)) {
+        return false;
+    }
+    cursor_ += size;
+    return true;
+}
+
+bool DlpRawMetadataReader::ReadTrailer(DlpRawTrailer& trailer)
+{
+    if (fileLen_ < TRAILER_SIZE) {
+        return false;
+    }
+    const uint8_t* data = View(fileLen_ - TRAILER_SIZE, TRAILER_SIZE);
+    if (data == nullptr) {
+        return false;
+    }
+    ParseTrailer(data, trailer);
+    return true;
+}
+
+void DlpRawMetadataReader::ParseTrailer(const uint8_t* data, DlpRawTrailer& trailer)
+{
+    trailer.nickNameMask.assign(reinterpret_cast<const char*>(data), NICK_NAME_MASK_SIZE);
+    trailer.countdown = LoadInt32(data + COUNTDOWN_POS);
+    trailer.waterMarkConfig = (LoadInt32(data + WATERMARK_POS) == 1);
+    int32_t flag = LoadInt32(data + FLAG_POS);
+    trailer.allowedOpenCount = (flag == 1) ? LoadInt32(data + ALLOWED_OPEN_COUNT_POS) : 0;
+    trailer.fileIdPlaintext.assign(reinterpret_cast<const char*>(data + FILEID_POS), FILEID_SIZE);
+    if (data[FILEID_POS] != 0 && flag == 0) {
+        trailer.allowedOpenCount = 1;
+    }
+}
+
+const uint8_t* DlpRawMetadataReader::Find(uint64_t offset, uint64_t size) const
+{
+    for (const auto& region : regions_) {
+        if (offset >= region.offset && offset - region.offset + size <= region.data.size()) {
+            return region.data.data() + (offset - region.offset);
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* DlpRawMetadataReader::Load(uint64_t offset, uint64_t size)
+{
+    std::vector<uint8_t> data(size);
+    readCount_++;
+    ssize_t ret = pread(fd_, data.data(), size, static_cast<off_t>(offset));
+    if (ret < 0 || static_cast<uint64_t>(ret) != size) {
+        return nullptr;
+    }
+    regions_.push_back({ offset, std::move(data) });
+    return regions_.back().data.data();
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dlp_sparse_map.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+template<typename T>
+uint8_t* Store(uint8_t* pos, T value)
+{
+    return std::copy_n(reinterpret_cast<const uint8_t*>(&value), sizeof(T), pos);
+}
+
+template<typename T>
+T Load(const uint8_t* pos)
+{
+    T value = 0;
+    std::copy_n(pos, sizeof(T), reinterpret_cast<uint8_t*>(&value));
+    return value;
+}
+} // namespace
+
+bool DlpSparseMap::Empty() const
+{
+    return regions_.empty();
+}
+
+const std::vector<DlpSparseMap::Region>& DlpSparseMap::GetRegions() const
+{
+    return regions_;
+}
+
+void DlpSparseMap::Clear()
+{
+    regions_.clear();
+}
+
+void DlpSparseMap::Add(uint64_t start, uint64_t end)
+{
+    if (start >= end) {
+        return;
+    }
+    auto first = std::lower_bound(regions_.begin(), regions_.end(), start,
+        [](const Region& region, uint64_t pos) { return region.end < pos; });
+    auto last = first;
+    while (last != regions_.end() && last->start <= end) {
+        start = std::min(start, last->start);
+        end = std::max(end, last->end);
+        ++last;
+    }
+    first = regions_.erase(first, last);
+    regions_.insert(first, { start, end });
+}
+
+void DlpSparseMap::Remove(uint64_t start, uint64_t end)
+{
+    if (start >= end) {
+        return;
+    }
+    std::vector<Region> kept;
+    kept.reserve(regions_.size() + 1);
+    for (const auto& region : regions_) {
+        if (region.end <= start || region.start >= end) {
+            kept.push_back(region);
+            continue;
+        }
+        if (region.start < start) {
+            kept.push_back({ region.start, start });
+        }
+        if (region.end > end) {
+            kept.push_back({ end, region.end });
+        }
+    }
+    regions_.swap(kept);
+}
+
+void DlpSparseMap::Truncate(uint64_t size)
+{
+    Remove(size, UINT64_MAX);
+}
+
+bool DlpSparseMap::Covers(uint64_t start, uint64_t end) const
+{
+    auto iter = std::upper_bound(regions_.begin(), regions_.end(), start,
+        [](uint64_t pos, const Region& region) { return pos < region.end; });
+    return iter != regions_.end() && iter->start <= start && end <= iter->end;
+}
+
+void DlpSparseMap::ZeroHoles(uint64_t offset, uint8_t* buf, uint64_t size) const
+{
+    auto iter = std::upper_bound(regions_.begin(), regions_.end(), offset,
+        [](uint64_t pos, const Region& region) { return pos < region.end; });
+    for (; iter != regions_.end() && iter->start < offset + size; ++iter) {
+        uint64_t begin = std::max(iter->start, offset);
+        uint64_t stop = std::min(iter->end, offset + size);
+        std::fill(buf + (begin - offset), buf + (stop - offset), 0);
+    }
+}
+
+size_t DlpSparseMap::GetSmallest() const
+{
+    return static_cast<size_t>(std::min_element(regions_.begin(), regions_.end(),
+        [](const Region& left, const Region& right) {
+            return left.end - left.start < right.end - right.start;
+        }) - regions_.begin());
+}
+
+uint32_t DlpSparseMap::GetEncodedSize() const
+{
+    return Empty() ? 0 : static_cast<uint32_t>(regions_.size()) * REGION_SIZE + FOOTER_SIZE;
+}
+
+void DlpSparseMap::Encode(uint8_t* buf) const
+{
+    uint8_t* pos = buf;
+    for (const auto& region : regions_) {
+        pos = Store(pos, region.start);
+        pos = Store(pos, region.end);
+    }
+    pos = Store(pos, static_cast<uint32_t>(regions_.size()));
+    (void)Store(pos, MAGIC);
+}
+
+bool DlpSparseMap::ParseFooter(const uint8_t* footer, uint32_t& count)
+{
+    count = Load<uint32_t>(footer);
+    return Load<uint32_t>(footer + sizeof(uint32_t)) == MAGIC && count > 0 && count <= MAX_REGIONS;
+}
+
+bool DlpSparseMap::Decode(const uint8_t* data, uint32_t count, uint64_t contentSize)
+{
+    std::vector<Region> regions;
+    regions.reserve(count);
+    uint64_t prevEnd = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        Region region = { Load<uint64_t>(data + i * REGION_SIZE),
+            Load<uint64_t>(data + i * REGION_SIZE + sizeof(uint64_t)) };
+        if (region.start >= region.end || region.end > contentSize || (i > 0 && region.start <= prevEnd)) {
+            return false;
+        }
+        prevEnd = region.end;
+        regions.push_back(region);
+    }
+    regions_.swap(regions);
+    return true;
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
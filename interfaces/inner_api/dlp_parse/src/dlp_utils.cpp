@@ -24,6 +24,7 @@
 #include "dlp_permission_log.h"
 #include "dlp_permission_public_interface.h"
 #include "dlp_file.h"
+#include "dlp_raw_metadata_reader.h"
 #include "dlp_zip.h"
 #include "parameter.h"
 #include "ipc_skeleton.h"
@@ -45,9 +46,6 @@ const std::string CACHE_PATH = "/data/storage/el2/base/files/cache/";
 const uint32_t DLP_CWD_MAX = 256;
 const uint32_t DLP_RAW_HEAD_OFFSET = 8;
 std::mutex g_fileOpLock;
-const int32_t FILEID_SIZE = 46;
-const int32_t FILEID_SIZE_OPPOSITE = -46;
-const int32_t WATERMARK_OPPOSITE = -58;
 const int32_t COUNTDOWN_FILETYPE = 10000;
 const int32_t INPUT_UDID_LEN = 65;
 const int32_t ADD_TWO = 2;
@@ -107,43 +105,29 @@ std::string DlpUtils::ToLowerString(const std::string& str)
 
 std::string DlpUtils::GetFileTypeBySuffix(const std::string& suffix, const bool isFromUriName)
 {
-    std::string lower = DlpUtils::ToLowerString(suffix);
-    if (isFromUriName) {
-        for (size_t len = MAX_REALY_TYPE_LENGTH; len >= MIN_REALY_TYPE_LENGTH; len--) {
-            if (len > lower.size()) {
-                continue;
-            }
-            std::string newStr = lower.substr(0, len);
-            auto iter = FILE_TYPE_MAP.find(newStr);
-            if (iter != FILE_TYPE_MAP.end()) {
-                return iter->second;
-            }
-        }
-    } else {
-        auto iter = FILE_TYPE_MAP.find(lower);
-        if (iter != FILE_TYPE_MAP.end()) {
-            return iter->second;
-        }
-    }
-    return DEFAULT_STRINGS;
+    const DlpFileTypeIndex& index = DlpUtils::GetFileTypeIndex();
+    const DlpFileTypeIndex::Entry* entry = isFromUriName ? index.FindPrefix(suffix, DlpFileTypeIndex::SUPPORT_DLP) :
+        index.Find(suffix, DlpFileTypeIndex::SUPPORT_DLP);
+    return (entry != nullptr) ? entry->fileType : DEFAULT_STRINGS;
 }
 
 bool DlpUtils::GetFileType(const std::string& realFileType)
 {
-    std::string lower = DlpUtils::ToLowerString(realFileType);
-    for (size_t len = MAX_REALY_TYPE_LENGTH; len >= MIN_REALY_TYPE_LENGTH; len--) {
-        if (len > lower.size()) {
-            continue;
-        }
-        std::string newStr = lower.substr(0, len);
-        if (newStr == DLP_HIAE_TYPE) {
-            DLP_LOG_DEBUG(LABEL, "the file supports the HIAE.");
-            return true;
-        }
+    if (DlpUtils::GetFileTypeIndex().FindPrefix(realFileType, DlpFileTypeIndex::HIAE) != nullptr) {
+        DLP_LOG_DEBUG(LABEL, "the file supports the HIAE.");
+        return true;
     }
     return false;
 }
 
+const DlpFileTypeIndex& DlpUtils::GetFileTypeIndex()
+{
+    static_assert(DlpFileTypeIndex::PREFIX_MIN_LEN == MIN_REALY_TYPE_LENGTH &&
+        DlpFileTypeIndex::PREFIX_MAX_LEN == MAX_REALY_TYPE_LENGTH, "prefix lengths differ from the type tables");
+    static const DlpFileTypeIndex index(FILE_TYPE_MAP, TYPE_TO_NUM_MAP, { DLP_HIAE_TYPE });
+    return index;
+}
+
 std::string DlpUtils::GetDlpFileRealSuffix(const std::string& dlpFileName, bool& isFromUriName)
 {
     uint32_t dlpSuffixLen = DLP_FILE_SUFFIXS.size();
@@ -347,12 +331,8 @@ static std::string GetGenerateInfoStr(const int32_t& fd)
 
 std::string DlpUtils::GetRealTypeWithRawFile(const int32_t& fd)
 {
-    if (lseek(fd, DLP_RAW_HEAD_OFFSET, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "file head is error: %{public}s", strerror(errno));
-        return DEFAULT_STRINGS;
-    }
     struct DlpHeader head;
-    if (read(fd, &head, sizeof(head)) != sizeof(head)) {
+    if (pread(fd, &head, sizeof(head), DLP_RAW_HEAD_OFFSET) != sizeof(head)) {
         DLP_LOG_ERROR(LABEL, "can not read file head : %{public}s", strerror(errno));
         return DEFAULT_STRINGS;
     }
@@ -371,49 +351,18 @@ std::string DlpUtils::GetRealTypeWithRawFile(const int32_t& fd)
 int32_t DlpUtils::GetRawFileAllowedOpenCount(const int32_t& fd,
     int32_t& allowedOpenCount, bool& waterMarkConfig)
 {
-    if (lseek(fd, WATERMARK_OPPOSITE, SEEK_END) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "get to waterMarkConfig invalid");
+    DlpRawMetadataReader reader;
+    if (!reader.Open(fd)) {
+        DLP_LOG_ERROR(LABEL, "get file size failed, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    int32_t waterMarkTmp = 0;
-    if (read(fd, &waterMarkTmp, sizeof(int32_t)) != sizeof(int32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read waterMarkConfig, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-    }
-    waterMarkConfig = (waterMarkTmp == 1);
-    int32_t flag = 0;
-    if (read(fd, &flag, sizeof(int32_t)) != sizeof(int32_t)) {
-        DLP_LOG_ERROR(LABEL, "can not read flag, %{public}s", strerror(errno));
+    DlpRawTrailer trailer;
+    if (!reader.ReadTrailer(trailer)) {
+        DLP_LOG_ERROR(LABEL, "can not read raw file property");
         return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
     }
-    allowedOpenCount = 0;
-    if (flag == 1) {
-        if (read(fd, &allowedOpenCount, sizeof(int32_t)) != sizeof(int32_t)) {
-            DLP_LOG_ERROR(LABEL, "can not read allowedOpenCount, %{public}s", strerror(errno));
-            return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-        }
-    }
-
-    uint8_t *fileIdtmpBuf = new (std::nothrow)uint8_t[FILEID_SIZE];
-    if (fileIdtmpBuf == nullptr) {
-        DLP_LOG_ERROR(LABEL, "fileId memory operate fail");
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    off_t fileLen = lseek(fd, FILEID_SIZE_OPPOSITE, SEEK_END);
-    if (fileLen == static_cast<off_t>(-1)) {
-        delete[] fileIdtmpBuf;
-        DLP_LOG_ERROR(LABEL, "get fileid fileLen invalid, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    if (read(fd, fileIdtmpBuf, FILEID_SIZE) != FILEID_SIZE) {
-        delete[] fileIdtmpBuf;
-        DLP_LOG_ERROR(LABEL, "can not read fileId, %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_FORMAT_ERROR;
-    }
-    if (fileIdtmpBuf[0] != 0 && flag == 0) {
-        allowedOpenCount = 1;
-    }
-    delete[] fileIdtmpBuf;
+    allowedOpenCount = trailer.allowedOpenCount;
+    waterMarkConfig = trailer.waterMarkConfig;
     return DLP_OK;
 }
 
@@ -221,6 +221,112 @@ static void FillFdOpenFileFunc(zlib_filefunc_def *pzlibFilefuncDef, int fd)
     pzlibFilefuncDef->opaque = ptrFd;
 }
 
+static void *FdOpen64FileFunc(void *opaque, const void *filename, int mode)
+{
+    return FdOpenFileFunc(opaque, static_cast<const char *>(filename), mode);
+}
+
+/*
+ * Writes a new archive into fd from its current offset on, through a dup of fd. Once the archive is closed fd is
+ * left at its end.
+ */
+zipFile CreateZipInFd(int32_t fd, void** outOpaque)
+{
+    if (outOpaque == nullptr) {
+        return nullptr;
+    }
+    *outOpaque = nullptr;
+    int *ptrFd = static_cast<int *>(malloc(sizeof(fd)));
+    if (ptrFd == nullptr) {
+        DLP_LOG_ERROR(LABEL, "malloc fail");
+        return nullptr;
+    }
+    *ptrFd = fd;
+    zlib_filefunc64_def zipFuncs;
+    fill_fopen64_filefunc(&zipFuncs);
+    zipFuncs.zopen64_file = FdOpen64FileFunc;
+    zipFuncs.zclose_file = FdCloseFileFunc;
+    zipFuncs.opaque = ptrFd;
+    zipFile zf = zipOpen2_64("fd", APPEND_STATUS_CREATE, nullptr, &zipFuncs);
+    if (zf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "zipOpen2_64 fail errno %{public}d", errno);
+        free(ptrFd);
+        return nullptr;
+    }
+    *outOpaque = ptrFd;
+    return zf;
+}
+
+int32_t CloseZipInFd(zipFile zf, void* opaque)
+{
+    int32_t res = DLP_ZIP_OK;
+    if (zipClose(zf, NULL) != ZIP_OK) {
+        DLP_LOG_ERROR(LABEL, "zipClose fail");
+        res = DLP_ZIP_FAIL;
+    }
+    free(opaque);
+    return res;
+}
+
+int32_t OpenEntryInZip(zipFile zf, const char *nameInZip)
+{
+    if (zf == nullptr || nameInZip == nullptr) {
+        DLP_LOG_ERROR(LABEL, "zf or nameInZip is nullptr.");
+        return DLP_ZIP_FAIL;
+    }
+    int32_t compressLevel = 0;
+    zip_fileinfo zi = {};
+    int32_t err = zipOpenNewFileInZip3_64(zf, nameInZip, &zi,
+        NULL, 0, NULL, 0, NULL /* comment */,
+        (compressLevel != 0) ? Z_DEFLATED : 0,
+        compressLevel, 0,
+        -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY,
+        NULL, 0, 0);
+    if (err != ZIP_OK) {
+        DLP_LOG_ERROR(LABEL, "create zip file fail err %{public}d, nameInZip %{public}s", err, nameInZip);
+        return DLP_ZIP_FAIL;
+    }
+    return DLP_ZIP_OK;
+}
+
+int32_t WriteEntryInZip(zipFile zf, const void *buf, uint32_t size)
+{
+    int32_t err = zipWriteInFileInZip(zf, buf, static_cast<unsigned>(size));
+    if (err != ZIP_OK) {
+        DLP_LOG_ERROR(LABEL, "zipWriteInFileInZip fail err %{public}d", err);
+        return DLP_ZIP_FAIL;
+    }
+    return DLP_ZIP_OK;
+}
+
+int32_t CloseEntryInZip(zipFile zf)
+{
+    if (zipCloseFileInZip(zf) != ZIP_OK) {
+        DLP_LOG_ERROR(LABEL, "zipCloseFileInZip fail");
+        return DLP_ZIP_FAIL;
+    }
+    return DLP_ZIP_OK;
+}
+
+int32_t AddBuffToOpenedZip(zipFile zf, const void *buf, uint32_t size, const char *nameInZip)
+{
+    if (buf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Buff is nullptr.");
+        return DLP_ZIP_FAIL;
+    }
+    if (OpenEntryInZip(zf, nameInZip) != DLP_ZIP_OK) {
+        return DLP_ZIP_FAIL;
+    }
+    int32_t res = WriteEntryInZip(zf, buf, size);
+    if (res == DLP_ZIP_OK && AddZeroBuffToZip(zf, nameInZip, size) != ZIP_OK) {
+        res = DLP_ZIP_FAIL;
+    }
+    if (CloseEntryInZip(zf) != DLP_ZIP_OK) {
+        res = DLP_ZIP_FAIL;
+    }
+    return res;
+}
+
 static unzFile OpenFdForUnzipping(int zipFD, void** outOpaque)
 {
     zlib_filefunc_def zipFuncs;
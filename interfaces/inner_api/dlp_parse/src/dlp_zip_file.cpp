@@ -14,15 +14,21 @@
  */
 
 #include "dlp_zip_file.h"
+#include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
 #include <fcntl.h>
 #include <string>
 #include <cstring>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
+#include "dlp_io_backend.h"
 #include "dlp_permission.h"
 #include "dlp_permission_kit.h"
 #include "dlp_permission_public_interface.h"
@@ -48,8 +54,11 @@ const std::string DLP_GENERAL_INFO = "dlp_general_info";
 const std::string DLP_CERT = "dlp_cert";
 const std::string DLP_ENC_DATA = "encrypted_data";
 const std::string DLP_OPENING_ENC_DATA = "opened_encrypted_data";
-const std::string DLP_GEN_FILE = "gen_dlp_file";
 const std::string DEFAULT_STRINGS = "";
+// Content windows in flight: one consumed while the next is read and encrypted.
+const uint32_t ENC_WINDOW_NUM = 2;
+const uint32_t ENC_SLICE_SIZE = 256 * 1024;
+const uint32_t ENC_MAX_WORKERS = 4;
 
 struct GenerInfoParams {
     bool accessFlag;
@@ -396,42 +405,6 @@ int32_t DlpZipFile::UpdateCertAndText(const std::vector<uint8_t>& cert, struct D
     return GenFileInZip(-1);
 }
 
-int32_t DlpZipFile::DoDlpContentCopyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset, uint64_t inFileLen)
-{
-    if (inOffset > inFileLen) {
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-    uint8_t *data = new (std::nothrow) uint8_t[DLP_BUFF_LEN];
-    if (data == nullptr) {
-        DLP_LOG_ERROR(LABEL, "prepare buff failed");
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-
-    int32_t ret = DLP_OK;
-    while (inOffset < inFileLen) {
-        uint32_t readLen = ((inFileLen - inOffset) < DLP_BUFF_LEN) ? (inFileLen - inOffset) : DLP_BUFF_LEN;
-        (void)memset_s(data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
-
-        if (read(inFd, data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "Read size do not equal readLen");
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-
-        if (write(outFd, data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "write fd failed, %{public}s", strerror(errno));
-            if (outFd != -1 && errno == EBADF) {
-                break;
-            }
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-        inOffset += readLen;
-    }
-    delete[] data;
-    return ret;
-}
-
 static int32_t GetFileSize(int32_t fd, uint64_t& fileLen)
 {
     int32_t ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -465,52 +438,271 @@ static int32_t SetDlpGeneralInfo(GenerInfoParams &genInfo, std::string &out)
     return GenerateDlpGeneralInfo(params, out);
 }
 
-int32_t DlpZipFile::GenEncData(int32_t inPlainFileFd)
+int32_t DlpZipFile::CreateEncDataFile(void)
 {
+    std::lock_guard<std::mutex> lock(g_fileOpLock_);
+    char cwd[DLP_CWD_MAX] = {0};
+    GETCWD_AND_CHECK(cwd, DLP_CWD_MAX, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    Defer p(nullptr, [&](...) {
+        (void)chdir(cwd);
+    });
+    CHDIR_AND_CHECK(workDir_.c_str(), DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    MKDIR_AND_CHECK(dirIndex_.c_str(), S_IRWXU, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    CHDIR_AND_CHECK(dirIndex_.c_str(), DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+
     int32_t encFile = -1;
-    if (inPlainFileFd == -1) {
-        OPEN_AND_CHECK(encFile, DLP_OPENING_ENC_DATA.c_str(), O_RDWR, 0,
-            DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    } else {
-        uint64_t fileLen = 0;
-        int32_t ret = GetFileSize(inPlainFileFd, fileLen);
-        CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    OPEN_AND_CHECK(encFile, DLP_OPENING_ENC_DATA.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+        S_IRUSR | S_IWUSR, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    if (encDataFd_ >= 0) {
+        (void)close(encDataFd_);
+    }
+    encDataFd_ = encFile;
+    return DLP_OK;
+}
 
-        OPEN_AND_CHECK(encFile, DLP_OPENING_ENC_DATA.c_str(), O_RDWR | O_CREAT | O_TRUNC,
-            S_IRUSR | S_IWUSR, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-        encDataFd_ = encFile;
-        ret = DoDlpContentCryptyOperation(inPlainFileFd, encFile, 0, fileLen, true);
-        CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-        LSEEK_AND_CHECK(encFile, 0, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+// A thread kept for a whole StreamEncData pass, running the jobs posted to it one at a time.
+class DlpZipFile::EncWorker {
+public:
+    EncWorker() : thread_([this]() { Loop(); }) {}
+
+    ~EncWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // The worker must be idle: a job is posted only after Wait returned for the previous one.
+    void Post(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = std::move(job);
+        }
+        cv_.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return job_ == nullptr; });
+    }
+
+private:
+    void Loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stop_ || job_ != nullptr; });
+            if (job_ == nullptr) {
+                return;
+            }
+            std::function<void()> job = job_;
+            lock.unlock();
+            job();
+            lock.lock();
+            job_ = nullptr;
+            cv_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::function<void()> job_ = nullptr;
+    bool stop_ = false;
+    std::thread thread_;  // declared last, so it starts with the rest initialized
+};
+
+/*
+ * Encrypts the window, the content at offset, in ENC_SLICE_SIZE slices spread over up to ENC_MAX_WORKERS threads:
+ * the calling one and the workers of the pass, which are started on first use and kept.
+ */
+int32_t DlpZipFile::EncryptEncWindow(EncWindow& window, uint64_t offset, EncWorkers& workers)
+{
+    uint32_t sliceNum = (window.size + ENC_SLICE_SIZE - 1) / ENC_SLICE_SIZE;
+    uint32_t threadNum = std::min(std::min(std::max(std::thread::hardware_concurrency(), 1U), ENC_MAX_WORKERS),
+        sliceNum);
+    uint32_t perThread = (sliceNum + threadNum - 1) / threadNum * ENC_SLICE_SIZE;
+    auto encrypt = [this, &window, offset, perThread](uint32_t index) {
+        uint32_t start = index * perThread;
+        struct DlpBlob message = { .size = std::min(perThread, window.size - start),
+            .data = window.plain.get() + start };
+        struct DlpBlob outMessage = { .size = message.size, .data = window.cipher.get() + start };
+        return DoDlpBlockCryptOperation(message, outMessage, offset + start, true);
+    };
+    uint32_t posted = 1;
+    while (posted < threadNum && posted * perThread < window.size) {
+        posted++;
+    }
+    while (workers.size() + 1 < posted) {
+        std::unique_ptr<EncWorker> worker(new (std::nothrow) EncWorker());
+        if (worker == nullptr) {
+            DLP_LOG_ERROR(LABEL, "New memory fail");
+            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+        workers.push_back(std::move(worker));
+    }
+    std::vector<int32_t> results(posted, DLP_OK);
+    for (uint32_t i = 1; i < posted; i++) {
+        workers[i - 1]->Post([&results, &encrypt, i]() { results[i] = encrypt(i); });
+    }
+    results[0] = encrypt(0);
+    for (uint32_t i = 1; i < posted; i++) {
+        workers[i - 1]->Wait();
     }
-    return encFile;
+    auto failed = std::find_if(results.begin(), results.end(), [](int32_t ret) { return ret != DLP_OK; });
+    if (failed != results.end()) {
+        DLP_LOG_ERROR(LABEL, "do crypt operation fail");
+        return *failed;
+    }
+    return DLP_OK;
 }
 
-int32_t DlpZipFile::GenerateHmacVal(int32_t encFile, struct DlpBlob& out)
+// Reads the window at offset: a new file encrypts it from source, a rewrite reads it back from the encrypted data.
+int32_t DlpZipFile::ReadEncWindow(DlpPlainSource* source, uint64_t offset, EncWindow& window, EncWorkers& workers)
 {
-    LSEEK_AND_CHECK(encFile, 0, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    int32_t fd = dup(encFile);
-    if (fd < 0) {
-        DLP_LOG_ERROR(LABEL, "dup file failed");
+    window.size = 0;
+    if (source == nullptr) {
+        ssize_t readLen = io_->Read(encDataFd_, window.cipher.get(), DLP_BUFF_LEN, offset);
+        if (readLen < 0) {
+            DLP_LOG_ERROR(LABEL, "read encrypted data failed, %{public}s", strerror(errno));
+            return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        window.size = static_cast<uint32_t>(readLen);
+        return DLP_OK;
+    }
+    int32_t ret = FillFromSource(*source, window.plain.get(), DLP_BUFF_LEN, window.size);
+    if (ret != DLP_OK || window.size == 0) {
+        return ret;
+    }
+    if (window.size > DLP_MAX_CONTENT_SIZE - offset) {
+        DLP_LOG_ERROR(LABEL, "plain source exceeds max content size");
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    uint64_t fileLen = 0;
+    return EncryptEncWindow(window, offset, workers);
+}
+
+/*
+ * Passes the encrypted content to sink one DLP_BUFF_LEN window at a time, in order, and computes hmac_ on the way
+ * if the file has none. A new file also writes each window to the opened encrypted data. The next window is read
+ * and encrypted on a worker thread while the current one is consumed, so the source is read once and the content
+ * is not read back. The threads are started once for the pass, not per window.
+ */
+int32_t DlpZipFile::StreamEncData(DlpPlainSource* source, const EncWindowSink& sink)
+{
+    bool needHmac = (version_ >= HMAC_VERSION && hmac_.size == 0);
+    void* hmacCtx = nullptr;
+    if (needHmac && DlpHmacStreamInit(cipher_.hmacKey, &hmacCtx) != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "init hmac failed");
+        return DLP_PARSE_ERROR_CRYPT_FAIL;
+    }
+    EncWindow windows[ENC_WINDOW_NUM];
+    Defer p(nullptr, [&](...) {
+        DlpHmacStreamFree(hmacCtx);
+        for (auto& window : windows) {
+            if (window.plain != nullptr) {
+                (void)memset_s(window.plain.get(), DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
+            }
+        }
+    });
+    for (auto& window : windows) {
+        window.cipher.reset(new (std::nothrow) uint8_t[DLP_BUFF_LEN]);
+        window.plain.reset((source != nullptr) ? new (std::nothrow) uint8_t[DLP_BUFF_LEN] : nullptr);
+        if (window.cipher == nullptr || (source != nullptr && window.plain == nullptr)) {
+            DLP_LOG_ERROR(LABEL, "New memory fail");
+            return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+        }
+    }
 
-    int32_t ret = GetFileSize(fd, fileLen);
+    // Declared after the windows, so the threads are stopped before the windows they use are wiped and freed.
+    EncWorkers workers;
+    std::unique_ptr<EncWorker> reader = nullptr;
+    uint64_t offset = 0;
+    uint32_t cur = 0;
+    int32_t ret = ReadEncWindow(source, offset, windows[cur], workers);
+    while (ret == DLP_OK && windows[cur].size > 0) {
+        if (source != nullptr && IsJobCancelled()) {
+            DLP_LOG_INFO(LABEL, "job cancelled");
+            return DLP_PARSE_ERROR_OPERATION_CANCELED;
+        }
+        EncWindow& window = windows[cur];
+        EncWindow& next = windows[(cur + 1) % ENC_WINDOW_NUM];
+        uint64_t nextOffset = offset + window.size;
+        int32_t nextRet = DLP_OK;
+        next.size = 0;
+        bool readAhead = (window.size == DLP_BUFF_LEN);
+        if (readAhead && reader == nullptr) {
+            reader.reset(new (std::nothrow) EncWorker());
+            if (reader == nullptr) {
+                DLP_LOG_ERROR(LABEL, "New memory fail");
+                return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
+            }
+        }
+        if (readAhead) {
+            reader->Post([this, source, nextOffset, &next, &nextRet, &workers]() {
+                nextRet = ReadEncWindow(source, nextOffset, next, workers);
+            });
+        }
+        if (source != nullptr &&
+            io_->Write(encDataFd_, window.cipher.get(), window.size, offset) != static_cast<ssize_t>(window.size)) {
+            DLP_LOG_ERROR(LABEL, "write encrypted data failed, %{public}s", strerror(errno));
+            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+        }
+        if (ret == DLP_OK && needHmac) {
+            ret = DlpHmacStreamUpdate(hmacCtx, window.cipher.get(), window.size);
+        }
+        if (ret == DLP_OK) {
+            ret = sink(window.cipher.get(), window.size);
+        }
+        if (readAhead) {
+            reader->Wait();
+        }
+        ret = (ret != DLP_OK) ? ret : nextRet;
+        offset = nextOffset;
+        cur = (cur + 1) % ENC_WINDOW_NUM;
+        if (source != nullptr) {
+            ReportJobProgress(offset);
+        }
+    }
+    if (ret != DLP_OK || !needHmac || offset == 0) {
+        // an empty content carries no hmac
+        return ret;
+    }
+    uint8_t* outBuf = new (std::nothrow) uint8_t[HMAC_SIZE];
+    if (outBuf == nullptr) {
+        DLP_LOG_ERROR(LABEL, "New memory fail");
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    struct DlpBlob out = {
+        .size = HMAC_SIZE,
+        .data = outBuf,
+    };
+    ret = DlpHmacStreamFinal(hmacCtx, out);
+    if (ret != DLP_OK) {
+        CleanBlobParam(out);
+        return ret;
+    }
+    hmac_.size = out.size;
+    hmac_.data = out.data;
+    return DLP_OK;
+}
+
+int32_t DlpZipFile::GenerateHmacVal(int32_t encFile, struct DlpBlob& out)
+{
+    uint64_t fileLen = 0;
+    int32_t ret = GetFileSize(encFile, fileLen);
     if (ret != DLP_OK) {
-        (void)close(fd);
         DLP_LOG_ERROR(LABEL, "failed to get fileLen");
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
     if (fileLen == 0) {
-        (void)close(fd);
         CleanBlobParam(out);
         return DLP_OK;
     }
-
-    ret = DlpHmacEncode(cipher_.hmacKey, fd, out);
-    (void)close(fd);
-    return ret;
+    return HmacContentWithIo(encFile, 0, fileLen, out);
 }
 
 int32_t DlpZipFile::GetHmacVal(int32_t encFile, std::string& hmacStr)
@@ -556,10 +748,10 @@ int32_t DlpZipFile::GetHmacVal(int32_t encFile, std::string& hmacStr)
     return DLP_OK;
 }
 
-int32_t DlpZipFile::AddGeneralInfoToBuff(int32_t encFile)
+int32_t DlpZipFile::GenGeneralInfo(std::string& info)
 {
     std::string hmacStr;
-    int ret = GetHmacVal(encFile, hmacStr);
+    int ret = GetHmacVal(encDataFd_, hmacStr);
     if (ret != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "GetHmacVal fail");
         return ret;
@@ -577,63 +769,77 @@ int32_t DlpZipFile::AddGeneralInfoToBuff(int32_t encFile)
         .countdown = countdown_,
         .nickNameMask = nickNameMask_,
     };
-
-    std::string ja;
-    ret = SetDlpGeneralInfo(genInfo, ja);
-    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    ret = AddBuffToZip(reinterpret_cast<const void *>(ja.c_str()), ja.size(),
-        DLP_GENERAL_INFO.c_str(), DLP_GEN_FILE.c_str());
-    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    return DLP_OK;
+    return SetDlpGeneralInfo(genInfo, info);
 }
 
-int32_t DlpZipFile::GenFileInZip(int32_t inPlainFileFd)
+/*
+ * Writes the archive straight into the dlp fd in one pass: the cert, the encrypted data streamed as it is
+ * encrypted (new file) or read back (rewrite), then the general info carrying the hmac computed on the way.
+ * A new file keeps its encrypted data opened in the work dir, the only file written besides the dlp fd.
+ */
+int32_t DlpZipFile::GenFileInZip(int32_t inPlainFileFd, DlpPlainSource* source)
 {
-    char cwd[DLP_CWD_MAX] = {0};
-    std::lock_guard<std::mutex> lock(g_fileOpLock_);
-    GETCWD_AND_CHECK(cwd, DLP_CWD_MAX, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    Defer p(nullptr, [&](...) {
-        (void)chdir(cwd);
-    });
-    CHDIR_AND_CHECK(workDir_.c_str(), DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    DlpFdPlainSource fdSource(inPlainFileFd);
     if (inPlainFileFd != -1) {
-        MKDIR_AND_CHECK(dirIndex_.c_str(), S_IRWXU, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+        uint64_t fileLen = 0;
+        int32_t ret = GetFileSize(inPlainFileFd, fileLen);
+        CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+        StartJob(fileLen);
+        source = &fdSource;
+    } else if (source != nullptr) {
+        StartJob(0);
+    }
+    if (source != nullptr) {
+        int32_t ret = CreateEncDataFile();
+        CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    } else if (encDataFd_ < 0) {
+        DLP_LOG_ERROR(LABEL, "encrypted data is not opened");
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
-    CHDIR_AND_CHECK(dirIndex_.c_str(), DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-
-    int32_t tmpFile;
-    OPEN_AND_CHECK(tmpFile, DLP_GEN_FILE.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR,
-        DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    Defer p2(nullptr, [&](...) {
-        (void)close(tmpFile);
-        (void)unlink(DLP_GEN_FILE.c_str());
-    });
-    int32_t ret = AddBuffToZip(reinterpret_cast<const void *>(cert_.data), cert_.size,
-        DLP_CERT.c_str(), DLP_GEN_FILE.c_str());
-    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
 
-    int32_t encFile = GenEncData(inPlainFileFd);
-    Defer p3(nullptr, [&](...) {
-        if (inPlainFileFd == -1) {
-            (void)close(encFile);
+    int32_t flags = fcntl(dlpFd_, F_GETFL);
+    if (flags == -1 || (static_cast<uint32_t>(flags) & O_ACCMODE) == O_RDONLY) {
+        DLP_LOG_DEBUG(LABEL, "this dlp fd is readonly, unable write.");
+        return StreamEncData(source, [](const uint8_t*, uint32_t) { return DLP_OK; });
+    }
+    LSEEK_AND_CHECK(dlpFd_, 0, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    void* opaque = nullptr;
+    zipFile zf = CreateZipInFd(dlpFd_, &opaque);
+    if (zf == nullptr) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
+    Defer p(nullptr, [&](...) {
+        if (zf != nullptr) {
+            (void)CloseZipInFd(zf, opaque);
         }
     });
-
-    ret = AddFileContextToZip(encFile, DLP_ENC_DATA.c_str(), DLP_GEN_FILE.c_str());
+    int32_t ret = AddBuffToOpenedZip(zf, reinterpret_cast<const void *>(cert_.data), cert_.size, DLP_CERT.c_str());
     CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    ret = AddGeneralInfoToBuff(encFile);
+    ret = OpenEntryInZip(zf, DLP_ENC_DATA.c_str());
+    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    ret = StreamEncData(source, [zf](const uint8_t* data, uint32_t size) {
+        return (WriteEntryInZip(zf, data, size) == 0) ? DLP_OK : DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    });
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "stream encrypted data fail, ret %{public}d", ret);
+        return ret;
+    }
+    ret = CloseEntryInZip(zf);
     CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
 
-    uint64_t zipSize = 0;
-    ret = GetFileSize(tmpFile, zipSize);
+    std::string ja;
+    ret = GenGeneralInfo(ja);
     CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    LSEEK_AND_CHECK(dlpFd_, 0, SEEK_SET, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
-    ret = DoDlpContentCopyOperation(tmpFile, dlpFd_, 0, zipSize);
+    ret = AddBuffToOpenedZip(zf, reinterpret_cast<const void *>(ja.c_str()), ja.size(), DLP_GENERAL_INFO.c_str());
+    CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
+    ret = CloseZipInFd(zf, opaque);
+    zf = nullptr;
     CHECK_RET(ret, 0, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
 
-    if (dlpFd_ != -1 && errno == EBADF) {
-        DLP_LOG_DEBUG(LABEL, "this dlp fd is readonly, unable write.");
-        return DLP_OK;
+    off_t zipSize = lseek(dlpFd_, 0, SEEK_CUR);
+    if (zipSize == static_cast<off_t>(-1)) {
+        DLP_LOG_ERROR(LABEL, "get zip size failed, %{public}s", strerror(errno));
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
     }
     FTRUNCATE_AND_CHECK(dlpFd_, zipSize, DLP_PARSE_ERROR_FILE_OPERATE_FAIL, LABEL);
 
@@ -655,6 +861,20 @@ int32_t DlpZipFile::GenFile(int32_t inPlainFileFd)
     return GenFileInZip(inPlainFileFd);
 }
 
+int32_t DlpZipFile::GenFileFromSource(DlpPlainSource& source)
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    if (dlpFd_ < 0 || !IsValidCipher(cipher_.encKey, cipher_.usageSpec, cipher_.hmacKey)) {
+        DLP_LOG_ERROR(LABEL, "params is error");
+        return DLP_PARSE_ERROR_VALUE_INVALID;
+    }
+
+    if (hmac_.size != 0) {
+        CleanBlobParam(hmac_);
+    }
+    return GenFileInZip(-1, &source);
+}
+
 int32_t DlpZipFile::RemoveDlpPermissionInZip(int32_t outPlainFileFd)
 {
     std::lock_guard<std::mutex> lock(g_fileOpLock_);
@@ -755,11 +975,6 @@ int32_t DlpZipFile::DlpFileRead(uint64_t offset, void* buf, uint32_t size, bool&
     uint64_t prefixingSize = offset - alignOffset;
     uint64_t alignSize = size + prefixingSize;
 
-    if (lseek(opFd, alignOffset, SEEK_SET) == -1) {
-        DLP_LOG_ERROR(LABEL, "lseek dlp file failed. %{public}s", strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-
     int32_t res = DecryptAndCopyData(alignSize, prefixingSize, alignOffset, buf, size);
     if (res > 0 && !hasRead) {
         int32_t ret = DlpPermissionKit::SetReadFlag(uid);
@@ -776,7 +991,7 @@ int32_t DlpZipFile::DecryptAndCopyData(uint64_t alignSize, uint64_t prefixingSiz
 {
     auto encBuff = std::make_unique<uint8_t[]>(alignSize);
     auto outBuff = std::make_unique<uint8_t[]>(alignSize);
-    int32_t readLen = read(encDataFd_, encBuff.get(), alignSize);
+    int32_t readLen = io_->Read(encDataFd_, encBuff.get(), alignSize, alignOffset);
     if (readLen == -1) {
         DLP_LOG_ERROR(LABEL, "read buff fail, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -809,7 +1024,7 @@ int32_t DlpZipFile::DecryptPrefixingData(uint32_t prefixingSize, uint64_t alignO
     if (prefixingSize == 0) {
         return DLP_OK;
     }
-    int32_t readLen = read(encDataFd_, enBuf, prefixingSize);
+    int32_t readLen = io_->Read(encDataFd_, enBuf, prefixingSize, alignOffset);
     if (readLen == -1) {
         DLP_LOG_ERROR(LABEL, "read first block prefixing fail, %{public}s", strerror(errno));
         return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
@@ -857,13 +1072,7 @@ int32_t DlpZipFile::WriteFirstBlockData(uint64_t offset, void* buf, uint32_t siz
             break;
         }
 
-        if (lseek(encDataFd_, alignOffset, SEEK_SET) == static_cast<off_t>(-1)) {
-            DLP_LOG_ERROR(LABEL, "lseek failed, %{public}s", strerror(errno));
-            res = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-
-        if (write(encDataFd_, enBuf, writtenSize) != (ssize_t)writtenSize) {
+        if (io_->Write(encDataFd_, enBuf, writtenSize, alignOffset) != (ssize_t)writtenSize) {
             DLP_LOG_ERROR(LABEL, "write failed, %{public}s", strerror(errno));
             res = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
             break;
@@ -879,12 +1088,6 @@ int32_t DlpZipFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
 {
     int32_t opFd = encDataFd_;
     uint64_t alignOffset = (offset / DLP_BLOCK_SIZE * DLP_BLOCK_SIZE);
-    if (lseek(opFd, alignOffset, SEEK_SET) == static_cast<off_t>(-1)) {
-        DLP_LOG_ERROR(LABEL, "lseek dlp file offset %{public}s failed, %{public}s",
-            std::to_string(offset).c_str(), strerror(errno));
-        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-    }
-
     /* write first block data, if it may be not aligned */
     int32_t writenSize = WriteFirstBlockData(offset, static_cast<uint8_t *>(buf), size);
     if (writenSize < 0) {
@@ -914,7 +1117,7 @@ int32_t DlpZipFile::DoDlpFileWrite(uint64_t offset, void* buf, uint32_t size)
         return ret;
     }
 
-    ret = write(opFd, writeBuff, restBlocksSize);
+    ret = io_->Write(opFd, writeBuff, restBlocksSize, alignOffset + DLP_BLOCK_SIZE);
     delete[] writeBuff;
     if (ret != static_cast<int32_t>(restBlocksSize)) {
         DLP_LOG_ERROR(LABEL, "write buff failed, %{public}s", strerror(errno));
@@ -954,7 +1157,10 @@ int32_t DlpZipFile::DlpFileWrite(uint64_t offset, void* buf, uint32_t size)
     if (hmac_.size != 0) {
         CleanBlobParam(hmac_);
     }
-    GenFileInZip(-1);
+    contentDirty_ = true;
+    if (!commitDeferred_) {
+        (void)DlpFileCommit();
+    }
     return res;
 }
 
@@ -981,14 +1187,17 @@ int32_t DlpZipFile::Truncate(uint64_t size)
     int32_t res = DLP_OK;
     if (size < curSize) {
         res = ftruncate(opFd, size);
-        GenFileInZip(-1);
+        contentDirty_ = true;
     } else if (size > curSize) {
         res = FillHoleData(curSize, size - curSize);
-        GenFileInZip(-1);
+        contentDirty_ = true;
     } else {
         DLP_LOG_INFO(LABEL, "Truncate file size equals origin file");
     }
 
+    if (!commitDeferred_) {
+        (void)DlpFileCommit();
+    }
     if (res != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Truncate file size %{public}s failed, %{public}s",
             std::to_string(size).c_str(), strerror(errno));
@@ -997,9 +1206,28 @@ int32_t DlpZipFile::Truncate(uint64_t size)
     return DLP_OK;
 }
 
+int32_t DlpZipFile::DlpFileCommit()
+{
+    std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    if (!contentDirty_) {
+        return DLP_OK;
+    }
+    int32_t ret = GenFileInZip(-1);
+    if (ret != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Commit content to zip failed, ret=%{public}d", ret);
+        return ret;
+    }
+    contentDirty_ = false;
+    return DLP_OK;
+}
+
 int32_t DlpZipFile::HmacCheck()
 {
     std::lock_guard<std::recursive_mutex> lock(opMutex_);
+    // the hmac of deferred changes is only generated with the archive
+    if (DlpFileCommit() != DLP_OK) {
+        return DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
+    }
     DLP_LOG_DEBUG(LABEL, "start HmacCheck, dlpVersion = %{public}d", version_);
     if (version_ < HMAC_VERSION) {
         DLP_LOG_INFO(LABEL, "no hmac check");
@@ -1038,45 +1266,10 @@ int32_t DlpZipFile::HmacCheck()
 int32_t DlpZipFile::DoDlpContentCryptyOperation(int32_t inFd, int32_t outFd, uint64_t inOffset,
     uint64_t inFileLen, bool isEncrypt)
 {
-    struct DlpBlob message;
-    struct DlpBlob outMessage;
-    if (PrepareBuff(message, outMessage) != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "prepare buff failed");
-        return DLP_PARSE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-
-    uint64_t dlpContentOffset = inOffset;
-    int32_t ret = DLP_OK;
-    while (inOffset < inFileLen) {
-        uint32_t readLen = ((inFileLen - inOffset) < DLP_BUFF_LEN) ? (inFileLen - inOffset) : DLP_BUFF_LEN;
-        (void)memset_s(message.data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
-        (void)memset_s(outMessage.data, DLP_BUFF_LEN, 0, DLP_BUFF_LEN);
-        if (read(inFd, message.data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "Read size do not equal readLen");
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-
-        message.size = readLen;
-        outMessage.size = readLen;
-        // Implicit condition: DLP_BUFF_LEN must be DLP_BLOCK_SIZE aligned
-        ret = DoDlpBlockCryptOperation(message, outMessage, inOffset - dlpContentOffset, isEncrypt);
-        if (ret != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "do crypt operation fail");
-            break;
-        }
-
-        if (write(outFd, outMessage.data, readLen) != (ssize_t)readLen) {
-            DLP_LOG_ERROR(LABEL, "write fd failed, %{public}s", strerror(errno));
-            ret = DLP_PARSE_ERROR_FILE_OPERATE_FAIL;
-            break;
-        }
-        inOffset += readLen;
-    }
-
-    delete[] message.data;
-    delete[] outMessage.data;
-    return ret;
+    auto crypt = [this, isEncrypt](struct DlpBlob& message, struct DlpBlob& outMessage, uint64_t offset) {
+        return DoDlpBlockCryptOperation(message, outMessage, offset, isEncrypt);
+    };
+    return CryptContentWithIo(inFd, outFd, inOffset, inFileLen, crypt, false);
 }
 }  // namespace DlpPermission
 }  // namespace Security
@@ -106,6 +106,9 @@ private:
     sptr<DlpPermissionDeathRecipient> serviceDeathObserver_ = nullptr;
     std::mutex callbackMutex_;
     std::map<std::shared_ptr<OpenDlpFileCallbackCustomize>, sptr<OpenDlpFileCallback>> callbackMap_;
+    // The service reads its config once, so its list is valid until it dies.
+    std::mutex supportFileTypeMutex_;
+    std::vector<std::string> supportFileTypes_;
 };
 }  // namespace DlpPermission
 }  // namespace Security
@@ -25,6 +25,8 @@ namespace Security {
 namespace DlpPermission {
 static const uint32_t CURRENT_VERSION = 3;
 static const uint32_t HMAC_VERSION = 3;
+// A CURRENT_VERSION raw file that keeps a chunk table or a sparse map behind its cert; older readers refuse it.
+static const uint32_t RAW_TAIL_MAP_VERSION = 4;
 
 struct GenerateInfoParams {
     uint32_t version;
@@ -29,6 +29,9 @@ public:
     virtual ~DlpSandboxChangeCallbackStub() = default;
 
     int32_t OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
+
+private:
+    int32_t OnStateChangeBatch(MessageParcel &data);
 };
 } // namespace DlpPermission
 } // namespace Security
@@ -18,6 +18,7 @@
 #include "dlp_permission_log.h"
 #include "dlp_permission_service_ipc_interface_code.h"
 #include "dlp_policy_parcel.h"
+#include "dlp_shared_memory.h"
 #include "ipc_skeleton.h"
 #include "permission_policy.h"
 
@@ -80,15 +81,11 @@ int32_t DlpPermissionAsyncStub::OnGenerateDlpCertificateStub(MessageParcel& data
         this->OnGenerateDlpCertificate(result, {});
         return DLP_OK;
     }
-    if (!data.ReadUInt8Vector(&cert)) {
-        DLP_LOG_ERROR(LABEL, "Read int8 vector fail");
-        this->OnGenerateDlpCertificate(DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL, {});
-        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
-    }
-    if (cert.size() > MAX_CERT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "cert size %{public}zu exceeds limit", cert.size());
-        this->OnGenerateDlpCertificate(DLP_SERVICE_ERROR_VALUE_INVALID, {});
-        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    int32_t res = ReadSharedBuffer(data, cert, MAX_CERT_SIZE);
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Read cert fail, res=%{public}d", res);
+        this->OnGenerateDlpCertificate(res, {});
+        return res;
     }
     this->OnGenerateDlpCertificate(result, cert);
     return DLP_OK;
@@ -126,17 +123,12 @@ int32_t DlpPermissionAsyncStub::OnParseDlpCertificateStub(MessageParcel& data, M
         return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
     }
     std::vector<uint8_t> cert;
-    if (!data.ReadUInt8Vector(&cert)) {
-        DLP_LOG_ERROR(LABEL, "Read int8 vector fail");
-        PermissionPolicy policyNull;
-        this->OnParseDlpCertificate(DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL, policyNull, {});
-        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
-    }
-    if (cert.size() > MAX_CERT_SIZE) {
-        DLP_LOG_ERROR(LABEL, "cert size %{public}zu exceeds limit", cert.size());
+    int32_t res = ReadSharedBuffer(data, cert, MAX_CERT_SIZE);
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Read cert fail, res=%{public}d", res);
         PermissionPolicy policyNull;
-        this->OnParseDlpCertificate(DLP_SERVICE_ERROR_VALUE_INVALID, policyNull, {});
-        return DLP_SERVICE_ERROR_VALUE_INVALID;
+        this->OnParseDlpCertificate(res, policyNull, {});
+        return res;
     }
     this->OnParseDlpCertificate(result, policyParcel->policyParams_, cert);
     return DLP_OK;
@@ -348,13 +348,25 @@ int32_t DlpPermissionClient::IsInDlpSandbox(bool& inSandbox)
 
 int32_t DlpPermissionClient::GetDlpSupportFileType(std::vector<std::string>& supportFileType)
 {
+    {
+        std::lock_guard<std::mutex> lock(supportFileTypeMutex_);
+        if (!supportFileTypes_.empty()) {
+            supportFileType = supportFileTypes_;
+            return DLP_OK;
+        }
+    }
     auto proxy = GetProxy(true);
     if (proxy == nullptr) {
         DLP_LOG_INFO(LABEL, "Proxy is null");
         return DLP_CALLBACK_SA_WORK_ABNORMAL;
     }
 
-    return proxy->GetDlpSupportFileType(supportFileType);
+    int32_t res = proxy->GetDlpSupportFileType(supportFileType);
+    if (res == DLP_OK && !supportFileType.empty()) {
+        std::lock_guard<std::mutex> lock(supportFileTypeMutex_);
+        supportFileTypes_ = supportFileType;
+    }
+    return res;
 }
 
 int32_t DlpPermissionClient::CreateDlpSandboxChangeCallback(
@@ -732,6 +744,10 @@ void DlpPermissionClient::LoadDlpPermissionSa()
 void DlpPermissionClient::OnRemoteDiedHandle()
 {
     DLP_LOG_ERROR(LABEL, "Remote service died");
+    {
+        std::lock_guard<std::mutex> lock(supportFileTypeMutex_);
+        supportFileTypes_.clear();
+    }
     std::unique_lock<std::mutex> lock(proxyMutex_);
     proxy_ = nullptr;
     serviceDeathObserver_ = nullptr;
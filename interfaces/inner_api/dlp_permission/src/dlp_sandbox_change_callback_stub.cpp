@@ -25,6 +25,7 @@ namespace DlpPermission {
 namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION,
     "DlpSandboxChangeCallbackStub" };
+static const uint32_t MAX_BATCH_SIZE = 1024;
 }
 
 int32_t DlpSandboxChangeCallbackStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
@@ -46,11 +47,34 @@ int32_t DlpSandboxChangeCallbackStub::OnRemoteRequest(uint32_t code, MessageParc
         }
 
         DlpSandboxStateChangeCallback(resultSptr->changeInfo);
+    } else if (msgCode == IDlpSandboxStateChangeCallback::DLP_SANDBOX_STATE_CHANGE_BATCH) {
+        return OnStateChangeBatch(data);
     } else {
         return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
     }
     return DLP_OK;
 }
+
+int32_t DlpSandboxChangeCallbackStub::OnStateChangeBatch(MessageParcel &data)
+{
+    uint32_t size = 0;
+    if (!data.ReadUint32(size) || size > MAX_BATCH_SIZE) {
+        DLP_LOG_ERROR(LABEL, "read batch size fail or size %{public}u is too large", size);
+        return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+    }
+    std::vector<DlpSandboxCallbackInfo> results;
+    results.reserve(size);
+    for (uint32_t i = 0; i < size; i++) {
+        sptr<DlpSandboxCallbackInfoParcel> resultSptr = data.ReadParcelable<DlpSandboxCallbackInfoParcel>();
+        if (resultSptr == nullptr) {
+            DLP_LOG_ERROR(LABEL, "ReadParcelable fail");
+            return DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL;
+        }
+        results.emplace_back(resultSptr->changeInfo);
+    }
+    DlpSandboxStateChangeBatchCallback(results);
+    return DLP_OK;
+}
 } // namespace DlpPermission
 } // namespace Security
 } // namespace OHOS
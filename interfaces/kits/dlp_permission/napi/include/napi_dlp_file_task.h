@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_KITS_DLP_PERMISSION_NAPI_INCLUDE_NAPI_DLP_FILE_TASK_H
+#define INTERFACES_KITS_DLP_PERMISSION_NAPI_INCLUDE_NAPI_DLP_FILE_TASK_H
+
+#include <atomic>
+#include <memory>
+#include "dlp_job_control.h"
+#include "napi/native_api.h"
+#include "napi/native_node_api.h"
+#include "napi_common.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct DlpFileTaskContext {
+    napi_env env = nullptr;
+    napi_ref progressRef = nullptr;  // only touched on the js thread
+    std::shared_ptr<DlpJobControl> jobControl = nullptr;
+    std::atomic<int64_t> lastReportMs { 0 };
+};
+
+/*
+ * JS handle of a long-running generate/recover/decrypt job: { result: Promise, on('progress'), off('progress'),
+ * cancel() }. Progress is posted to the js thread at most once per REPORT_INTERVAL_MS, plus the final report.
+ */
+class NapiDlpFileTask {
+public:
+    static napi_value CreateTask(napi_env env, const std::shared_ptr<DlpJobControl>& jobControl, napi_value promise);
+    // Queues the async work of a parsed context as a task; the context must not carry a callback.
+    // Returns nullptr with the promise rejected on failure, the caller still owns the context then.
+    static napi_value StartTask(napi_env env, CommonAsyncContext& asyncContext,
+        const std::shared_ptr<DlpJobControl>& jobControl, const char* resourceName,
+        napi_async_execute_callback execute, napi_async_complete_callback complete);
+
+private:
+    static napi_value On(napi_env env, napi_callback_info cbInfo);
+    static napi_value Off(napi_env env, napi_callback_info cbInfo);
+    static napi_value Cancel(napi_env env, napi_callback_info cbInfo);
+    static void Finalize(napi_env env, void* data, void* hint);
+    static std::shared_ptr<DlpFileTaskContext> GetTaskContext(napi_env env, napi_value thisVar);
+    static bool CheckProgressType(napi_env env, napi_value type);
+    static void PostProgress(const std::weak_ptr<DlpFileTaskContext>& weakContext, const DlpJobProgress& progress);
+    static void CallProgress(const std::shared_ptr<DlpFileTaskContext>& context, const DlpJobProgress& progress);
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif /*  INTERFACES_KITS_DLP_PERMISSION_NAPI_INCLUDE_NAPI_DLP_FILE_TASK_H */
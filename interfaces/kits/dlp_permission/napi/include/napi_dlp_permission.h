@@ -41,6 +41,7 @@ private:
     static void GenerateDlpFileExcute(napi_env env, void* data);
     static void GenerateDlpFileComplete(napi_env env, napi_status status, void* data);
     static napi_value GenerateDlpFile(napi_env env, napi_callback_info cbInfo);
+    static napi_value StartGenerateDlpFile(napi_env env, napi_callback_info cbInfo);
 
     static void OpenDlpFileExcute(napi_env env, void* data);
     static void OpenDlpFileComplete(napi_env env, napi_status status, void* data);
@@ -73,6 +74,7 @@ private:
     static void RecoverDlpFileExcute(napi_env env, void* data);
     static void RecoverDlpFileComplete(napi_env env, napi_status status, void* data);
     static napi_value RecoverDlpFile(napi_env env, napi_callback_info cbInfo);
+    static napi_value StartRecoverDlpFile(napi_env env, napi_callback_info cbInfo);
 
     static void CloseDlpFileExcute(napi_env env, void* data);
     static void CloseDlpFileComplete(napi_env env, napi_status status, void* data);
@@ -155,6 +157,7 @@ private:
     static void GenerateDlpFileForEnterpriseComplete(napi_env env, napi_status status, void* data);
 
     static napi_value DecryptDlpFile(napi_env env, napi_callback_info cbInfo);
+    static napi_value StartDecryptDlpFile(napi_env env, napi_callback_info cbInfo);
     static void DecryptDlpFileExcute(napi_env env, void* data);
     static void DecryptDlpFileComplete(napi_env env, napi_status status, void* data);
 
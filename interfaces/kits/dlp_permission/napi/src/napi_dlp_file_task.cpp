@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "napi_dlp_file_task.h"
+#include <chrono>
+#include <string>
+#include "dlp_permission.h"
+#include "dlp_permission_log.h"
+#include "napi_common.h"
+#include "napi_error_msg.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpFileTaskNapi"};
+const std::string DLP_PERMISSION_SERVICE_NAME = "dlpPermissionService";
+const std::string PROGRESS_EVENT = "progress";
+static constexpr int64_t REPORT_INTERVAL_MS = 100;
+
+static int64_t GetSteadyTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static napi_value RejectTask(napi_env env, napi_deferred deferred)
+{
+    napi_value error = GenerateBusinessError(env, ERR_JS_SYSTEM_SERVICE_EXCEPTION,
+        "The system ability works abnormally.");
+    if (error == nullptr || napi_reject_deferred(env, deferred, error) != napi_ok) {
+        DLP_LOG_ERROR(LABEL, "reject deferred failed");
+    }
+    DlpNapiThrow(env, ERR_JS_SYSTEM_SERVICE_EXCEPTION, "The system ability works abnormally.");
+    return nullptr;
+}
+}  // namespace
+
+napi_value NapiDlpFileTask::CreateTask(napi_env env, const std::shared_ptr<DlpJobControl>& jobControl,
+    napi_value promise)
+{
+    if (jobControl == nullptr) {
+        DLP_LOG_ERROR(LABEL, "job control is nullptr");
+        return nullptr;
+    }
+    auto* holder = new (std::nothrow) std::shared_ptr<DlpFileTaskContext>(std::make_shared<DlpFileTaskContext>());
+    if (holder == nullptr) {
+        DLP_LOG_ERROR(LABEL, "insufficient memory for task context!");
+        return nullptr;
+    }
+    std::unique_ptr<std::shared_ptr<DlpFileTaskContext>> holderPtr { holder };
+    (*holder)->env = env;
+    (*holder)->jobControl = jobControl;
+
+    napi_value task = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &task));
+    napi_property_descriptor properties[] = {
+        DECLARE_NAPI_FUNCTION("on", On),
+        DECLARE_NAPI_FUNCTION("off", Off),
+        DECLARE_NAPI_FUNCTION("cancel", Cancel),
+        DECLARE_NAPI_PROPERTY("result", promise),
+    };
+    NAPI_CALL(env, napi_define_properties(env, task, sizeof(properties) / sizeof(napi_property_descriptor),
+        properties));
+    NAPI_CALL(env, napi_wrap(env, task, holder, Finalize, nullptr, nullptr));
+    holderPtr.release();
+
+    std::weak_ptr<DlpFileTaskContext> weakContext = *holder;
+    jobControl->SetProgressCallback([weakContext](const DlpJobProgress& progress) {
+        PostProgress(weakContext, progress);
+    });
+    return task;
+}
+
+napi_value NapiDlpFileTask::StartTask(napi_env env, CommonAsyncContext& asyncContext,
+    const std::shared_ptr<DlpJobControl>& jobControl, const char* resourceName,
+    napi_async_execute_callback execute, napi_async_complete_callback complete)
+{
+    if (asyncContext.callbackRef != nullptr) {
+        DLP_LOG_ERROR(LABEL, "task does not accept callback");
+        ThrowParamError(env, "callback", "undefined");
+        return nullptr;
+    }
+    napi_value promise = nullptr;
+    NAPI_CALL(env, napi_create_promise(env, &asyncContext.deferred, &promise));
+    // from here on a failure settles the promise; the caller frees the context and with it any created work
+    napi_value task = CreateTask(env, jobControl, promise);
+    if (task == nullptr) {
+        DLP_LOG_ERROR(LABEL, "create task failed");
+        return RejectTask(env, asyncContext.deferred);
+    }
+    napi_value resource = nullptr;
+    if (napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH, &resource) != napi_ok ||
+        napi_create_async_work(env, nullptr, resource, execute, complete, static_cast<void*>(&asyncContext),
+            &(asyncContext.work)) != napi_ok) {
+        DLP_LOG_ERROR(LABEL, "create async work failed");
+        return RejectTask(env, asyncContext.deferred);
+    }
+    if (napi_queue_async_work_with_qos(env, asyncContext.work, napi_qos_user_initiated) != napi_ok) {
+        DLP_LOG_ERROR(LABEL, "queue async work failed");
+        return RejectTask(env, asyncContext.deferred);
+    }
+    return task;
+}
+
+void NapiDlpFileTask::Finalize(napi_env env, void* data, void* hint)
+{
+    auto* holder = reinterpret_cast<std::shared_ptr<DlpFileTaskContext>*>(data);
+    if (holder == nullptr) {
+        return;
+    }
+    if ((*holder)->progressRef != nullptr) {
+        napi_delete_reference(env, (*holder)->progressRef);
+        (*holder)->progressRef = nullptr;
+    }
+    delete holder;
+}
+
+std::shared_ptr<DlpFileTaskContext> NapiDlpFileTask::GetTaskContext(napi_env env, napi_value thisVar)
+{
+    void* data = nullptr;
+    if (napi_unwrap(env, thisVar, &data) != napi_ok || data == nullptr) {
+        DLP_LOG_ERROR(LABEL, "unwrap task context fail");
+        return nullptr;
+    }
+    return *reinterpret_cast<std::shared_ptr<DlpFileTaskContext>*>(data);
+}
+
+bool NapiDlpFileTask::CheckProgressType(napi_env env, napi_value type)
+{
+    std::string event;
+    if (!GetStringValue(env, type, event) || event != PROGRESS_EVENT) {
+        DLP_LOG_ERROR(LABEL, "event type is not progress");
+        ThrowParamError(env, "type", "'progress'");
+        return false;
+    }
+    return true;
+}
+
+napi_value NapiDlpFileTask::On(napi_env env, napi_callback_info cbInfo)
+{
+    size_t argc = PARAM_SIZE_TWO;
+    napi_value argv[PARAM_SIZE_TWO] = {nullptr};
+    napi_value thisVar = nullptr;
+    NAPI_CALL(env, napi_get_cb_info(env, cbInfo, &argc, argv, &thisVar, nullptr));
+    if (!NapiCheckArgc(env, argc, PARAM_SIZE_TWO) || !CheckProgressType(env, argv[PARAM0])) {
+        return nullptr;
+    }
+    napi_valuetype valueType = napi_undefined;
+    NAPI_CALL(env, napi_typeof(env, argv[PARAM1], &valueType));
+    if (valueType != napi_function) {
+        ThrowParamError(env, "callback", "function");
+        return nullptr;
+    }
+    auto context = GetTaskContext(env, thisVar);
+    if (context == nullptr) {
+        return nullptr;
+    }
+    if (context->progressRef != nullptr) {
+        napi_delete_reference(env, context->progressRef);
+        context->progressRef = nullptr;
+    }
+    NAPI_CALL(env, napi_create_reference(env, argv[PARAM1], 1, &context->progressRef));
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_undefined(env, &result));
+    return result;
+}
+
+napi_value NapiDlpFileTask::Off(napi_env env, napi_callback_info cbInfo)
+{
+    size_t argc = PARAM_SIZE_TWO;
+    napi_value argv[PARAM_SIZE_TWO] = {nullptr};
+    napi_value thisVar = nullptr;
+    NAPI_CALL(env, napi_get_cb_info(env, cbInfo, &argc, argv, &thisVar, nullptr));
+    if (!NapiCheckArgc(env, argc, PARAM_SIZE_ONE) || !CheckProgressType(env, argv[PARAM0])) {
+        return nullptr;
+    }
+    auto context = GetTaskContext(env, thisVar);
+    if (context == nullptr) {
+        return nullptr;
+    }
+    if (context->progressRef != nullptr) {
+        napi_delete_reference(env, context->progressRef);
+        context->progressRef = nullptr;
+    }
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_undefined(env, &result));
+    return result;
+}
+
+napi_value NapiDlpFileTask::Cancel(napi_env env, napi_callback_info cbInfo)
+{
+    napi_value thisVar = nullptr;
+    NAPI_CALL(env, napi_get_cb_info(env, cbInfo, nullptr, nullptr, &thisVar, nullptr));
+    auto context = GetTaskContext(env, thisVar);
+    if (context == nullptr) {
+        return nullptr;
+    }
+    DLP_LOG_INFO(LABEL, "cancel dlp file task");
+    context->jobControl->Cancel();
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_get_undefined(env, &result));
+    return result;
+}
+
+void NapiDlpFileTask::PostProgress(const std::weak_ptr<DlpFileTaskContext>& weakContext,
+    const DlpJobProgress& progress)
+{
+    auto context = weakContext.lock();
+    if (context == nullptr) {
+        return;
+    }
+    // a stream has no total size, the report sent when the job finishes is its last one
+    bool isLast = progress.finished;
+    int64_t now = GetSteadyTimeMs();
+    int64_t last = context->lastReportMs.load();
+    if (!isLast && (now - last < REPORT_INTERVAL_MS || !context->lastReportMs.compare_exchange_strong(last, now))) {
+        return;
+    }
+    napi_env env = context->env;
+    auto task = [weakContext, progress]() {
+        auto context = weakContext.lock();
+        if (context == nullptr) {
+            return;
+        }
+        CallProgress(context, progress);
+    };
+    if (napi_send_event(env, task, napi_eprio_immediate, DLP_PERMISSION_SERVICE_NAME.c_str()) != napi_ok) {
+        DLP_LOG_ERROR(LABEL, "Failed to SendEvent");
+    }
+}
+
+void NapiDlpFileTask::CallProgress(const std::shared_ptr<DlpFileTaskContext>& context,
+    const DlpJobProgress& progress)
+{
+    napi_env env = context->env;
+    if (context->progressRef == nullptr) {
+        return;
+    }
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(env, &scope);
+    if (scope == nullptr) {
+        DLP_LOG_ERROR(LABEL, "scope is nullptr");
+        return;
+    }
+    napi_value progressJs = nullptr;
+    napi_value processedJs = nullptr;
+    napi_value totalJs = nullptr;
+    napi_value speedJs = nullptr;
+    napi_value callback = nullptr;
+    napi_value undefined = nullptr;
+    napi_value callResult = nullptr;
+    if (napi_create_object(env, &progressJs) != napi_ok ||
+        napi_create_int64(env, static_cast<int64_t>(progress.processedSize), &processedJs) != napi_ok ||
+        napi_create_int64(env, static_cast<int64_t>(progress.totalSize), &totalJs) != napi_ok ||
+        napi_create_int64(env, static_cast<int64_t>(progress.bytesPerSecond), &speedJs) != napi_ok ||
+        napi_set_named_property(env, progressJs, "processedSize", processedJs) != napi_ok ||
+        napi_set_named_property(env, progressJs, "totalSize", totalJs) != napi_ok ||
+        napi_set_named_property(env, progressJs, "bytesPerSecond", speedJs) != napi_ok ||
+        napi_get_reference_value(env, context->progressRef, &callback) != napi_ok ||
+        napi_get_undefined(env, &undefined) != napi_ok) {
+        DLP_LOG_ERROR(LABEL, "create progress value fail");
+        napi_close_handle_scope(env, scope);
+        return;
+    }
+    napi_call_function(env, undefined, callback, PARAM_SIZE_ONE, &progressJs, &callResult);
+    napi_close_handle_scope(env, scope);
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -36,6 +36,7 @@
 #include "tokenid_kit.h"
 #include "token_setproc.h"
 #include "napi_dlp_connection_plugin.h"
+#include "napi_dlp_file_task.h"
 #include "napi_dlp_transparent_enc.h"
 
 namespace OHOS {
@@ -93,6 +94,34 @@ napi_value NapiDlpPermission::GenerateDlpFile(napi_env env, napi_callback_info c
     return result;
 }
 
+napi_value NapiDlpPermission::StartGenerateDlpFile(napi_env env, napi_callback_info cbInfo)
+{
+    if (CheckDevice(env)) {
+        return nullptr;
+    }
+    if (!IsSystemApp(env)) {
+        return nullptr;
+    }
+    auto* asyncContext = new (std::nothrow) GenerateDlpFileAsyncContext(env);
+    if (asyncContext == nullptr) {
+        DLP_LOG_ERROR(LABEL, "insufficient memory for asyncContext!");
+        DlpNapiThrow(env, DLP_SERVICE_ERROR_VALUE_INVALID);
+        return nullptr;
+    }
+    std::unique_ptr<GenerateDlpFileAsyncContext> asyncContextPtr { asyncContext };
+
+    if (!GetGenerateDlpFileParams(env, cbInfo, *asyncContext)) {
+        return nullptr;
+    }
+    asyncContext->jobControl = std::make_shared<DlpJobControl>();
+    napi_value task = NapiDlpFileTask::StartTask(env, *asyncContext, asyncContext->jobControl,
+        "StartGenerateDlpFile", GenerateDlpFileExcute, GenerateDlpFileComplete);
+    if (task != nullptr) {
+        asyncContextPtr.release();
+    }
+    return task;
+}
+
 void NapiDlpPermission::GenerateDlpFileExcute(napi_env env, void* data)
 {
     DLP_LOG_DEBUG(LABEL, "napi_create_async_work running");
@@ -123,7 +152,8 @@ void NapiDlpPermission::GenerateDlpFileExcute(napi_env env, void* data)
 
     asyncContext->errCode = DlpFileManager::GetInstance().GenerateDlpFile(
         asyncContext->plaintextFd, asyncContext->ciphertextFd, asyncContext->property,
-        asyncContext->dlpFileNative, rPath);
+        asyncContext->dlpFileNative, rPath, asyncContext->jobControl);
+    asyncContext->jobControl->Finish();
 }
 
 void NapiDlpPermission::GenerateDlpFileComplete(napi_env env, napi_status status, void* data)
@@ -782,6 +812,37 @@ napi_value NapiDlpPermission::RecoverDlpFile(napi_env env, napi_callback_info cb
     return result;
 }
 
+napi_value NapiDlpPermission::StartRecoverDlpFile(napi_env env, napi_callback_info cbInfo)
+{
+    if (CheckDevice(env)) {
+        return nullptr;
+    }
+    if (!IsSystemApp(env)) {
+        return nullptr;
+    }
+    if (!CheckPermission(env, PERMISSION_ACCESS_DLP_FILE)) {
+        return nullptr;
+    }
+    auto* asyncContext = new (std::nothrow) RecoverDlpFileAsyncContext(env);
+    if (asyncContext == nullptr) {
+        DLP_LOG_ERROR(LABEL, "insufficient memory for asyncContext!");
+        DlpNapiThrow(env, ERR_JS_SYSTEM_SERVICE_EXCEPTION, "The system ability works abnormally.");
+        return nullptr;
+    }
+    std::unique_ptr<RecoverDlpFileAsyncContext> asyncContextPtr { asyncContext };
+
+    if (!GetRecoverDlpFileParams(env, cbInfo, *asyncContext)) {
+        return nullptr;
+    }
+    asyncContext->jobControl = std::make_shared<DlpJobControl>();
+    napi_value task = NapiDlpFileTask::StartTask(env, *asyncContext, asyncContext->jobControl,
+        "StartRecoverDlpFile", RecoverDlpFileExcute, RecoverDlpFileComplete);
+    if (task != nullptr) {
+        asyncContextPtr.release();
+    }
+    return task;
+}
+
 void NapiDlpPermission::RecoverDlpFileExcute(napi_env env, void* data)
 {
     DLP_LOG_DEBUG(LABEL, "napi_create_async_work running");
@@ -792,7 +853,9 @@ void NapiDlpPermission::RecoverDlpFileExcute(napi_env env, void* data)
     }
 
     asyncContext->errCode =
-        DlpFileManager::GetInstance().RecoverDlpFile(asyncContext->dlpFileNative, asyncContext->plaintextFd);
+        DlpFileManager::GetInstance().RecoverDlpFile(asyncContext->dlpFileNative, asyncContext->plaintextFd,
+            asyncContext->jobControl);
+    asyncContext->jobControl->Finish();
 }
 
 void NapiDlpPermission::RecoverDlpFileComplete(napi_env env, napi_status status, void* data)
@@ -2097,6 +2160,7 @@ void NapiDlpPermission::InitFunction(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("startDLPManagerForResult", StartDLPManagerForResult),
 
         DECLARE_NAPI_FUNCTION("generateDLPFile", GenerateDlpFile),
+        DECLARE_NAPI_FUNCTION("startGenerateDLPFile", StartGenerateDlpFile),
         DECLARE_NAPI_FUNCTION("openDLPFile", OpenDlpFile),
         DECLARE_NAPI_FUNCTION("installDLPSandbox", InstallDlpSandbox),
         DECLARE_NAPI_FUNCTION("uninstallDLPSandbox", UninstallDlpSandbox),
@@ -2110,6 +2174,7 @@ void NapiDlpPermission::InitFunction(napi_env env, napi_value exports)
 
         DECLARE_NAPI_FUNCTION("generateDlpFileForEnterprise", GenerateDlpFileForEnterprise),
         DECLARE_NAPI_FUNCTION("decryptDlpFile", DecryptDlpFile),
+        DECLARE_NAPI_FUNCTION("startDecryptDlpFile", StartDecryptDlpFile),
         DECLARE_NAPI_FUNCTION("queryDlpPolicy", QueryDlpPolicy),
 
         DECLARE_NAPI_FUNCTION("setEnterprisePolicy", SetEnterprisePolicy),
@@ -2136,6 +2201,7 @@ napi_value NapiDlpPermission::Init(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("replaceDLPLinkFile", ReplaceDlpLinkFile),
         DECLARE_NAPI_FUNCTION("deleteDLPLinkFile", DeleteDlpLinkFile),
         DECLARE_NAPI_FUNCTION("recoverDLPFile", RecoverDlpFile),
+        DECLARE_NAPI_FUNCTION("startRecoverDLPFile", StartRecoverDlpFile),
         DECLARE_NAPI_FUNCTION("closeDLPFile", CloseDlpFile),
     };
 
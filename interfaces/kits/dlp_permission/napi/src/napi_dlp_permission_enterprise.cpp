@@ -37,6 +37,7 @@
 #include "tokenid_kit.h"
 #include "token_setproc.h"
 #include "napi_dlp_connection_plugin.h"
+#include "napi_dlp_file_task.h"
 #include "parameters.h"
 
 namespace OHOS {
@@ -290,6 +291,25 @@ napi_value NapiDlpPermission::DecryptDlpFile(napi_env env, napi_callback_info cb
     return result;
 }
 
+napi_value NapiDlpPermission::StartDecryptDlpFile(napi_env env, napi_callback_info cbInfo)
+{
+    if (CheckDevice(env)) {
+        return nullptr;
+    }
+    auto asyncContextPtr = std::make_unique<DecryptDlpFileAsyncContext>(env);
+
+    if (!GetDecryptDlpFileParam(env, cbInfo, *asyncContextPtr)) {
+        return nullptr;
+    }
+    asyncContextPtr->jobControl = std::make_shared<DlpJobControl>();
+    napi_value task = NapiDlpFileTask::StartTask(env, *asyncContextPtr, asyncContextPtr->jobControl,
+        "StartDecryptDlpFile", DecryptDlpFileExcute, DecryptDlpFileComplete);
+    if (task != nullptr) {
+        asyncContextPtr.release();
+    }
+    return task;
+}
+
 void NapiDlpPermission::DecryptDlpFileExcute(napi_env env, void* data)
 {
     DLP_LOG_DEBUG(LABEL, "QueryDlpPolicy start run.");
@@ -300,7 +320,8 @@ void NapiDlpPermission::DecryptDlpFileExcute(napi_env env, void* data)
     }
 
     asyncContext->errCode = EnterpriseSpaceDlpPermissionKit::GetInstance()->DecryptDlpFile(
-        asyncContext->plainFileFd, asyncContext->dlpFd);
+        asyncContext->plainFileFd, asyncContext->dlpFd, asyncContext->jobControl);
+    asyncContext->jobControl->Finish();
 }
 
 void NapiDlpPermission::DecryptDlpFileComplete(napi_env env, napi_status status, void* data)
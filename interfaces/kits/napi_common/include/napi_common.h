@@ -139,6 +139,7 @@ struct GenerateDlpFileAsyncContext : public CommonAsyncContext {
     int64_t ciphertextFd = -1;
     DlpProperty property;
     std::shared_ptr<DlpFile> dlpFileNative = nullptr;
+    std::shared_ptr<DlpJobControl> jobControl = nullptr;
 };
 
 struct DlpFileAsyncContext : public CommonAsyncContext {
@@ -160,6 +161,7 @@ struct RecoverDlpFileAsyncContext : public CommonAsyncContext {
     explicit RecoverDlpFileAsyncContext(napi_env env) : CommonAsyncContext(env) {};
     int64_t plaintextFd = -1;
     std::shared_ptr<DlpFile> dlpFileNative = nullptr;
+    std::shared_ptr<DlpJobControl> jobControl = nullptr;
 };
 
 struct CloseDlpFileAsyncContext : public CommonAsyncContext {
@@ -203,6 +205,7 @@ struct DecryptDlpFileAsyncContext : public CommonAsyncContext {
     explicit DecryptDlpFileAsyncContext(napi_env env) : CommonAsyncContext(env) {};
     int64_t dlpFd = -1;
     int64_t plainFileFd = -1;
+    std::shared_ptr<DlpJobControl> jobControl = nullptr;
 };
 
 struct QueryDlpPolicyAsyncContext : public CommonAsyncContext {
@@ -55,6 +55,7 @@ enum JsErrorCode : int32_t {
     ERR_JS_DLP_USERID_INCONSISTENT = 19100023,
     ERR_JS_DLP_NOT_ENTERPRISE_WORKSPACE = 19100024,
     ERR_JS_DLP_FILE_INVALID = 19100025,
+    ERR_JS_OPERATION_CANCELED = 19100026,
 };
 
 std::string GetJsErrMsg(int32_t errNo);
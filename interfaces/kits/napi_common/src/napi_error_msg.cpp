@@ -56,6 +56,7 @@ static const std::unordered_map<int32_t, std::string> JS_ERROR_MSG_MAP = {
     { ERR_JS_DLP_NOT_ENTERPRISE_WORKSPACE,
       "The specified userId belongs to a personal space user and cannot be controlled." },
     { ERR_JS_DLP_FILE_INVALID, "The file is invalid." },
+    { ERR_JS_OPERATION_CANCELED, "The operation is canceled." },
 };
 
 static const std::unordered_map<int32_t, int32_t> NATIVE_CODE_TO_JS_CODE_MAP = {
@@ -190,6 +191,9 @@ static const std::unordered_map<int32_t, int32_t> NATIVE_CODE_TO_JS_CODE_MAP = {
     // ERR_JS_DLP_FILE_INVALID
     { DLP_ERROR_FILE_INVALID, ERR_JS_DLP_FILE_INVALID },
 
+    // ERR_JS_OPERATION_CANCELED
+    { DLP_PARSE_ERROR_OPERATION_CANCELED, ERR_JS_OPERATION_CANCELED },
+
     // ERR_JS_SYSTEM_SERVICE_EXCEPTION
     { DLP_TRANSPARENT_ENC_ERROR, ERR_JS_SYSTEM_SERVICE_EXCEPTION },
 };
@@ -16,6 +16,7 @@
 #ifndef HUKS_ADAPT_MANAGER_H
 #define HUKS_ADAPT_MANAGER_H
 
+#include <vector>
 #include "alg_common_type.h"
 #include "alg_utils.h"
 
@@ -25,9 +26,39 @@
 #define MAX_OUTDATA_SIZE (64 * 1024)
 #define SIZE_OF_UINT64 sizeof(uint64_t)
 
+struct HksParamSet;
+
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
+/*
+ * One HUKS HMAC operation. Input is coalesced into MAX_UPDATE_SIZE segments
+ * so several small updates cost a single HksUpdate, and the last segment
+ * rides on HksFinish. An unfinished session is aborted on destruction.
+ */
+class HuksHmacSession {
+public:
+    explicit HuksHmacSession(const AlgKeyInfo *keyInfo);
+    ~HuksHmacSession();
+    HuksHmacSession(const HuksHmacSession&) = delete;
+    HuksHmacSession& operator=(const HuksHmacSession&) = delete;
+
+    int32_t Init();
+    int32_t Update(const BlobData *data);
+    int32_t Finish(BlobData *outData);
+
+private:
+    int32_t UpdateSegment(const uint8_t *data, uint32_t size);
+    int32_t Stage(const uint8_t *data, uint32_t size);
+    void Abort();
+
+    const AlgKeyInfo *keyInfo_;
+    struct HksParamSet *paramSet_ = nullptr;
+    uint8_t handle_[SIZE_OF_UINT64] = { 0 };
+    bool started_ = false;
+    std::vector<uint8_t> stage_;
+    std::vector<uint8_t> outSeg_;
+};
 
 bool IsHuksMgrKeyExist(const AlgKeyInfo *keyInfo);
 int32_t HuksGenerateMacKey(const AlgKeyInfo *keyInfo);
@@ -15,6 +15,7 @@
 
 #include "huks_adapt_manager.h"
 
+#include <algorithm>
 #include "hks_api.h"
 #include "hks_param.h"
 #include "securec.h"
@@ -31,16 +32,25 @@ constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, SECURITY_DOMAIN_DLP_PE
 }
 static const uint32_t HMAC_KEY_SIZE_256 = 256;
 
-static bool CheckHMACParams(const AlgKeyInfo *keyInfo, const BlobData *data, const BlobData *outData)
+static bool CheckHMACParams(const AlgKeyInfo *keyInfo, const BlobData *blobs, uint32_t blobCount,
+    const BlobData *outData)
 {
     if (keyInfo == nullptr || !IsBlobDataValid(&(keyInfo->keyAlias))) {
         DLP_LOG_ERROR(LABEL, "Mac keyInfo is invalid!");
         return false;
     }
-    if (!IsBlobDataValid(data) || data->dataSize > MAX_DATABASE_FILE_SIZE) {
+    if (blobs == nullptr || blobCount == 0) {
         DLP_LOG_ERROR(LABEL, "Mac data is invalid!");
         return false;
     }
+    uint32_t totalSize = 0;
+    for (uint32_t i = 0; i < blobCount; i++) {
+        if (!IsBlobDataValid(&blobs[i]) || blobs[i].dataSize > MAX_DATABASE_FILE_SIZE - totalSize) {
+            DLP_LOG_ERROR(LABEL, "Mac data is invalid!");
+            return false;
+        }
+        totalSize += blobs[i].dataSize;
+    }
     if (outData == nullptr) {
         DLP_LOG_ERROR(LABEL, "Mac outData is invalid!");
         return false;
@@ -73,104 +83,157 @@ static int32_t ConstructParamSet(struct HksParamSet **outParamSet, struct HksPar
     return DLP_OK;
 }
 
-static int32_t MallocAndCheckBlobData(struct HksBlob *blob, uint32_t blobSize)
+HuksHmacSession::HuksHmacSession(const AlgKeyInfo *keyInfo) : keyInfo_(keyInfo) {}
+
+HuksHmacSession::~HuksHmacSession()
 {
-    blob->data = static_cast<uint8_t *>(HcMalloc(blobSize, 0));
-    if (blob->data == nullptr) {
-        DLP_LOG_ERROR(LABEL, "Allocate blob data memory failed!");
-        return HKS_FAILURE;
+    Abort();
+    if (paramSet_ != nullptr) {
+        HksFreeParamSet(&paramSet_);
     }
-    return HKS_SUCCESS;
 }
 
-static int32_t LessThanMaxSeg(const struct HksBlob *handle, const struct HksParamSet *paramSet,
-    const struct HksBlob *inData, struct HksBlob *outData)
+int32_t HuksHmacSession::Init()
 {
-    struct HksBlob tmpOutData = { MAX_OUTDATA_SIZE, nullptr };
-    if (MallocAndCheckBlobData(&tmpOutData, tmpOutData.size) != HKS_SUCCESS) {
-        return HKS_FAILURE;
+    if (keyInfo_ == nullptr || !IsBlobDataValid(&(keyInfo_->keyAlias))) {
+        DLP_LOG_ERROR(LABEL, "Mac keyInfo is invalid!");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    int32_t ret = HksUpdate(handle, paramSet, inData, &tmpOutData);
-    HcFree(tmpOutData.data);
-    if (ret != HKS_SUCCESS) {
-        DLP_LOG_ERROR(LABEL, "HksUpdate Failed, error code: %{public}d.", ret);
-        return HKS_FAILURE;
+    if (started_) {
+        DLP_LOG_ERROR(LABEL, "Hmac session already started.");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    struct HksBlob tmpInData = { 0, nullptr };
-    if (MallocAndCheckBlobData(&tmpInData, MAX_UPDATE_SIZE) != HKS_SUCCESS) {
-        return HKS_FAILURE;
+    if (paramSet_ == nullptr) {
+        struct HksParam deHmacParams[] = {
+            { .tag = HKS_TAG_ALGORITHM, .uint32Param = HKS_ALG_HMAC },
+            { .tag = HKS_TAG_PURPOSE, .uint32Param = HKS_KEY_PURPOSE_MAC },
+            { .tag = HKS_TAG_DIGEST, .uint32Param = HKS_DIGEST_SHA256 },
+            { .tag = HKS_TAG_SPECIFIC_USER_ID, .uint32Param = keyInfo_->osAccountId },
+            { .tag = HKS_TAG_AUTH_STORAGE_LEVEL, .uint32Param = HKS_AUTH_STORAGE_LEVEL_DE },
+        };
+        if (ConstructParamSet(&paramSet_, deHmacParams, sizeof(deHmacParams) / sizeof(deHmacParams[0])) != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "construct hmac param set failed!");
+            paramSet_ = nullptr;
+            return DLP_ERROR_CONSTRUCT_PARAMS_FAILED;
+        }
     }
-
-    ret = HksFinish(handle, paramSet, &tmpInData, outData);
-    HcFree(tmpInData.data);
+    struct HksBlob handleBlob = { SIZE_OF_UINT64, handle_ };
+    int32_t ret = HksInit(reinterpret_cast<const struct HksBlob *>(&(keyInfo_->keyAlias)), paramSet_,
+        &handleBlob, nullptr);
     if (ret != HKS_SUCCESS) {
-        DLP_LOG_ERROR(LABEL, "HksFinish Failed, error code: %{public}d.", ret);
-        return HKS_FAILURE;
+        DLP_LOG_ERROR(LABEL, "HksInit failed, error code: %{public}d.", ret);
+        return DLP_ERROR_HMAC_FAILED;
     }
-    return HKS_SUCCESS;
+    stage_.clear();
+    stage_.reserve(MAX_UPDATE_SIZE);
+    started_ = true;
+    return DLP_OK;
 }
 
-static int32_t HksShardingUpdateAndFinish(const struct HksBlob *handle, const struct HksParamSet *paramSet,
-    const struct HksBlob *inData, struct HksBlob *outData)
+int32_t HuksHmacSession::UpdateSegment(const uint8_t *data, uint32_t size)
 {
-    struct HksBlob inDataSeg = *inData;
-    inDataSeg.size = MAX_UPDATE_SIZE;
-    uint8_t *lastPtr = inData->data + inData->size - 1;
-    struct HksBlob outDataSeg = { MAX_OUTDATA_SIZE, nullptr };
-
-    if (inData->size <= MAX_UPDATE_SIZE) {
-        return LessThanMaxSeg(handle, paramSet, inData, outData);
+    if (outSeg_.empty()) {
+        outSeg_.resize(MAX_OUTDATA_SIZE);
+    }
+    struct HksBlob handleBlob = { SIZE_OF_UINT64, handle_ };
+    struct HksBlob inBlob = { size, const_cast<uint8_t *>(data) };
+    struct HksBlob outBlob = { static_cast<uint32_t>(outSeg_.size()), outSeg_.data() };
+    int32_t ret = HksUpdate(&handleBlob, paramSet_, &inBlob, &outBlob);
+    if (ret != HKS_SUCCESS) {
+        DLP_LOG_ERROR(LABEL, "HksUpdate Failed, error code: %{public}d.", ret);
+        return DLP_ERROR_HMAC_FAILED;
     }
+    return DLP_OK;
+}
 
-    while (inDataSeg.data <= lastPtr) {
-        if (inDataSeg.data + MAX_UPDATE_SIZE <= lastPtr) {
-            outDataSeg.size = MAX_OUTDATA_SIZE;
-            if (MallocAndCheckBlobData(&outDataSeg, outDataSeg.size) != HKS_SUCCESS) {
-                return HKS_FAILURE;
+int32_t HuksHmacSession::Stage(const uint8_t *data, uint32_t size)
+{
+    uint32_t offset = 0;
+    while (offset < size) {
+        // Flush only when more input arrives, so the tail is always left for HksFinish.
+        if (stage_.size() == MAX_UPDATE_SIZE) {
+            int32_t ret = UpdateSegment(stage_.data(), stage_.size());
+            if (ret != DLP_OK) {
+                return ret;
             }
-        } else {
-            inDataSeg.size = lastPtr - inDataSeg.data + 1;
-            break;
-        }
-        if (HksUpdate(handle, paramSet, &inDataSeg, &outDataSeg) != HKS_SUCCESS) {
-            DLP_LOG_ERROR(LABEL, "HksUpdate Failed.");
-            DLP_FREE_PTR(outDataSeg.data);
-            return HKS_FAILURE;
+            stage_.clear();
         }
-        DLP_FREE_PTR(outDataSeg.data);
-        if (inDataSeg.data + MAX_UPDATE_SIZE > lastPtr) {
-            return HKS_FAILURE;
+        uint32_t remain = size - offset;
+        if (stage_.empty() && remain > MAX_UPDATE_SIZE) {
+            int32_t ret = UpdateSegment(data + offset, MAX_UPDATE_SIZE);
+            if (ret != DLP_OK) {
+                return ret;
+            }
+            offset += MAX_UPDATE_SIZE;
+            continue;
         }
-        inDataSeg.data += MAX_UPDATE_SIZE;
+        uint32_t copySize = std::min(remain, static_cast<uint32_t>(MAX_UPDATE_SIZE - stage_.size()));
+        stage_.insert(stage_.end(), data + offset, data + offset + copySize);
+        offset += copySize;
+    }
+    return DLP_OK;
+}
+
+int32_t HuksHmacSession::Update(const BlobData *data)
+{
+    if (!started_ || data == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Hmac session is not started or data is null.");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    if (data->dataSize == 0) {
+        return DLP_OK;
     }
-    if (HksFinish(handle, paramSet, &inDataSeg, outData) != HKS_SUCCESS) {
-        DLP_LOG_ERROR(LABEL, "Finish stage failed.");
-        return HKS_FAILURE;
+    if (data->value == nullptr) {
+        DLP_LOG_ERROR(LABEL, "The value of blob is null!");
+        Abort();
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    int32_t ret = Stage(data->value, data->dataSize);
+    if (ret != DLP_OK) {
+        Abort();
     }
-    return HKS_SUCCESS;
+    return ret;
 }
 
-static int32_t HksHMACThreeStages(const BlobData *keyAlias, struct HksParamSet *hmacParamSet,
-    const BlobData *data, BlobData *outData)
+int32_t HuksHmacSession::Finish(BlobData *outData)
 {
-    uint8_t handle[SIZE_OF_UINT64] = { 0 };
-    struct HksBlob handleHMAC = { SIZE_OF_UINT64, handle };
-    int32_t ret = HksInit(reinterpret_cast<const struct HksBlob *>(keyAlias), hmacParamSet, &handleHMAC, nullptr);
-    if (ret != HKS_SUCCESS) {
-        DLP_LOG_ERROR(LABEL, "HksInit failed, error code: %{public}d.", ret);
-        return ret;
+    if (!started_ || outData == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Hmac session is not started or outData is null.");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    outData->value = static_cast<uint8_t *>(HcMalloc(HASH_SIZE_SHA_256, 0));
+    if (outData->value == nullptr) {
+        DLP_LOG_ERROR(LABEL, "Allocate outData memory failed");
+        Abort();
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
     }
+    outData->dataSize = HASH_SIZE_SHA_256;
 
-    ret = HksShardingUpdateAndFinish(&handleHMAC, hmacParamSet,
-        reinterpret_cast<const struct HksBlob *>(data), reinterpret_cast<struct HksBlob *>(outData));
+    struct HksBlob handleBlob = { SIZE_OF_UINT64, handle_ };
+    struct HksBlob inBlob = { static_cast<uint32_t>(stage_.size()), stage_.data() };
+    int32_t ret = HksFinish(&handleBlob, paramSet_, &inBlob, reinterpret_cast<struct HksBlob *>(outData));
     if (ret != HKS_SUCCESS) {
-        DLP_LOG_ERROR(LABEL, "Update and finish stage failed, error code: %{public}d.", ret);
-        HksAbort(&handleHMAC, hmacParamSet);
-        return DLP_SERVICE_ERROR_VALUE_INVALID;
+        DLP_LOG_ERROR(LABEL, "HksFinish Failed, error code: %{public}d.", ret);
+        FreeBlobData(outData);
+        Abort();
+        return DLP_ERROR_HMAC_FAILED;
     }
+    started_ = false;
+    stage_.clear();
     return DLP_OK;
 }
 
+void HuksHmacSession::Abort()
+{
+    if (!started_) {
+        return;
+    }
+    struct HksBlob handleBlob = { SIZE_OF_UINT64, handle_ };
+    (void)HksAbort(&handleBlob, paramSet_);
+    started_ = false;
+    stage_.clear();
+}
+
 bool IsHuksMgrKeyExist(const AlgKeyInfo *keyInfo)
 {
     if (keyInfo == nullptr || !IsBlobDataValid(&(keyInfo->keyAlias))) {
@@ -228,37 +291,19 @@ int32_t HuksGenerateMacKey(const AlgKeyInfo *keyInfo)
 
 int32_t HuksGenerateHmac(const AlgKeyInfo *keyInfo, const BlobData *data, BlobData *outData)
 {
-    if (!CheckHMACParams(keyInfo, data, outData)) {
+    if (!CheckHMACParams(keyInfo, data, 1, outData)) {
         return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    outData->value = static_cast<uint8_t *>(HcMalloc(HASH_SIZE_SHA_256, 0));
-    if (outData->value == nullptr) {
-        DLP_LOG_ERROR(LABEL, "Allocate outData memory failed");
-        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
-    }
-    outData->dataSize = HASH_SIZE_SHA_256;
-
-    struct HksParamSet *hmacParamSet = nullptr;
-    struct HksParam deHmacParams[] = {
-        { .tag = HKS_TAG_ALGORITHM, .uint32Param = HKS_ALG_HMAC },
-        { .tag = HKS_TAG_PURPOSE, .uint32Param = HKS_KEY_PURPOSE_MAC },
-        { .tag = HKS_TAG_DIGEST, .uint32Param = HKS_DIGEST_SHA256 },
-        { .tag = HKS_TAG_SPECIFIC_USER_ID, .uint32Param = keyInfo->osAccountId },
-        { .tag = HKS_TAG_AUTH_STORAGE_LEVEL, .uint32Param = HKS_AUTH_STORAGE_LEVEL_DE },
-    };
-    int32_t res = ConstructParamSet(&hmacParamSet, deHmacParams, sizeof(deHmacParams) / sizeof(deHmacParams[0]));
+    HuksHmacSession session(keyInfo);
+    int32_t res = session.Init();
     if (res != DLP_OK) {
-        DLP_LOG_ERROR(LABEL, "construct hmac param set failed!");
-        FreeBlobData(outData);
-        return DLP_ERROR_CONSTRUCT_PARAMS_FAILED;
+        return res;
     }
-    res = HksHMACThreeStages(&(keyInfo->keyAlias), hmacParamSet, data, outData);
-    HksFreeParamSet(&hmacParamSet);
+    res = session.Update(data);
     if (res != DLP_OK) {
-        FreeBlobData(outData);
-        res = DLP_ERROR_HMAC_FAILED;
+        return DLP_ERROR_HMAC_FAILED;
     }
-    return res;
+    return session.Finish(outData);
 }
 }  // namespace DlpPermission
 }  // namespace Security
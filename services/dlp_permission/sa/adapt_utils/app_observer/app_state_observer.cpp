@@ -14,6 +14,8 @@
  */
 
 #include "app_state_observer.h"
+#include <algorithm>
+#include <chrono>
 #include <unistd.h>
 #include "account_adapt.h"
 #include "bundle_manager_adapter.h"
@@ -47,6 +49,14 @@ const std::string FLAG_OF_MINI = "svr";
 static const std::string TASK_ID = "dlpPermissionServiceUnloadTask";
 constexpr int32_t SA_SHORT_LIFT_TIME = 60 * 1000; // SA life time for short task, in 60 seconds
 constexpr int32_t SA_LONG_LIFT_TIME = 120 * 1000; // SA life time for long task, in 120 seconds
+constexpr int64_t CRITICAL_RELEASE_DELAY = 5 * 1000; // keep memmgr critical across a burst of calls, in 5 seconds
+constexpr size_t MAX_COPY_POLICY_CACHE_SIZE = 1024;
+
+static int64_t GetSteadyTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 }
 
 AppStateObserver::AppStateObserver()
@@ -101,24 +111,18 @@ void AppStateObserver::UninstallDlpSandbox(DlpSandboxInfo& appInfo)
 
 void AppStateObserver::UninstallAllDlpSandboxForUser(int32_t userId)
 {
-    AppExecFwk::BundleMgrClient bundleMgrClient;
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (auto iter = sandboxInfo_.begin(); iter != sandboxInfo_.end();) {
-        auto& appInfo = iter->second;
-        if (appInfo.userId != userId) {
-            ++iter;
-            continue;
-        }
+    // Records and token bindings of the user leave the registry in one event before the slow uninstalls.
+    std::vector<DlpSandboxInfo> appInfos = sandboxRegistry_.EraseByUser(userId);
+    for (auto& appInfo : appInfos) {
         RetentionFileManager::GetInstance().SetInitStatus(appInfo.tokenId);
         if (RetentionFileManager::GetInstance().CanUninstall(appInfo.tokenId)) {
             UninstallDlpSandbox(appInfo);
         }
-        EraseUidTokenIdMap(appInfo.tokenId);
         DLP_LOG_INFO(LABEL, "ExecuteCallbackAsync appInfo bundleName:%{public}s,appIndex:%{public}d,pid:%{public}d",
             appInfo.bundleName.c_str(), appInfo.appIndex, appInfo.pid);
         DlpSandboxChangeCallbackManager::GetInstance().ExecuteCallbackAsync(appInfo);
-        iter = sandboxInfo_.erase(iter);
     }
+    InvalidateCopyPolicy();
 }
 
 void AppStateObserver::UninstallAllDlpSandbox()
@@ -133,14 +137,7 @@ void AppStateObserver::UninstallAllDlpSandbox()
 
 bool AppStateObserver::HasDlpSandboxForUser(int32_t userId)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (auto iter = sandboxInfo_.begin(); iter != sandboxInfo_.end(); iter++) {
-        auto& appInfo = iter->second;
-        if (appInfo.userId == userId) {
-            return true;
-        }
-    }
-    return false;
+    return sandboxRegistry_.HasUser(userId);
 }
 
 int32_t AppStateObserver::ExitSaAfterAllDlpManagerDie()
@@ -200,53 +197,34 @@ void AppStateObserver::AddUserId(int32_t userId)
 
 bool AppStateObserver::GetSandboxInfo(int32_t uid, DlpSandboxInfo& appInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    auto iter = sandboxInfo_.find(uid);
-    if (iter != sandboxInfo_.end()) {
-        appInfo = iter->second;
-        return true;
-    }
-    return false;
+    return sandboxRegistry_.Get(uid, appInfo);
 }
 
 bool AppStateObserver::GetSandboxHasRead(int32_t uid, bool& hasRead)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    auto iter = sandboxInfo_.find(uid);
-    if (iter != sandboxInfo_.end()) {
-        hasRead = iter->second.hasRead;
+    return sandboxRegistry_.Read(uid, [&hasRead](const DlpSandboxInfo* appInfo) {
+        if (appInfo == nullptr) {
+            return false;
+        }
+        hasRead = appInfo->hasRead;
         return true;
-    }
-    return false;
+    });
 }
 
 void AppStateObserver::GetSandboxInfosByClassificationLabel(const std::string& label,
     const std::string& appIdentifier, std::vector<std::string>& uris)
 {
     uris.clear();
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    for (const auto& entry : enterpriseUriMap_) {
-        const EnterpriseInfo& enterpriseInfo = entry.second;
-        if ((label.empty() || enterpriseInfo.classificationLabel == label) &&
-            enterpriseInfo.appIdentifier == appIdentifier &&
-            enterpriseInfo.uid >= 0) {
-            uris.emplace_back(entry.first);
-        }
-    }
+    enterpriseFileTracker_.QueryOpenedUris(label, appIdentifier, uris);
 }
 
 void AppStateObserver::GetNeededDelEnterpriseSandbox(const std::string& label,
     const std::string& appIdentifier, std::vector<DlpSandboxInfo>& appInfos)
 {
     appInfos.clear();
-    {
-        std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-        for (const auto& entry : sandboxInfo_) {
-            const DlpSandboxInfo& appInfo = entry.second;
-            if ((label.empty() || appInfo.classificationLabel == label) &&
-                appInfo.appIdentifier == appIdentifier) {
-                appInfos.emplace_back(appInfo);
-            }
+    for (auto& appInfo : sandboxRegistry_.GetByLabel(label)) {
+        if (appInfo.appIdentifier == appIdentifier) {
+            appInfos.emplace_back(std::move(appInfo));
         }
     }
     EraseEnterpriseInfoByUid(appInfos);
@@ -254,53 +232,42 @@ void AppStateObserver::GetNeededDelEnterpriseSandbox(const std::string& label,
 
 void AppStateObserver::UpdateReadFlag(int32_t uid)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    auto iter = sandboxInfo_.find(uid);
-    if (iter != sandboxInfo_.end()) {
-        iter->second.hasRead = true;
-    }
+    (void)sandboxRegistry_.Update(uid, [](DlpSandboxInfo& appInfo) { appInfo.hasRead = true; });
 }
 
 bool AppStateObserver::CheckSandboxInfo(const std::string& bundleName, int32_t appIndex, int32_t userId)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& iter : sandboxInfo_) {
-        if (iter.second.bundleName == bundleName && iter.second.appIndex == appIndex && iter.second.userId == userId) {
-            return true;
-        }
-    }
-    return false;
+    return sandboxRegistry_.Contains(bundleName, appIndex, userId);
 }
 
 void AppStateObserver::EraseSandboxInfo(int32_t uid)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    auto iter = sandboxInfo_.find(uid);
-    if (iter != sandboxInfo_.end()) {
-        AppFileService::ModuleFileUri::FileUri fileUri(iter->second.uri);
-        std::string path = fileUri.GetRealPath();
-        EraseFileInfoByUri(path);
-        DecMaskInfoCnt(iter->second);
-        EraseEnterpriseInfoByUid({iter->second});
-        DLP_LOG_INFO(LABEL, "sandbox app %{public}s%{public}d info delete success, uid: %{public}d",
-            iter->second.bundleName.c_str(), iter->second.appIndex, iter->second.uid);
-        sandboxInfo_.erase(iter);
+    DlpSandboxInfo appInfo;
+    if (!sandboxRegistry_.Erase(uid, appInfo)) {
+        return;
     }
+    AppFileService::ModuleFileUri::FileUri fileUri(appInfo.uri);
+    std::string path = fileUri.GetRealPath();
+    EraseFileInfoByUri(path);
+    DecMaskInfoCnt(appInfo);
+    EraseEnterpriseInfoByUid({appInfo});
+    DLP_LOG_INFO(LABEL, "sandbox app %{public}s%{public}d info delete success, uid: %{public}d",
+        appInfo.bundleName.c_str(), appInfo.appIndex, appInfo.uid);
+    InvalidateCopyPolicy();
 }
 
 void AppStateObserver::AddSandboxInfo(const DlpSandboxInfo& appInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
     AddMaskInfoCnt(appInfo);
-    if (sandboxInfo_.count(appInfo.uid) > 0) {
+    if (!sandboxRegistry_.Add(appInfo)) {
         DLP_LOG_ERROR(LABEL, "sandbox app %{public}s%{public}d is already insert, ignore it",
             appInfo.bundleName.c_str(), appInfo.appIndex);
         // Update PID when sandbox already exists to fix PID mismatch issue
-        sandboxInfo_[appInfo.uid].pid = appInfo.pid;
+        (void)sandboxRegistry_.Update(appInfo.uid, [&appInfo](DlpSandboxInfo& info) { info.pid = appInfo.pid; });
         DLP_LOG_INFO(LABEL, "sandbox app %{public}s%{public}d already exists, update pid to %{public}d",
             appInfo.bundleName.c_str(), appInfo.appIndex, appInfo.pid);
     } else {
-        sandboxInfo_[appInfo.uid] = appInfo;
+        InvalidateCopyPolicy();
         DLP_LOG_INFO(LABEL, "sandbox app %{public}s%{public}d info insert success, uid: %{public}d",
             appInfo.bundleName.c_str(), appInfo.appIndex, appInfo.uid);
     }
@@ -343,6 +310,7 @@ void AppStateObserver::AddMaskInfoCnt(const DlpSandboxInfo& appInfo)
         DLP_LOG_ERROR(LABEL, "Not watermark sandbox or param is error");
         return;
     }
+    std::lock_guard<std::mutex> lock(maskInfoMapLock_);
     auto it = maskInfoMap_.find(appInfo.maskInfo);
     if (it == maskInfoMap_.end()) {
         maskInfoMap_.emplace(appInfo.maskInfo, 1);
@@ -371,6 +339,7 @@ void AppStateObserver::DecMaskInfoCnt(const DlpSandboxInfo& appInfo)
     }
     std::string accountAndUserId = accountInfo.second.name_ + std::to_string(userId);
     DLP_LOG_DEBUG(LABEL, "Erase watermark sandbox.");
+    std::lock_guard<std::mutex> lock(maskInfoMapLock_);
     auto it = maskInfoMap_.find(appInfo.maskInfo);
     if (it == maskInfoMap_.end()) {
         DLP_LOG_INFO(LABEL, "Watermark sandbox no exist");
@@ -431,34 +400,22 @@ bool AppStateObserver::FillSandboxInfoIfProcessRunning(const DlpSandboxInfo& app
 bool AppStateObserver::GetOpeningSandboxInfo(const std::string& bundleName, const std::string& uri,
     int32_t userId, SandboxInfo& sandboxInfo, const std::string& fileId)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& entry : sandboxInfo_) {
-        const DlpSandboxInfo& appInfo = entry.second;
-        if (appInfo.userId != userId || appInfo.bundleName != bundleName ||
-            appInfo.uri != uri || appInfo.fileId != fileId) {
-            continue;
-        }
-        return FillSandboxInfoIfProcessRunning(appInfo, sandboxInfo);
-    }
-    return false;
+    DlpSandboxInfo appInfo;
+    bool isFound = sandboxRegistry_.FindByUri(uri, [&](const DlpSandboxInfo& info) {
+        return info.userId == userId && info.bundleName == bundleName && info.fileId == fileId;
+    }, appInfo);
+    return isFound && FillSandboxInfoIfProcessRunning(appInfo, sandboxInfo);
 }
 
 bool AppStateObserver::GetOpeningEnterpriseSandboxInfo(SandboxInfo& sandboxInfo,
     const InputSandboxInfo& inputSandboxInfo, const EnterpriseInfo& enterpriseInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& entry : sandboxInfo_) {
-        const DlpSandboxInfo& appInfo = entry.second;
-        if (appInfo.userId != inputSandboxInfo.userId ||
-            appInfo.bundleName != inputSandboxInfo.bundleName ||
-            appInfo.uri != inputSandboxInfo.uri ||
-            appInfo.fileId != enterpriseInfo.fileId ||
-            appInfo.classificationLabel != enterpriseInfo.classificationLabel) {
-            continue;
-        }
-        return FillSandboxInfoIfProcessRunning(appInfo, sandboxInfo);
-    }
-    return false;
+    DlpSandboxInfo appInfo;
+    bool isFound = sandboxRegistry_.FindByUri(inputSandboxInfo.uri, [&](const DlpSandboxInfo& info) {
+        return info.userId == inputSandboxInfo.userId && info.bundleName == inputSandboxInfo.bundleName &&
+            info.fileId == enterpriseInfo.fileId && info.classificationLabel == enterpriseInfo.classificationLabel;
+    }, appInfo);
+    return isFound && FillSandboxInfoIfProcessRunning(appInfo, sandboxInfo);
 }
 
 bool AppStateObserver::CanUninstallByGid(DlpSandboxInfo& appInfo, const AppExecFwk::ProcessData& processData)
@@ -486,18 +443,16 @@ bool AppStateObserver::CanUninstallByGid(DlpSandboxInfo& appInfo, const AppExecF
 void AppStateObserver::GetOpeningReadOnlySandbox(const std::string& bundleName,
     int32_t userId, int32_t& appIndex, int32_t& bindAppIndex)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& iter : sandboxInfo_) {
-        const DlpSandboxInfo& appInfo = iter.second;
-        if (appInfo.userId == userId && appInfo.bundleName == bundleName &&
-            appInfo.dlpFileAccess == DLPFileAccess::READ_ONLY && !appInfo.isReadOnce) {
-            appIndex = appInfo.appIndex;
-            bindAppIndex = appInfo.bindAppIndex;
-            DLP_LOG_INFO(LABEL,
-                "GetOpeningReadOnlySandbox, appIndex:%{public}d, bindAppIndex:%{public}d, bundleName=%{public}s",
-                appIndex, bindAppIndex, bundleName.c_str());
-            return;
-        }
+    DlpSandboxInfo appInfo;
+    if (sandboxRegistry_.FindByUser(userId, [&bundleName](const DlpSandboxInfo& info) {
+        return info.bundleName == bundleName && info.dlpFileAccess == DLPFileAccess::READ_ONLY && !info.isReadOnce;
+    }, appInfo)) {
+        appIndex = appInfo.appIndex;
+        bindAppIndex = appInfo.bindAppIndex;
+        DLP_LOG_INFO(LABEL,
+            "GetOpeningReadOnlySandbox, appIndex:%{public}d, bindAppIndex:%{public}d, bundleName=%{public}s",
+            appIndex, bindAppIndex, bundleName.c_str());
+        return;
     }
     appIndex = -1;
     bindAppIndex = -1;
@@ -507,21 +462,18 @@ void AppStateObserver::GetOpeningReadOnlySandbox(const std::string& bundleName,
 void AppStateObserver::GetOpeningEnterpriseReadOnlySandbox(const InputSandboxInfo& inputSandboxInfo,
     const EnterpriseInfo& enterpriseInfo, DlpSandboxInfo& dlpsandboxInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& iter : sandboxInfo_) {
-        const DlpSandboxInfo& appInfo = iter.second;
-        if (appInfo.userId == inputSandboxInfo.userId &&
-            appInfo.bundleName == inputSandboxInfo.bundleName &&
-            appInfo.dlpFileAccess == DLPFileAccess::READ_ONLY &&
-            !appInfo.isReadOnce && appInfo.appIdentifier == enterpriseInfo.appIdentifier &&
-            appInfo.classificationLabel == enterpriseInfo.classificationLabel) {
-            dlpsandboxInfo.appIndex = appInfo.appIndex;
-            dlpsandboxInfo.bindAppIndex = appInfo.bindAppIndex;
-            DLP_LOG_INFO(LABEL,
-                "OpenedEnterpriseReadOnlySandbox, appIndex:%{public}d, bindAppIndex:%{public}d, bundleName=%{public}s",
-                dlpsandboxInfo.appIndex, dlpsandboxInfo.bindAppIndex, inputSandboxInfo.bundleName.c_str());
-            return;
-        }
+    DlpSandboxInfo appInfo;
+    if (sandboxRegistry_.FindByUser(inputSandboxInfo.userId, [&](const DlpSandboxInfo& info) {
+        return info.bundleName == inputSandboxInfo.bundleName && info.dlpFileAccess == DLPFileAccess::READ_ONLY &&
+            !info.isReadOnce && info.appIdentifier == enterpriseInfo.appIdentifier &&
+            info.classificationLabel == enterpriseInfo.classificationLabel;
+    }, appInfo)) {
+        dlpsandboxInfo.appIndex = appInfo.appIndex;
+        dlpsandboxInfo.bindAppIndex = appInfo.bindAppIndex;
+        DLP_LOG_INFO(LABEL,
+            "OpenedEnterpriseReadOnlySandbox, appIndex:%{public}d, bindAppIndex:%{public}d, bundleName=%{public}s",
+            dlpsandboxInfo.appIndex, dlpsandboxInfo.bindAppIndex, inputSandboxInfo.bundleName.c_str());
+        return;
     }
     dlpsandboxInfo.appIndex = -1;
     dlpsandboxInfo.bindAppIndex = -1;
@@ -580,7 +532,7 @@ void AppStateObserver::OnProcessDied(const AppExecFwk::ProcessData& processData)
         }
     }
     // if current died process is a listener
-    if (RemoveCallbackListener(processData.pid)) {
+    if (callbackPidFilter_.MayContain(processData.pid) && RemoveCallbackListener(processData.pid)) {
         DLP_LOG_INFO(LABEL, "PostDelayUnloadTask by listener");
         CheckHasBackgroundTask();
         PostDelayUnloadTask(CurrentTaskState::SHORT_TASK);
@@ -590,9 +542,9 @@ void AppStateObserver::OnProcessDied(const AppExecFwk::ProcessData& processData)
         DLP_LOG_INFO(LABEL, "Ignore render process death, renderUid: %{public}d", processData.renderUid);
         return;
     }
-    // current died process is dlp sandbox app
+    // current died process is dlp sandbox app; almost every death on the device stops at the filter
     DlpSandboxInfo appInfo;
-    if (!GetSandboxInfo(processData.uid, appInfo)) {
+    if (!sandboxRegistry_.MayContain(processData.uid) || !GetSandboxInfo(processData.uid, appInfo)) {
         return;
     }
     if (!CanUninstallByGid(appInfo, processData)) {
@@ -611,11 +563,9 @@ void AppStateObserver::OnProcessDied(const AppExecFwk::ProcessData& processData)
 
 void AppStateObserver::EraseUidTokenIdMap(uint32_t tokenId)
 {
-    std::lock_guard<std::mutex> lock(tokenIdToUidMapLock_);
-    auto iter = tokenIdToUidMap_.find(tokenId);
-    if (iter != tokenIdToUidMap_.end()) {
+    if (sandboxRegistry_.UnbindToken(tokenId)) {
         DLP_LOG_INFO(LABEL, "erase tokenId: %{public}d", tokenId);
-        tokenIdToUidMap_.erase(iter);
+        InvalidateCopyPolicy();
     }
 }
 
@@ -625,20 +575,16 @@ void AppStateObserver::AddUidWithTokenId(uint32_t tokenId, int32_t uid)
         DLP_LOG_ERROR(LABEL, "tokenId is invalid");
         return;
     }
-    std::lock_guard<std::mutex> lock(tokenIdToUidMapLock_);
-    if (tokenIdToUidMap_.count(tokenId) > 0) {
+    if (!sandboxRegistry_.BindToken(tokenId, uid)) {
         return;
     }
     DLP_LOG_INFO(LABEL, "add tokenId: %{public}d, uid: %{public}d", tokenId, uid);
-    tokenIdToUidMap_[tokenId] = uid;
+    InvalidateCopyPolicy();
 }
 
 bool AppStateObserver::GetUidByTokenId(uint32_t tokenId, int32_t& uid)
 {
-    std::lock_guard<std::mutex> lock(tokenIdToUidMapLock_);
-    auto iter = tokenIdToUidMap_.find(tokenId);
-    if (iter != tokenIdToUidMap_.end()) {
-        uid = iter->second;
+    if (sandboxRegistry_.GetUidByTokenId(tokenId, uid)) {
         DLP_LOG_INFO(LABEL, "tokenId: %{public}d, uid: %{public}d", tokenId, uid);
         return true;
     }
@@ -660,6 +606,7 @@ bool AppStateObserver::RemoveCallbackListener(int32_t pid)
         if ((*iter).second <= 0) {
             DLP_LOG_INFO(LABEL, "erase pid %{public}d", pid);
             callbackList_.erase(pid);
+            callbackPidFilter_.Remove(pid);
             return callbackList_.empty();
         }
     }
@@ -670,7 +617,9 @@ void AppStateObserver::AddCallbackListener(int32_t pid)
 {
     std::lock_guard<std::mutex> lock(callbackListLock_);
     DLP_LOG_INFO(LABEL, "add pid %{public}d", pid);
-    callbackList_[pid]++;
+    if (callbackList_[pid]++ == 0) {
+        callbackPidFilter_.Add(pid);
+    }
 }
 
 static bool IsCopyable(DLPFileAccess dlpFileAccess)
@@ -708,6 +657,46 @@ int32_t AppStateObserver::QueryDlpFileCopyableByTokenId(bool& copyable, uint32_t
     return res;
 }
 
+void AppStateObserver::GetCopyPolicyByTokenId(uint32_t tokenId, DlpCopyPolicy& policy)
+{
+    uint64_t generation = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(copyPolicyLock_);
+        auto iter = copyPolicyCache_.find(tokenId);
+        if (iter != copyPolicyCache_.end()) {
+            policy = iter->second;
+            return;
+        }
+        generation = copyPolicyGeneration_;
+    }
+    DlpCopyPolicy newPolicy;
+    newPolicy.result = QueryDlpFileCopyableByTokenId(newPolicy.copyable, tokenId, newPolicy.inDlpSandbox);
+    DlpSandboxInfo sandboxInfo;
+    EnterpriseInfo enterpriseInfo;
+    if (GetSandboxInfoByTokenId(tokenId, sandboxInfo) && GetEnterpriseInfoByUid(sandboxInfo.uid, enterpriseInfo)) {
+        newPolicy.isEnterprise = true;
+        newPolicy.fileId = sandboxInfo.fileId;
+    }
+    policy = newPolicy;
+
+    std::unique_lock<std::shared_mutex> lock(copyPolicyLock_);
+    // A sandbox or enterprise change while resolving makes the record stale, so it is returned but not kept.
+    if (generation != copyPolicyGeneration_) {
+        return;
+    }
+    if (copyPolicyCache_.size() >= MAX_COPY_POLICY_CACHE_SIZE) {
+        copyPolicyCache_.clear();
+    }
+    copyPolicyCache_[tokenId] = newPolicy;
+}
+
+void AppStateObserver::InvalidateCopyPolicy()
+{
+    std::unique_lock<std::shared_mutex> lock(copyPolicyLock_);
+    copyPolicyGeneration_++;
+    copyPolicyCache_.clear();
+}
+
 int32_t AppStateObserver::QueryDlpFileAccessByUid(DLPFileAccess& dlpFileAccess, int32_t uid)
 {
     DlpSandboxInfo appInfo;
@@ -722,6 +711,12 @@ int32_t AppStateObserver::QueryDlpFileAccessByUid(DLPFileAccess& dlpFileAccess,
     return DLP_OK;
 }
 
+bool AppStateObserver::IsSandboxUid(int32_t uid) const
+{
+    return sandboxRegistry_.Read(uid,
+        [](const DlpSandboxInfo* appInfo) { return appInfo != nullptr && appInfo->appIndex > 0; });
+}
+
 int32_t AppStateObserver::IsInDlpSandbox(bool& inSandbox, int32_t uid)
 {
     inSandbox = false;
@@ -735,10 +730,8 @@ int32_t AppStateObserver::IsInDlpSandbox(bool& inSandbox, int32_t uid)
 
 void AppStateObserver::DumpSandbox(int fd)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
     dprintf(fd, "DlpSandbox:\n");
-    for (auto iter = sandboxInfo_.begin(); iter != sandboxInfo_.end(); iter++) {
-        DlpSandboxInfo& appInfo = iter->second;
+    for (const auto& appInfo : sandboxRegistry_.GetAll()) {
         dprintf(fd, "    userId:%d;bundleName:%s;sandboxIndex:%d;dlpFileAccess:%s\n",
             appInfo.userId, appInfo.bundleName.c_str(), appInfo.appIndex,
             appInfo.dlpFileAccess == DLPFileAccess::READ_ONLY ? "ReadOnly" : "FullControl");
@@ -787,19 +780,16 @@ bool AppStateObserver::AddUriAndEnterpriseInfo(const std::string& uri, const Ent
         DLP_LOG_ERROR(LABEL, "uri is invalid");
         return false;
     }
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    DLP_LOG_INFO(LABEL, "add enterpriseUriMap, classificationLabel: %{private}s",
+    DLP_LOG_INFO(LABEL, "add enterprise info, classificationLabel: %{private}s",
         enterpriseInfo.classificationLabel.c_str());
-    enterpriseUriMap_[uri] = enterpriseInfo;
+    enterpriseFileTracker_.Put(uri, enterpriseInfo);
+    InvalidateCopyPolicy();
     return true;
 }
 
 bool AppStateObserver::GetEnterpriseInfoByUri(const std::string& uri, EnterpriseInfo& enterpriseInfo)
 {
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    auto iter = enterpriseUriMap_.find(uri);
-    if (iter != enterpriseUriMap_.end()) {
-        enterpriseInfo = iter->second;
+    if (enterpriseFileTracker_.Get(uri, enterpriseInfo)) {
         DLP_LOG_INFO(LABEL, "enterprise info hit for uri");
         return true;
     }
@@ -808,23 +798,17 @@ bool AppStateObserver::GetEnterpriseInfoByUri(const std::string& uri, Enterprise
 
 bool AppStateObserver::GetEnterpriseInfoByUid(int32_t uid, EnterpriseInfo& enterpriseInfo)
 {
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    for (const auto& entry : enterpriseUriMap_) {
-        if (entry.second.uid == uid) {
-            enterpriseInfo = entry.second;
-            DLP_LOG_INFO(LABEL, "enterprise info hit for uid");
-            return true;
-        }
+    if (enterpriseFileTracker_.GetByUid(uid, enterpriseInfo)) {
+        DLP_LOG_INFO(LABEL, "enterprise info hit for uid");
+        return true;
     }
     return false;
 }
 
 void AppStateObserver::UpdateEnterpriseUidByUri(const std::string& uri, const std::string& fileId, int32_t uid)
 {
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    auto iter = enterpriseUriMap_.find(uri);
-    if (iter != enterpriseUriMap_.end() && iter->second.fileId == fileId) {
-        iter->second.uid = uid;
+    if (enterpriseFileTracker_.UpdateUid(uri, fileId, uid)) {
+        InvalidateCopyPolicy();
     }
 }
 
@@ -833,38 +817,27 @@ void AppStateObserver::EraseEnterpriseInfoByUid(const std::vector<DlpSandboxInfo
     if (appInfos.empty()) {
         return;
     }
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    for (auto mapIter = enterpriseUriMap_.begin(); mapIter != enterpriseUriMap_.end();) {
-        bool needErase = false;
-        for (const auto& appInfo : appInfos) {
-            if (mapIter->second.uid == appInfo.uid) {
-                needErase = true;
-                break;
-            }
-        }
-        if (needErase) {
-            mapIter = enterpriseUriMap_.erase(mapIter);
-            continue;
-        }
-        ++mapIter;
+    std::set<int32_t> uids;
+    for (const auto& appInfo : appInfos) {
+        uids.insert(appInfo.uid);
     }
+    (void)enterpriseFileTracker_.EraseByUids(uids);
+    InvalidateCopyPolicy();
 }
 
 void AppStateObserver::EraseEnterpriseInfoByUri(const std::string& uri, const std::string& fileId)
 {
-    std::lock_guard<std::mutex> lock(enterpriseUriMapLock_);
-    auto iter = enterpriseUriMap_.find(uri);
-    if (iter != enterpriseUriMap_.end() && iter->second.fileId == fileId) {
+    if (enterpriseFileTracker_.Erase(uri, fileId)) {
         DLP_LOG_INFO(LABEL, "erase enterprise info by uri");
-        enterpriseUriMap_.erase(iter);
+        InvalidateCopyPolicy();
     }
 }
 
 void AppStateObserver::GetDelSandboxInfo(std::unordered_map<int32_t, DlpSandboxInfo>& sandboxInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    for (const auto& entry : sandboxInfo_) {
-        sandboxInfo[entry.first] = entry.second;
+    for (auto& appInfo : sandboxRegistry_.GetAll()) {
+        int32_t uid = appInfo.uid;
+        sandboxInfo[uid] = std::move(appInfo);
     }
 }
 
@@ -874,53 +847,94 @@ void AppStateObserver::PostDelayUnloadTask(CurrentTaskState newTaskState)
     DLP_LOG_INFO(LABEL, "fuzz or tdd test, do not post delay unload task");
     return;
 #endif
+    int64_t now = GetSteadyTimeMs();
+    lastActivityMs_.store(now);
+    CurrentTaskState state = taskState_.load();
+    do {
+        if (state == CurrentTaskState::LONG_TASK && newTaskState == CurrentTaskState::SHORT_TASK) {
+            break;
+        }
+    } while (!taskState_.compare_exchange_weak(state, newTaskState));
+
+    // An armed timer re-reads the activity time when it fires, so a call only touches the handler when there is
+    // no timer yet, or when the critical state it raised needs an earlier release check.
+    int64_t deadline = unloadDeadlineMs_.load();
+    bool needCriticalCheck = IsCriticalHeldByCalls() && deadline > now + CRITICAL_RELEASE_DELAY;
+    if (deadline != 0 && !needCriticalCheck) {
+        return;
+    }
     std::lock_guard<std::mutex> lock(unloadHandlerMutex_);
     if (unloadHandler_ == nullptr) {
         DLP_LOG_ERROR(LABEL, "unloadHandler_ is nullptr. Unable to automatically uninstall dlp_permission_sevice");
         InitUnloadHandler();
         return;
     }
-    DLP_LOG_DEBUG(LABEL, "PostDelayUnloadTask start");
-    if (taskState_ == CurrentTaskState::LONG_TASK && newTaskState == CurrentTaskState::SHORT_TASK) {
-        DLP_LOG_DEBUG(LABEL, "taskState_ is LONG_TASK, do not change to SHORT_TASK");
+    if (needCriticalCheck) {
+        ArmUnloadTimerLocked(CRITICAL_RELEASE_DELAY);
         return;
     }
-    taskState_ = newTaskState;
-    auto task = [this]() {
-        if (taskState_ == CurrentTaskState::SHORT_TASK || taskState_ == CurrentTaskState::LONG_TASK) {
-            PostDelayUnloadTask(CurrentTaskState::IDLE);
-            return;
-        }
+    if (unloadDeadlineMs_.load() == 0) {
+        ArmUnloadTimerLocked(taskState_.load() == CurrentTaskState::LONG_TASK ? SA_LONG_LIFT_TIME :
+            SA_SHORT_LIFT_TIME);
+    }
+}
+
+void AppStateObserver::ArmUnloadTimerLocked(int64_t delayMs)
+{
+    unloadHandler_->RemoveTask(TASK_ID);
+    unloadDeadlineMs_.store(GetSteadyTimeMs() + delayMs);
+    DLP_LOG_INFO(LABEL, "unload check in %{public}dms, task state %{public}d", static_cast<int32_t>(delayMs),
+        static_cast<int32_t>(taskState_.load()));
+    unloadHandler_->PostTask([this]() { OnUnloadTimer(); }, TASK_ID, delayMs);
+}
+
+void AppStateObserver::RearmUnloadTimer(int64_t delayMs, int64_t releaseInMs)
+{
+    // A pending release fires when it is due. A call still in flight keeps the check at the release delay, so the
+    // critical state never outlives the last call by a whole SA lifetime.
+    if (releaseInMs > 0) {
+        delayMs = std::min(delayMs, releaseInMs);
+    } else if (IsCriticalHeldByCalls()) {
+        delayMs = std::min(delayMs, CRITICAL_RELEASE_DELAY);
+    }
+    std::lock_guard<std::mutex> lock(unloadHandlerMutex_);
+    if (unloadHandler_ == nullptr) {
+        return;
+    }
+    ArmUnloadTimerLocked(delayMs);
+}
+
+void AppStateObserver::OnUnloadTimer()
+{
+    unloadDeadlineMs_.store(0);
+    int64_t releaseInMs = ReleaseCriticalIfIdle(CRITICAL_RELEASE_DELAY);
+    int64_t idleMs = GetSteadyTimeMs() - lastActivityMs_.load();
+    CurrentTaskState state = taskState_.load();
+    int64_t lifeTime = (state == CurrentTaskState::LONG_TASK) ? SA_LONG_LIFT_TIME : SA_SHORT_LIFT_TIME;
+    if (idleMs < lifeTime) {
+        RearmUnloadTimer(lifeTime - idleMs, releaseInMs);
+        return;
+    }
+    if (state != CurrentTaskState::IDLE) {
+        // A finished task keeps the SA for one more short period before unloading.
+        (void)taskState_.compare_exchange_strong(state, CurrentTaskState::IDLE);
+        lastActivityMs_.store(GetSteadyTimeMs());
+        RearmUnloadTimer(SA_SHORT_LIFT_TIME, releaseInMs);
+        return;
+    }
+    {
         std::lock_guard<std::mutex> lock(terminalMutex_);
-        int32_t ret = ExitSaAfterAllDlpManagerDie();
-        if (ret != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "ExitSaAfterAllDlpManagerDie failed");
-            PostDelayUnloadTask(CurrentTaskState::IDLE);
+        if (ExitSaAfterAllDlpManagerDie() == DLP_OK) {
             return;
         }
-    };
-    unloadHandler_->RemoveTask(TASK_ID);
-    if (taskState_ == CurrentTaskState::LONG_TASK) {
-        DLP_LOG_INFO(LABEL, "you will delay long task for 120s");
-        unloadHandler_->PostTask(task, TASK_ID, SA_LONG_LIFT_TIME);
-        return;
     }
-    DLP_LOG_INFO(LABEL, "you will delay %{public}d task for 60s", taskState_);
-    unloadHandler_->PostTask(task, TASK_ID, SA_SHORT_LIFT_TIME);
+    DLP_LOG_ERROR(LABEL, "ExitSaAfterAllDlpManagerDie failed");
+    RearmUnloadTimer(SA_SHORT_LIFT_TIME, releaseInMs);
 }
 bool AppStateObserver::GetSandboxInfoByAppIndex(const std::string& bundleName,
     int32_t appIndex, DlpSandboxInfo& appInfo)
 {
-    std::lock_guard<std::mutex> lock(sandboxInfoLock_);
-    auto iter = std::find_if(sandboxInfo_.begin(), sandboxInfo_.end(),
-        [bundleName, appIndex](const auto& pair) {
-            return pair.second.appIndex == appIndex && pair.second.bundleName == bundleName;
-        });
-    if (iter != sandboxInfo_.end()) {
-        appInfo = iter->second;
-        return true;
-    }
-    return false;
+    return sandboxRegistry_.GetByAppIndex(bundleName, appIndex, appInfo);
 }
 
 bool AppStateObserver::GetSandboxInfoByTokenId(uint32_t tokenId, DlpSandboxInfo& appInfo)
@@ -16,14 +16,19 @@
 #ifndef DLP_PERMISSION_SERVICE_SERVICES_DLP_PERMISSION_SA_APP_STATE_OBSERVER_APP_STATE_OBSERVER_H
 #define DLP_PERMISSION_SERVICE_SERVICES_DLP_PERMISSION_SA_APP_STATE_OBSERVER_APP_STATE_OBSERVER_H
 
+#include <atomic>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 #include "application_state_observer_stub.h"
 #include "app_mgr_proxy.h"
+#include "dlp_permission.h"
 #include "dlp_sandbox_info.h"
+#include "enterprise_file_tracker.h"
 #include "iremote_object.h"
 #include "retention_file_manager.h"
 #include "event_handler.h"
+#include "sandbox_registry.h"
 
 namespace OHOS {
 namespace Security {
@@ -31,12 +36,13 @@ namespace DlpPermission {
 using OHOS::AppExecFwk::RunningProcessInfo;
 enum class CurrentTaskState { IDLE, SHORT_TASK, LONG_TASK };
 
-struct EnterpriseInfo {
-    std::string classificationLabel = "";
-    DLPFileAccess dlpFileAccess = DLPFileAccess::NO_PERMISSION;
+// What QueryDlpFileCopyableByTokenId needs about one token, resolved together and cached per token.
+struct DlpCopyPolicy {
+    bool inDlpSandbox = false;
+    bool copyable = false;
+    int32_t result = DLP_SERVICE_ERROR_APPOBSERVER_ERROR;
+    bool isEnterprise = false;
     std::string fileId = "";
-    std::string appIdentifier = "";
-    int32_t uid = -1;
 };
 
 struct InputSandboxInfo {
@@ -55,6 +61,7 @@ public:
     void OnProcessDied(const AppExecFwk::ProcessData& processData) override;
     int32_t QueryDlpFileCopyableByTokenId(bool& copyable, uint32_t tokenId, bool& inDlpsandbox);
     int32_t QueryDlpFileCopyableByTokenId(bool& copyable, uint32_t tokenId);
+    void GetCopyPolicyByTokenId(uint32_t tokenId, DlpCopyPolicy& policy);
     int32_t QueryDlpFileAccessByUid(DLPFileAccess& dlpFileAccess, int32_t uid);
     int32_t IsInDlpSandbox(bool& inSandbox, int32_t uid);
     void AddDlpSandboxInfo(const DlpSandboxInfo& appInfo);
@@ -97,6 +104,8 @@ public:
     void AddMaskInfoCnt(const DlpSandboxInfo& appInfo);
     bool GetSandboxInfoByAppIndex(const std::string& bundleName, int32_t appIndex, DlpSandboxInfo& appInfo);
     bool GetSandboxInfoByTokenId(uint32_t tokenId, DlpSandboxInfo& appInfo);
+    // Same answer as IsInDlpSandbox without copying the record, for per-launch checks.
+    bool IsSandboxUid(int32_t uid) const;
 
 private:
     void UninstallDlpSandbox(DlpSandboxInfo& appInfo);
@@ -119,26 +128,34 @@ private:
     bool CanUninstallByGid(DlpSandboxInfo& appInfo, const AppExecFwk::ProcessData& processData);
     void OnDlpmanagerDied(const AppExecFwk::ProcessData& processData);
     bool InitUnloadHandler();
+    void OnUnloadTimer();
+    void RearmUnloadTimer(int64_t delayMs, int64_t releaseInMs);
+    void ArmUnloadTimerLocked(int64_t delayMs);
     void CheckHasBackgroundTask();
+    void InvalidateCopyPolicy();
 
-    std::unordered_map<uint32_t, int32_t> tokenIdToUidMap_;
-    std::mutex tokenIdToUidMapLock_;
-    std::unordered_map<int32_t, DlpSandboxInfo> sandboxInfo_;
-    std::mutex sandboxInfoLock_;
+    SandboxRegistry sandboxRegistry_;
+    // Copy policy per queried token, sandbox or not; cleared by every sandbox and enterprise info change.
+    std::unordered_map<uint32_t, DlpCopyPolicy> copyPolicyCache_;
+    uint64_t copyPolicyGeneration_ = 0;
+    std::shared_mutex copyPolicyLock_;
     std::set<int32_t> userIdList_;
     std::mutex userIdListLock_;
     std::map<int32_t, int32_t> callbackList_;
     std::mutex callbackListLock_;
+    IdFilter callbackPidFilter_;  // pids of callbackList_, checked before the lock on every process death
     sptr<AppExecFwk::AppMgrProxy> appProxy_ = nullptr;
     std::unordered_map<std::string, FileInfo> fileInfoUriMap_;
     std::mutex fileInfoUriMapLock_;
-    std::unordered_map<std::string, EnterpriseInfo> enterpriseUriMap_;
-    std::mutex enterpriseUriMapLock_;
+    EnterpriseFileTracker enterpriseFileTracker_;
     std::mutex terminalMutex_;
     std::shared_ptr<AppExecFwk::EventHandler> unloadHandler_ = nullptr;
-    CurrentTaskState taskState_;
+    std::atomic<CurrentTaskState> taskState_ { CurrentTaskState::IDLE };
+    std::atomic<int64_t> lastActivityMs_ { 0 };
+    std::atomic<int64_t> unloadDeadlineMs_ { 0 };  // 0 while no unload timer is armed
     std::mutex unloadHandlerMutex_;
     std::unordered_map<std::string, int> maskInfoMap_;
+    std::mutex maskInfoMapLock_;
 };
 }  // namespace DlpPermission
 }  // namespace Security
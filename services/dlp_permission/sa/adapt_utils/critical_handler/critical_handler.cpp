@@ -15,6 +15,9 @@
 
 #include "critical_handler.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include "dlp_permission_log.h"
 #include "mem_mgr_client.h"
 #include "mem_mgr_proxy.h"
@@ -24,11 +27,19 @@ namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "CriticalHandler"};
 }
 
-static uint32_t g_count = 0;
-static bool g_hasBackgroundTask = false;
+static std::atomic<uint32_t> g_count { 0 };
+static std::atomic<bool> g_hasBackgroundTask { false };
+static std::atomic<bool> g_isCritical { false };
+static std::atomic<int64_t> g_idleSinceMs { 0 };
 static std::mutex g_criticalMutex;
 static constexpr int32_t SA_ID_DLP_PERMISSION_SERVICE = 3521;
 
+static int64_t GetSteadyTimeMs(void)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void NotifyProcessIsActive(void)
 {
     DLP_LOG_INFO(LABEL, "start to notify memmgr sa active");
@@ -41,34 +52,55 @@ void NotifyProcessIsStop(void)
     OHOS::Memory::MemMgrClient::GetInstance().NotifyProcessStatus(getpid(), 1, 0, SA_ID_DLP_PERMISSION_SERVICE);
 }
 
-void IncreaseCriticalCnt(void)
+static void AcquireCritical(void)
 {
     std::lock_guard<std::mutex> lock(g_criticalMutex);
-    if (g_count == 0 && !g_hasBackgroundTask) {
-        DLP_LOG_INFO(LABEL, "Try to set critical to true");
-        OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), true, SA_ID_DLP_PERMISSION_SERVICE);
+    if (g_isCritical.load()) {
+        return;
+    }
+    DLP_LOG_INFO(LABEL, "Try to set critical to true");
+    OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), true, SA_ID_DLP_PERMISSION_SERVICE);
+    g_isCritical.store(true);
+}
+
+// Caller holds g_criticalMutex. Clears the flag before re-reading the counter so a concurrent
+// IncreaseCriticalCnt either sees the cleared flag and re-acquires, or makes this release back off.
+static void ReleaseCriticalLocked(void)
+{
+    if (!g_isCritical.load() || g_hasBackgroundTask.load()) {
+        return;
+    }
+    g_isCritical.store(false);
+    if (g_count.load() != 0) {
+        g_isCritical.store(true);
+        return;
+    }
+    DLP_LOG_INFO(LABEL, "Try to set critical to false");
+    OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), false, SA_ID_DLP_PERMISSION_SERVICE);
+}
+
+void IncreaseCriticalCnt(void)
+{
+    g_count.fetch_add(1);
+    if (!g_isCritical.load()) {
+        AcquireCritical();
     }
-    g_count = g_count + 1;
-    DLP_LOG_DEBUG(LABEL, "IncreaseCriticalCnt g_count %{public}d g_hasBackgroundTask %{public}d",
-        g_count, g_hasBackgroundTask);
 }
 
 void DecreaseCriticalCnt(void)
 {
-    std::lock_guard<std::mutex> lock(g_criticalMutex);
-    g_count = g_count > 0 ? g_count - 1 : g_count;
-    DLP_LOG_DEBUG(LABEL, "DecreaseCriticalCnt g_count %{public}d g_hasBackgroundTask %{public}d",
-        g_count, g_hasBackgroundTask);
-    if (g_count == 0 && !g_hasBackgroundTask) {
-        DLP_LOG_INFO(LABEL, "Try to set critical to false");
-        OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), false, SA_ID_DLP_PERMISSION_SERVICE);
+    uint32_t count = g_count.load();
+    while (count > 0 && !g_count.compare_exchange_weak(count, count - 1)) {
+    }
+    if (count == 1) {
+        // Released by the idle timer through ReleaseCriticalIfIdle, so back-to-back calls keep one critical period.
+        g_idleSinceMs.store(GetSteadyTimeMs());
     }
 }
 
 uint32_t GetCriticalCnt(void)
 {
-    std::lock_guard<std::mutex> lock(g_criticalMutex);
-    return g_count;
+    return g_count.load();
 }
 
 void SetHasBackgroundTask(bool hasBackgroundTask)
@@ -76,23 +108,46 @@ void SetHasBackgroundTask(bool hasBackgroundTask)
     std::lock_guard<std::mutex> lock(g_criticalMutex);
     DLP_LOG_DEBUG(LABEL,
         "SetHasBackgroundTask g_count %{public}d g_hasBackgroundTask %{public}d hasBackgroundTask %{public}d",
-        g_count, g_hasBackgroundTask, hasBackgroundTask);
-    if (hasBackgroundTask == g_hasBackgroundTask) {
+        g_count.load(), g_hasBackgroundTask.load(), hasBackgroundTask);
+    if (hasBackgroundTask == g_hasBackgroundTask.load()) {
         return;
     }
-    if (g_count == 0 && hasBackgroundTask) {
+    g_hasBackgroundTask.store(hasBackgroundTask);
+    if (hasBackgroundTask && !g_isCritical.load()) {
         DLP_LOG_INFO(LABEL, "Try to set critical to true");
         OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), true, SA_ID_DLP_PERMISSION_SERVICE);
+        g_isCritical.store(true);
     }
-    if (g_count == 0 && !hasBackgroundTask) {
-        DLP_LOG_INFO(LABEL, "Try to set critical to false");
-        OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), false, SA_ID_DLP_PERMISSION_SERVICE);
+    if (!hasBackgroundTask) {
+        ReleaseCriticalLocked();
     }
-    g_hasBackgroundTask = hasBackgroundTask;
 }
 
 bool GetHasBackgroundTask(void)
 {
+    return g_hasBackgroundTask.load();
+}
+
+bool IsCriticalReleasePending(void)
+{
+    return g_isCritical.load() && g_count.load() == 0 && !g_hasBackgroundTask.load();
+}
+
+bool IsCriticalHeldByCalls(void)
+{
+    return g_isCritical.load() && !g_hasBackgroundTask.load();
+}
+
+int64_t ReleaseCriticalIfIdle(int64_t idleDelayMs)
+{
+    if (!IsCriticalReleasePending()) {
+        return 0;
+    }
+    int64_t idleMs = GetSteadyTimeMs() - g_idleSinceMs.load();
+    if (idleMs < idleDelayMs) {
+        return idleDelayMs - idleMs;
+    }
     std::lock_guard<std::mutex> lock(g_criticalMutex);
-    return g_hasBackgroundTask;
+    ReleaseCriticalLocked();
+    return 0;
 }
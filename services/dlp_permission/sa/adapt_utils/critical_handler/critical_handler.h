@@ -31,6 +31,13 @@ void DecreaseCriticalCnt(void);
 uint32_t GetCriticalCnt(void);
 void SetHasBackgroundTask(bool hasBackgroundTask);
 bool GetHasBackgroundTask(void);
+// True while MemMgr still sees the SA as critical although no call or background task needs it.
+bool IsCriticalReleasePending(void);
+// True while the critical state is held for calls only, i.e. it will need a release by the idle timer.
+bool IsCriticalHeldByCalls(void);
+// Drops the critical state once the SA has been idle for idleDelayMs; driven by the idle timer.
+// Returns the time left before a pending release is due, 0 when none is pending.
+int64_t ReleaseCriticalIfIdle(int64_t idleDelayMs);
 
 #ifdef __cplusplus
 }
@@ -24,16 +24,15 @@ namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "CriticalHelper"};
 }  // namespace
 
-CriticalHelper::CriticalHelper(const std::string& functionName)
+CriticalHelper::CriticalHelper(const char* functionName) : functionName_(functionName)
 {
-    DLP_LOG_INFO(LABEL, "%{public}s is begin", functionName.c_str());
-    functionName_ = functionName;
+    DLP_LOG_DEBUG(LABEL, "%{public}s is begin", functionName_);
     (void)IncreaseCriticalCnt();
 }
 
 CriticalHelper::~CriticalHelper()
 {
-    DLP_LOG_INFO(LABEL, "%{public}s is end", functionName_.c_str());
+    DLP_LOG_DEBUG(LABEL, "%{public}s is end", functionName_);
     (void)DecreaseCriticalCnt();
 }
 
@@ -16,19 +16,17 @@
 #ifndef CRITICAL_HELPER_H
 #define CRITICAL_HELPER_H
 
-#include <string>
-#include <vector>
-
 namespace OHOS {
 namespace Security {
 namespace DlpPermission {
 class CriticalHelper {
 public:
-    explicit CriticalHelper(const std::string& functionName);
+    // functionName must outlive the helper; every caller passes a literal.
+    explicit CriticalHelper(const char* functionName);
     ~CriticalHelper();
 
 private:
-    std::string functionName_;
+    const char* functionName_;
 };
 } // namespace DlpPermission
 } // namespace Security
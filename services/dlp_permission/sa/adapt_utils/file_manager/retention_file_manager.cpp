@@ -155,6 +155,16 @@ int32_t RetentionFileManager::RemoveRetentionState(const std::string& bundleName
     return UpdateFile(res);
 }
 
+int32_t RetentionFileManager::RemoveRetentionStates(const std::vector<std::pair<std::string, int32_t>>& sandboxes)
+{
+    if (!Init()) {
+        DLP_LOG_ERROR(LABEL, "Init failed!");
+        return DLP_RETENTION_UPDATE_ERROR;
+    }
+    int32_t res = sandboxJsonManager_->RemoveRetentionStates(sandboxes);
+    return UpdateFile(res);
+}
+
 int32_t RetentionFileManager::ClearUnreservedSandbox(int32_t isNotMatch)
 {
     if (!Init()) {
@@ -204,6 +214,35 @@ int32_t RetentionFileManager::UpdateReadFlag(uint32_t tokenId)
     int32_t res = sandboxJsonManager_->UpdateReadFlag(tokenId);
     return UpdateFile(res);
 }
+
+int32_t RetentionFileManager::AddPoolSandbox(const RetentionInfo& info)
+{
+    if (!Init()) {
+        DLP_LOG_ERROR(LABEL, "Init failed!");
+        return DLP_RETENTION_UPDATE_ERROR;
+    }
+    int32_t res = sandboxJsonManager_->AddPoolSandbox(info);
+    return UpdateFile(res);
+}
+
+int32_t RetentionFileManager::RemovePoolSandboxes(const std::vector<RetentionInfo>& sandboxes)
+{
+    if (!Init()) {
+        DLP_LOG_ERROR(LABEL, "Init failed!");
+        return DLP_RETENTION_UPDATE_ERROR;
+    }
+    int32_t res = sandboxJsonManager_->RemovePoolSandboxes(sandboxes);
+    return UpdateFile(res);
+}
+
+std::vector<RetentionInfo> RetentionFileManager::GetPoolSandboxes()
+{
+    if (!Init()) {
+        DLP_LOG_ERROR(LABEL, "Init failed!");
+        return {};
+    }
+    return sandboxJsonManager_->GetPoolSandboxes();
+}
 } // namespace DlpPermission
 } // namespace Security
 } // namespace OHOS
@@ -39,6 +39,8 @@ public:
     void SetInitStatus(const uint32_t& tokenId);
     int32_t UpdateSandboxInfo(const std::set<std::string>& docUriSet, RetentionInfo& info, bool isRetention);
     int32_t RemoveRetentionState(const std::string& bundleName, const int32_t& appIndex);
+    // Removes the retention state of every (bundleName, appIndex) pair and persists the file once.
+    int32_t RemoveRetentionStates(const std::vector<std::pair<std::string, int32_t>>& sandboxes);
     int32_t GetRetentionSandboxList(const std::string& bundleName,
         std::vector<RetentionSandBoxInfo>& retentionSandBoxInfoVec, bool isRetention);
     bool HasRetentionSandboxInfo(const std::string& bundleName);
@@ -46,6 +48,10 @@ public:
     int32_t UpdateReadFlag(uint32_t tokenId);
     int32_t GetBundleNameSetByUserId(const int32_t userId, std::set<std::string>& bundleNameSet);
     int32_t RemoveRetentionInfoByUserId(const int32_t userId, const std::set<std::string>& bundleNameSet);
+    // Pre-installed pool sandboxes, kept on disk so that a restarted service can uninstall the ones it lost.
+    int32_t AddPoolSandbox(const RetentionInfo& info);
+    int32_t RemovePoolSandboxes(const std::vector<RetentionInfo>& sandboxes);
+    std::vector<RetentionInfo> GetPoolSandboxes();
 private:
     RetentionFileManager();
     DISALLOW_COPY_AND_MOVE(RetentionFileManager);
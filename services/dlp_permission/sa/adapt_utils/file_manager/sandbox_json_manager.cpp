@@ -15,6 +15,7 @@
 
 #include "sandbox_json_manager.h"
 
+#include <algorithm>
 #include "appexecfwk_errors.h"
 #include "bundle_mgr_client.h"
 #include "dlp_permission_log.h"
@@ -42,6 +43,8 @@ const std::string USERID = "userId";
 const std::string TOKENID = "tokenId";
 const std::string DLPFILEACCESS = "dlpFileAccess";
 const std::string HAS_READ = "hasRead";
+const std::string RETENTION = "retention";
+const std::string POOL = "pool";
 static const uint32_t MAX_RETENTION_SIZE = 1024;
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "SandboxJsonManager" };
 }
@@ -264,6 +267,32 @@ int32_t SandboxJsonManager::RemoveRetentionState(const std::string& bundleName,
     return DLP_OK;
 }
 
+int32_t SandboxJsonManager::RemoveRetentionStates(const std::vector<std::pair<std::string, int32_t>>& sandboxes)
+{
+    if (sandboxes.empty()) {
+        return DLP_FILE_NO_NEED_UPDATE;
+    }
+    int32_t userId;
+    if (!GetUserIdByForegroundAccount(&userId)) {
+        return DLP_SERVICE_ERROR_GET_ACCOUNT_FAIL;
+    }
+    bool hasRemoved = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = infoVec_.begin(); iter != infoVec_.end();) {
+        bool isMatch = iter->userId == userId && std::any_of(sandboxes.begin(), sandboxes.end(),
+            [&iter](const std::pair<std::string, int32_t>& sandbox) {
+                return iter->bundleName == sandbox.first && (sandbox.second == -1 || iter->appIndex == sandbox.second);
+            });
+        if (isMatch) {
+            iter = infoVec_.erase(iter);
+            hasRemoved = true;
+        } else {
+            ++iter;
+        }
+    }
+    return hasRemoved ? DLP_OK : DLP_FILE_NO_NEED_UPDATE;
+}
+
 int32_t SandboxJsonManager::GetRetentionSandboxList(const std::string& bundleName,
     std::vector<RetentionSandBoxInfo>& retentionSandBoxInfoVec, bool isRetention)
 {
@@ -393,6 +422,44 @@ int32_t SandboxJsonManager::RemoveRetentionInfoByUserId(const int32_t userId,
     return DLP_OK;
 }
 
+int32_t SandboxJsonManager::AddPoolSandbox(const RetentionInfo& info)
+{
+    if (info.bundleName.empty() || info.appIndex < 0 || info.userId < 0) {
+        DLP_LOG_ERROR(LABEL, "param is invalid");
+        return DLP_INSERT_FILE_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (poolVec_.size() >= MAX_RETENTION_SIZE) {
+        DLP_LOG_ERROR(LABEL, "too many pool sandboxes");
+        return DLP_INSERT_FILE_ERROR;
+    }
+    poolVec_.emplace_back(info);
+    return DLP_OK;
+}
+
+int32_t SandboxJsonManager::RemovePoolSandboxes(const std::vector<RetentionInfo>& sandboxes)
+{
+    bool hasRemoved = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& sandbox : sandboxes) {
+        auto iter = std::find_if(poolVec_.begin(), poolVec_.end(), [&sandbox](const RetentionInfo& info) {
+            return info.bundleName == sandbox.bundleName && info.appIndex == sandbox.appIndex &&
+                info.userId == sandbox.userId;
+        });
+        if (iter != poolVec_.end()) {
+            poolVec_.erase(iter);
+            hasRemoved = true;
+        }
+    }
+    return hasRemoved ? DLP_OK : DLP_FILE_NO_NEED_UPDATE;
+}
+
+std::vector<RetentionInfo> SandboxJsonManager::GetPoolSandboxes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return poolVec_;
+}
+
 bool SandboxJsonManager::CheckReInstall(const RetentionInfo& info, const int32_t userId)
 {
     uint32_t tokenId = AccessToken::AccessTokenKit::GetHapTokenID(userId, info.bundleName, info.appIndex);
@@ -436,7 +503,12 @@ Json SandboxJsonManager::ToJson() const
     for (auto iter = infoVec_.begin(); iter != infoVec_.end(); ++iter) {
         Json infoJson;
         RetentionInfoToJson(infoJson, *iter);
-        jsonObject["retention"].emplace_back(infoJson);
+        jsonObject[RETENTION].emplace_back(infoJson);
+    }
+    for (const auto& info : poolVec_) {
+        Json infoJson;
+        RetentionInfoToJson(infoJson, info);
+        jsonObject[POOL].emplace_back(infoJson);
     }
     return jsonObject;
 }
@@ -492,11 +564,20 @@ void SandboxJsonManager::FromJson(const Json& jsonObject)
         DLP_LOG_ERROR(LABEL, "json error");
         return;
     }
-    if (!jsonObject.contains("retention") || !jsonObject.at("retention").is_array()) {
+    if (jsonObject.contains(POOL) && jsonObject.at(POOL).is_array()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& poolJson : jsonObject.at(POOL)) {
+            RetentionInfo info;
+            if (ParseRetentionInfo(poolJson, info) && poolVec_.size() < MAX_RETENTION_SIZE) {
+                poolVec_.emplace_back(info);
+            }
+        }
+    }
+    if (!jsonObject.contains(RETENTION) || !jsonObject.at(RETENTION).is_array()) {
         DLP_LOG_ERROR(LABEL, "json has no retention array");
         return;
     }
-    for (const auto& retentionJson : jsonObject["retention"]) {
+    for (const auto& retentionJson : jsonObject[RETENTION]) {
         RetentionInfo info;
         if (!ParseRetentionInfo(retentionJson, info)) {
             continue;
@@ -58,6 +58,7 @@ public:
     int32_t UpdateRetentionState(const std::set<std::string>& docUriSet, RetentionInfo& info, bool isRetention);
     int32_t UpdateReadFlag(uint32_t tokenId);
     int32_t RemoveRetentionState(const std::string& bundleName, const int32_t& appIndex);
+    int32_t RemoveRetentionStates(const std::vector<std::pair<std::string, int32_t>>& sandboxes);
     bool HasRetentionSandboxInfo(const std::string& bundleName);
     int32_t GetRetentionSandboxList(const std::string& bundleName,
         std::vector<RetentionSandBoxInfo>& retentionSandBoxInfoVec, bool isRetention);
@@ -68,6 +69,9 @@ public:
     std::string ToString() const override;
     int32_t GetBundleNameSetByUserId(const int32_t userId, std::set<std::string>& bundleNameSet);
     int32_t RemoveRetentionInfoByUserId(const int32_t userId, const std::set<std::string>& bundleNameSet);
+    int32_t AddPoolSandbox(const RetentionInfo& info);
+    int32_t RemovePoolSandboxes(const std::vector<RetentionInfo>& sandboxes);
+    std::vector<RetentionInfo> GetPoolSandboxes() const;
 
 private:
     bool ParseRetentionInfo(const Json& retentionJson, RetentionInfo& info);
@@ -84,6 +88,7 @@ private:
         bool (*update)(RetentionInfo& info, const std::set<std::string>& newSet));
     mutable std::mutex mutex_;
     std::vector<RetentionInfo> infoVec_;
+    std::vector<RetentionInfo> poolVec_;
 };
 } // namespace DlpPermission
 } // namespace Security
@@ -162,6 +162,49 @@ void DlpSandboxChangeCallbackManager::ExecuteCallbackAsync(const DlpSandboxInfo
     }
     DLP_LOG_INFO(LABEL, "The callback execution is complete");
 }
+
+void DlpSandboxChangeCallbackManager::ExecuteCallbackBatchAsync(const std::vector<DlpSandboxInfo> &dlpSandboxInfos)
+{
+    if (dlpSandboxInfos.empty()) {
+        return;
+    }
+    // Sandboxes installed by one caller share its callback, so each callback gets a single combined request.
+    std::map<int32_t, std::vector<DlpSandboxCallbackInfo>> changesByPid;
+    for (const auto& dlpSandboxInfo : dlpSandboxInfos) {
+        DlpSandboxCallbackInfo resInfo;
+        resInfo.appIndex = dlpSandboxInfo.appIndex;
+        resInfo.bundleName = dlpSandboxInfo.bundleName;
+        changesByPid[dlpSandboxInfo.pid].emplace_back(resInfo);
+    }
+    auto callbackStart = [changesByPid, this]() mutable {
+        std::string name = "DlpCallback";
+        pthread_setname_np(pthread_self(), name.substr(0, MAX_PTHREAD_NAME_LEN).c_str());
+        for (auto& changes : changesByPid) {
+            sptr<IRemoteObject> callbackObj = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto goalCallback = callbackInfoMap_.find(changes.first);
+                if (goalCallback == callbackInfoMap_.end()) {
+                    continue;
+                }
+                callbackObj = goalCallback->second.callbackObject_;
+            }
+            auto callback = iface_cast<IDlpSandboxStateChangeCallback>(callbackObj);
+            if (callback != nullptr) {
+                callback->DlpSandboxStateChangeBatchCallback(changes.second);
+            }
+        }
+    };
+    std::packaged_task<void()> callbackTask(callbackStart);
+    std::future<void> fut = callbackTask.get_future();
+    std::make_unique<std::thread>(std::move(callbackTask))->detach();
+
+    DLP_LOG_INFO(LABEL, "Waiting for %{public}zu callback executions to complete...", dlpSandboxInfos.size());
+    std::future_status status = fut.wait_for(std::chrono::seconds(MAX_TIMEOUT_SEC));
+    if (status == std::future_status::timeout) {
+        DLP_LOG_INFO(LABEL, "callbackTask batch callback execution timeout");
+    }
+}
 } // namespace DlpPermission
 } // namespace Security
 } // namespace OHOS
@@ -18,6 +18,7 @@
 
 #include <mutex>
 #include <map>
+#include <vector>
 
 #include "dlp_sandbox_info.h"
 #include "iremote_broker.h"
@@ -43,6 +44,8 @@ public:
     int32_t RemoveCallback(const sptr<IRemoteObject>& callback);
     int32_t RemoveCallback(int32_t pid, bool &result);
     void ExecuteCallbackAsync(const DlpSandboxInfo &dlpSandboxInfo);
+    // Notifies a batch of sandbox changes with one request per registered callback and waits for all of them once.
+    void ExecuteCallbackBatchAsync(const std::vector<DlpSandboxInfo> &dlpSandboxInfos);
 
 private:
     DlpSandboxChangeCallbackManager();
@@ -45,7 +45,34 @@ void DlpSandboxChangeCallbackProxy::DlpSandboxStateChangeCallback(DlpSandboxCall
         DLP_LOG_ERROR(LABEL, "Failed to WriteParcelable(result)");
         return;
     }
+    SendStateChangeRequest(static_cast<uint32_t>(IDlpSandboxStateChangeCallback::DLP_SANDBOX_STATE_CHANGE), data);
+}
 
+void DlpSandboxChangeCallbackProxy::DlpSandboxStateChangeBatchCallback(std::vector<DlpSandboxCallbackInfo> &results)
+{
+    MessageParcel data;
+    if (!data.WriteInterfaceToken(IDlpSandboxStateChangeCallback::GetDescriptor())) {
+        DLP_LOG_ERROR(LABEL, "Write descriptor fail");
+        return;
+    }
+    if (!data.WriteUint32(static_cast<uint32_t>(results.size()))) {
+        DLP_LOG_ERROR(LABEL, "Failed to WriteUint32(size)");
+        return;
+    }
+    for (const auto &result : results) {
+        DlpSandboxCallbackInfoParcel resultParcel;
+        resultParcel.changeInfo = result;
+        if (!data.WriteParcelable(&resultParcel)) {
+            DLP_LOG_ERROR(LABEL, "Failed to WriteParcelable(result)");
+            return;
+        }
+    }
+    SendStateChangeRequest(static_cast<uint32_t>(IDlpSandboxStateChangeCallback::DLP_SANDBOX_STATE_CHANGE_BATCH),
+        data);
+}
+
+void DlpSandboxChangeCallbackProxy::SendStateChangeRequest(uint32_t code, MessageParcel &data)
+{
     MessageParcel reply;
     MessageOption option(MessageOption::TF_SYNC);
     sptr<IRemoteObject> remote = Remote();
@@ -53,8 +80,7 @@ void DlpSandboxChangeCallbackProxy::DlpSandboxStateChangeCallback(DlpSandboxCall
         DLP_LOG_ERROR(LABEL, "remote service null.");
         return;
     }
-    int32_t requestResult = remote->SendRequest(
-        static_cast<uint32_t>(IDlpSandboxStateChangeCallback::DLP_SANDBOX_STATE_CHANGE), data, reply, option);
+    int32_t requestResult = remote->SendRequest(code, data, reply, option);
     if (requestResult != NO_ERROR) {
         DLP_LOG_ERROR(LABEL, "send request fail, result: %{public}d", requestResult);
         return;
@@ -28,8 +28,11 @@ public:
     explicit DlpSandboxChangeCallbackProxy(const sptr<IRemoteObject> &impl);
     ~DlpSandboxChangeCallbackProxy() override;
     void DlpSandboxStateChangeCallback(DlpSandboxCallbackInfo &result) override;
+    void DlpSandboxStateChangeBatchCallback(std::vector<DlpSandboxCallbackInfo> &results) override;
 
 private:
+    void SendStateChangeRequest(uint32_t code, MessageParcel &data);
+
     static inline BrokerDelegator<DlpSandboxChangeCallbackProxy> delegator_;
 };
 } // namespace DlpPermission
@@ -14,6 +14,8 @@
  */
 
 #include "dlp_ability_adapter.h"
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <extension_manager_client.h>
 #include "dlp_ability_proxy.h"
@@ -28,6 +30,18 @@ namespace {
 constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpAbilityAdapter" };
 static const std::string BUNDLE_NAME = "com.huawei.hmos.dlpcredmgr";
 static const std::string PERM_ABILITY_NAME = "DlpPermServiceAbility";
+static constexpr int64_t IDLE_TIMEOUT_MS = 30000;
+static constexpr int64_t CONNECT_TIMEOUT_MS = 5000;
+
+std::mutex g_adaptersMutex;
+std::map<int32_t, std::shared_ptr<DlpAbilityAdapter>> g_adapters;
+std::atomic<uint64_t> g_nextReqId { 1 };
+
+int64_t GetSteadyMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 }
 
 DlpAbilityAdapter::DlpAbilityAdapter(ReceiveDataCallback &callback)
@@ -35,64 +49,333 @@ DlpAbilityAdapter::DlpAbilityAdapter(ReceiveDataCallback &callback)
     callback_ = callback;
 }
 
+std::shared_ptr<DlpAbilityAdapter> DlpAbilityAdapter::GetInstance(int32_t userId, ReceiveDataCallback callback)
+{
+    std::lock_guard<std::mutex> lock(g_adaptersMutex);
+    auto iter = g_adapters.find(userId);
+    if (iter != g_adapters.end()) {
+        return iter->second;
+    }
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    g_adapters[userId] = adapter;
+    return adapter;
+}
+
+void DlpAbilityAdapter::ReleaseAll()
+{
+    std::map<int32_t, std::shared_ptr<DlpAbilityAdapter>> adapters;
+    {
+        std::lock_guard<std::mutex> lock(g_adaptersMutex);
+        adapters.swap(g_adapters);
+    }
+    DLP_LOG_INFO(LABEL, "Release %{public}zu ability channels.", adapters.size());
+}
+
 int32_t DlpAbilityAdapter::ConnectPermServiceAbility(int32_t userId,
     std::function<void(sptr<IRemoteObject>)> connectCallback)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (abilityConnection_ != nullptr && abilityConnection_->IsConnected()) {
+    sptr<DlpAbilityConnection> connection = nullptr;
+    uint64_t connGen = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        connection = abilityConnection_;
+        connGen = connGen_;
+    }
+    sptr<IRemoteObject> remoteObj = (connection != nullptr) ? connection->GetProxy() : nullptr;
+    if (remoteObj != nullptr) {
         DLP_LOG_INFO(LABEL, "Connected Ability Before, get exist instance.");
-        connectCallback(abilityConnection_->GetProxy());
+        connectCallback(remoteObj);
         return DLP_OK;
     }
 
     AAFwk::Want want;
     want.SetElementName(BUNDLE_NAME, PERM_ABILITY_NAME);
-    abilityConnection_ = new (std::nothrow) DlpAbilityConnection(connectCallback, callback_);
-    if (abilityConnection_ == nullptr) {
+    std::weak_ptr<DlpAbilityAdapter> weakAdapter = weak_from_this();
+    auto disconnectCallback = [weakAdapter, connGen](int32_t errCode, uint64_t reqId, uint8_t *outData,
+        uint32_t outDataLen) -> int32_t {
+        (void)reqId;
+        (void)outData;
+        (void)outDataLen;
+        std::shared_ptr<DlpAbilityAdapter> adapter = weakAdapter.lock();
+        if (adapter == nullptr) {
+            DLP_LOG_WARN(LABEL, "Adapter released, ignore disconnect callback.");
+            return DLP_OK;
+        }
+        return adapter->OnDisconnected(connGen, errCode);
+    };
+    connection = new (std::nothrow) DlpAbilityConnection(connectCallback, disconnectCallback);
+    if (connection == nullptr) {
         DLP_LOG_ERROR(LABEL, "Create AbilityConnection failed.");
         return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
     }
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (connGen != connGen_) {
+            DLP_LOG_ERROR(LABEL, "Channel dropped while connecting.");
+            return DLP_ABILITY_CONNECT_ERROR;
+        }
+        abilityConnection_ = connection;
+    }
     int32_t connect = AAFwk::ExtensionManagerClient::
-        GetInstance().ConnectServiceExtensionAbility(want, abilityConnection_, userId);
+        GetInstance().ConnectServiceExtensionAbility(want, connection, userId);
     if (connect != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Connect Ability failed, errorCode = %{public}d", connect);
-        abilityConnection_.clear();
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (abilityConnection_ == connection) {
+            abilityConnection_.clear();
+        }
         return DLP_ABILITY_CONNECT_ERROR;
     }
     return DLP_OK;
 }
 
-void DlpAbilityAdapter::DisconnectPermServiceAbility()
+sptr<DlpAbilityConnection> DlpAbilityAdapter::DetachConnectionLocked()
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (abilityConnection_ == nullptr) {
+    sptr<DlpAbilityConnection> connection = abilityConnection_;
+    abilityConnection_ = nullptr;
+    remoteObj_ = nullptr;
+    isConnecting_ = false;
+    connectDeadlineMs_ = 0;
+    connGen_++;
+    return connection;
+}
+
+void DlpAbilityAdapter::ReleaseConnection(sptr<DlpAbilityConnection> connection)
+{
+    if (connection == nullptr) {
         DLP_LOG_ERROR(LABEL, "AbilityConnection is nullptr.");
         return;
     }
+    // The disconnect notification of a connection we drop ourselves must not fail later requests.
+    connection->SetIsDestroyFlag(true);
     ErrCode disconnect = AAFwk::ExtensionManagerClient::
-        GetInstance().DisconnectAbility(abilityConnection_);
+        GetInstance().DisconnectAbility(connection);
     if (disconnect != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Disconnect Ability failed, errCode: %{public}d", disconnect);
     }
-    if (abilityConnection_ != nullptr) {
-        abilityConnection_.clear();
+}
+
+void DlpAbilityAdapter::DisconnectPermServiceAbility()
+{
+    sptr<DlpAbilityConnection> connection = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        connection = DetachConnectionLocked();
+    }
+    ReleaseConnection(connection);
+}
+
+int32_t DlpAbilityAdapter::SendRequest(int32_t userId, AbilityRequest request)
+{
+    uint64_t reqId = g_nextReqId.fetch_add(1);
+    uint64_t connGen = 0;
+    {
+        std::unique_lock<std::recursive_mutex> lock(mutex_);
+        idleDeadlineMs_ = 0;
+        if (remoteObj_ != nullptr) {
+            sptr<IRemoteObject> remoteObj = remoteObj_;
+            inflight_.insert(reqId);
+            lock.unlock();
+            RunRequest(reqId, request, remoteObj);
+            return DLP_OK;
+        }
+        queued_.emplace(reqId, std::move(request));
+        if (isConnecting_) {
+            DLP_LOG_DEBUG(LABEL, "Queue request %{public}llu until connected.",
+                static_cast<unsigned long long>(reqId));
+            return DLP_OK;
+        }
+        isConnecting_ = true;
+        connectDeadlineMs_ = GetSteadyMs() + CONNECT_TIMEOUT_MS;
+        ArmTimerLocked();
+        connGen = connGen_;
+    }
+    std::weak_ptr<DlpAbilityAdapter> weakAdapter = weak_from_this();
+    int32_t res = ConnectPermServiceAbility(userId, [weakAdapter, connGen](sptr<IRemoteObject> remoteObj) {
+        std::shared_ptr<DlpAbilityAdapter> adapter = weakAdapter.lock();
+        if (adapter == nullptr) {
+            DLP_LOG_WARN(LABEL, "Adapter released, ignore connect callback.");
+            return;
+        }
+        adapter->OnConnected(connGen, remoteObj);
+    });
+    if (res != DLP_OK) {
+        OnConnectFailed(connGen, res);
+    }
+    return res;
+}
+
+void DlpAbilityAdapter::OnConnected(uint64_t connGen, sptr<IRemoteObject> remoteObj)
+{
+    if (remoteObj == nullptr) {
+        OnConnectFailed(connGen, DLP_ABILITY_CONNECT_ERROR);
+        return;
+    }
+    std::map<uint64_t, AbilityRequest> queued;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (connGen != connGen_) {
+            DLP_LOG_WARN(LABEL, "Ignore connect callback of a dropped channel.");
+            return;
+        }
+        isConnecting_ = false;
+        connectDeadlineMs_ = 0;
+        remoteObj_ = remoteObj;
+        queued.swap(queued_);
+        for (const auto& entry : queued) {
+            inflight_.insert(entry.first);
+        }
+    }
+    DLP_LOG_INFO(LABEL, "Channel connected, run %{public}zu queued requests.", queued.size());
+    for (const auto& entry : queued) {
+        RunRequest(entry.first, entry.second, remoteObj);
+    }
+}
+
+void DlpAbilityAdapter::OnConnectFailed(uint64_t connGen, int32_t errCode)
+{
+    sptr<DlpAbilityConnection> connection = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (connGen != connGen_) {
+            return;  // already failed by a timeout or a disconnect
+        }
+        connection = DetachConnectionLocked();
+    }
+    DLP_LOG_ERROR(LABEL, "Channel connect failed, errCode: %{public}d", errCode);
+    if (connection != nullptr) {
+        ReleaseConnection(connection);
+    }
+    FailQueued(errCode);
+}
+
+int32_t DlpAbilityAdapter::OnDisconnected(uint64_t connGen, int32_t errCode)
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (connGen != connGen_) {
+            return DLP_OK;
+        }
+        // The next request reconnects.
+        (void)DetachConnectionLocked();
+    }
+    FailQueued(errCode);
+    if (callback_ != nullptr) {
+        return callback_(errCode, 0, nullptr, 0);
+    }
+    return DLP_OK;
+}
+
+void DlpAbilityAdapter::RunRequest(uint64_t reqId, const AbilityRequest& request, sptr<IRemoteObject> remoteObj)
+{
+    if (request != nullptr) {
+        request(remoteObj);
+    }
+    if (remoteObj != nullptr) {
+        OnRequestDone(reqId);
+    }
+}
+
+void DlpAbilityAdapter::FailQueued(int32_t errCode)
+{
+    std::map<uint64_t, AbilityRequest> queued;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        queued.swap(queued_);
+    }
+    if (!queued.empty()) {
+        DLP_LOG_ERROR(LABEL, "Fail %{public}zu queued requests, errCode: %{public}d", queued.size(), errCode);
+    }
+    for (const auto& entry : queued) {
+        RunRequest(entry.first, entry.second, nullptr);
+    }
+}
+
+void DlpAbilityAdapter::OnRequestDone(uint64_t reqId)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    inflight_.erase(reqId);
+    if (inflight_.empty() && queued_.empty() && abilityConnection_ != nullptr) {
+        idleDeadlineMs_ = GetSteadyMs() + IDLE_TIMEOUT_MS;
+        ArmTimerLocked();
+    }
+}
+
+void DlpAbilityAdapter::ArmTimerLocked()
+{
+    if (stopTimer_) {
+        return;
+    }
+    if (!timerThread_.joinable()) {
+        // The destructor joins the thread before any member goes away.
+        timerThread_ = std::thread([this] { TimerLoop(); });
+        return;
+    }
+    timerCv_.notify_all();
+}
+
+void DlpAbilityAdapter::TimerLoop()
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    while (!stopTimer_) {
+        int64_t now = GetSteadyMs();
+        if (connectDeadlineMs_ != 0 && now >= connectDeadlineMs_) {
+            connectDeadlineMs_ = 0;
+            uint64_t connGen = connGen_;
+            lock.unlock();
+            DLP_LOG_ERROR(LABEL, "Channel connect timeout.");
+            OnConnectFailed(connGen, DLP_ABILITY_CONNECT_ERROR);
+            lock.lock();
+            continue;
+        }
+        if (idleDeadlineMs_ != 0 && now >= idleDeadlineMs_) {
+            idleDeadlineMs_ = 0;
+            if (inflight_.empty() && queued_.empty() && !isConnecting_ && abilityConnection_ != nullptr) {
+                DLP_LOG_INFO(LABEL, "Channel idle, disconnect.");
+                sptr<DlpAbilityConnection> connection = DetachConnectionLocked();
+                lock.unlock();
+                ReleaseConnection(connection);
+                lock.lock();
+            }
+            continue;
+        }
+        int64_t deadline = connectDeadlineMs_;
+        if (idleDeadlineMs_ != 0 && (deadline == 0 || idleDeadlineMs_ < deadline)) {
+            deadline = idleDeadlineMs_;
+        }
+        if (deadline == 0) {
+            timerCv_.wait(lock);
+        } else {
+            timerCv_.wait_for(lock, std::chrono::milliseconds(deadline - now));
+        }
+    }
+}
+
+void DlpAbilityAdapter::StopTimer()
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        stopTimer_ = true;
+    }
+    timerCv_.notify_all();
+    if (timerThread_.joinable()) {
+        timerThread_.join();
     }
-    return;
 }
 
 int32_t DlpAbilityAdapter::HandleGetWaterMark(int32_t userId,
     std::shared_ptr<WaterMarkInfo> waterMarkInfo, std::condition_variable &waterMarkInfoCv)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    int32_t res = ConnectPermServiceAbility(userId,
-        [this, waterMarkInfo, &waterMarkInfoCv](sptr<IRemoteObject> remoteObj) -> void {
+    ReceiveDataCallback callback = callback_;
+    int32_t res = SendRequest(userId,
+        [callback, waterMarkInfo, &waterMarkInfoCv](sptr<IRemoteObject> remoteObj) -> void {
         do {
             if (remoteObj == nullptr) {
                 DLP_LOG_ERROR(LABEL, "ConnectCallback is nullptr.");
                 break;
             }
             DlpAbilityProxy proxy(remoteObj);
-            sptr<DlpAbilityStub> stub = DlpAbilityStub::GetInstance(callback_);
+            sptr<DlpAbilityStub> stub = DlpAbilityStub::GetInstance(callback);
             if (stub == nullptr) {
                 DLP_LOG_ERROR(LABEL, "DlpAbilityStub is nullptr.");
                 break;
@@ -104,13 +387,14 @@ int32_t DlpAbilityAdapter::HandleGetWaterMark(int32_t userId,
             waterMarkInfo->waterMarkFd = waterMarkFd;
             DLP_LOG_DEBUG(LABEL, "Get watermark success.");
         } while (0);
+        waterMarkInfo->isReady = true;
         waterMarkInfoCv.notify_all();
-        DisconnectPermServiceAbility();
         return;
     });
     if (res != DLP_OK) {
         DLP_LOG_ERROR(LABEL,
             "ConnectPermServiceAbility failed, errCode: %{public}d", res);
+        waterMarkInfo->isReady = true;
         waterMarkInfoCv.notify_all();
     }
     return res;
@@ -118,19 +402,30 @@ int32_t DlpAbilityAdapter::HandleGetWaterMark(int32_t userId,
 
 void DlpAbilityAdapter::SetIsDestroyFlag(bool flag)
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (abilityConnection_ == nullptr) {
+    sptr<DlpAbilityConnection> connection = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        connection = abilityConnection_;
+    }
+    if (connection == nullptr) {
         DLP_LOG_ERROR(LABEL, "No any ability connection.");
         return;
     }
-    abilityConnection_->SetIsDestroyFlag(flag);
+    connection->SetIsDestroyFlag(flag);
 }
 
 DlpAbilityAdapter::~DlpAbilityAdapter()
 {
+    StopTimer();
     SetIsDestroyFlag(true);
+    {
+        // Requests still queued belong to callers that are gone as well; they are dropped, not run.
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        queued_.clear();
+        inflight_.clear();
+    }
     DisconnectPermServiceAbility();
 }
 } // namespace DlpPermission
 } // namespace Security
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
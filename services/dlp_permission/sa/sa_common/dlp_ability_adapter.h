@@ -16,9 +16,13 @@
 #ifndef DLP_ABILITY_ADAPTER_H
 #define DLP_ABILITY_ADAPTER_H
 
+#include <condition_variable>
+#include <map>
 #include <mutex>
 #include <functional>
 #include <memory>
+#include <set>
+#include <thread>
 #include <iremote_object.h>
 #include "dlp_ability_conn.h"
 #include "dlp_ability_stub.h"
@@ -29,9 +33,23 @@ namespace OHOS {
 namespace Security {
 namespace DlpPermission {
 
-class DlpAbilityAdapter {
+/*
+ * Channel to the permission service ability of one user. Requests share one connection: requests sent while it
+ * is being established are queued and all run once it is up, the connection is kept until it has been idle for
+ * IDLE_TIMEOUT_MS, and a disconnect, a failed connect or one not done within CONNECT_TIMEOUT_MS runs the queued
+ * requests without a remote object so that the next one reconnects.
+ * The connection is only called with mutex_ released, as it may call back into the adapter. Its callbacks hold the
+ * adapter by weak_ptr and are ignored once it is gone, so adapters must be owned by a shared_ptr (see GetInstance).
+ */
+class DlpAbilityAdapter : public std::enable_shared_from_this<DlpAbilityAdapter> {
 public:
+    // Runs with the connected remote object, or with nullptr if the channel could not be (or stayed) connected.
+    using AbilityRequest = std::function<void(sptr<IRemoteObject> remoteObj)>;
+
     explicit DlpAbilityAdapter(ReceiveDataCallback &callback);
+    static std::shared_ptr<DlpAbilityAdapter> GetInstance(int32_t userId, ReceiveDataCallback callback);
+    static void ReleaseAll();
+    int32_t SendRequest(int32_t userId, AbilityRequest request);
     int32_t HandleGetWaterMark(int32_t userId, std::shared_ptr<WaterMarkInfo> waterMarkInfo,
         std::condition_variable &waterMarkInfoCv);
     void SetIsDestroyFlag(bool flag);
@@ -41,12 +59,34 @@ private:
     int32_t ConnectPermServiceAbility(int32_t userId,
         std::function<void(OHOS::sptr<OHOS::IRemoteObject>)> connectCallback);
     void DisconnectPermServiceAbility();
+    OHOS::sptr<DlpAbilityConnection> DetachConnectionLocked();
+    void ReleaseConnection(OHOS::sptr<DlpAbilityConnection> connection);
+    void OnConnected(uint64_t connGen, sptr<IRemoteObject> remoteObj);
+    int32_t OnDisconnected(uint64_t connGen, int32_t errCode);
+    void OnConnectFailed(uint64_t connGen, int32_t errCode);
+    void RunRequest(uint64_t reqId, const AbilityRequest& request, sptr<IRemoteObject> remoteObj);
+    void FailQueued(int32_t errCode);
+    void OnRequestDone(uint64_t reqId);
+    void ArmTimerLocked();
+    void TimerLoop();
+    void StopTimer();
+
     std::recursive_mutex mutex_;
     OHOS::sptr<DlpAbilityConnection> abilityConnection_;
+    uint64_t connGen_ = 0;  // bumped whenever abilityConnection_ is dropped, stale callbacks are ignored
+    sptr<IRemoteObject> remoteObj_ = nullptr;  // set once the current connection is up
     ReceiveDataCallback callback_{nullptr};
+    bool isConnecting_ = false;
+    std::map<uint64_t, AbilityRequest> queued_;  // sent while connecting, run in order once connected
+    std::set<uint64_t> inflight_;  // running on the connected remote object
+    std::condition_variable_any timerCv_;
+    std::thread timerThread_;
+    int64_t idleDeadlineMs_ = 0;  // 0 while not idle
+    int64_t connectDeadlineMs_ = 0;  // 0 while not connecting
+    bool stopTimer_ = false;
 };
 } // namespace DlpPermission
 } // namespace Security
 } // namespace OHOS
 
-#endif
\ No newline at end of file
+#endif
@@ -61,35 +61,56 @@ void DlpAbilityConnection::OnAbilityConnectDone(const AppExecFwk::ElementName &e
     const sptr<IRemoteObject> &remoteObj, int res)
 {
     (void)res;
-    if (remoteObj == nullptr) {
-        DLP_LOG_ERROR(LABEL, "Invaild Ability Connection.");
+    // Callbacks run without mutex_ held: they take the owner's lock, and the owner calls in here.
+    ConnectCallback connectCallback = nullptr;
+    DisconnectCallback disconnectCallback = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (isDestroyFlag_) {
+            DLP_LOG_ERROR(LABEL, "Object is destroying, ignore connect callback.");
+            return;
+        }
+        if (remoteObj == nullptr) {
+            // A connect that failed is reported like a disconnect, so the owner does not wait for it.
+            DLP_LOG_ERROR(LABEL, "Invaild Ability Connection.");
+            disconnectCallback = disconnectCallback_;
+        } else {
+            remoteObj_ = remoteObj;
+            DLP_LOG_INFO(LABEL, "Get Ability Connection.");
+            connectCallback = connectCallback_;
+        }
+    }
+    if (disconnectCallback != nullptr) {
+        disconnectCallback(DDLP_HAP_DISCONN_ERROR, 0, nullptr, 0);
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (isDestroyFlag_) {
-        DLP_LOG_ERROR(LABEL, "Object is destroying, ignore connect callback.");
+    if (remoteObj == nullptr) {
         return;
     }
-    remoteObj_ = remoteObj;
-    DLP_LOG_INFO(LABEL, "Get Ability Connection.");
-    if (connectCallback_ != nullptr) {
-        connectCallback_(remoteObj_);
+    if (connectCallback == nullptr) {
+        DLP_LOG_ERROR(LABEL, "connectCallback is nullptr.");
         return;
     }
-    DLP_LOG_ERROR(LABEL, "connectCallback is nullptr.");
+    connectCallback(remoteObj);
 }
 
 void DlpAbilityConnection::OnAbilityDisconnectDone(const AppExecFwk::ElementName &element, int res)
 {
     (void)res;
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    if (disconnectCallback_ != nullptr && isDestroyFlag_ == false) {
-        disconnectCallback_(DDLP_HAP_DISCONN_ERROR, 0, nullptr, 0);
-    } else {
-        DLP_LOG_ERROR(LABEL, "disConnectCallback is nullptr or be destroyed.");
+    DisconnectCallback disconnectCallback = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (disconnectCallback_ != nullptr && isDestroyFlag_ == false) {
+            disconnectCallback = disconnectCallback_;
+        } else {
+            DLP_LOG_ERROR(LABEL, "disConnectCallback is nullptr or be destroyed.");
+        }
+        ClearProxy();
+        DLP_LOG_INFO(LABEL, "Disconnect ability, DestroyFlag is %{public}d", isDestroyFlag_);
+    }
+    if (disconnectCallback != nullptr) {
+        disconnectCallback(DDLP_HAP_DISCONN_ERROR, 0, nullptr, 0);
     }
-    ClearProxy();
-    DLP_LOG_INFO(LABEL, "Disconnect ability, DestroyFlag is %{public}d", isDestroyFlag_);
 }
 
 bool DlpAbilityConnection::IsConnected()
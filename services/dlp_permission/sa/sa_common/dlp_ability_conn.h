@@ -31,7 +31,8 @@ using namespace OHOS;
 class DlpAbilityConnection : public AAFwk::AbilityConnectionStub {
 public:
     using ConnectCallback = std::function<void(sptr<IRemoteObject>)>;
-    using DisconnectCallback = ReceiveDataCallback;
+    using DisconnectCallback = std::function<int32_t(int32_t errCode, uint64_t reqId, uint8_t *outData,
+        uint32_t outDataLen)>;
 
     DlpAbilityConnection() = default;
     explicit DlpAbilityConnection(ConnectCallback connectCallback,
@@ -15,6 +15,9 @@
 
 #include "dlp_common_func.h"
 
+#include <mutex>
+#include <set>
+#include <string>
 #include "account_adapt.h"
 #include "alg_common_type.h"
 #include "alg_manager.h"
@@ -36,6 +39,46 @@ static bool ConstTimeMemEqual(const uint8_t *a, const uint8_t *b, uint32_t len)
     }
     return diff == 0;
 }
+
+// Keys known to exist in HUKS, keyed by "osAccountId:alias". Only positive results are kept.
+std::mutex g_existKeyLock;
+std::set<std::string> g_existKeySet;
+
+static std::string GetKeyCacheId(const AlgKeyInfo *keyInfo)
+{
+    return std::to_string(keyInfo->osAccountId) + ":" +
+        std::string(reinterpret_cast<const char *>(keyInfo->keyAlias.value), keyInfo->keyAlias.dataSize);
+}
+
+static void InvalidateKeyCache(const AlgKeyInfo *keyInfo)
+{
+    std::lock_guard<std::mutex> lock(g_existKeyLock);
+    g_existKeySet.erase(GetKeyCacheId(keyInfo));
+}
+}
+
+int32_t EnsureHMACKeyExist(const AlgKeyInfo *keyInfo)
+{
+    if (keyInfo == nullptr || !IsBlobDataValid(&(keyInfo->keyAlias))) {
+        DLP_LOG_ERROR(LABEL, "keyInfo is invalid!");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    std::string cacheId = GetKeyCacheId(keyInfo);
+    {
+        std::lock_guard<std::mutex> lock(g_existKeyLock);
+        if (g_existKeySet.find(cacheId) != g_existKeySet.end()) {
+            return DLP_OK;
+        }
+    }
+    if (!AlgIsKeyExist(keyInfo)) {
+        if (AlgGenerateMacKey(keyInfo) != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "Generate HMAC key failed!");
+            return DLP_ERROR_GENERATE_KEY_FAILED;
+        }
+    }
+    std::lock_guard<std::mutex> lock(g_existKeyLock);
+    g_existKeySet.insert(cacheId);
+    return DLP_OK;
 }
 
 int32_t GetHMACValue(const HMACSrcParams *hmacSrcParams,
@@ -50,14 +93,23 @@ int32_t GetHMACValue(const HMACSrcParams *hmacSrcParams,
 
     AlgKeyInfo keyInfo = { .protectionLevel = hmacSrcParams->protectionLevel,
         .osAccountId = hmacSrcParams->osAccountId, .keyAlias = *aliasBlob };
-    if (!AlgIsKeyExist(&keyInfo)) {
-        if (AlgGenerateMacKey(&keyInfo) != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "Generate HMAC key failed!");
-            return DLP_ERROR_GENERATE_KEY_FAILED;
+    int32_t ret = EnsureHMACKeyExist(&keyInfo);
+    if (ret != DLP_OK) {
+        return ret;
+    }
+    ret = AlgHmac(&keyInfo, hmacSrcParams->SrcDataBlob, &outDataBlob);
+    if (ret != DLP_OK) {
+        // The key may have been removed behind our back, e.g. with its os account, check it again once.
+        DLP_LOG_WARN(LABEL, "Do HMAC failed, errCode: %{public}d, retry with the key checked.", ret);
+        InvalidateKeyCache(&keyInfo);
+        ret = EnsureHMACKeyExist(&keyInfo);
+        if (ret != DLP_OK) {
+            return ret;
         }
+        ret = AlgHmac(&keyInfo, hmacSrcParams->SrcDataBlob, &outDataBlob);
     }
-    int32_t ret = AlgHmac(&keyInfo, hmacSrcParams->SrcDataBlob, &outDataBlob);
     if (ret != DLP_OK) {
+        InvalidateKeyCache(&keyInfo);
         DLP_LOG_ERROR(LABEL, "Do HMAC failed, errCode: %{public}d.", ret);
         return ret;
     }
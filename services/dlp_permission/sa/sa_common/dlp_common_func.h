@@ -23,6 +23,8 @@ namespace OHOS {
 namespace Security {
 namespace DlpPermission {
 
+int32_t EnsureHMACKeyExist(const AlgKeyInfo *keyInfo);
+
 int32_t GetHMACValue(const HMACSrcParams *hmacSrcParams,
     uint8_t **hmacValue, uint32_t *hmacValueSize, const BlobData *aliasBlob);
 
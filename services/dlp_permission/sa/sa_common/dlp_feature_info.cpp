@@ -17,7 +17,6 @@
 
 #include "account_adapt.h"
 #include "alg_common_type.h"
-#include "alg_manager.h"
 #include "alg_utils.h"
 #include "dlp_common_func.h"
 #include "dlp_permission.h"
@@ -75,13 +74,10 @@ int32_t DlpFeatureInfo::SaveDlpFeatureInfoToFile(const unordered_json &dlpFeatur
     BlobData keyAliasBlob = { HcStrlen(DLP_FEATURE_INFO_FILE_KEY_ALIAS),
         const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(DLP_FEATURE_INFO_FILE_KEY_ALIAS)) };
     AlgKeyInfo keyInfo = { .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = userId, .keyAlias = keyAliasBlob };
-    int32_t res = DLP_SERVICE_ERROR_VALUE_INVALID;
-    if (!AlgIsKeyExist(&keyInfo)) {
-        res = AlgGenerateMacKey(&keyInfo);
-        if (res != DLP_OK) {
-            DLP_LOG_ERROR(LABEL, "Generate HMAC key failed!");
-            return DLP_ERROR_GENERATE_KEY_FAILED;
-        }
+    int32_t res = EnsureHMACKeyExist(&keyInfo);
+    if (res != DLP_OK) {
+        DLP_LOG_ERROR(LABEL, "Generate HMAC key failed!");
+        return DLP_ERROR_GENERATE_KEY_FAILED;
     }
 
     char *filePath = nullptr;
@@ -16,6 +16,7 @@
 #include "dlp_permission_serializer.h"
 #include <cinttypes>
 #include <climits>
+#include "dlp_cert_tlv.h"
 #include "domain_account_client.h"
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
@@ -859,6 +860,68 @@ int32_t DlpPermissionSerializer::DeserializeEncPolicyData(const unordered_json&
     return DLP_OK;
 }
 
+int32_t DlpPermissionSerializer::SerializeEncPolicyDataTlv(const DLP_EncPolicyData& encData,
+    std::vector<uint8_t>& cert)
+{
+    if (encData.data == nullptr || encData.dataLen == 0 || encData.dataLen > DLP_MAX_CERT_SIZE) {
+        DLP_LOG_ERROR(LABEL, "Cert lenth %{public}d is invalid", encData.dataLen);
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    cert.clear();
+    cert.reserve(DLP_CERT_TLV_HEADER_SIZE + DLP_CERT_TLV_RECORD_HEAD_SIZE * 2 + sizeof(uint32_t) + encData.dataLen);
+    DlpTlvWriter writer(cert);
+    writer.WriteHeader();
+    writer.WriteUint32(DLP_CERT_TLV_TAG_ACCOUNT_TYPE, static_cast<uint32_t>(encData.accountType));
+    writer.WriteBytes(DLP_CERT_TLV_TAG_ENC_DATA, encData.data, encData.dataLen);
+    DLP_LOG_INFO(LABEL, "Serialize tlv successfully!");
+    return DLP_OK;
+}
+
+int32_t DlpPermissionSerializer::DeserializeEncPolicyDataTlv(const std::vector<uint8_t>& cert,
+    DLP_EncPolicyData& encData)
+{
+    DlpTlvReader reader(cert.data(), cert.size());
+    if (!reader.ReadHeader()) {
+        DLP_LOG_ERROR(LABEL, "Cert is not tlv");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    uint16_t tag = 0;
+    const uint8_t* value = nullptr;
+    uint32_t len = 0;
+    const uint8_t* data = nullptr;
+    uint32_t dataLen = 0;
+    while (reader.Next(tag, value, len)) {
+        if (tag == DLP_CERT_TLV_TAG_ACCOUNT_TYPE) {
+            uint32_t accountType = 0;
+            if (!ReadTlvUint32(value, len, accountType)) {
+                return DLP_SERVICE_ERROR_VALUE_INVALID;
+            }
+            encData.accountType = static_cast<AccountType>(accountType);
+        } else if (tag == DLP_CERT_TLV_TAG_ENC_DATA) {
+            data = value;
+            dataLen = len;
+        }
+    }
+    if (!reader.AtEnd() || data == nullptr || dataLen == 0 || dataLen > DLP_MAX_CERT_SIZE) {
+        DLP_LOG_ERROR(LABEL, "Tlv cert is truncated or has no enc data");
+        return DLP_SERVICE_ERROR_VALUE_INVALID;
+    }
+    encData.data = new (std::nothrow) uint8_t[dataLen];
+    if (encData.data == nullptr) {
+        DLP_LOG_ERROR(LABEL, "New memory fail");
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    if (memcpy_s(encData.data, dataLen, data, dataLen) != EOK) {
+        DLP_LOG_ERROR(LABEL, "Memcpy encData fail");
+        delete[] encData.data;
+        encData.data = nullptr;
+        return DLP_SERVICE_ERROR_MEMORY_OPERATE_FAIL;
+    }
+    encData.dataLen = dataLen;
+    DLP_LOG_INFO(LABEL, "Deserialize tlv successfully!");
+    return DLP_OK;
+}
+
 int32_t getEncJson(const unordered_json& encDataJson, unordered_json& certJson, std::string dataKey,
     std::string extraKey)
 {
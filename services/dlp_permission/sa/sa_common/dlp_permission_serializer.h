@@ -37,6 +37,8 @@ public:
     int32_t SerializeEncPolicyData(const DLP_EncPolicyData& encData, unordered_json& encDataJson);
     int32_t DeserializeEncPolicyData(const unordered_json& encDataJson, DLP_EncPolicyData& encData,
         bool isNeedAdapter);
+    int32_t SerializeEncPolicyDataTlv(const DLP_EncPolicyData& encData, std::vector<uint8_t>& cert);
+    int32_t DeserializeEncPolicyDataTlv(const std::vector<uint8_t>& cert, DLP_EncPolicyData& encData);
     int32_t DeserializeEncPolicyDataByFirstVersion(const unordered_json& encDataJson,
         const unordered_json& offlineEncDataJson, DLP_EncPolicyData& encData, std::string ownerAccountId);
 private:
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_ENTERPRISE_FILE_TRACKER_H
+#define DLP_PERMISSION_ENTERPRISE_FILE_TRACKER_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "permission_policy.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct EnterpriseInfo {
+    std::string classificationLabel = "";
+    DLPFileAccess dlpFileAccess = DLPFileAccess::NO_PERMISSION;
+    std::string fileId = "";
+    std::string appIdentifier = "";
+    int32_t uid = -1;
+};
+
+struct EnterpriseOpenFile {
+    std::string uri;
+    int32_t uid = -1;
+    std::string fileId;
+};
+
+/*
+ * Enterprise info of every uri handed to SetEnterpriseInfos. Files opened in a sandbox (uid >= 0) are also indexed
+ * by (appIdentifier, label) and by uid, so queries and revocations only touch the files they return.
+ * Labels may be given an order with SetLevels(); a label outside the order only matches itself.
+ */
+class EnterpriseFileTracker {
+public:
+    // levels from lowest to highest classification.
+    void SetLevels(const std::vector<std::string>& levels)
+    {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        levels_ = levels;
+        levelRank_.clear();
+        for (size_t i = 0; i < levels.size(); ++i) {
+            levelRank_.emplace(levels[i], i);
+        }
+    }
+
+    void Put(const std::string& uri, const EnterpriseInfo& info)
+    {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        auto iter = files_.find(uri);
+        if (iter != files_.end()) {
+            UnindexLocked(*iter);
+            iter->second = info;
+        } else {
+            iter = files_.emplace(uri, info).first;
+        }
+        IndexLocked(*iter);
+    }
+
+    bool Get(const std::string& uri, EnterpriseInfo& info) const
+    {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        auto iter = files_.find(uri);
+        if (iter == files_.end()) {
+            return false;
+        }
+        info = iter->second;
+        return true;
+    }
+
+    bool GetByUid(int32_t uid, EnterpriseInfo& info) const
+    {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        auto uidIter = byUid_.find(uid);
+        if (uidIter == byUid_.end() || uidIter->second.empty()) {
+            return false;
+        }
+        info = (*uidIter->second.begin())->second;
+        return true;
+    }
+
+    // Records the sandbox uri was opened in, if uri still belongs to fileId.
+    bool UpdateUid(const std::string& uri, const std::string& fileId, int32_t uid)
+    {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        auto iter = files_.find(uri);
+        if (iter == files_.end() || iter->second.fileId != fileId) {
+            return false;
+        }
+        UnindexLocked(*iter);
+        iter->second.uid = uid;
+        IndexLocked(*iter);
+        return true;
+    }
+
+    bool Erase(const std::string& uri, const std::string& fileId)
+    {
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        auto iter = files_.find(uri);
+        if (iter == files_.end() || iter->second.fileId != fileId) {
+            return false;
+        }
+        UnindexLocked(*iter);
+        files_.erase(iter);
+        return true;
+    }
+
+    // Removes every file opened in one of uids and returns them.
+    std::vector<EnterpriseOpenFile> EraseByUids(const std::set<int32_t>& uids)
+    {
+        std::vector<EnterpriseOpenFile> erased;
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        EraseByUidsLocked(uids, erased);
+        return erased;
+    }
+
+    // Opened files of appIdentifier labelled label; an empty label selects every label.
+    std::vector<EnterpriseOpenFile> QueryOpened(const std::string& label, const std::string& appIdentifier) const
+    {
+        std::vector<EnterpriseOpenFile> result;
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        ForEachOpenedLocked(label, appIdentifier, false,
+            [&result](const FileNode& node) { result.emplace_back(ToOpenFile(node)); });
+        return result;
+    }
+
+    // Same selection as QueryOpened, uris only.
+    void QueryOpenedUris(const std::string& label, const std::string& appIdentifier,
+        std::vector<std::string>& uris) const
+    {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        ForEachOpenedLocked(label, appIdentifier, false,
+            [&uris](const FileNode& node) { uris.emplace_back(node.first); });
+    }
+
+    // Opened files of appIdentifier at label's level or above it.
+    std::vector<EnterpriseOpenFile> QueryOpenedAtOrAbove(const std::string& label,
+        const std::string& appIdentifier) const
+    {
+        std::vector<EnterpriseOpenFile> result;
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        ForEachOpenedLocked(label, appIdentifier, true,
+            [&result](const FileNode& node) { result.emplace_back(ToOpenFile(node)); });
+        return result;
+    }
+
+    /*
+     * Revocation: removes, in one pass, the opened files of appIdentifier selected like QueryOpened (or
+     * QueryOpenedAtOrAbove) plus every other file open in the same sandboxes, and returns them all.
+     */
+    std::vector<EnterpriseOpenFile> Revoke(const std::string& label, const std::string& appIdentifier,
+        bool atOrAbove = false)
+    {
+        std::vector<EnterpriseOpenFile> closed;
+        std::unique_lock<std::shared_mutex> lock(lock_);
+        std::set<int32_t> uids;
+        ForEachOpenedLocked(label, appIdentifier, atOrAbove,
+            [&uids](const FileNode& node) { uids.insert(node.second.uid); });
+        EraseByUidsLocked(uids, closed);
+        return closed;
+    }
+
+    size_t Size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        return files_.size();
+    }
+
+private:
+    using LabelKey = std::pair<std::string, std::string>;  // appIdentifier, classificationLabel
+    using FileNode = std::unordered_map<std::string, EnterpriseInfo>::value_type;
+
+    // Nodes of files_ keep their address until erased, so the indexes refer to them directly.
+    void IndexLocked(const FileNode& node)
+    {
+        if (node.second.uid < 0) {
+            return;
+        }
+        byLabel_[LabelKey(node.second.appIdentifier, node.second.classificationLabel)].insert(&node);
+        byUid_[node.second.uid].insert(&node);
+    }
+
+    void UnindexLocked(const FileNode& node)
+    {
+        if (node.second.uid < 0) {
+            return;
+        }
+        auto labelIter = byLabel_.find(LabelKey(node.second.appIdentifier, node.second.classificationLabel));
+        if (labelIter != byLabel_.end()) {
+            labelIter->second.erase(&node);
+            if (labelIter->second.empty()) {
+                byLabel_.erase(labelIter);
+            }
+        }
+        auto uidIter = byUid_.find(node.second.uid);
+        if (uidIter != byUid_.end()) {
+            uidIter->second.erase(&node);
+            if (uidIter->second.empty()) {
+                byUid_.erase(uidIter);
+            }
+        }
+    }
+
+    void EraseByUidsLocked(const std::set<int32_t>& uids, std::vector<EnterpriseOpenFile>& erased)
+    {
+        for (int32_t uid : uids) {
+            auto uidIter = byUid_.find(uid);
+            if (uidIter == byUid_.end()) {
+                continue;
+            }
+            std::unordered_set<const FileNode*> nodes = std::move(uidIter->second);
+            byUid_.erase(uidIter);
+            for (const FileNode* node : nodes) {
+                erased.emplace_back(ToOpenFile(*node));
+                auto labelIter = byLabel_.find(LabelKey(node->second.appIdentifier, node->second.classificationLabel));
+                labelIter->second.erase(node);
+                if (labelIter->second.empty()) {
+                    byLabel_.erase(labelIter);
+                }
+                files_.erase(files_.find(node->first));
+            }
+        }
+    }
+
+    static EnterpriseOpenFile ToOpenFile(const FileNode& node)
+    {
+        return EnterpriseOpenFile { node.first, node.second.uid, node.second.fileId };
+    }
+
+    template <typename Func>
+    void ForEachOpenedLocked(const std::string& label, const std::string& appIdentifier, bool atOrAbove,
+        Func&& func) const
+    {
+        auto visit = [&func](const std::unordered_set<const FileNode*>& nodes) {
+            for (const FileNode* node : nodes) {
+                func(*node);
+            }
+        };
+        if (label.empty()) {
+            // All labels of appIdentifier are adjacent in byLabel_.
+            for (auto iter = byLabel_.lower_bound(LabelKey(appIdentifier, ""));
+                iter != byLabel_.end() && iter->first.first == appIdentifier; ++iter) {
+                visit(iter->second);
+            }
+            return;
+        }
+        auto rankIter = levelRank_.find(label);
+        size_t first = (atOrAbove && rankIter != levelRank_.end()) ? rankIter->second : levels_.size();
+        if (first == levels_.size()) {
+            auto iter = byLabel_.find(LabelKey(appIdentifier, label));
+            if (iter != byLabel_.end()) {
+                visit(iter->second);
+            }
+            return;
+        }
+        for (size_t i = first; i < levels_.size(); ++i) {
+            auto iter = byLabel_.find(LabelKey(appIdentifier, levels_[i]));
+            if (iter != byLabel_.end()) {
+                visit(iter->second);
+            }
+        }
+    }
+
+    mutable std::shared_mutex lock_;
+    std::unordered_map<std::string, EnterpriseInfo> files_;
+    std::map<LabelKey, std::unordered_set<const FileNode*>> byLabel_;
+    std::unordered_map<int32_t, std::unordered_set<const FileNode*>> byUid_;
+    std::vector<std::string> levels_;
+    std::unordered_map<std::string, size_t> levelRank_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_ENTERPRISE_FILE_TRACKER_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_RCU_SNAPSHOT_H
+#define DLP_PERMISSION_RCU_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+// Source of RcuSnapshot versions, shared by all instances so that no two publishes get the same version.
+uint64_t NextRcuSnapshotVersion();
+
+/*
+ * Copy-on-write container for read-mostly tables. Readers take an immutable snapshot without locking; writers
+ * are serialized, copy the current table, change the copy and publish it. A reader holding an old snapshot keeps
+ * it alive until it is done.
+ * Read() additionally keeps the last snapshot per thread and only reloads it after a publish, so steady-state
+ * readers touch a single read-mostly counter instead of the shared reference count.
+ */
+template <typename T>
+class RcuSnapshot {
+public:
+    RcuSnapshot() : data_(std::make_shared<const T>()), version_(NextRcuSnapshotVersion()) {}
+    ~RcuSnapshot() = default;
+
+    std::shared_ptr<const T> Load() const
+    {
+        return std::atomic_load(&data_);
+    }
+
+    // func must not call Read() on another RcuSnapshot<T>, which would replace the cached snapshot under it.
+    template <typename Func>
+    auto Read(Func&& func) const
+    {
+        // Versions are unique across all instances, so one cached entry per thread is never confused.
+        thread_local uint64_t cachedVersion = 0;
+        thread_local std::shared_ptr<const T> cachedData = nullptr;
+        uint64_t version = version_.load(std::memory_order_acquire);
+        if (cachedVersion != version || cachedData == nullptr) {
+            cachedData = std::atomic_load(&data_);
+            cachedVersion = version;
+        }
+        return func(*cachedData);
+    }
+
+    template <typename Func>
+    void Update(Func&& func)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto next = std::make_shared<T>(*std::atomic_load(&data_));
+        func(*next);
+        std::atomic_store(&data_, std::shared_ptr<const T>(std::move(next)));
+        version_.store(NextRcuSnapshotVersion(), std::memory_order_release);
+    }
+
+    void Reset(T&& value)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        std::atomic_store(&data_, std::shared_ptr<const T>(std::make_shared<T>(std::move(value))));
+        version_.store(NextRcuSnapshotVersion(), std::memory_order_release);
+    }
+
+private:
+    std::mutex writeMutex_;
+    std::shared_ptr<const T> data_;
+    std::atomic<uint64_t> version_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_RCU_SNAPSHOT_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_SANDBOX_POOL_H
+#define DLP_PERMISSION_SANDBOX_POOL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+struct SandboxPoolKey {
+    std::string bundleName;
+    int32_t permForBMS = 0;
+    int32_t userId = 0;
+
+    bool operator<(const SandboxPoolKey& other) const
+    {
+        return std::tie(userId, bundleName, permForBMS) < std::tie(other.userId, other.bundleName, other.permForBMS);
+    }
+};
+
+struct SandboxPoolEntry {
+    int32_t appIndex = -1;
+    int32_t bindAppIndex = -1;
+};
+
+struct SandboxPoolPolicy {
+    // Idle plus installing sandboxes of one user; 0 disables the pool.
+    uint32_t maxPerUser = 0;
+    uint32_t maxPerKey = 1;
+};
+
+struct SandboxPoolStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t provisioned = 0;
+    uint64_t discarded = 0;
+};
+
+/*
+ * Bookkeeping of pre-installed, never used sandboxes, keyed by (bundle, BMS permission, user). The service installs
+ * and uninstalls the sandboxes; the pool only decides which keys to refill and which idle sandboxes to drop. The
+ * budget of a user goes to its most recently opened keys first.
+ */
+class SandboxPool {
+public:
+    void SetPolicy(const SandboxPoolPolicy& policy)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = policy;
+    }
+
+    bool IsEnabled()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return policy_.maxPerUser > 0 && policy_.maxPerKey > 0;
+    }
+
+    // Takes an idle sandbox of key and marks key as recently used, whether it hits or not.
+    bool Acquire(const SandboxPoolKey& key, SandboxPoolEntry& entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (policy_.maxPerUser == 0 || policy_.maxPerKey == 0) {
+            return false;
+        }
+        Slot& slot = slots_[key];
+        slot.lastUse = ++useClock_;
+        if (slot.idle.empty()) {
+            ++stats_.misses;
+            return false;
+        }
+        entry = slot.idle.front();
+        slot.idle.pop_front();
+        ++stats_.hits;
+        return true;
+    }
+
+    /*
+     * Reserves the installs needed to bring each user back to its budget, and hands out idle sandboxes that no
+     * longer fit it. Every reserved key must be answered with Provisioned() or CancelProvision().
+     */
+    void CollectWork(std::vector<SandboxPoolKey>& toInstall,
+        std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>>& toUninstall)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<int32_t, std::vector<std::map<SandboxPoolKey, Slot>::iterator>> byUser;
+        for (auto iter = slots_.begin(); iter != slots_.end(); ++iter) {
+            byUser[iter->first.userId].emplace_back(iter);
+        }
+        for (auto& user : byUser) {
+            auto& slots = user.second;
+            std::sort(slots.begin(), slots.end(),
+                [](const auto& left, const auto& right) { return left->second.lastUse > right->second.lastUse; });
+            uint32_t budget = policy_.maxPerUser;
+            for (auto& iter : slots) {
+                Slot& slot = iter->second;
+                uint32_t want = std::min(policy_.maxPerKey, budget);
+                while (slot.idle.size() + slot.pending > want && !slot.idle.empty()) {
+                    toUninstall.emplace_back(iter->first, slot.idle.back());
+                    slot.idle.pop_back();
+                    ++stats_.discarded;
+                }
+                while (slot.idle.size() + slot.pending < want) {
+                    toInstall.emplace_back(iter->first);
+                    ++slot.pending;
+                }
+                uint32_t used = static_cast<uint32_t>(slot.idle.size()) + slot.pending;
+                budget -= std::min(budget, used);
+                if (used == 0) {
+                    slots_.erase(iter);
+                }
+            }
+        }
+    }
+
+    // Returns false when the sandbox is not wanted any more and has to be uninstalled by the caller.
+    bool Provisioned(const SandboxPoolKey& key, const SandboxPoolEntry& entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = slots_.find(key);
+        if (iter == slots_.end() || iter->second.pending == 0) {
+            ++stats_.discarded;
+            return false;
+        }
+        --iter->second.pending;
+        iter->second.idle.emplace_back(entry);
+        ++stats_.provisioned;
+        return true;
+    }
+
+    void CancelProvision(const SandboxPoolKey& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = slots_.find(key);
+        if (iter != slots_.end() && iter->second.pending > 0) {
+            --iter->second.pending;
+        }
+    }
+
+    // Removes every idle sandbox of userId, or of all users when userId is negative.
+    std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>> Drain(int32_t userId)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>> drained;
+        for (auto iter = slots_.begin(); iter != slots_.end();) {
+            if (userId >= 0 && iter->first.userId != userId) {
+                ++iter;
+                continue;
+            }
+            for (const auto& entry : iter->second.idle) {
+                drained.emplace_back(iter->first, entry);
+            }
+            stats_.discarded += iter->second.idle.size();
+            iter = slots_.erase(iter);
+        }
+        return drained;
+    }
+
+    SandboxPoolStats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void Dump(int fd)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dprintf(fd, "SandboxPool: maxPerUser %u, maxPerKey %u, hits %llu, misses %llu, provisioned %llu, "
+            "discarded %llu\n", policy_.maxPerUser, policy_.maxPerKey, static_cast<unsigned long long>(stats_.hits),
+            static_cast<unsigned long long>(stats_.misses), static_cast<unsigned long long>(stats_.provisioned),
+            static_cast<unsigned long long>(stats_.discarded));
+        for (const auto& slot : slots_) {
+            dprintf(fd, "    %s perm %d user %d: idle %zu, installing %u\n", slot.first.bundleName.c_str(),
+                slot.first.permForBMS, slot.first.userId, slot.second.idle.size(), slot.second.pending);
+        }
+    }
+
+private:
+    struct Slot {
+        std::deque<SandboxPoolEntry> idle;
+        uint32_t pending = 0;
+        uint64_t lastUse = 0;
+    };
+
+    std::mutex mutex_;
+    SandboxPoolPolicy policy_;
+    std::map<SandboxPoolKey, Slot> slots_;
+    uint64_t useClock_ = 0;
+    SandboxPoolStats stats_;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_SANDBOX_POOL_H
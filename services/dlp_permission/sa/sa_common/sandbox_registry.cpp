@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sandbox_registry.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+namespace {
+void EraseFromIndex(std::unordered_map<std::string, std::set<int32_t>>& index, const std::string& key, int32_t uid)
+{
+    auto iter = index.find(key);
+    if (iter == index.end()) {
+        return;
+    }
+    iter->second.erase(uid);
+    if (iter->second.empty()) {
+        index.erase(iter);
+    }
+}
+} // namespace
+
+void IdFilter::Add(int32_t id)
+{
+    slots_[Slot(id)].fetch_add(1, std::memory_order_release);
+}
+
+void IdFilter::Remove(int32_t id)
+{
+    slots_[Slot(id)].fetch_sub(1, std::memory_order_release);
+}
+
+bool IdFilter::MayContain(int32_t id) const
+{
+    return slots_[Slot(id)].load(std::memory_order_acquire) != 0;
+}
+
+void IdFilter::Clear()
+{
+    for (auto& slot : slots_) {
+        slot.store(0, std::memory_order_release);
+    }
+}
+
+size_t IdFilter::Slot(int32_t id)
+{
+    constexpr uint32_t goldenRatio = 0x9E3779B1;
+    return (static_cast<uint32_t>(id) * goldenRatio) >> (sizeof(uint32_t) * CHAR_BIT - SLOT_BITS);
+}
+
+bool SandboxRegistry::Add(const DlpSandboxInfo& appInfo)
+{
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    Shard& shard = GetShard(appInfo.uid);
+    std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+    if (!shard.infos.emplace(appInfo.uid, appInfo).second) {
+        return false;
+    }
+    AddIndexLocked(appInfo);
+    if (appInfo.tokenId != 0 && tokenIndex_.emplace(appInfo.tokenId, appInfo.uid).second) {
+        tokenFilter_.Add(static_cast<int32_t>(appInfo.tokenId));
+    }
+    ++generation_;
+    return true;
+}
+
+void SandboxRegistry::Put(const DlpSandboxInfo& appInfo)
+{
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    Shard& shard = GetShard(appInfo.uid);
+    std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+    auto iter = shard.infos.find(appInfo.uid);
+    if (iter != shard.infos.end()) {
+        RemoveIndexLocked(iter->second);
+        iter->second = appInfo;
+    } else {
+        shard.infos.emplace(appInfo.uid, appInfo);
+    }
+    AddIndexLocked(appInfo);
+    ++generation_;
+}
+
+bool SandboxRegistry::Erase(int32_t uid, DlpSandboxInfo& appInfo)
+{
+    if (!uidFilter_.MayContain(uid)) {
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    Shard& shard = GetShard(uid);
+    std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+    auto iter = shard.infos.find(uid);
+    if (iter == shard.infos.end()) {
+        return false;
+    }
+    appInfo = iter->second;
+    RemoveIndexLocked(appInfo);
+    EraseTokenLocked(appInfo.tokenId, uid);
+    shard.infos.erase(iter);
+    ++generation_;
+    return true;
+}
+
+std::vector<DlpSandboxInfo> SandboxRegistry::EraseByUser(int32_t userId)
+{
+    std::vector<DlpSandboxInfo> erased;
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    auto userIter = userIndex_.find(userId);
+    if (userIter == userIndex_.end()) {
+        return erased;
+    }
+    std::vector<int32_t> uids(userIter->second.begin(), userIter->second.end());
+    for (int32_t uid : uids) {
+        Shard& shard = GetShard(uid);
+        std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+        auto iter = shard.infos.find(uid);
+        if (iter == shard.infos.end()) {
+            continue;
+        }
+        erased.emplace_back(iter->second);
+        RemoveIndexLocked(iter->second);
+        EraseTokenLocked(iter->second.tokenId, uid);
+        shard.infos.erase(iter);
+    }
+    ++generation_;
+    return erased;
+}
+
+void SandboxRegistry::Clear()
+{
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    for (auto& shard : shards_) {
+        std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+        shard.infos.clear();
+    }
+    tokenIndex_.clear();
+    appIndex_.clear();
+    userIndex_.clear();
+    uriIndex_.clear();
+    labelIndex_.clear();
+    uidFilter_.Clear();
+    tokenFilter_.Clear();
+    ++generation_;
+}
+
+bool SandboxRegistry::MayContain(int32_t uid) const
+{
+    return uidFilter_.MayContain(uid);
+}
+
+bool SandboxRegistry::Get(int32_t uid, DlpSandboxInfo& appInfo) const
+{
+    if (!uidFilter_.MayContain(uid)) {
+        return false;
+    }
+    const Shard& shard = GetShard(uid);
+    std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+    auto iter = shard.infos.find(uid);
+    if (iter == shard.infos.end()) {
+        return false;
+    }
+    appInfo = iter->second;
+    return true;
+}
+
+bool SandboxRegistry::BindToken(uint32_t tokenId, int32_t uid)
+{
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    if (!tokenIndex_.emplace(tokenId, uid).second) {
+        return false;
+    }
+    tokenFilter_.Add(static_cast<int32_t>(tokenId));
+    ++generation_;
+    return true;
+}
+
+bool SandboxRegistry::UnbindToken(uint32_t tokenId)
+{
+    std::unique_lock<std::shared_mutex> indexLock(indexLock_);
+    auto iter = tokenIndex_.find(tokenId);
+    if (iter == tokenIndex_.end()) {
+        return false;
+    }
+    tokenIndex_.erase(iter);
+    tokenFilter_.Remove(static_cast<int32_t>(tokenId));
+    ++generation_;
+    return true;
+}
+
+bool SandboxRegistry::GetUidByTokenId(uint32_t tokenId, int32_t& uid) const
+{
+    if (!tokenFilter_.MayContain(static_cast<int32_t>(tokenId))) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    auto iter = tokenIndex_.find(tokenId);
+    if (iter == tokenIndex_.end()) {
+        return false;
+    }
+    uid = iter->second;
+    return true;
+}
+
+bool SandboxRegistry::Contains(const std::string& bundleName, int32_t appIndex, int32_t userId) const
+{
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    return appIndex_.count(std::make_tuple(bundleName, appIndex, userId)) > 0;
+}
+
+bool SandboxRegistry::GetByAppIndex(const std::string& bundleName, int32_t appIndex, DlpSandboxInfo& appInfo) const
+{
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    auto iter = appIndex_.lower_bound(std::make_tuple(bundleName, appIndex, INT32_MIN));
+    if (iter == appIndex_.end() || std::get<0>(iter->first) != bundleName ||
+        std::get<1>(iter->first) != appIndex) {
+        return false;
+    }
+    return GetLocked(iter->second, appInfo);
+}
+
+bool SandboxRegistry::HasUser(int32_t userId) const
+{
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    return userIndex_.count(userId) > 0;
+}
+
+std::vector<DlpSandboxInfo> SandboxRegistry::GetByLabel(const std::string& label) const
+{
+    std::vector<DlpSandboxInfo> result;
+    if (label.empty()) {
+        return GetAll();
+    }
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    auto iter = labelIndex_.find(label);
+    if (iter == labelIndex_.end()) {
+        return result;
+    }
+    for (int32_t uid : iter->second) {
+        DlpSandboxInfo appInfo;
+        if (GetLocked(uid, appInfo)) {
+            result.emplace_back(appInfo);
+        }
+    }
+    return result;
+}
+
+std::vector<DlpSandboxInfo> SandboxRegistry::GetAll() const
+{
+    std::vector<DlpSandboxInfo> result;
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+        for (const auto& entry : shard.infos) {
+            result.emplace_back(entry.second);
+        }
+    }
+    return result;
+}
+
+uint64_t SandboxRegistry::GetGeneration() const
+{
+    std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+    return generation_;
+}
+
+SandboxRegistry::Shard& SandboxRegistry::GetShard(int32_t uid)
+{
+    return shards_[static_cast<uint32_t>(uid) % SHARD_COUNT];
+}
+
+const SandboxRegistry::Shard& SandboxRegistry::GetShard(int32_t uid) const
+{
+    return shards_[static_cast<uint32_t>(uid) % SHARD_COUNT];
+}
+
+bool SandboxRegistry::GetLocked(int32_t uid, DlpSandboxInfo& appInfo) const
+{
+    const Shard& shard = GetShard(uid);
+    std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+    auto iter = shard.infos.find(uid);
+    if (iter == shard.infos.end()) {
+        return false;
+    }
+    appInfo = iter->second;
+    return true;
+}
+
+void SandboxRegistry::AddIndexLocked(const DlpSandboxInfo& appInfo)
+{
+    uidFilter_.Add(appInfo.uid);
+    appIndex_.emplace(AppKey(appInfo.bundleName, appInfo.appIndex, appInfo.userId), appInfo.uid);
+    userIndex_[appInfo.userId].insert(appInfo.uid);
+    uriIndex_[appInfo.uri].insert(appInfo.uid);
+    if (!appInfo.classificationLabel.empty()) {
+        labelIndex_[appInfo.classificationLabel].insert(appInfo.uid);
+    }
+}
+
+void SandboxRegistry::RemoveIndexLocked(const DlpSandboxInfo& appInfo)
+{
+    uidFilter_.Remove(appInfo.uid);
+    auto appIter = appIndex_.find(AppKey(appInfo.bundleName, appInfo.appIndex, appInfo.userId));
+    if (appIter != appIndex_.end() && appIter->second == appInfo.uid) {
+        appIndex_.erase(appIter);
+    }
+    auto userIter = userIndex_.find(appInfo.userId);
+    if (userIter != userIndex_.end()) {
+        userIter->second.erase(appInfo.uid);
+        if (userIter->second.empty()) {
+            userIndex_.erase(userIter);
+        }
+    }
+    EraseFromIndex(uriIndex_, appInfo.uri, appInfo.uid);
+    EraseFromIndex(labelIndex_, appInfo.classificationLabel, appInfo.uid);
+}
+
+void SandboxRegistry::EraseTokenLocked(uint32_t tokenId, int32_t uid)
+{
+    auto iter = tokenIndex_.find(tokenId);
+    if (iter != tokenIndex_.end() && iter->second == uid) {
+        tokenIndex_.erase(iter);
+        tokenFilter_.Remove(static_cast<int32_t>(tokenId));
+    }
+}
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_SANDBOX_REGISTRY_H
+#define DLP_PERMISSION_SANDBOX_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dlp_sandbox_info.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Counting filter over int ids: MayContain() is false only for ids that were never added or were removed as often
+ * as added, so it rejects unknown ids with one atomic load and no lock.
+ */
+class IdFilter {
+public:
+    void Add(int32_t id);
+    void Remove(int32_t id);
+    bool MayContain(int32_t id) const;
+    void Clear();
+
+private:
+    static constexpr uint32_t SLOT_BITS = 12;
+
+    static size_t Slot(int32_t id);
+
+    std::array<std::atomic<uint32_t>, 1 << SLOT_BITS> slots_ {};
+};
+
+/*
+ * Sandboxes opened by the service, stored in shards by uid. Every change is one event that updates the record and
+ * all of its secondary indexes (token, bundle/appIndex/user, user, document uri, classification label) under one
+ * exclusive index lock, so index readers never see half an event. Lookups by uid only take their shard.
+ * Lock order is index lock, then shard lock.
+ */
+class SandboxRegistry {
+public:
+    // Inserts appInfo, binding its tokenId when set. Returns false when the uid is already registered.
+    bool Add(const DlpSandboxInfo& appInfo);
+
+    // Replaces or inserts the whole record; token bindings are left as they are.
+    void Put(const DlpSandboxInfo& appInfo);
+
+    // Changes fields that are not indexed (pid, hasRead, ...) of a registered uid.
+    template <typename Func>
+    bool Update(int32_t uid, Func&& func)
+    {
+        Shard& shard = GetShard(uid);
+        std::unique_lock<std::shared_mutex> shardLock(shard.lock);
+        auto iter = shard.infos.find(uid);
+        if (iter == shard.infos.end()) {
+            return false;
+        }
+        func(iter->second);
+        return true;
+    }
+
+    // Removes the record and its token binding as one event.
+    bool Erase(int32_t uid, DlpSandboxInfo& appInfo);
+
+    std::vector<DlpSandboxInfo> EraseByUser(int32_t userId);
+
+    void Clear();
+
+    // Lock-free negative check, for process deaths that are almost never sandboxes.
+    bool MayContain(int32_t uid) const;
+
+    bool Get(int32_t uid, DlpSandboxInfo& appInfo) const;
+
+    template <typename Func>
+    auto Read(int32_t uid, Func&& func) const -> decltype(func(std::declval<const DlpSandboxInfo*>()))
+    {
+        if (!uidFilter_.MayContain(uid)) {
+            return func(nullptr);
+        }
+        const Shard& shard = GetShard(uid);
+        std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+        auto iter = shard.infos.find(uid);
+        return func(iter == shard.infos.end() ? nullptr : &iter->second);
+    }
+
+    // Binds a token to a uid ahead of its record. Returns false when the token is already bound.
+    bool BindToken(uint32_t tokenId, int32_t uid);
+
+    bool UnbindToken(uint32_t tokenId);
+
+    bool GetUidByTokenId(uint32_t tokenId, int32_t& uid) const;
+
+    bool Contains(const std::string& bundleName, int32_t appIndex, int32_t userId) const;
+
+    // First record of bundleName/appIndex in any user.
+    bool GetByAppIndex(const std::string& bundleName, int32_t appIndex, DlpSandboxInfo& appInfo) const;
+
+    bool HasUser(int32_t userId) const;
+
+    /*
+     * First record of userId for which pred is true. A user usually owns most of the records, so the shards are
+     * scanned directly, one lock each, instead of looking every uid of the user index up again.
+     */
+    template <typename Pred>
+    bool FindByUser(int32_t userId, Pred&& pred, DlpSandboxInfo& appInfo) const
+    {
+        if (!HasUser(userId)) {
+            return false;
+        }
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+            for (const auto& entry : shard.infos) {
+                if (entry.second.userId == userId && pred(entry.second)) {
+                    appInfo = entry.second;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename Pred>
+    bool FindByUri(const std::string& uri, Pred&& pred, DlpSandboxInfo& appInfo) const
+    {
+        std::shared_lock<std::shared_mutex> indexLock(indexLock_);
+        auto iter = uriIndex_.find(uri);
+        return iter != uriIndex_.end() && FindLocked(iter->second, pred, appInfo);
+    }
+
+    // Records with classificationLabel equal to label; an empty label selects every record.
+    std::vector<DlpSandboxInfo> GetByLabel(const std::string& label) const;
+
+    std::vector<DlpSandboxInfo> GetAll() const;
+
+    // Bumped by every event that changes membership or an index.
+    uint64_t GetGeneration() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    using AppKey = std::tuple<std::string, int32_t, int32_t>;
+
+    struct Shard {
+        mutable std::shared_mutex lock;
+        std::unordered_map<int32_t, DlpSandboxInfo> infos;
+    };
+
+    Shard& GetShard(int32_t uid);
+    const Shard& GetShard(int32_t uid) const;
+    bool GetLocked(int32_t uid, DlpSandboxInfo& appInfo) const;
+
+    template <typename Pred>
+    bool FindLocked(const std::set<int32_t>& uids, Pred& pred, DlpSandboxInfo& appInfo) const
+    {
+        for (int32_t uid : uids) {
+            const Shard& shard = GetShard(uid);
+            std::shared_lock<std::shared_mutex> shardLock(shard.lock);
+            auto iter = shard.infos.find(uid);
+            if (iter != shard.infos.end() && pred(iter->second)) {
+                appInfo = iter->second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AddIndexLocked(const DlpSandboxInfo& appInfo);
+    void RemoveIndexLocked(const DlpSandboxInfo& appInfo);
+    void EraseTokenLocked(uint32_t tokenId, int32_t uid);
+
+    mutable std::shared_mutex indexLock_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::unordered_map<uint32_t, int32_t> tokenIndex_;
+    std::map<AppKey, int32_t> appIndex_;
+    std::map<int32_t, std::set<int32_t>> userIndex_;
+    std::unordered_map<std::string, std::set<int32_t>> uriIndex_;
+    std::unordered_map<std::string, std::set<int32_t>> labelIndex_;
+    IdFilter uidFilter_;
+    IdFilter tokenFilter_;
+    uint64_t generation_ = 0;
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_SANDBOX_REGISTRY_H
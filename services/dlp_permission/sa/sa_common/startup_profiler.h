@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_STARTUP_PROFILER_H
+#define DLP_PERMISSION_STARTUP_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Records how long each phase of an on-demand SA start takes, and the time from the start of OnStart until the
+ * first client request reaches the service.
+ */
+class StartupProfiler {
+public:
+    static StartupProfiler& GetInstance()
+    {
+        static StartupProfiler instance;
+        return instance;
+    }
+
+    void Begin()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        phases_.clear();
+        beginUs_ = GetSteadyTimeUs();
+        lastUs_ = beginUs_;
+        firstRequestUs_.store(-1);
+        firstRequestName_ = "";
+    }
+
+    // Records the time spent since the previous mark (or Begin) as phase.
+    void Mark(const std::string& phase)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t now = GetSteadyTimeUs();
+        phases_.emplace_back(phase, now - lastUs_);
+        lastUs_ = now;
+    }
+
+    // Records a phase that ran off the start path, from its own begin time.
+    void MarkSince(const std::string& phase, int64_t phaseBeginUs)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        phases_.emplace_back(phase, GetSteadyTimeUs() - phaseBeginUs);
+    }
+
+    void MarkFirstRequest(const char* name)
+    {
+        if (firstRequestUs_.load(std::memory_order_relaxed) >= 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (firstRequestUs_.load() >= 0 || beginUs_ == 0) {
+            return;
+        }
+        firstRequestName_ = name;
+        firstRequestUs_.store(GetSteadyTimeUs() - beginUs_);
+    }
+
+    int64_t GetFirstRequestLatencyUs() const
+    {
+        return firstRequestUs_.load();
+    }
+
+    void Dump(int fd)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dprintf(fd, "StartupProfile:\n");
+        for (const auto& phase : phases_) {
+            dprintf(fd, "    %s: %lld us\n", phase.first.c_str(), static_cast<long long>(phase.second));
+        }
+        dprintf(fd, "    first request %s after %lld us\n", firstRequestName_.c_str(),
+            static_cast<long long>(firstRequestUs_.load()));
+    }
+
+    static int64_t GetSteadyTimeUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    StartupProfiler() = default;
+    ~StartupProfiler() = default;
+
+    std::mutex mutex_;
+    std::vector<std::pair<std::string, int64_t>> phases_;
+    int64_t beginUs_ = 0;
+    int64_t lastUs_ = 0;
+    std::atomic<int64_t> firstRequestUs_ { -1 };
+    std::string firstRequestName_ = "";
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_STARTUP_PROFILER_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DLP_PERMISSION_WARM_START_SNAPSHOT_H
+#define DLP_PERMISSION_WARM_START_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "securec.h"
+
+namespace OHOS {
+namespace Security {
+namespace DlpPermission {
+/*
+ * Derived state that is expensive to rebuild on every on-demand start, saved when the SA stops and mapped when it
+ * starts again. Layout: SnapshotHeader, then the support file types as [uint16 length][bytes]. The payload is
+ * covered by a 64-bit FNV-1a checksum and tied to the size and mtime of the config files it was derived from, so a changed config
+ * or a damaged file is rebuilt from source instead of being trusted.
+ */
+class WarmStartSnapshot {
+public:
+    static uint64_t GetSourceStamp(const std::vector<std::string>& sourcePaths)
+    {
+        uint64_t stamp = FNV_OFFSET_BASIS;
+        for (const auto& path : sourcePaths) {
+            struct stat st;
+            uint64_t fields[] = { 0, 0, 0 };
+            if (stat(path.c_str(), &st) == 0) {
+                fields[0] = static_cast<uint64_t>(st.st_size);
+                fields[1] = static_cast<uint64_t>(st.st_mtim.tv_sec);
+                fields[2] = static_cast<uint64_t>(st.st_mtim.tv_nsec);
+            }
+            stamp = Fnv1a(stamp, path.data(), path.size());
+            stamp = Fnv1a(stamp, fields, sizeof(fields));
+        }
+        return stamp;
+    }
+
+    static bool Save(const std::string& path, uint64_t sourceStamp, const std::vector<std::string>& supportFileTypes)
+    {
+        std::string payload;
+        for (const auto& type : supportFileTypes) {
+            if (type.size() > UINT16_MAX) {
+                return false;
+            }
+            uint16_t len = static_cast<uint16_t>(type.size());
+            payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+            payload.append(type);
+        }
+        SnapshotHeader header = {
+            .magic = SNAPSHOT_MAGIC,
+            .version = SNAPSHOT_VERSION,
+            .sourceStamp = sourceStamp,
+            .count = static_cast<uint32_t>(supportFileTypes.size()),
+            .payloadSize = static_cast<uint32_t>(payload.size()),
+            .checksum = Fnv1a(FNV_OFFSET_BASIS, payload.data(), payload.size()),
+        };
+        std::string tmpPath = path + ".tmp";
+        int fd = open(tmpPath.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = WriteAll(fd, &header, sizeof(header)) && WriteAll(fd, payload.data(), payload.size()) &&
+            fsync(fd) == 0;
+        close(fd);
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            (void)unlink(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static bool Load(const std::string& path, uint64_t sourceStamp, std::vector<std::string>& supportFileTypes)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotHeader)) ||
+            st.st_size > static_cast<off_t>(MAX_SNAPSHOT_SIZE)) {
+            close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        bool ok = Parse(static_cast<const uint8_t*>(addr), size, sourceStamp, supportFileTypes);
+        munmap(addr, size);
+        return ok;
+    }
+
+private:
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceStamp;
+        uint32_t count;
+        uint32_t payloadSize;
+        uint64_t checksum;
+    };
+
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x444C5053; // "DLPS"
+    static constexpr uint32_t SNAPSHOT_VERSION = 1;
+    static constexpr size_t MAX_SNAPSHOT_SIZE = 1024 * 1024;
+    static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    static uint64_t Fnv1a(uint64_t hash, const void* data, size_t len)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static bool WriteAll(int fd, const void* data, size_t len)
+    {
+        const char* ptr = static_cast<const char*>(data);
+        while (len > 0) {
+            ssize_t ret = write(fd, ptr, len);
+            if (ret <= 0) {
+                return false;
+            }
+            ptr += ret;
+            len -= static_cast<size_t>(ret);
+        }
+        return true;
+    }
+
+    static bool Parse(const uint8_t* data, size_t size, uint64_t sourceStamp, std::vector<std::string>& types)
+    {
+        SnapshotHeader header;
+        if (memcpy_s(&header, sizeof(header), data, sizeof(header)) != EOK) {
+            return false;
+        }
+        if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+            header.sourceStamp != sourceStamp || header.payloadSize != size - sizeof(header)) {
+            return false;
+        }
+        const uint8_t* payload = data + sizeof(header);
+        if (Fnv1a(FNV_OFFSET_BASIS, payload, header.payloadSize) != header.checksum) {
+            return false;
+        }
+        std::vector<std::string> result;
+        size_t offset = 0;
+        for (uint32_t i = 0; i < header.count; i++) {
+            uint16_t len = 0;
+            if (header.payloadSize - offset < sizeof(len) ||
+                memcpy_s(&len, sizeof(len), payload + offset, sizeof(len)) != EOK) {
+                return false;
+            }
+            offset += sizeof(len);
+            if (header.payloadSize - offset < len) {
+                return false;
+            }
+            result.emplace_back(reinterpret_cast<const char*>(payload + offset), len);
+            offset += len;
+        }
+        if (offset != header.payloadSize) {
+            return false;
+        }
+        types = std::move(result);
+        return true;
+    }
+};
+}  // namespace DlpPermission
+}  // namespace Security
+}  // namespace OHOS
+#endif  // DLP_PERMISSION_WARM_START_SNAPSHOT_H
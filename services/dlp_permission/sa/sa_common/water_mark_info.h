@@ -16,6 +16,7 @@
 #ifndef WATER_MARK_INFO_H
 #define WATER_MARK_INFO_H
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include "transaction/rs_interfaces.h"
@@ -29,6 +30,7 @@ public:
     std::shared_ptr<Media::PixelMap> waterMarkImg = nullptr;
     int32_t waterMarkFd = -1;
     std::string maskInfo = "";
+    std::atomic<bool> isReady { false };  // set by the request once the fields above are final
 };
 } // namespace DlpPermission
 } // namespace Security
@@ -21,6 +21,7 @@
 #include "account_adapt.h"
 #include "bundle_manager_adapter.h"
 #include "critical_handler.h"
+#include "dlp_cert_tlv.h"
 #include "dlp_policy_mgr_client.h"
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
@@ -50,6 +51,8 @@ static const std::string DLP_MANAGER_BUNDLE_NAME = "com.ohos.dlpmanager";
 static std::unordered_map<uint64_t, RequestInfo> g_requestMap;
 static std::unordered_map<uint64_t, DlpAccountType> g_requestAccountTypeMap;
 static const std::string DEVELOPER_MODE = "const.security.developermode.state";
+// write certs in the binary envelope only once every reader on the product understands it
+static const std::string CERT_TLV_ENABLE = "const.dlp.cert_tlv_enable";
 std::mutex g_lockRequest;
 
 #ifdef SUPPORT_DLP_CREDENTIAL
@@ -203,6 +206,21 @@ public:
     SdkRefGuard& operator=(const SdkRefGuard&) = delete;
 };
 
+static int32_t SerializeCert(const DLP_EncPolicyData& encData, std::vector<uint8_t>& cert)
+{
+    if (OHOS::system::GetBoolParameter(CERT_TLV_ENABLE, false)) {
+        return DlpPermissionSerializer::GetInstance().SerializeEncPolicyDataTlv(encData, cert);
+    }
+    unordered_json encDataJson;
+    int32_t res = DlpPermissionSerializer::GetInstance().SerializeEncPolicyData(encData, encDataJson);
+    if (res != DLP_OK) {
+        return res;
+    }
+    std::string encDataStr = encDataJson.dump();
+    cert.assign(encDataStr.begin(), encDataStr.end());
+    return DLP_OK;
+}
+
 static void DlpPackPolicyCallback(uint64_t requestId, int errorCode, DLP_EncPolicyData* outParams)
 {
     SdkRefGuard sdkRefGuard;
@@ -224,15 +242,13 @@ static void DlpPackPolicyCallback(uint64_t requestId, int errorCode, DLP_EncPoli
         info.callback->OnGenerateDlpCertificate(DLP_SERVICE_ERROR_VALUE_INVALID, std::vector<uint8_t>());
         return;
     }
-    unordered_json encDataJson;
-    int32_t res = DlpPermissionSerializer::GetInstance().SerializeEncPolicyData(*outParams, encDataJson);
+    std::vector<uint8_t> cert;
+    int32_t res = SerializeCert(*outParams, cert);
     if (res != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Serialize fail");
         info.callback->OnGenerateDlpCertificate(res, std::vector<uint8_t>());
         return;
     }
-    std::string encData = encDataJson.dump();
-    std::vector<uint8_t> cert(encData.begin(), encData.end());
     info.callback->OnGenerateDlpCertificate(errorCode, cert);
 }
 
@@ -255,18 +271,13 @@ static int32_t GetNewCert(const unordered_json& plainPolicyJson, std::vector<uin
     }
     params.dataLen = strlen(encData.c_str());
     params.accountType = static_cast<AccountType>(ownerAccountType);
-    unordered_json encDataJson;
-    int32_t res = DlpPermissionSerializer::GetInstance().SerializeEncPolicyData(params, encDataJson);
+    int32_t res = SerializeCert(params, cert);
+    free(params.data);
+    params.data = nullptr;
     if (res != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "Serialize fail");
-        free(params.data);
-        params.data = nullptr;
         return res;
     }
-    free(params.data);
-    params.data = nullptr;
-    std::string encDataStr = encDataJson.dump();
-    cert.assign(encDataStr.begin(), encDataStr.end());
 #endif
     return DLP_OK;
 }
@@ -739,17 +750,27 @@ int32_t DlpCredential::ParseDlpCertificate(const sptr<CertParcel>& certParcel,
     const std::string& appId, bool offlineAccess,
     AppExecFwk::ApplicationInfo& applicationInfo)
 {
-    std::string encDataJsonStr(certParcel->cert.begin(), certParcel->cert.end());
-    auto jsonObj = unordered_json::parse(encDataJsonStr, nullptr, false);
-    if (jsonObj.is_discarded() || (!jsonObj.is_object())) {
-        return DLP_SERVICE_ERROR_JSON_OPERATE_FAIL;
+    bool isTlv = IsDlpCertTlv(certParcel->cert.data(), certParcel->cert.size());
+    unordered_json jsonObj;
+    if (isTlv) {
+        if (certParcel->isNeedAdapter) {
+            DLP_LOG_ERROR(LABEL, "Tlv cert can not come from a 4.0 dlp file");
+            return DLP_SERVICE_ERROR_VALUE_INVALID;
+        }
+    } else {
+        std::string encDataJsonStr(certParcel->cert.begin(), certParcel->cert.end());
+        jsonObj = unordered_json::parse(encDataJsonStr, nullptr, false);
+        if (jsonObj.is_discarded() || (!jsonObj.is_object())) {
+            return DLP_SERVICE_ERROR_JSON_OPERATE_FAIL;
+        }
     }
     EncAndDecOptions options;
     DLP_EncPolicyData encPolicy;
     if (InitEncPolicyData(options, encPolicy, offlineAccess, appId) != DLP_OK) {
         return DLP_CREDENTIAL_ERROR_VALUE_INVALID;
     }
-    int32_t result =
+    int32_t result = isTlv ?
+        DlpPermissionSerializer::GetInstance().DeserializeEncPolicyDataTlv(certParcel->cert, encPolicy) :
         DlpPermissionSerializer::GetInstance().DeserializeEncPolicyData(jsonObj, encPolicy, certParcel->isNeedAdapter);
     auto accountType = static_cast<DlpAccountType>(encPolicy.accountType);
     if (result != DLP_OK) {
@@ -18,6 +18,7 @@
 #include "dlp_permission_log.h"
 #include "dlp_permission_service_ipc_interface_code.h"
 #include "dlp_policy_parcel.h"
+#include "dlp_shared_memory.h"
 
 namespace OHOS {
 namespace Security {
@@ -38,9 +39,10 @@ void DlpPermissionAsyncProxy::OnGenerateDlpCertificate(int32_t result, const std
         DLP_LOG_ERROR(LABEL, "Write int32 fail");
         return;
     }
+    std::shared_ptr<DlpSharedMemory> certHolder;
     if (result == DLP_OK) {
-        if (!data.WriteUInt8Vector(cert)) {
-            DLP_LOG_ERROR(LABEL, "Write uint8 vector fail");
+        if (!WriteSharedBuffer(data, cert, certHolder)) {
+            DLP_LOG_ERROR(LABEL, "Write cert fail");
             return;
         }
     }
@@ -74,6 +76,7 @@ void DlpPermissionAsyncProxy::OnParseDlpCertificate(int32_t result, const Permis
         return;
     }
 
+    std::shared_ptr<DlpSharedMemory> certHolder;
     if (result == DLP_OK) {
         DlpPolicyParcel policyParcel;
         policyParcel.policyParams_.CopyPermissionPolicy(policy);
@@ -82,8 +85,8 @@ void DlpPermissionAsyncProxy::OnParseDlpCertificate(int32_t result, const Permis
             return;
         }
 
-        if (!data.WriteUInt8Vector(cert)) {
-            DLP_LOG_ERROR(LABEL, "Write uint8 vector fail");
+        if (!WriteSharedBuffer(data, cert, certHolder)) {
+            DLP_LOG_ERROR(LABEL, "Write cert fail");
             return;
         }
     }
@@ -14,7 +14,10 @@
  */
 
 #include "dlp_permission_service.h"
+#include <algorithm>
 #include <chrono>
+#include <thread>
+#include <unordered_set>
 #include <unistd.h>
 #include "accesstoken_kit.h"
 #include "access_token_adapter.h"
@@ -62,6 +65,8 @@
 #include "dlp_ability_adapter.h"
 #include "critical_handler.h"
 #include "critical_helper.h"
+#include "startup_profiler.h"
+#include "warm_start_snapshot.h"
 #include "account_status_listener.h"
 
 #ifdef SECURITY_GUARD_ENABLE
@@ -78,7 +83,7 @@ using namespace Security::AccessToken;
 using namespace OHOS::AppExecFwk;
 namespace {
 constexpr const int32_t SA_ID_DLP_PERMISSION_SERVICE = 3521;
-static const std::string ALLOW_ACTION[] = {"ohos.want.action.CREATE_FILE"};
+static const std::unordered_set<std::string> ALLOW_ACTION = {"ohos.want.action.CREATE_FILE"};
 static const std::string DLP_MANAGER = "com.ohos.dlpmanager";
 #ifdef SECURITY_GUARD_ENABLE
 static const int64_t EVENTID = 0x00F000006;
@@ -88,6 +93,8 @@ static const std::string SETTINGS_BUNDLE_NAME = "com.huawei.hmos.settings";
 static const std::string DLP_CONFIG = "etc/dlp_permission/dlp_config.json";
 static const std::string SUPPORT_FILE_TYPE = "support_file_type";
 static const std::string DEAULT_DLP_CONFIG = "/system/etc/dlp_config.json";
+static const std::string WARM_START_SNAPSHOT_PATH =
+    "/data/service/el1/public/dlp_permission_service/warm_start.snapshot";
 static const std::string DEVELOPER_MODE = "const.security.developermode.state";
 static const std::string FALSE_VALUE = "false";
 static const std::string SEPARATOR = "_";
@@ -100,8 +107,12 @@ static const uint32_t MAX_CERT_SIZE = 1024 * 1024 * 40 * 2;
 static const int32_t HIPREVIEW_SANDBOX_LOW_BOUND = 1000;
 static const int32_t LIBCESFWK_SERVICES_ID = 3299;
 constexpr int32_t PARSE_WAIT_TIME_OUT = 5;
+constexpr size_t MAX_TEARDOWN_CONCURRENCY = 4;
+static const std::string SANDBOX_POOL_MAX_PER_USER = "const.dlp.sandbox_pool.max_per_user";
+static const std::string SANDBOX_POOL_MAX_PER_BUNDLE = "const.dlp.sandbox_pool.max_per_bundle";
+constexpr int32_t MAX_SANDBOX_POOL_SIZE = 16;
 static AccountListenerCallback *g_accountListenerCallback = nullptr;
-static const std::vector<std::string> SANDBOX_WHITELIST = { HIPREVIEW_LOW, SETTINGS_BUNDLE_NAME };
+static const std::unordered_set<std::string> SANDBOX_WHITELIST = { HIPREVIEW_LOW, SETTINGS_BUNDLE_NAME };
 }
 REGISTER_SYSTEM_ABILITY_BY_ID(DlpPermissionService, SA_ID_DLP_PERMISSION_SERVICE, true);
 
@@ -114,6 +125,8 @@ DlpPermissionService::DlpPermissionService(int saId, bool runOnCreate)
 DlpPermissionService::~DlpPermissionService()
 {
     DLP_LOG_INFO(LABEL, "~DlpPermissionService()");
+    StopWarmUp();
+    StopSandboxPool();
     sptr<AppExecFwk::IAppMgr> appMgr;
     sptr<AppStateObserver> observer;
     {
@@ -126,14 +139,14 @@ DlpPermissionService::~DlpPermissionService()
     if (appMgr != nullptr && observer != nullptr) {
         appMgr->UnregisterApplicationStateObserver(observer);
     }
-    std::unique_lock<std::shared_mutex> lock(dlpSandboxDataMutex_);
-    dlpSandboxData_.clear();
+    dlpSandboxData_.Reset({});
 }
 
 static bool IsSaCall()
 {
     Security::AccessToken::AccessTokenID callingToken = IPCSkeleton::GetCallingTokenID();
-    Security::AccessToken::TypeATokenTypeEnum res = Security::AccessToken::AccessTokenKit::GetTokenType(callingToken);
+    // GetTokenTypeFlag decodes the type bits of the id locally instead of asking the token service.
+    Security::AccessToken::ATokenTypeEnum res = Security::AccessToken::AccessTokenKit::GetTokenTypeFlag(callingToken);
     return (res == Security::AccessToken::TOKEN_NATIVE);
 }
 
@@ -148,6 +161,9 @@ sptr<AppStateObserver> DlpPermissionService::GetAppStateObserver(CurrentTaskStat
         DLP_LOG_ERROR(LABEL, "GetAppStateObserver observer is nullptr");
         return observer;
     }
+    if (taskState != CurrentTaskState::IDLE) {
+        StartupProfiler::GetInstance().MarkFirstRequest("client request");
+    }
     observer->PostDelayUnloadTask(taskState);
     return observer;
 }
@@ -159,21 +175,33 @@ void DlpPermissionService::OnStart()
         return;
     }
     DLP_LOG_INFO(LABEL, "DlpPermissionService is starting");
+    auto& profiler = StartupProfiler::GetInstance();
+    profiler.Begin();
     if (!RegisterAppStateObserver()) {
         DLP_LOG_ERROR(LABEL, "Failed to register app state observer!");
         return;
     }
+    profiler.Mark("RegisterAppStateObserver");
     dlpEventSubSubscriber_ = std::make_shared<DlpEventSubSubscriber>();
+    profiler.Mark("DlpEventSubSubscriber");
     bool ret = Publish(this);
     if (!ret) {
         DLP_LOG_ERROR(LABEL, "Failed to publish service!");
         return;
     }
+    profiler.Mark("Publish");
     if (!AddSystemAbilityListener(LIBCESFWK_SERVICES_ID)) {
         DLP_LOG_ERROR(LABEL, "add common event system ability listener failed");
     }
+    if (!AddSystemAbilityListener(PASTEBOARD_SERVICE_ID) ||
+        !AddSystemAbilityListener(DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID)) {
+        DLP_LOG_ERROR(LABEL, "add copy policy caller system ability listener failed");
+    }
+    profiler.Mark("AddSystemAbilityListener");
     state_ = ServiceRunningState::STATE_RUNNING;
     (void)NotifyProcessIsActive();
+    sandboxPoolStopped_.store(false);
+    StartWarmUp();
     DLP_LOG_INFO(LABEL, "Congratulations, DlpPermissionService start successfully!");
     auto observer = GetAppStateObserver(CurrentTaskState::IDLE);
     if (observer != nullptr) {
@@ -182,9 +210,50 @@ void DlpPermissionService::OnStart()
     DLP_LOG_INFO(LABEL, "DlpPermissionService set timer to destroy itself!");
 }
 
+void DlpPermissionService::StartWarmUp()
+{
+    // State the first requests would otherwise build lazily is loaded off the start path, so the first call finds
+    // it ready or waits on the same lock instead of doing the work itself.
+    if (warmUpThread_.joinable()) {
+        return;
+    }
+    warmUpThread_ = std::thread([this]() {
+        int64_t beginUs = StartupProfiler::GetSteadyTimeUs();
+        std::vector<std::string> typeList;
+        InitConfig(typeList);
+        (void)RetentionFileManager::GetInstance();
+        // The pool stays disabled until its policy is set, so every pooled sandbox on record is from the last run.
+        UninstallLostPooledSandboxes();
+        InitSandboxPoolPolicy();
+        StartupProfiler::GetInstance().MarkSince("WarmUp", beginUs);
+    });
+}
+
+void DlpPermissionService::StopWarmUp()
+{
+    if (warmUpThread_.joinable()) {
+        warmUpThread_.join();
+    }
+}
+
+void DlpPermissionService::SaveWarmStartSnapshot()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!supportFileTypeInit_ || supportFileTypeFromSnapshot_ || supportFileTypes_.empty()) {
+        return;
+    }
+    if (!WarmStartSnapshot::Save(WARM_START_SNAPSHOT_PATH, supportFileTypeStamp_, supportFileTypes_)) {
+        DLP_LOG_WARN(LABEL, "save warm start snapshot failed");
+    }
+}
+
 void DlpPermissionService::OnStop()
 {
     DLP_LOG_INFO(LABEL, "Stop service");
+    StopWarmUp();
+    StopSandboxPool();
+    DlpAbilityAdapter::ReleaseAll();
+    SaveWarmStartSnapshot();
     dlpEventSubSubscriber_ = nullptr;
     (void)NotifyProcessIsStop();
     UnRegisterAccountMonitor();
@@ -232,33 +301,73 @@ void DlpPermissionService::DelSandboxInfoByAccount(bool isRegister)
     }
     std::unordered_map<int32_t, DlpSandboxInfo> sandboxInfo;
     observer->GetDelSandboxInfo(sandboxInfo);
+    std::vector<DlpSandboxInfo> teardownList;
     for (const auto& entry : sandboxInfo) {
         const DlpSandboxInfo& sandboxInfoEntry = entry.second;
-        std::string bundleName = sandboxInfoEntry.bundleName;
-        int32_t appIndex = sandboxInfoEntry.appIndex;
-        int32_t userId = sandboxInfoEntry.userId;
-        std::string accountName = sandboxInfoEntry.accountName;
-        if (!isRegister && (userId != foregroundUserId || accountName == "")) {
+        if (sandboxInfoEntry.userId != foregroundUserId || sandboxInfoEntry.accountName == "") {
             continue;
         }
-        if (isRegister &&
-            (userId != foregroundUserId || accountName == "" || accountName == localAccount)) {
+        if (isRegister && sandboxInfoEntry.accountName == localAccount) {
             continue;
         }
-        DeleteDlpSandboxInfo(bundleName, appIndex, userId);
-        if (bundleName == HIPREVIEW_HIGH) {
-            int32_t bindAppIndex = sandboxInfoEntry.bindAppIndex;
-            if (UninstallDlpSandboxApp(HIPREVIEW_LOW, bindAppIndex, userId) != DLP_OK) {
-                DLP_LOG_ERROR(LABEL, "UninstallDlpSandboxApp failed, bindAppIndex=%d",  bindAppIndex);
-            } else {
-                DLP_LOG_INFO(LABEL, "UninstallDlpSandboxApp success, bindAppIndex=%d", bindAppIndex);
+        teardownList.emplace_back(sandboxInfoEntry);
+    }
+    TeardownSandboxes(teardownList);
+    DelWaterMarkInfo();
+}
+
+int32_t DlpPermissionService::UninstallSandboxPair(const DlpSandboxInfo& sandboxInfo)
+{
+    if (sandboxInfo.bundleName == HIPREVIEW_HIGH) {
+        int32_t bindAppIndex = sandboxInfo.bindAppIndex;
+        if (UninstallDlpSandboxApp(HIPREVIEW_LOW, bindAppIndex, sandboxInfo.userId) != DLP_OK) {
+            DLP_LOG_ERROR(LABEL, "UninstallDlpSandboxApp failed, bindAppIndex=%{public}d", bindAppIndex);
+        } else {
+            DLP_LOG_INFO(LABEL, "UninstallDlpSandboxApp success, bindAppIndex=%{public}d", bindAppIndex);
+        }
+    }
+    return UninstallDlpSandboxApp(sandboxInfo.bundleName, sandboxInfo.appIndex, sandboxInfo.userId);
+}
+
+bool DlpPermissionService::TeardownSandboxes(const std::vector<DlpSandboxInfo>& sandboxes)
+{
+    if (sandboxes.empty()) {
+        return true;
+    }
+    auto beginTime = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, int32_t>> retentionKeys;
+    for (const auto& sandbox : sandboxes) {
+        DeleteDlpSandboxInfo(sandbox.bundleName, sandbox.appIndex, sandbox.userId);
+        retentionKeys.emplace_back(sandbox.bundleName, sandbox.appIndex);
+    }
+
+    // Each uninstall is an independent BMS call; run a few at once, a hipreview pair stays on one worker.
+    std::atomic<size_t> next { 0 };
+    std::atomic<bool> allUninstalled { true };
+    auto worker = [this, &sandboxes, &next, &allUninstalled]() {
+        for (size_t i = next.fetch_add(1); i < sandboxes.size(); i = next.fetch_add(1)) {
+            if (UninstallSandboxPair(sandboxes[i]) != DLP_OK) {
+                allUninstalled = false;
             }
         }
-        UninstallDlpSandboxApp(bundleName, appIndex, userId);
-        RetentionFileManager::GetInstance().RemoveRetentionState(bundleName, appIndex);
-        DlpSandboxChangeCallbackManager::GetInstance().ExecuteCallbackAsync(sandboxInfoEntry);
+    };
+    std::vector<std::thread> workers;
+    size_t workerNum = std::min(sandboxes.size(), MAX_TEARDOWN_CONCURRENCY);
+    for (size_t i = 1; i < workerNum; i++) {
+        workers.emplace_back(worker);
     }
-    DelWaterMarkInfo();
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    RetentionFileManager::GetInstance().RemoveRetentionStates(retentionKeys);
+    DlpSandboxChangeCallbackManager::GetInstance().ExecuteCallbackBatchAsync(sandboxes);
+    int64_t costMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - beginTime).count();
+    DLP_LOG_INFO(LABEL, "teardown %{public}zu sandboxes cost %{public}d ms", sandboxes.size(),
+        static_cast<int32_t>(costMs));
+    return allUninstalled.load();
 }
 
 int32_t DlpPermissionService::InitAccountListenerCallback()
@@ -292,6 +401,17 @@ void DlpPermissionService::OnAddSystemAbility(int32_t systemAbilityId, const std
     }
 }
 
+void DlpPermissionService::OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
+{
+    DLP_LOG_INFO(LABEL, "OnRemoveSystemAbility systemAbilityId %{public}d", systemAbilityId);
+    // A restarted caller may come back with a new native token, resolve it again on its next call.
+    if (systemAbilityId == PASTEBOARD_SERVICE_ID) {
+        pasteboardTokenId_.store(0);
+    } else if (systemAbilityId == DISTRIBUTED_KV_DATA_SERVICE_ABILITY_ID) {
+        distributedDataTokenId_.store(0);
+    }
+}
+
 bool DlpPermissionService::RegisterAppStateObserver()
 {
     if (appStateObserver_ != nullptr) {
@@ -589,11 +709,12 @@ int32_t DlpPermissionService::GetWaterMark(const bool waterMarkConfig,
 
     int32_t userId = GetCallingUserId();
     auto wmInfo = std::make_shared<WaterMarkInfo>();
-    ReceiveDataCallback recvCallback = ReceiveCallback;
-    DlpAbilityAdapter dlpAbilityAdapter(recvCallback);
-    dlpAbilityAdapter.HandleGetWaterMark(userId, wmInfo, waterMarkInfoCv_);
+    auto abilityAdapter = DlpAbilityAdapter::GetInstance(userId, ReceiveCallback);
+    abilityAdapter->HandleGetWaterMark(userId, wmInfo, waterMarkInfoCv_);
 
-    waterMarkInfoCv_.wait_for(lock, std::chrono::seconds(PARSE_WAIT_TIME_OUT));
+    // The request may already be done here when the channel to the ability was still connected.
+    waterMarkInfoCv_.wait_for(lock, std::chrono::seconds(PARSE_WAIT_TIME_OUT),
+        [&wmInfo] { return wmInfo->isReady.load(); });
     if (wmInfo->waterMarkFd < 0) {
         DLP_LOG_ERROR(LABEL, "Get watermark fd failed.");
         return DLP_IPC_CALLBACK_ERROR;
@@ -836,14 +957,18 @@ static void FillDlpSandboxInfo(DlpSandboxInfo& dlpSandboxInfo, const std::string
         std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
 }
 
+static int32_t GetPermForBMS(DLPFileAccess dlpFileAccess)
+{
+    return static_cast<int32_t>(
+        (dlpFileAccess == DLPFileAccess::READ_ONLY) ? DLPFileAccess::READ_ONLY : DLPFileAccess::CONTENT_EDIT);
+}
+
 int32_t DlpPermissionService::InstallSandboxApp(const std::string& bundleName, DLPFileAccess dlpFileAccess,
     int32_t userId, DlpSandboxInfo& dlpSandboxInfo)
 {
     AppExecFwk::BundleMgrClient bundleMgrClient;
-    DLPFileAccess permForBMS =
-        (dlpFileAccess == DLPFileAccess::READ_ONLY) ? DLPFileAccess::READ_ONLY : DLPFileAccess::CONTENT_EDIT;
-    int32_t bundleClientRes = bundleMgrClient.InstallSandboxApp(bundleName,
-        static_cast<int32_t>(permForBMS), userId, dlpSandboxInfo.appIndex);
+    int32_t bundleClientRes = bundleMgrClient.InstallSandboxApp(bundleName, GetPermForBMS(dlpFileAccess), userId,
+        dlpSandboxInfo.appIndex);
     if (bundleClientRes != DLP_OK) {
         DLP_LOG_ERROR(LABEL, "install sandbox %{public}s fail, %{public}d", bundleName.c_str(), bundleClientRes);
         return DLP_SERVICE_ERROR_INSTALL_SANDBOX_FAIL;
@@ -856,10 +981,8 @@ static void previewBindInstall(DlpSandboxInfo& sandboxInfo, int32_t userId, DLPF
 {
     if (sandboxInfo.bindAppIndex <= HIPREVIEW_SANDBOX_LOW_BOUND && sandboxInfo.appIndex > HIPREVIEW_SANDBOX_LOW_BOUND) {
         AppExecFwk::BundleMgrClient bundleMgrClient;
-        DLPFileAccess permForBMS =
-            (dlpFileAccess == DLPFileAccess::READ_ONLY) ? DLPFileAccess::READ_ONLY : DLPFileAccess::CONTENT_EDIT;
         int32_t bundleClientRes = bundleMgrClient.InstallSandboxApp(
-            HIPREVIEW_LOW, static_cast<int32_t>(permForBMS), userId, sandboxInfo.bindAppIndex);
+            HIPREVIEW_LOW, GetPermForBMS(dlpFileAccess), userId, sandboxInfo.bindAppIndex);
         if (bundleClientRes != DLP_OK) {
             DLP_LOG_ERROR(LABEL, "install sandbox %{public}s fail, %{public}d", HIPREVIEW_LOW, bundleClientRes);
         } else {
@@ -871,16 +994,166 @@ static void previewBindInstall(DlpSandboxInfo& sandboxInfo, int32_t userId, DLPF
     }
 }
  
+static RetentionInfo ToPoolRecord(const SandboxPoolKey& key, const SandboxPoolEntry& entry)
+{
+    RetentionInfo info;
+    info.bundleName = key.bundleName;
+    info.dlpFileAccess = static_cast<DLPFileAccess>(key.permForBMS);
+    info.userId = key.userId;
+    info.appIndex = entry.appIndex;
+    info.bindAppIndex = entry.bindAppIndex;
+    return info;
+}
+
+void DlpPermissionService::InitSandboxPoolPolicy()
+{
+    SandboxPoolPolicy policy;
+    policy.maxPerUser = static_cast<uint32_t>(OHOS::system::GetIntParameter<int32_t>(SANDBOX_POOL_MAX_PER_USER,
+        0, 0, MAX_SANDBOX_POOL_SIZE));
+    policy.maxPerKey = static_cast<uint32_t>(OHOS::system::GetIntParameter<int32_t>(SANDBOX_POOL_MAX_PER_BUNDLE,
+        1, 1, MAX_SANDBOX_POOL_SIZE));
+    sandboxPool_.SetPolicy(policy);
+    DLP_LOG_INFO(LABEL, "sandbox pool maxPerUser=%{public}u, maxPerKey=%{public}u", policy.maxPerUser,
+        policy.maxPerKey);
+}
+
+bool DlpPermissionService::AcquirePooledSandbox(const InputSandboxInfo& inputSandboxInfo,
+    DlpSandboxInfo& dlpSandboxInfo)
+{
+    SandboxPoolKey key = {inputSandboxInfo.bundleName, GetPermForBMS(inputSandboxInfo.dlpFileAccess),
+        inputSandboxInfo.userId};
+    SandboxPoolEntry entry;
+    bool isHit = sandboxPool_.Acquire(key, entry);
+    if (isHit) {
+        dlpSandboxInfo.appIndex = entry.appIndex;
+        dlpSandboxInfo.bindAppIndex = entry.bindAppIndex;
+        (void)RetentionFileManager::GetInstance().RemovePoolSandboxes({ ToPoolRecord(key, entry) });
+        DLP_LOG_INFO(LABEL, "use pooled sandbox %{public}s, appIndex=%{public}d", key.bundleName.c_str(),
+            entry.appIndex);
+    }
+    RequestSandboxPoolRefill();
+    return isHit;
+}
+
+void DlpPermissionService::RequestSandboxPoolRefill()
+{
+    if (sandboxPoolStopped_.load() || !sandboxPool_.IsEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sandboxPoolThreadMutex_);
+    if (sandboxPoolStopped_.load() || sandboxPoolRefilling_.exchange(true)) {
+        return;
+    }
+    if (sandboxPoolThread_.joinable()) {
+        sandboxPoolThread_.join();
+    }
+    sandboxPoolThread_ = std::thread([this]() {
+        RefillSandboxPool();
+        sandboxPoolRefilling_.store(false);
+    });
+}
+
+void DlpPermissionService::RefillSandboxPool()
+{
+    while (!sandboxPoolStopped_.load()) {
+        std::vector<SandboxPoolKey> toInstall;
+        std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>> toUninstall;
+        sandboxPool_.CollectWork(toInstall, toUninstall);
+        UninstallPooledSandboxes(toUninstall);
+        if (toInstall.empty()) {
+            return;
+        }
+        bool isFailed = false;
+        AppExecFwk::BundleMgrClient bundleMgrClient;
+        for (const auto& key : toInstall) {
+            if (isFailed || sandboxPoolStopped_.load()) {
+                sandboxPool_.CancelProvision(key);
+                continue;
+            }
+            SandboxPoolEntry entry;
+            int32_t res = bundleMgrClient.InstallSandboxApp(key.bundleName, key.permForBMS, key.userId,
+                entry.appIndex);
+            if (res != DLP_OK) {
+                DLP_LOG_ERROR(LABEL, "provision sandbox %{public}s fail, %{public}d", key.bundleName.c_str(), res);
+                sandboxPool_.CancelProvision(key);
+                isFailed = true;
+                continue;
+            }
+            if (key.bundleName == HIPREVIEW_HIGH) {
+                DlpSandboxInfo sandboxInfo;
+                sandboxInfo.appIndex = entry.appIndex;
+                previewBindInstall(sandboxInfo, key.userId, static_cast<DLPFileAccess>(key.permForBMS));
+                entry.bindAppIndex = sandboxInfo.bindAppIndex;
+            }
+            if (RetentionFileManager::GetInstance().AddPoolSandbox(ToPoolRecord(key, entry)) != DLP_OK) {
+                DLP_LOG_WARN(LABEL, "persist pooled sandbox %{public}s fail", key.bundleName.c_str());
+            }
+            if (!sandboxPool_.Provisioned(key, entry)) {
+                UninstallPooledSandboxes({ { key, entry } });
+            }
+        }
+        // A failed install is retried on the next open of any pooled bundle, not in a loop here.
+        if (isFailed) {
+            return;
+        }
+    }
+}
+
+void DlpPermissionService::UninstallPooledSandboxes(
+    const std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>>& sandboxes)
+{
+    if (sandboxes.empty()) {
+        return;
+    }
+    std::vector<RetentionInfo> records;
+    for (const auto& sandbox : sandboxes) {
+        const SandboxPoolKey& key = sandbox.first;
+        if (key.bundleName == HIPREVIEW_HIGH && sandbox.second.bindAppIndex > HIPREVIEW_SANDBOX_LOW_BOUND) {
+            (void)UninstallDlpSandboxApp(HIPREVIEW_LOW, sandbox.second.bindAppIndex, key.userId);
+        }
+        (void)UninstallDlpSandboxApp(key.bundleName, sandbox.second.appIndex, key.userId);
+        records.emplace_back(ToPoolRecord(key, sandbox.second));
+    }
+    (void)RetentionFileManager::GetInstance().RemovePoolSandboxes(records);
+}
+
+void DlpPermissionService::UninstallLostPooledSandboxes()
+{
+    std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>> sandboxes;
+    for (const auto& info : RetentionFileManager::GetInstance().GetPoolSandboxes()) {
+        SandboxPoolKey key = { info.bundleName, static_cast<int32_t>(info.dlpFileAccess), info.userId };
+        SandboxPoolEntry entry = { info.appIndex, info.bindAppIndex };
+        sandboxes.emplace_back(key, entry);
+    }
+    if (!sandboxes.empty()) {
+        DLP_LOG_INFO(LABEL, "uninstall %{public}zu pooled sandboxes left by the last run", sandboxes.size());
+    }
+    UninstallPooledSandboxes(sandboxes);
+}
+
+void DlpPermissionService::StopSandboxPool()
+{
+    sandboxPoolStopped_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sandboxPoolThreadMutex_);
+        if (sandboxPoolThread_.joinable()) {
+            sandboxPoolThread_.join();
+        }
+    }
+    // Idle pooled sandboxes must not outlive the service; those lost to a crash are uninstalled at the next start.
+    UninstallPooledSandboxes(sandboxPool_.Drain(-1));
+    // Disabled until the next start has uninstalled the sandboxes on record.
+    sandboxPool_.SetPolicy(SandboxPoolPolicy());
+}
+
 static int32_t InstallDlpSandboxExecute(bool& isNeedInstall, DLPFileAccess& dlpFileAccess,
     const std::string& bundleName, int32_t& userId, DlpSandboxInfo& dlpSandboxInfo)
 {
     DLP_LOG_INFO(LABEL, "InstallDlpSandbox %s, isNeedInstall=%d", bundleName.c_str(), isNeedInstall);
     if (isNeedInstall) {
         AppExecFwk::BundleMgrClient bundleMgrClient;
-        DLPFileAccess permForBMS =
-            (dlpFileAccess == DLPFileAccess::READ_ONLY) ? DLPFileAccess::READ_ONLY : DLPFileAccess::CONTENT_EDIT;
-        int32_t bundleClientRes = bundleMgrClient.InstallSandboxApp(bundleName,
-            static_cast<int32_t>(permForBMS), userId, dlpSandboxInfo.appIndex);
+        int32_t bundleClientRes = bundleMgrClient.InstallSandboxApp(bundleName, GetPermForBMS(dlpFileAccess), userId,
+            dlpSandboxInfo.appIndex);
         if (bundleClientRes != DLP_OK) {
             DLP_LOG_ERROR(LABEL, "install sandbox %{public}s fail, %{public}d", bundleName.c_str(), bundleClientRes);
             return DLP_SERVICE_ERROR_INSTALL_SANDBOX_FAIL;
@@ -900,10 +1173,9 @@ void DlpPermissionService::UpdateSandboxInstallResult(SandboxInfo& sandboxInfo,
     sandboxInfo.appIndex = dlpSandboxInfo.appIndex;
     sandboxInfo.bindAppIndex = dlpSandboxInfo.bindAppIndex;
     sandboxInfo.tokenId = dlpSandboxInfo.tokenId;
-    std::unique_lock<std::shared_mutex> lock(dlpSandboxDataMutex_);
-    if (dlpSandboxData_.find(dlpSandboxInfo.uid) == dlpSandboxData_.end()) {
-        dlpSandboxData_.insert(std::make_pair(dlpSandboxInfo.uid, dlpSandboxInfo.dlpFileAccess));
-    }
+    dlpSandboxData_.Update([&dlpSandboxInfo](std::unordered_map<int, DLPFileAccess>& data) {
+        data.emplace(dlpSandboxInfo.uid, dlpSandboxInfo.dlpFileAccess);
+    });
 }
 
 int32_t DlpPermissionService::HandleEnterpriseInstallDlpSandbox(SandboxInfo& sandboxInfo,
@@ -937,7 +1209,8 @@ int32_t DlpPermissionService::HandleEnterpriseInstallDlpSandbox(SandboxInfo& san
         isNeedInstall = (dlpSandboxInfo.appIndex != -1) ? false : true;
     }
 
-    res = InstallDlpSandboxExecute(isNeedInstall, inputSandboxInfo.dlpFileAccess,
+    bool isInstallNow = isNeedInstall && !AcquirePooledSandbox(inputSandboxInfo, dlpSandboxInfo);
+    res = InstallDlpSandboxExecute(isInstallNow, inputSandboxInfo.dlpFileAccess,
         inputSandboxInfo.bundleName, inputSandboxInfo.userId, dlpSandboxInfo);
     if (res != DLP_OK) {
         observer->EraseEnterpriseInfoByUri(inputSandboxInfo.path, enterpriseInfo.fileId);
@@ -986,7 +1259,8 @@ int32_t DlpPermissionService::HandleInstallDlpSandbox(SandboxInfo& sandboxInfo,
         isNeedInstall = (dlpSandboxInfo.appIndex != -1) ? false : true;
     }
 
-    res = InstallDlpSandboxExecute(isNeedInstall, inputSandboxInfo.dlpFileAccess,
+    bool isInstallNow = isNeedInstall && !AcquirePooledSandbox(inputSandboxInfo, dlpSandboxInfo);
+    res = InstallDlpSandboxExecute(isInstallNow, inputSandboxInfo.dlpFileAccess,
         inputSandboxInfo.bundleName, inputSandboxInfo.userId, dlpSandboxInfo);
     if (res != DLP_OK) {
         return res;
@@ -1049,11 +1323,7 @@ uint32_t DlpPermissionService::DeleteDlpSandboxInfo(const std::string& bundleNam
         return 0;
     }
 
-    std::unique_lock<std::shared_mutex> lock(dlpSandboxDataMutex_);
-    auto it = dlpSandboxData_.find(info.uid);
-    if (it != dlpSandboxData_.end()) {
-        dlpSandboxData_.erase(info.uid);
-    }
+    dlpSandboxData_.Update([&info](std::unordered_map<int, DLPFileAccess>& data) { data.erase(info.uid); });
 
     return observer->EraseDlpSandboxInfo(info.uid);
 }
@@ -1103,7 +1373,9 @@ int32_t DlpPermissionService::UninstallDlpSandbox(const std::string& bundleName,
             int32_t bindAppIndex = sandboxInfo.bindAppIndex;
             (void)UninstallDlpSandboxApp(HIPREVIEW_LOW, bindAppIndex, userId);
         }
-        return UninstallDlpSandboxApp(bundleName, appIndex, userId);
+        int32_t res = UninstallDlpSandboxApp(bundleName, appIndex, userId);
+        RequestSandboxPoolRefill();
+        return res;
     }
     return DLP_OK;
 }
@@ -1113,11 +1385,11 @@ static bool CheckAllowAbilityList(const AAFwk::Want& want)
     std::string bundleName = want.GetBundle();
     std::string actionName = want.GetAction();
     DLP_LOG_DEBUG(LABEL, "CheckAllowAbilityList %{public}s %{public}s", bundleName.c_str(), actionName.c_str());
-    bool bundleCheck = (bundleName == DLP_MANAGER) &&
+    if (ALLOW_ACTION.count(actionName) > 0) {
+        return true;
+    }
+    return (bundleName == DLP_MANAGER) &&
         BundleManagerAdapter::GetInstance().CheckHapPermission(bundleName, PERMISSION_ACCESS_DLP_FILE);
-    bool actionCheck = std::any_of(std::begin(ALLOW_ACTION), std::end(ALLOW_ACTION),
-        [actionName](const std::string& action) { return action == actionName; });
-    return actionCheck || bundleCheck;
 }
 
 int32_t DlpPermissionService::GetSandboxExternalAuthorization(
@@ -1137,25 +1409,22 @@ int32_t DlpPermissionService::GetSandboxExternalAuthorization(
         DLP_LOG_ERROR(LABEL, "param is invalid");
         return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    bool isSandbox = false;
-
-    observer->IsInDlpSandbox(isSandbox, sandboxUid);
-
-    std::unique_lock<std::shared_mutex> lock(dlpSandboxDataMutex_);
-    auto it = dlpSandboxData_.find(sandboxUid);
-    DLP_LOG_INFO(LABEL, "GetSandboxExternalAuthorization bundleName=%s", bundleName.c_str());
-    if (isSandbox && it != dlpSandboxData_.end() &&
-        std::find(SANDBOX_WHITELIST.begin(), SANDBOX_WHITELIST.end(), bundleName) != SANDBOX_WHITELIST.end()) {
+    // Called on every ability start, so both lookups read published snapshots instead of taking locks.
+    if (!observer->IsSandboxUid(sandboxUid)) {
         authType = SandBoxExternalAuthorType::ALLOW_START_ABILITY;
         return DLP_OK;
     }
-
-    if (isSandbox && it != dlpSandboxData_.end() && dlpSandboxData_[sandboxUid] != DLPFileAccess::READ_ONLY) {
+    DLP_LOG_DEBUG(LABEL, "GetSandboxExternalAuthorization bundleName=%{public}s", bundleName.c_str());
+    bool isAllowed = dlpSandboxData_.Read([sandboxUid, &bundleName](const auto& data) {
+        auto it = data.find(sandboxUid);
+        return it != data.end() && (SANDBOX_WHITELIST.count(bundleName) > 0 || it->second != DLPFileAccess::READ_ONLY);
+    });
+    if (isAllowed) {
         authType = SandBoxExternalAuthorType::ALLOW_START_ABILITY;
         return DLP_OK;
     }
 
-    if (isSandbox && !CheckAllowAbilityList(want)) {
+    if (!CheckAllowAbilityList(want)) {
         authType = SandBoxExternalAuthorType::DENY_START_ABILITY;
     } else {
         authType = SandBoxExternalAuthorType::ALLOW_START_ABILITY;
@@ -1208,6 +1477,23 @@ static int32_t ProcessCopyReport(const std::string& fileId, int32_t ret)
     return res;
 }
 
+static bool MatchNativeToken(std::atomic<Security::AccessToken::AccessTokenID>& cachedTokenId,
+    const std::string& processName, Security::AccessToken::AccessTokenID callingToken)
+{
+    Security::AccessToken::AccessTokenID tokenId = cachedTokenId.load(std::memory_order_relaxed);
+    if (tokenId == 0) {
+        tokenId = Security::AccessToken::AccessTokenKit::GetNativeTokenId(processName);
+        cachedTokenId.store(tokenId, std::memory_order_relaxed);
+    }
+    return tokenId != 0 && tokenId == callingToken;
+}
+
+bool DlpPermissionService::IsCopyPolicyCaller(Security::AccessToken::AccessTokenID callingToken)
+{
+    return MatchNativeToken(pasteboardTokenId_, PASTEBOARD_SERVICE_NAME, callingToken) ||
+        MatchNativeToken(distributedDataTokenId_, DISTRIBUTED_DATA_NAME, callingToken);
+}
+
 int32_t DlpPermissionService::QueryDlpFileCopyableByTokenId(bool& copyable, uint32_t tokenId)
 {
     CriticalHelper criticalHelper("QueryDlpFileCopyableByTokenId");
@@ -1215,32 +1501,25 @@ int32_t DlpPermissionService::QueryDlpFileCopyableByTokenId(bool& copyable, uint
     if (observer == nullptr) {
         return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    Security::AccessToken::AccessTokenID callingToken = IPCSkeleton::GetCallingTokenID();
-    Security::AccessToken::AccessTokenID pasteboardToken =
-        Security::AccessToken::AccessTokenKit::GetNativeTokenId(PASTEBOARD_SERVICE_NAME);
-    Security::AccessToken::AccessTokenID distributeddataToken =
-        Security::AccessToken::AccessTokenKit::GetNativeTokenId(DISTRIBUTED_DATA_NAME);
-    if (callingToken != pasteboardToken && callingToken != distributeddataToken) {
+    if (!IsCopyPolicyCaller(IPCSkeleton::GetCallingTokenID())) {
         DLP_LOG_ERROR(LABEL, "Caller is not pasteboard or distributeddata");
         return DLP_SERVICE_ERROR_PERMISSION_DENY;
     }
     if (tokenId == 0) {
         return DLP_SERVICE_ERROR_VALUE_INVALID;
     }
-    bool inDlpsandbox = false;
-    int32_t res = observer->QueryDlpFileCopyableByTokenId(copyable, tokenId, inDlpsandbox);
-    DlpSandboxInfo sandboxInfo;
-    EnterpriseInfo enterpriseInfo;
-    if (observer->GetSandboxInfoByTokenId(tokenId, sandboxInfo) &&
-        observer->GetEnterpriseInfoByUid(sandboxInfo.uid, enterpriseInfo)) {
-        ProcessCopyReport(sandboxInfo.fileId, res);
+    DlpCopyPolicy policy;
+    observer->GetCopyPolicyByTokenId(tokenId, policy);
+    copyable = policy.copyable;
+    if (policy.isEnterprise) {
+        ProcessCopyReport(policy.fileId, policy.result);
     }
-    
-    if (!inDlpsandbox) {
-        DLP_LOG_INFO(LABEL, "tokenId %{public}u is not in dlp sandbox, query from credential service", tokenId);
-        res = DlpCredential::GetInstance().QueryDlpFileCopyableByTokenId(copyable, tokenId);
+
+    if (!policy.inDlpSandbox) {
+        DLP_LOG_DEBUG(LABEL, "tokenId %{public}u is not in dlp sandbox, query from credential service", tokenId);
+        return DlpCredential::GetInstance().QueryDlpFileCopyableByTokenId(copyable, tokenId);
     }
-    return res;
+    return policy.result;
 }
 
 static ActionFlags GetDlpActionFlag(DLPFileAccess dlpFileAccess)
@@ -1333,27 +1612,36 @@ void DlpPermissionService::GetConfigFileValue(const std::string& cfgFile, std::v
 
 void DlpPermissionService::InitConfig(std::vector<std::string>& typeList)
 {
-    static std::vector<std::string> typeListTemp;
-    static bool cfgInit = true;
     std::lock_guard<std::mutex> lock(mutex_);
-    if (cfgInit) {
-        cfgInit = false;
-        std::vector<std::string> cfgFilesList;
-        GetCfgFilesList(cfgFilesList);
-        for (const auto& cfgFile : cfgFilesList) {
-            GetConfigFileValue(cfgFile, typeListTemp);
-            if (!typeListTemp.empty()) {
-                typeList = typeListTemp;
-                return;
-            }
-        }
-        DLP_LOG_INFO(LABEL, "get config value failed, use default file path");
-        GetConfigFileValue(DEAULT_DLP_CONFIG, typeListTemp);
-        if (typeListTemp.empty()) {
-            DLP_LOG_ERROR(LABEL, "support file type list is empty");
+    if (supportFileTypeInit_) {
+        typeList = supportFileTypes_;
+        return;
+    }
+    supportFileTypeInit_ = true;
+    std::vector<std::string> cfgFilesList;
+    GetCfgFilesList(cfgFilesList);
+    std::vector<std::string> sourcePaths = cfgFilesList;
+    sourcePaths.emplace_back(DEAULT_DLP_CONFIG);
+    supportFileTypeStamp_ = WarmStartSnapshot::GetSourceStamp(sourcePaths);
+    if (WarmStartSnapshot::Load(WARM_START_SNAPSHOT_PATH, supportFileTypeStamp_, supportFileTypes_) &&
+        !supportFileTypes_.empty()) {
+        supportFileTypeFromSnapshot_ = true;
+        typeList = supportFileTypes_;
+        return;
+    }
+    for (const auto& cfgFile : cfgFilesList) {
+        GetConfigFileValue(cfgFile, supportFileTypes_);
+        if (!supportFileTypes_.empty()) {
+            typeList = supportFileTypes_;
+            return;
         }
     }
-    typeList = typeListTemp;
+    DLP_LOG_INFO(LABEL, "get config value failed, use default file path");
+    GetConfigFileValue(DEAULT_DLP_CONFIG, supportFileTypes_);
+    if (supportFileTypes_.empty()) {
+        DLP_LOG_ERROR(LABEL, "support file type list is empty");
+    }
+    typeList = supportFileTypes_;
 }
 
 int32_t DlpPermissionService::GetDlpSupportFileType(std::vector<std::string>& supportFileType)
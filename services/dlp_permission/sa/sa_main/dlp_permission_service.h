@@ -20,12 +20,15 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "app_state_observer.h"
 #include "app_uninstall_observer.h"
 #include "dlp_permission_service_stub.h"
 #include "iremote_object.h"
 #include "nocopyable.h"
+#include "rcu_snapshot.h"
 #include "retention_file_manager.h"
+#include "sandbox_pool.h"
 #include "sandbox_config_kv_data_storage.h"
 #include "singleton.h"
 #include "system_ability.h"
@@ -104,6 +107,7 @@ public:
     int32_t SetEnterpriseInfos(const std::string& uri, const std::string& fileId,
         DLPFileAccess dlpFileAccess, const std::string& classificationLabel, const std::string& appIdentifier) override;
     void OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
+    void OnRemoveSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
 
 private:
     bool InsertDlpSandboxInfo(DlpSandboxInfo& sandboxInfo, bool hasRetention);
@@ -126,18 +130,32 @@ private:
     int32_t HandleInstallDlpSandbox(SandboxInfo& sandboxInfo,
         InputSandboxInfo& inputSandboxInfo, const FileInfo& fileInfo);
     void UpdateSandboxInstallResult(SandboxInfo& sandboxInfo, const DlpSandboxInfo& dlpSandboxInfo);
+    bool IsCopyPolicyCaller(Security::AccessToken::AccessTokenID callingToken);
     int32_t ChangeWaterMarkInfo();
     void UnregisterAccount();
     void RegisterAccount();
     int32_t InitAccountListenerCallback();
     void DelSandboxInfoByAccount(bool isRegister);
+    void StartWarmUp();
+    void StopWarmUp();
+    void SaveWarmStartSnapshot();
+    // Returns false if any sandbox failed to uninstall.
+    bool TeardownSandboxes(const std::vector<DlpSandboxInfo>& sandboxes);
+    int32_t UninstallSandboxPair(const DlpSandboxInfo& sandboxInfo);
+    void InitSandboxPoolPolicy();
+    bool AcquirePooledSandbox(const InputSandboxInfo& inputSandboxInfo, DlpSandboxInfo& dlpSandboxInfo);
+    void RequestSandboxPoolRefill();
+    void RefillSandboxPool();
+    void StopSandboxPool();
+    void UninstallPooledSandboxes(const std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>>& sandboxes);
+    void UninstallLostPooledSandboxes();
     void DelWaterMarkInfo();
     sptr<AppStateObserver> GetAppStateObserver(CurrentTaskState taskState);
 
     std::atomic<int32_t> repeatTime_;
     std::shared_ptr<std::thread> thread_ = nullptr;
+    std::thread warmUpThread_;
     std::mutex mutex_;
-    std::shared_mutex dlpSandboxDataMutex_;
     std::shared_mutex serviceMemberMutex_;
     std::mutex waterMarkInfoMutex_;
     std::condition_variable waterMarkInfoCv_;
@@ -145,7 +163,19 @@ private:
     sptr<AppExecFwk::IAppMgr> iAppMgr_;
     sptr<AppStateObserver> appStateObserver_;
     std::shared_ptr<DlpEventSubSubscriber> dlpEventSubSubscriber_ = nullptr;
-    std::map<int, DLPFileAccess> dlpSandboxData_;
+    RcuSnapshot<std::unordered_map<int, DLPFileAccess>> dlpSandboxData_;
+    std::atomic<Security::AccessToken::AccessTokenID> pasteboardTokenId_ { 0 };
+    std::atomic<Security::AccessToken::AccessTokenID> distributedDataTokenId_ { 0 };
+    // Guarded by mutex_; loaded from the warm start snapshot when the config files are unchanged.
+    std::vector<std::string> supportFileTypes_;
+    bool supportFileTypeInit_ = false;
+    bool supportFileTypeFromSnapshot_ = false;
+    uint64_t supportFileTypeStamp_ = 0;
+    SandboxPool sandboxPool_;
+    std::mutex sandboxPoolThreadMutex_;
+    std::thread sandboxPoolThread_;
+    std::atomic<bool> sandboxPoolRefilling_ { false };
+    std::atomic<bool> sandboxPoolStopped_ { false };
     WaterMarkInfo waterMarkInfo_;
 };
 }  // namespace DlpPermission
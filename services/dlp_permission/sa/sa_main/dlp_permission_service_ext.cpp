@@ -29,6 +29,7 @@
 #include "permission_manager_adapter.h"
 #include "retention_file_manager.h"
 #include "sandbox_config_kv_data_storage.h"
+#include "startup_profiler.h"
 #include "visit_record_file_manager.h"
 #include "critical_helper.h"
 #include "alg_utils.h"
@@ -440,6 +441,8 @@ int DlpPermissionService::Dump(int fd, const std::vector<std::u16string>& args)
             return ERR_INVALID_VALUE;
         }
         observer->DumpSandbox(fd);
+        StartupProfiler::GetInstance().Dump(fd);
+        sandboxPool_.Dump(fd);
     }
 
     return ERR_OK;
@@ -575,18 +578,7 @@ int32_t DlpPermissionService::CloseOpenedEnterpriseDlpFiles(const std::string& l
     observer->GetNeededDelEnterpriseSandbox(label, appIdentifier, appInfos);
     DLP_LOG_INFO(LABEL, "CloseOpenedEnterpriseDlpFiles label:%{private}s, count:%{public}zu", label.c_str(),
         appInfos.size());
-    bool allUninstalled = true;
-    for (const auto& appInfo : appInfos) {
-        DeleteDlpSandboxInfo(appInfo.bundleName, appInfo.appIndex, appInfo.userId);
-        if (appInfo.bundleName == HIPREVIEW_HIGH) {
-            UninstallDlpSandboxApp(HIPREVIEW_LOW, appInfo.bindAppIndex, appInfo.userId);
-        }
-        allUninstalled = (UninstallDlpSandboxApp(appInfo.bundleName, appInfo.appIndex, appInfo.userId) == DLP_OK) &&
-            allUninstalled;
-        RetentionFileManager::GetInstance().RemoveRetentionState(appInfo.bundleName, appInfo.appIndex);
-        DlpSandboxChangeCallbackManager::GetInstance().ExecuteCallbackAsync(appInfo);
-    }
-    return allUninstalled ? DLP_OK : DLP_PARSE_ERROR_BMS_ERROR;
+    return TeardownSandboxes(appInfos) ? DLP_OK : DLP_PARSE_ERROR_BMS_ERROR;
 }
 
 int32_t DlpPermissionService::SetEnterpriseInfos(const std::string& uri, const std::string& fileId,
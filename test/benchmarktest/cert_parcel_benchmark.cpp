@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "cert_parcel.h"
+#include "message_parcel.h"
+
+using namespace OHOS;
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr int64_t MIN_CERT_SIZE = 1024;
+static constexpr int64_t MAX_CERT_SIZE = 16 * 1024 * 1024;
+static constexpr int RANGE_MULTIPLIER = 4;
+
+// Marshal and unmarshal a cert of state.range(0) bytes, the way a ParseDlpCertificate round trip does.
+static void BM_CertParcelRoundTrip(benchmark::State& state)
+{
+    CertParcel info;
+    info.cert = std::vector<uint8_t>(static_cast<size_t>(state.range(0)), 0x5a);
+    for (auto _ : state) {
+        MessageParcel data;
+        if (!info.Marshalling(data)) {
+            state.SkipWithError("Marshalling fail");
+            break;
+        }
+        CertParcel* result = CertParcel::Unmarshalling(data);
+        if (result == nullptr) {
+            state.SkipWithError("Unmarshalling fail");
+            break;
+        }
+        benchmark::DoNotOptimize(result->cert.data());
+        delete result;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_CertParcelRoundTrip)->RangeMultiplier(RANGE_MULTIPLIER)->Range(MIN_CERT_SIZE, MAX_CERT_SIZE);
+
+BENCHMARK_MAIN();
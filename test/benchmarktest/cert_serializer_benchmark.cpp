@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "dlp_permission.h"
+#include "dlp_permission_serializer.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static const uint32_t KEY_LEN = 32;
+static const uint32_t IV_LEN = 16;
+
+// A cert body whose size follows the authorized user list, as returned by the credential SDK.
+static std::string BuildPolicyPayload(int64_t userNum)
+{
+    PermissionPolicy policy;
+    policy.ownerAccount_ = "owner";
+    policy.ownerAccountId_ = "ownerId";
+    policy.ownerAccountType_ = DlpAccountType::CLOUD_ACCOUNT;
+    uint8_t key[KEY_LEN] = {0};
+    uint8_t iv[IV_LEN] = {0};
+    policy.SetAeskey(key, KEY_LEN);
+    policy.SetIv(iv, IV_LEN);
+    policy.SetHmacKey(key, KEY_LEN);
+    for (int64_t i = 0; i < userNum; i++) {
+        AuthUserInfo user;
+        user.authAccount = "user" + std::to_string(i) + "@example.com";
+        user.authPerm = DLPFileAccess::READ_ONLY;
+        policy.authUsers_.emplace_back(user);
+    }
+    unordered_json json;
+    (void)DlpPermissionSerializer::GetInstance().SerializeDlpPermission(policy, json);
+    return json.dump();
+}
+
+static DLP_EncPolicyData BuildEncData(std::string& payload)
+{
+    DLP_EncPolicyData encData = {};
+    encData.data = reinterpret_cast<uint8_t*>(payload.data());
+    encData.dataLen = payload.size();
+    encData.accountType = static_cast<AccountType>(DlpAccountType::CLOUD_ACCOUNT);
+    return encData;
+}
+
+static void BM_CertEnvelopeJson(benchmark::State& state)
+{
+    std::string payload = BuildPolicyPayload(state.range(0));
+    DLP_EncPolicyData encData = BuildEncData(payload);
+    for (auto _ : state) {
+        unordered_json encDataJson;
+        (void)DlpPermissionSerializer::GetInstance().SerializeEncPolicyData(encData, encDataJson);
+        std::string cert = encDataJson.dump();
+        auto parsed = unordered_json::parse(cert, nullptr, false);
+        DLP_EncPolicyData outData = {};
+        (void)DlpPermissionSerializer::GetInstance().DeserializeEncPolicyData(parsed, outData, false);
+        benchmark::DoNotOptimize(outData.data);
+        delete[] outData.data;
+    }
+}
+
+static void BM_CertEnvelopeTlv(benchmark::State& state)
+{
+    std::string payload = BuildPolicyPayload(state.range(0));
+    DLP_EncPolicyData encData = BuildEncData(payload);
+    for (auto _ : state) {
+        std::vector<uint8_t> cert;
+        (void)DlpPermissionSerializer::GetInstance().SerializeEncPolicyDataTlv(encData, cert);
+        DLP_EncPolicyData outData = {};
+        (void)DlpPermissionSerializer::GetInstance().DeserializeEncPolicyDataTlv(cert, outData);
+        benchmark::DoNotOptimize(outData.data);
+        delete[] outData.data;
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_CertEnvelopeJson)->Arg(1)->Arg(100)->Arg(1000);
+BENCHMARK(BM_CertEnvelopeTlv)->Arg(1)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "dlp_file_registry.h"
+#include "dlp_raw_file.h"
+#include "rwlock.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t OPEN_FILE_NUM = 1000;
+static constexpr int32_t FD_BASE = 100;
+// One open and close of a spare file for this many lookups, like a manager serving reads between opens.
+static constexpr uint32_t LOOKUPS_PER_REOPEN = 16;
+
+// The previous layout: one map behind one lock, walked entry by entry to find or remove a fd.
+struct LegacyFileMap {
+    OHOS::Utils::RWLock lock;
+    std::unordered_map<int32_t, std::shared_ptr<DlpFile>> files;
+
+    std::shared_ptr<DlpFile> Get(int32_t dlpFd)
+    {
+        OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> guard(lock);
+        for (auto iter = files.begin(); iter != files.end(); iter++) {
+            if (dlpFd == iter->first) {
+                return iter->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void Add(const std::shared_ptr<DlpFile>& file)
+    {
+        OHOS::Utils::UniqueWriteGuard<OHOS::Utils::RWLock> guard(lock);
+        files[file->dlpFd_] = file;
+    }
+
+    void Remove(const std::shared_ptr<DlpFile>& file)
+    {
+        OHOS::Utils::UniqueWriteGuard<OHOS::Utils::RWLock> guard(lock);
+        for (auto iter = files.begin(); iter != files.end(); iter++) {
+            if (file->dlpFd_ == iter->first) {
+                files.erase(iter);
+                return;
+            }
+        }
+    }
+};
+
+struct RegistryFileMap {
+    DlpFileRegistry registry { OPEN_FILE_NUM + 64 };
+
+    std::shared_ptr<DlpFile> Get(int32_t dlpFd)
+    {
+        return registry.Get(dlpFd);
+    }
+
+    void Add(const std::shared_ptr<DlpFile>& file)
+    {
+        (void)registry.Add(file);
+    }
+
+    void Remove(const std::shared_ptr<DlpFile>& file)
+    {
+        (void)registry.Remove(file);
+    }
+};
+
+template<typename MapT>
+static MapT& GetMap()
+{
+    static MapT map;
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        for (uint32_t i = 0; i < OPEN_FILE_NUM; i++) {
+            map.Add(std::make_shared<DlpRawFile>(FD_BASE + static_cast<int32_t>(i), "txt"));
+        }
+    });
+    return map;
+}
+
+// Every thread looks up the open files in turn; each also opens and closes a spare file of its own now and then.
+template<typename MapT>
+static void BM_LookupWithReopen(benchmark::State& state)
+{
+    auto& map = GetMap<MapT>();
+    auto spare = std::make_shared<DlpRawFile>(FD_BASE + static_cast<int32_t>(OPEN_FILE_NUM) + state.thread_index(),
+        "txt");
+    uint32_t index = static_cast<uint32_t>(state.thread_index()) * (OPEN_FILE_NUM / 8);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.Get(FD_BASE + static_cast<int32_t>(index % OPEN_FILE_NUM)));
+        if (++index % LOOKUPS_PER_REOPEN == 0) {
+            map.Add(spare);
+            map.Remove(spare);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_LookupWithReopen, LegacyFileMap)->Threads(1)->Threads(4)->Threads(8);
+BENCHMARK_TEMPLATE(BM_LookupWithReopen, RegistryFileMap)->Threads(1)->Threads(4)->Threads(8);
+
+BENCHMARK_MAIN();
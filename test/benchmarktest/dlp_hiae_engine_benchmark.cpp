@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "dlp_crypt.h"
+#include "dlp_hiae_engine.h"
+#include "dlp_permission.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t KEY_SIZE = 16;
+static constexpr uint32_t IV_SIZE = 16;
+static constexpr uint32_t COUNTER_SIZE = 16;
+// Content crypted per iteration, in range(0) sized calls.
+static constexpr uint32_t CONTENT_SIZE = 16 * 1024 * 1024;
+
+struct CryptInput {
+    uint8_t keyData[KEY_SIZE] = { 0x11 };
+    uint8_t ivData[IV_SIZE] = { 0x22 };
+    struct DlpBlob key = { .size = KEY_SIZE, .data = keyData };
+    struct DlpBlob iv = { .size = IV_SIZE, .data = ivData };
+    std::vector<uint8_t> in = std::vector<uint8_t>(CONTENT_SIZE, 'a');
+    std::vector<uint8_t> out = std::vector<uint8_t>(CONTENT_SIZE);
+};
+
+template<typename CryptFunc>
+static void RunCrypt(benchmark::State& state, CryptInput& input, CryptFunc crypt)
+{
+    uint32_t callSize = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        for (uint32_t offset = 0; offset < CONTENT_SIZE; offset += callSize) {
+            if (crypt(input.in.data() + offset, input.out.data() + offset, callSize, offset) != DLP_OK) {
+                state.SkipWithError("crypt failed");
+                return;
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(CONTENT_SIZE));
+}
+
+static void BM_AesCtr(benchmark::State& state)
+{
+    CryptInput input;
+    RunCrypt(state, input, [&input](const uint8_t* in, uint8_t* out, uint32_t size, uint32_t offset) {
+        uint8_t ivData[IV_SIZE];
+        std::copy(input.ivData, input.ivData + IV_SIZE, ivData);
+        struct DlpCipherParam param;
+        param.iv = { .size = IV_SIZE, .data = ivData };
+        (void)DlpCtrModeIncreaeIvCounter(param.iv, offset / COUNTER_SIZE);
+        struct DlpUsageSpec spec = { .mode = DLP_MODE_CTR, .algParam = &param };
+        struct DlpBlob message = { .size = size, .data = const_cast<uint8_t*>(in) };
+        struct DlpBlob cipherText = { .size = size, .data = out };
+        return DlpOpensslAesEncrypt(&input.key, &spec, &message, &cipherText);
+    });
+}
+
+// The library is only there on devices that ship it.
+static bool LoadHIAE(benchmark::State& state)
+{
+    if (InitDlpHIAEMgr() != DLP_OK) {
+        state.SkipWithError("HIAE library is not available");
+        return false;
+    }
+    return true;
+}
+
+// One library init, update and clear per 4K block, each behind the library lock.
+static void BM_HIAEPerBlock(benchmark::State& state)
+{
+    if (!LoadHIAE(state)) {
+        return;
+    }
+    CryptInput input;
+    RunCrypt(state, input, [&input](const uint8_t* in, uint8_t* out, uint32_t size, uint32_t offset) {
+        uint8_t ivData[IV_SIZE];
+        struct DlpCipherParam param;
+        param.iv = { .size = IV_SIZE, .data = ivData };
+        struct DlpUsageSpec spec = { .mode = DLP_MODE_HIAE, .algParam = &param };
+        for (uint32_t pos = 0; pos < size; pos += DlpHIAEEngine::BLOCK_SIZE) {
+            std::copy(input.ivData, input.ivData + IV_SIZE, ivData);
+            (void)DlpCtrModeIncreaeIvCounter(param.iv, (offset + pos) / COUNTER_SIZE);
+            int32_t ret = DlpHIAEEncrypt(&input.key, &spec, std::min(size - pos, DlpHIAEEngine::BLOCK_SIZE),
+                in + pos, out + pos);
+            if (ret != DLP_OK) {
+                return ret;
+            }
+        }
+        return static_cast<int32_t>(DLP_OK);
+    });
+    ClearDlpHIAEMgr();
+}
+
+static void BM_HIAEEngine(benchmark::State& state)
+{
+    if (!LoadHIAE(state)) {
+        return;
+    }
+    CryptInput input;
+    DlpHIAEEngine engine;
+    if (engine.Init(input.key, input.iv) != DLP_OK) {
+        state.SkipWithError("init HIAE engine failed");
+        ClearDlpHIAEMgr();
+        return;
+    }
+    engine.SetWorkers(static_cast<uint32_t>(state.range(1)));
+    RunCrypt(state, input, [&engine](const uint8_t* in, uint8_t* out, uint32_t size, uint32_t offset) {
+        return engine.Crypt(in, out, size, offset, true);
+    });
+    ClearDlpHIAEMgr();
+}
+}  // namespace
+
+// 4K is a page sized read through the FUSE mount, 64K a typical player read and 1M a whole content window.
+BENCHMARK(BM_AesCtr)->Arg(4 * 1024)->Arg(64 * 1024)->Arg(1024 * 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HIAEPerBlock)->Arg(4 * 1024)->Arg(64 * 1024)->Arg(1024 * 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HIAEEngine)->Args({ 4 * 1024, 1 })->Args({ 64 * 1024, 1 })->Args({ 1024 * 1024, 1 })
+    ->Args({ 1024 * 1024, DlpHIAEEngine::MAX_WORKERS })->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
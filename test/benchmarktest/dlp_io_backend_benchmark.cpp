@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "dlp_io_backend.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t CHUNK_SIZE = 1024 * 1024;
+static constexpr uint32_t CHUNK_NUM = 64;
+static constexpr uint32_t MAX_BATCH = 4;
+// tmpfs and the data partition, the content of a dlp file lives on the latter.
+static const std::vector<std::string> TEST_DIRS = { "/dev/shm/", "/data/local/tmp/" };
+static constexpr int64_t TMPFS_DIR = 0;
+static constexpr int64_t DATA_DIR = 1;
+
+class TestFile {
+public:
+    TestFile(const std::string& dir, bool fill) : path_(dir + "dlp_io_backend_benchmark.dat")
+    {
+        fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (fd_ < 0 || !fill) {
+            return;
+        }
+        std::vector<uint8_t> chunk(CHUNK_SIZE, 'a');
+        for (uint32_t i = 0; i < CHUNK_NUM; i++) {
+            if (pwrite(fd_, chunk.data(), CHUNK_SIZE, static_cast<off_t>(i) * CHUNK_SIZE) != CHUNK_SIZE) {
+                close(fd_);
+                fd_ = -1;
+                return;
+            }
+        }
+    }
+    ~TestFile()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+            unlink(path_.c_str());
+        }
+    }
+    int32_t GetFd() const
+    {
+        return fd_;
+    }
+
+private:
+    std::string path_;
+    int32_t fd_ = -1;
+};
+
+// Streams CHUNK_NUM chunks through io, batch chunks per Submit; batch 1 is one pread or pwrite at a time.
+static void RunSequential(benchmark::State& state, IDlpIoBackend& io, bool isWrite)
+{
+    int64_t dirIndex = state.range(0);
+    uint32_t batch = static_cast<uint32_t>(state.range(1));
+    TestFile file(TEST_DIRS[dirIndex], !isWrite);
+    if (file.GetFd() < 0) {
+        state.SkipWithError("test directory is not writable");
+        return;
+    }
+    std::vector<std::vector<uint8_t>> buffs(batch, std::vector<uint8_t>(CHUNK_SIZE, 'b'));
+    DlpIoRequest reqs[MAX_BATCH];
+    for (auto _ : state) {
+        for (uint32_t chunk = 0; chunk < CHUNK_NUM; chunk += batch) {
+            for (uint32_t i = 0; i < batch; i++) {
+                reqs[i] = { file.GetFd(), buffs[i].data(), CHUNK_SIZE,
+                    static_cast<uint64_t>(chunk + i) * CHUNK_SIZE, 0 };
+            }
+            if (!io.Submit(reqs, batch, isWrite)) {
+                state.SkipWithError("submit failed");
+                return;
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(CHUNK_NUM) * CHUNK_SIZE);
+    state.SetLabel(io.GetName());
+}
+
+static void BM_PosixSequentialRead(benchmark::State& state)
+{
+    DlpPosixIoBackend io;
+    RunSequential(state, io, false);
+}
+
+static void BM_PosixSequentialWrite(benchmark::State& state)
+{
+    DlpPosixIoBackend io;
+    RunSequential(state, io, true);
+}
+
+#ifdef DLP_PARSE_IO_URING
+static void RunUring(benchmark::State& state, bool isWrite)
+{
+    DlpUringIoBackend io;
+    if (!io.IsReady()) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+    RunSequential(state, io, isWrite);
+}
+
+static void BM_UringSequentialRead(benchmark::State& state)
+{
+    RunUring(state, false);
+}
+
+static void BM_UringSequentialWrite(benchmark::State& state)
+{
+    RunUring(state, true);
+}
+#endif
+}  // namespace
+
+// io_uring completes part of the work on kernel workers, so the rates are taken from the wall clock.
+#define DLP_IO_ARGS Args({ TMPFS_DIR, 1 })->Args({ TMPFS_DIR, MAX_BATCH })->Args({ DATA_DIR, 1 }) \
+    ->Args({ DATA_DIR, MAX_BATCH })->UseRealTime()->Unit(benchmark::kMillisecond)
+
+BENCHMARK(BM_PosixSequentialRead)->DLP_IO_ARGS;
+BENCHMARK(BM_PosixSequentialWrite)->DLP_IO_ARGS;
+#ifdef DLP_PARSE_IO_URING
+BENCHMARK(BM_UringSequentialRead)->DLP_IO_ARGS;
+BENCHMARK(BM_UringSequentialWrite)->DLP_IO_ARGS;
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "dlp_permission.h"
+#define private public
+#include "dlp_raw_file.h"
+#undef private
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t KEY_SIZE = 16;
+static constexpr uint32_t HMAC_KEY_SIZE = 32;
+static constexpr uint32_t CERT_SIZE = 16;
+static constexpr uint32_t CONTENT_SIZE = 64 * 1024 * 1024;
+static constexpr uint32_t SEQUENTIAL_READ_SIZE = 128 * 1024;
+static constexpr uint32_t RANDOM_READ_SIZE = 4 * 1024;
+static constexpr uint32_t RANDOM_READ_NUM = 4096;
+static constexpr int64_t FD_READ = 0;
+static constexpr int64_t MAPPED_READ = 1;
+static const std::string PLAIN_PATH = "/data/local/tmp/dlp_mapped_benchmark.txt";
+static const std::string DLP_PATH = "/data/local/tmp/dlp_mapped_benchmark.txt.dlp";
+
+static void InitCipher(DlpRawFile& file)
+{
+    uint8_t keyData[KEY_SIZE] = {};
+    uint8_t ivData[IV_SIZE] = {};
+    uint8_t hmacKeyData[HMAC_KEY_SIZE] = {};
+    struct DlpBlob key = { .size = KEY_SIZE, .data = keyData };
+    struct DlpCipherParam param;
+    param.iv = { .size = IV_SIZE, .data = ivData };
+    struct DlpUsageSpec spec = { .mode = DLP_MODE_CTR, .algParam = &param };
+    struct DlpBlob hmacKey = { .size = HMAC_KEY_SIZE, .data = hmacKeyData };
+    (void)file.SetCipher(key, spec, hmacKey);
+}
+
+// A dlp file of CONTENT_SIZE bytes, generated once for all the runs.
+static int32_t GetDlpFd()
+{
+    static int32_t dlpFd = -1;
+    if (dlpFd >= 0) {
+        return dlpFd;
+    }
+    int32_t plainFd = open(PLAIN_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    int32_t fd = open(DLP_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    std::vector<uint8_t> plain(CONTENT_SIZE, 'a');
+    uint8_t certData[CERT_SIZE] = {};
+    struct DlpBlob cert = { .size = CERT_SIZE, .data = certData };
+    DlpRawFile file(fd, "txt");
+    InitCipher(file);
+    bool ready = plainFd >= 0 && fd >= 0 && write(plainFd, plain.data(), CONTENT_SIZE) == CONTENT_SIZE &&
+        file.SetEncryptCert(cert) == DLP_OK && file.SetContactAccount("benchmarkAccount") == DLP_OK &&
+        file.GenFile(plainFd) == DLP_OK;
+    close(plainFd);
+    unlink(PLAIN_PATH.c_str());
+    if (!ready) {
+        close(fd);
+        unlink(DLP_PATH.c_str());
+        return -1;
+    }
+    dlpFd = fd;
+    return dlpFd;
+}
+
+// Reads size bytes at each of offsets per iteration, through the fd or the content mapping as range(0) says.
+static void RunReads(benchmark::State& state, const std::vector<uint64_t>& offsets, uint32_t size)
+{
+    int32_t dlpFd = GetDlpFd();
+    if (dlpFd < 0) {
+        state.SkipWithError("generate dlp file failed");
+        return;
+    }
+    DlpRawFile file(dlpFd, "txt");
+    InitCipher(file);
+    if (file.ProcessDlpFile() != DLP_OK) {
+        state.SkipWithError("open dlp file failed");
+        return;
+    }
+    file.authPerm_ = DLPFileAccess::READ_ONLY;
+    if (state.range(0) == MAPPED_READ && file.EnableMappedRead() != DLP_OK) {
+        state.SkipWithError("map dlp file failed");
+        return;
+    }
+    std::vector<uint8_t> buf(size);
+    bool hasRead = true;
+    for (auto _ : state) {
+        for (uint64_t offset : offsets) {
+            if (file.DlpFileRead(offset, buf.data(), size, hasRead, 0) != static_cast<int32_t>(size)) {
+                state.SkipWithError("read failed");
+                return;
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(offsets.size()) * size);
+    state.SetLabel(state.range(0) == MAPPED_READ ? "mapped" : "fd");
+}
+
+// A player or reader streaming the whole file in FUSE sized reads.
+static void BM_SequentialRead(benchmark::State& state)
+{
+    std::vector<uint64_t> offsets;
+    for (uint64_t offset = 0; offset < CONTENT_SIZE; offset += SEQUENTIAL_READ_SIZE) {
+        offsets.push_back(offset);
+    }
+    RunReads(state, offsets, SEQUENTIAL_READ_SIZE);
+}
+
+// A viewer jumping between pages, unaligned like the records of a document.
+static void BM_RandomRead(benchmark::State& state)
+{
+    std::mt19937_64 engine(1);
+    std::uniform_int_distribution<uint64_t> dist(0, CONTENT_SIZE - RANDOM_READ_SIZE);
+    std::vector<uint64_t> offsets;
+    for (uint32_t i = 0; i < RANDOM_READ_NUM; i++) {
+        offsets.push_back(dist(engine));
+    }
+    RunReads(state, offsets, RANDOM_READ_SIZE);
+}
+}  // namespace
+
+BENCHMARK(BM_SequentialRead)->Arg(FD_READ)->Arg(MAPPED_READ)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RandomRead)->Arg(FD_READ)->Arg(MAPPED_READ)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
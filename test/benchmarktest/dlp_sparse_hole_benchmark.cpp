@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "dlp_permission.h"
+#define private public
+#include "dlp_raw_file.h"
+#undef private
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t KEY_SIZE = 16;
+static constexpr uint32_t HMAC_KEY_SIZE = 32;
+static constexpr uint32_t CERT_SIZE = 16;
+static constexpr uint32_t CHUNK_SIZE = 64 * 1024;
+static constexpr uint32_t REVERSE_CHUNK_NUM = 16;
+static const std::string PLAIN_PATH = "/data/local/tmp/dlp_sparse_benchmark.txt";
+static const std::string DLP_PATH = "/data/local/tmp/dlp_sparse_benchmark.txt.dlp";
+
+// Fills holes the way every hole was filled before the sparse map: encrypted zeros all the way.
+class DenseRawFile : public DlpRawFile {
+public:
+    using DlpRawFile::DlpRawFile;
+
+private:
+    int32_t FillHoleData(uint64_t holeStart, uint64_t holeSize) override
+    {
+        return DlpFile::FillHoleData(holeStart, holeSize);
+    }
+};
+
+// A writable raw dlp file holding one chunk of content, regenerated for every iteration.
+static bool PrepareFile(DlpRawFile& file, int32_t plainFd)
+{
+    uint8_t keyData[KEY_SIZE] = {};
+    uint8_t ivData[IV_SIZE] = {};
+    uint8_t hmacKeyData[HMAC_KEY_SIZE] = {};
+    uint8_t certData[CERT_SIZE] = {};
+    struct DlpBlob key = { .size = KEY_SIZE, .data = keyData };
+    struct DlpCipherParam param;
+    param.iv = { .size = IV_SIZE, .data = ivData };
+    struct DlpUsageSpec spec = { .mode = DLP_MODE_CTR, .algParam = &param };
+    struct DlpBlob hmacKey = { .size = HMAC_KEY_SIZE, .data = hmacKeyData };
+    struct DlpBlob cert = { .size = CERT_SIZE, .data = certData };
+    if (file.SetCipher(key, spec, hmacKey) != DLP_OK || file.SetEncryptCert(cert) != DLP_OK ||
+        file.SetContactAccount("benchmarkAccount") != DLP_OK || file.GenFile(plainFd) != DLP_OK) {
+        return false;
+    }
+    file.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    return true;
+}
+
+template<typename FileT>
+static void RunWrites(benchmark::State& state, const std::vector<uint64_t>& offsets)
+{
+    int32_t plainFd = open(PLAIN_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    int32_t dlpFd = open(DLP_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    std::vector<uint8_t> chunk(CHUNK_SIZE, 'a');
+    if (plainFd < 0 || dlpFd < 0 || write(plainFd, chunk.data(), CHUNK_SIZE) != CHUNK_SIZE) {
+        state.SkipWithError("test directory is not writable");
+        close(plainFd);
+        close(dlpFd);
+        return;
+    }
+    uint64_t written = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        FileT file(dlpFd, "txt");
+        bool prepared = PrepareFile(file, plainFd);
+        state.ResumeTiming();
+        if (!prepared) {
+            state.SkipWithError("generate dlp file failed");
+            break;
+        }
+        for (uint64_t offset : offsets) {
+            if (file.DlpFileWrite(offset, chunk.data(), CHUNK_SIZE) != static_cast<int32_t>(CHUNK_SIZE)) {
+                state.SkipWithError("write failed");
+                break;
+            }
+            written += CHUNK_SIZE;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(written));
+    close(plainFd);
+    close(dlpFd);
+    unlink(PLAIN_PATH.c_str());
+    unlink(DLP_PATH.c_str());
+}
+
+// One chunk written range(0) bytes past the end, like a preallocating app or a muxer seeking ahead.
+template<typename FileT>
+static void BM_WritePastEnd(benchmark::State& state)
+{
+    RunWrites<FileT>(state, { CHUNK_SIZE + static_cast<uint64_t>(state.range(0)) });
+}
+
+// Chunks written from the last to the first, the first write leaves the largest hole.
+template<typename FileT>
+static void BM_ReverseWrite(benchmark::State& state)
+{
+    std::vector<uint64_t> offsets;
+    for (uint32_t i = REVERSE_CHUNK_NUM; i > 0; i--) {
+        offsets.push_back(static_cast<uint64_t>(i) * CHUNK_SIZE);
+    }
+    RunWrites<FileT>(state, offsets);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_WritePastEnd, DenseRawFile)->Arg(1 << 20)->Arg(8 << 20)->Arg(48 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_WritePastEnd, DlpRawFile)->Arg(1 << 20)->Arg(8 << 20)->Arg(48 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ReverseWrite, DenseRawFile)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ReverseWrite, DlpRawFile)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
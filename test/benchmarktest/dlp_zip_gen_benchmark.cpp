@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "dlp_permission.h"
+#include "dlp_permission_public_interface.h"
+#define private public
+#include "dlp_zip_file.h"
+#undef private
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr uint32_t KEY_SIZE = 16;
+static constexpr uint32_t HMAC_KEY_SIZE = 32;
+static constexpr uint32_t CERT_SIZE = 16;
+static constexpr uint32_t WRITE_SIZE = 4096;
+static const std::string WORK_DIR = "/data/local/tmp/dlp_zip_benchmark";
+static const std::string PLAIN_PATH = "/data/local/tmp/dlp_zip_benchmark.txt";
+static const std::string DLP_PATH = "/data/local/tmp/dlp_zip_benchmark.txt.dlp";
+
+// A zip dlp file in a fresh work dir, the file removes the dir again when it is destroyed.
+static std::unique_ptr<DlpZipFile> PrepareFile(int32_t dlpFd)
+{
+    (void)mkdir(WORK_DIR.c_str(), S_IRWXU);
+    auto file = std::make_unique<DlpZipFile>(dlpFd, WORK_DIR, 0, "txt");
+    uint8_t keyData[KEY_SIZE] = {};
+    uint8_t ivData[IV_SIZE] = {};
+    uint8_t hmacKeyData[HMAC_KEY_SIZE] = {};
+    uint8_t certData[CERT_SIZE] = {};
+    struct DlpBlob key = { .size = KEY_SIZE, .data = keyData };
+    struct DlpCipherParam param;
+    param.iv = { .size = IV_SIZE, .data = ivData };
+    struct DlpUsageSpec spec = { .mode = DLP_MODE_CTR, .algParam = &param };
+    struct DlpBlob hmacKey = { .size = HMAC_KEY_SIZE, .data = hmacKeyData };
+    struct DlpBlob cert = { .size = CERT_SIZE, .data = certData };
+    if (file->SetCipher(key, spec, hmacKey) != DLP_OK || file->SetEncryptCert(cert) != DLP_OK ||
+        file->SetContactAccount("benchmarkAccount") != DLP_OK) {
+        return nullptr;
+    }
+    file->version_ = CURRENT_VERSION;
+    return file;
+}
+
+struct BenchFds {
+    int32_t plainFd;
+    int32_t dlpFd;
+};
+
+static bool OpenFds(benchmark::State& state, uint64_t plainSize, BenchFds& fds)
+{
+    fds.plainFd = open(PLAIN_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    fds.dlpFd = open(DLP_PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    std::vector<uint8_t> chunk(DLP_BUFF_LEN, 'a');
+    bool ok = fds.plainFd >= 0 && fds.dlpFd >= 0;
+    for (uint64_t written = 0; ok && written < plainSize; written += DLP_BUFF_LEN) {
+        ok = write(fds.plainFd, chunk.data(), DLP_BUFF_LEN) == static_cast<ssize_t>(DLP_BUFF_LEN);
+    }
+    if (!ok) {
+        state.SkipWithError("test directory is not writable");
+    }
+    return ok;
+}
+
+static void CloseFds(BenchFds& fds)
+{
+    close(fds.plainFd);
+    close(fds.dlpFd);
+    unlink(PLAIN_PATH.c_str());
+    unlink(DLP_PATH.c_str());
+}
+
+// Generates a zip dlp file from range(0) bytes of plaintext.
+static void BM_GenZipFile(benchmark::State& state)
+{
+    uint64_t plainSize = static_cast<uint64_t>(state.range(0));
+    BenchFds fds;
+    if (!OpenFds(state, plainSize, fds)) {
+        CloseFds(fds);
+        return;
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto file = PrepareFile(fds.dlpFd);
+        state.ResumeTiming();
+        if (file == nullptr || file->GenFile(fds.plainFd) != DLP_OK) {
+            state.SkipWithError("generate dlp file failed");
+            break;
+        }
+        state.PauseTiming();
+        file.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * plainSize));
+    CloseFds(fds);
+}
+
+// One small write to an opened zip dlp file of range(0) bytes, which regenerates the archive.
+static void BM_RewriteZipFile(benchmark::State& state)
+{
+    uint64_t plainSize = static_cast<uint64_t>(state.range(0));
+    BenchFds fds;
+    if (!OpenFds(state, plainSize, fds)) {
+        CloseFds(fds);
+        return;
+    }
+    auto file = PrepareFile(fds.dlpFd);
+    if (file == nullptr || file->GenFile(fds.plainFd) != DLP_OK) {
+        state.SkipWithError("generate dlp file failed");
+        CloseFds(fds);
+        return;
+    }
+    file->authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    std::vector<uint8_t> buf(WRITE_SIZE, 'b');
+    for (auto _ : state) {
+        if (file->DlpFileWrite(0, buf.data(), WRITE_SIZE) != static_cast<int32_t>(WRITE_SIZE)) {
+            state.SkipWithError("write failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * plainSize));
+    file.reset();
+    CloseFds(fds);
+}
+}  // namespace
+
+BENCHMARK(BM_GenZipFile)->Arg(1 << 20)->Arg(16 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RewriteZipFile)->Arg(1 << 20)->Arg(16 << 20)->Arg(64 << 20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
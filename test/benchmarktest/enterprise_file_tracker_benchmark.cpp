@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "enterprise_file_tracker.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr int32_t OPENED_FILE_NUM = 10000;
+static constexpr int32_t FILES_PER_SANDBOX = 4;
+static constexpr int32_t SANDBOX_UID_BASE = 20010000;
+static const std::vector<std::string> LEVELS = { "Public", "Internal", "Confidential", "Secret" };
+static const std::string APP_IDENTIFIER = "com.example.mdm";
+
+static std::string MakeUri(int32_t index)
+{
+    return "file://docs/data/storage/el2/base/" + std::to_string(index) + ".docx.dlp";
+}
+
+static EnterpriseInfo MakeInfo(int32_t index)
+{
+    EnterpriseInfo info;
+    info.classificationLabel = LEVELS[index % LEVELS.size()];
+    info.fileId = "file" + std::to_string(index);
+    info.appIdentifier = APP_IDENTIFIER;
+    // Neighbouring files of one level share a sandbox.
+    info.uid = SANDBOX_UID_BASE + index / (FILES_PER_SANDBOX * static_cast<int32_t>(LEVELS.size())) *
+        static_cast<int32_t>(LEVELS.size()) + index % static_cast<int32_t>(LEVELS.size());
+    return info;
+}
+
+static void FillLegacy(std::unordered_map<std::string, EnterpriseInfo>& uriMap)
+{
+    uriMap.clear();
+    for (int32_t i = 0; i < OPENED_FILE_NUM; i++) {
+        uriMap[MakeUri(i)] = MakeInfo(i);
+    }
+}
+
+static void FillTracker(EnterpriseFileTracker& tracker)
+{
+    tracker.SetLevels(LEVELS);
+    for (int32_t i = 0; i < OPENED_FILE_NUM; i++) {
+        tracker.Put(MakeUri(i), MakeInfo(i));
+    }
+}
+
+// GetSandboxInfosByClassificationLabel before the tracker: every opened uri is visited.
+static void BM_LegacyQueryOpened(benchmark::State& state)
+{
+    static std::unordered_map<std::string, EnterpriseInfo> uriMap;
+    static std::once_flag flag;
+    std::call_once(flag, [] { FillLegacy(uriMap); });
+    for (auto _ : state) {
+        std::vector<std::string> uris;
+        for (const auto& entry : uriMap) {
+            if (entry.second.classificationLabel == "Secret" && entry.second.appIdentifier == APP_IDENTIFIER &&
+                entry.second.uid >= 0) {
+                uris.emplace_back(entry.first);
+            }
+        }
+        benchmark::DoNotOptimize(uris);
+    }
+}
+
+static void BM_TrackerQueryOpened(benchmark::State& state)
+{
+    static EnterpriseFileTracker tracker;
+    static std::once_flag flag;
+    std::call_once(flag, [] { FillTracker(tracker); });
+    for (auto _ : state) {
+        std::vector<std::string> uris;
+        tracker.QueryOpenedUris("Secret", APP_IDENTIFIER, uris);
+        benchmark::DoNotOptimize(uris);
+    }
+}
+
+/*
+ * CloseOpenedEnterpriseDlpFiles before the tracker: the sandboxes of the label are collected, then every uri is
+ * compared against every closed sandbox.
+ */
+static void BM_LegacyRevoke(benchmark::State& state)
+{
+    std::unordered_map<std::string, EnterpriseInfo> uriMap;
+    for (auto _ : state) {
+        state.PauseTiming();
+        FillLegacy(uriMap);
+        state.ResumeTiming();
+        std::vector<int32_t> closedUids;
+        for (const auto& entry : uriMap) {
+            if (entry.second.classificationLabel == "Secret" && entry.second.appIdentifier == APP_IDENTIFIER) {
+                closedUids.emplace_back(entry.second.uid);
+            }
+        }
+        for (auto iter = uriMap.begin(); iter != uriMap.end();) {
+            bool needErase = false;
+            for (int32_t uid : closedUids) {
+                if (iter->second.uid == uid) {
+                    needErase = true;
+                    break;
+                }
+            }
+            iter = needErase ? uriMap.erase(iter) : std::next(iter);
+        }
+        benchmark::DoNotOptimize(uriMap);
+    }
+}
+
+static void BM_TrackerRevoke(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tracker = std::make_unique<EnterpriseFileTracker>();
+        FillTracker(*tracker);
+        state.ResumeTiming();
+        std::vector<EnterpriseOpenFile> closed = tracker->Revoke("Secret", APP_IDENTIFIER);
+        benchmark::DoNotOptimize(closed);
+        state.PauseTiming();
+        tracker = nullptr;
+        state.ResumeTiming();
+    }
+}
+
+static void BM_TrackerRevokeAtOrAbove(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tracker = std::make_unique<EnterpriseFileTracker>();
+        FillTracker(*tracker);
+        state.ResumeTiming();
+        std::vector<EnterpriseOpenFile> closed = tracker->Revoke("Confidential", APP_IDENTIFIER, true);
+        benchmark::DoNotOptimize(closed);
+        state.PauseTiming();
+        tracker = nullptr;
+        state.ResumeTiming();
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_LegacyQueryOpened);
+BENCHMARK(BM_TrackerQueryOpened);
+BENCHMARK(BM_LegacyRevoke)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackerRevoke)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TrackerRevokeAtOrAbove)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <vector>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include "alg_common_type.h"
+#include "dlp_permission.h"
+#include "huks_adapt_manager.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static const uint32_t MAIN_OS_ACCOUNT_ID = 100;
+static const uint32_t IOV_COUNT = 16;
+static const uint32_t SOFT_KEY_SIZE = 32;
+static const char *const BENCH_KEY_ALIAS = "DLP_HMAC_BENCHMARK_KEY";
+
+static AlgKeyInfo GetKeyInfo()
+{
+    BlobData alias = { strlen(BENCH_KEY_ALIAS),
+        const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(BENCH_KEY_ALIAS)) };
+    AlgKeyInfo keyInfo = { .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = MAIN_OS_ACCOUNT_ID, .keyAlias = alias };
+    if (!IsHuksMgrKeyExist(&keyInfo)) {
+        (void)HuksGenerateMacKey(&keyInfo);
+    }
+    return keyInfo;
+}
+
+// One contiguous buffer, one HuksGenerateHmac call per iteration.
+static void BM_HuksHmacContiguous(benchmark::State& state)
+{
+    AlgKeyInfo keyInfo = GetKeyInfo();
+    std::vector<uint8_t> data(state.range(0), 'a');
+    BlobData blob = { static_cast<uint32_t>(data.size()), data.data() };
+    for (auto _ : state) {
+        BlobData out = { 0, nullptr };
+        if (HuksGenerateHmac(&keyInfo, &blob, &out) != DLP_OK) {
+            state.SkipWithError("HuksGenerateHmac failed");
+            break;
+        }
+        FreeBlobData(&out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// The same bytes split over IOV_COUNT buffers and absorbed by one session.
+static void BM_HuksHmacIov(benchmark::State& state)
+{
+    AlgKeyInfo keyInfo = GetKeyInfo();
+    std::vector<uint8_t> data(state.range(0), 'a');
+    uint32_t partSize = data.size() / IOV_COUNT;
+    std::vector<BlobData> blobs;
+    for (uint32_t i = 0; i < IOV_COUNT; i++) {
+        uint32_t size = (i == IOV_COUNT - 1) ? data.size() - partSize * i : partSize;
+        blobs.push_back({ size, data.data() + partSize * i });
+    }
+    for (auto _ : state) {
+        BlobData out = { 0, nullptr };
+        HuksHmacSession session(&keyInfo);
+        int32_t ret = session.Init();
+        for (uint32_t i = 0; i < blobs.size() && ret == DLP_OK; i++) {
+            ret = session.Update(&blobs[i]);
+        }
+        if (ret != DLP_OK || session.Finish(&out) != DLP_OK) {
+            state.SkipWithError("HuksHmacSession failed");
+            break;
+        }
+        FreeBlobData(&out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// In-process HMAC-SHA256 with a plain key: the floor that the HUKS round trips are measured against.
+static void BM_SoftwareHmac(benchmark::State& state)
+{
+    uint8_t key[SOFT_KEY_SIZE] = { 0 };
+    std::vector<uint8_t> data(state.range(0), 'a');
+    uint8_t out[EVP_MAX_MD_SIZE] = { 0 };
+    unsigned int outLen = 0;
+    for (auto _ : state) {
+        HMAC(EVP_sha256(), key, SOFT_KEY_SIZE, data.data(), data.size(), out, &outLen);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_HuksHmacContiguous)->Arg(1024)->Arg(4096)->Arg(MAX_DATABASE_FILE_SIZE);
+BENCHMARK(BM_HuksHmacIov)->Arg(1024)->Arg(4096)->Arg(MAX_DATABASE_FILE_SIZE);
+BENCHMARK(BM_SoftwareHmac)->Arg(1024)->Arg(4096)->Arg(MAX_DATABASE_FILE_SIZE);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <unistd.h>
+#include "critical_handler.h"
+#include "critical_helper.h"
+#include "mem_mgr_client.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr int32_t SA_ID_DLP_PERMISSION_SERVICE = 3521;
+static uint32_t g_legacyCount = 0;
+static std::mutex g_legacyMutex;
+
+// The previous per-call path: a mutex on both edges and a MemMgr round trip on every 0->1 and 1->0 edge.
+static void LegacyIncrease()
+{
+    std::lock_guard<std::mutex> lock(g_legacyMutex);
+    if (g_legacyCount == 0) {
+        OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), true, SA_ID_DLP_PERMISSION_SERVICE);
+    }
+    g_legacyCount++;
+}
+
+static void LegacyDecrease()
+{
+    std::lock_guard<std::mutex> lock(g_legacyMutex);
+    g_legacyCount = g_legacyCount > 0 ? g_legacyCount - 1 : g_legacyCount;
+    if (g_legacyCount == 0) {
+        OHOS::Memory::MemMgrClient::GetInstance().SetCritical(getpid(), false, SA_ID_DLP_PERMISSION_SERVICE);
+    }
+}
+
+// Isolated calls, as a lightly loaded SA sees them.
+static void BM_LegacyCriticalPerCall(benchmark::State& state)
+{
+    for (auto _ : state) {
+        LegacyIncrease();
+        LegacyDecrease();
+    }
+}
+
+// The same calls through CriticalHelper: after the first call the state stays critical until the idle check.
+static void BM_CriticalHelperPerCall(benchmark::State& state)
+{
+    for (auto _ : state) {
+        CriticalHelper criticalHelper("benchmark");
+        benchmark::DoNotOptimize(&criticalHelper);
+    }
+    ReleaseCriticalIfIdle(0);
+}
+
+// Concurrent callers contending on the tracker.
+static void BM_CriticalHelperThreads(benchmark::State& state)
+{
+    for (auto _ : state) {
+        CriticalHelper criticalHelper("benchmark");
+        benchmark::DoNotOptimize(&criticalHelper);
+    }
+    if (state.thread_index() == 0) {
+        ReleaseCriticalIfIdle(0);
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_LegacyCriticalPerCall);
+BENCHMARK(BM_CriticalHelperPerCall);
+BENCHMARK(BM_CriticalHelperThreads)->Threads(1)->Threads(4)->Threads(8);
+
+BENCHMARK_MAIN();
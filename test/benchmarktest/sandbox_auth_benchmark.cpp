@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "rcu_snapshot.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr int32_t SANDBOX_NUM = 64;
+static constexpr int32_t SANDBOX_UID_BASE = 20010000;
+static constexpr int32_t READ_ONLY = 1;
+
+struct LegacyTables {
+    std::mutex sandboxInfoLock;
+    std::map<int32_t, int32_t> sandboxInfo;
+    std::shared_mutex dataMutex;
+    std::map<int, int32_t> data;
+};
+
+struct SnapshotTables {
+    RcuSnapshot<std::unordered_set<int32_t>> sandboxUids;
+    RcuSnapshot<std::unordered_map<int, int32_t>> data;
+};
+
+static LegacyTables& GetLegacyTables()
+{
+    static LegacyTables tables;
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        for (int32_t i = 0; i < SANDBOX_NUM; i++) {
+            tables.sandboxInfo[SANDBOX_UID_BASE + i] = i + 1;
+            tables.data[SANDBOX_UID_BASE + i] = READ_ONLY;
+        }
+    });
+    return tables;
+}
+
+static SnapshotTables& GetSnapshotTables()
+{
+    static SnapshotTables tables;
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        for (int32_t i = 0; i < SANDBOX_NUM; i++) {
+            tables.sandboxUids.Update([i](std::unordered_set<int32_t>& uids) { uids.insert(SANDBOX_UID_BASE + i); });
+            tables.data.Update([i](std::unordered_map<int, int32_t>& data) { data[SANDBOX_UID_BASE + i] = READ_ONLY; });
+        }
+    });
+    return tables;
+}
+
+// The previous lookup: observer mutex for sandbox membership, then an exclusive lock on the access table.
+static void BM_LegacySandboxAuth(benchmark::State& state)
+{
+    auto& tables = GetLegacyTables();
+    int32_t uid = SANDBOX_UID_BASE + state.thread_index() % SANDBOX_NUM;
+    for (auto _ : state) {
+        bool isSandbox = false;
+        {
+            std::lock_guard<std::mutex> lock(tables.sandboxInfoLock);
+            auto iter = tables.sandboxInfo.find(uid);
+            isSandbox = iter != tables.sandboxInfo.end() && iter->second > 0;
+        }
+        std::unique_lock<std::shared_mutex> lock(tables.dataMutex);
+        auto it = tables.data.find(uid);
+        bool allow = !isSandbox || (it != tables.data.end() && it->second != READ_ONLY);
+        benchmark::DoNotOptimize(allow);
+    }
+}
+
+// The snapshot lookup used by GetSandboxExternalAuthorization.
+static void BM_SnapshotSandboxAuth(benchmark::State& state)
+{
+    auto& tables = GetSnapshotTables();
+    int32_t uid = SANDBOX_UID_BASE + state.thread_index() % SANDBOX_NUM;
+    for (auto _ : state) {
+        bool isSandbox = tables.sandboxUids.Read(
+            [uid](const std::unordered_set<int32_t>& uids) { return uids.count(uid) > 0; });
+        bool allow = !isSandbox || tables.data.Read([uid](const std::unordered_map<int, int32_t>& data) {
+            auto it = data.find(uid);
+            return it != data.end() && it->second != READ_ONLY;
+        });
+        benchmark::DoNotOptimize(allow);
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_LegacySandboxAuth)->Threads(1)->Threads(4)->Threads(8)->Threads(16);
+BENCHMARK(BM_SnapshotSandboxAuth)->Threads(1)->Threads(4)->Threads(8)->Threads(16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "sandbox_registry.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static constexpr int32_t SANDBOX_NUM = 256;
+static constexpr int32_t USER_NUM = 4;
+static constexpr int32_t SANDBOX_UID_BASE = 20010000;
+static constexpr int32_t APP_UID_BASE = 20020000;
+static constexpr int32_t APP_UID_NUM = 5000;
+static constexpr int32_t LISTENER_PID_BASE = 3000;
+static constexpr int32_t LISTENER_NUM = 8;
+static constexpr size_t STORM_SIZE = 1 << 16;
+static constexpr uint32_t SANDBOX_DEATH_PERMILLE = 5;
+static constexpr uint32_t PERMILLE = 1000;
+static constexpr int32_t PID_RANGE = 60000;
+
+struct ProcessDeath {
+    int32_t uid;
+    int32_t pid;
+};
+
+static DlpSandboxInfo MakeSandbox(int32_t index)
+{
+    DlpSandboxInfo appInfo;
+    appInfo.uid = SANDBOX_UID_BASE + index;
+    appInfo.userId = 100 + index % USER_NUM;
+    appInfo.appIndex = index + 1;
+    appInfo.tokenId = static_cast<uint32_t>(0x28000000 + index);
+    appInfo.bundleName = "com.example.app" + std::to_string(index % 16);
+    appInfo.uri = "file://docs/data/storage/el2/base/" + std::to_string(index) + ".docx.dlp";
+    appInfo.dlpFileAccess = (index % 2 == 0) ? DLPFileAccess::READ_ONLY : DLPFileAccess::CONTENT_EDIT;
+    return appInfo;
+}
+
+// The previous layout: one map per table, each behind its own mutex, scanned for anything not keyed by uid.
+struct LegacyObserver {
+    std::mutex callbackListLock;
+    std::map<int32_t, int32_t> callbackList;
+    std::mutex sandboxInfoLock;
+    std::unordered_map<int32_t, DlpSandboxInfo> sandboxInfo;
+};
+
+struct Fixture {
+    LegacyObserver legacy;
+    SandboxRegistry registry;
+    IdFilter callbackPidFilter;
+    std::vector<ProcessDeath> storm;
+};
+
+static Fixture& GetFixture()
+{
+    static Fixture fixture;
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        for (int32_t i = 0; i < SANDBOX_NUM; i++) {
+            DlpSandboxInfo appInfo = MakeSandbox(i);
+            fixture.legacy.sandboxInfo[appInfo.uid] = appInfo;
+            fixture.registry.Add(appInfo);
+        }
+        for (int32_t i = 0; i < LISTENER_NUM; i++) {
+            fixture.legacy.callbackList[LISTENER_PID_BASE + i] = 1;
+            fixture.callbackPidFilter.Add(LISTENER_PID_BASE + i);
+        }
+        // A device-wide storm: nearly all deaths are ordinary apps and services, a few are sandboxes.
+        std::mt19937 rng(0);
+        fixture.storm.reserve(STORM_SIZE);
+        for (size_t i = 0; i < STORM_SIZE; i++) {
+            bool isSandbox = rng() % PERMILLE < SANDBOX_DEATH_PERMILLE;
+            int32_t uid = isSandbox ? SANDBOX_UID_BASE + static_cast<int32_t>(rng() % SANDBOX_NUM) :
+                APP_UID_BASE + static_cast<int32_t>(rng() % APP_UID_NUM);
+            fixture.storm.push_back({ uid, static_cast<int32_t>(rng() % PID_RANGE) });
+        }
+    });
+    return fixture;
+}
+
+// OnProcessDied before the registry: the listener map and the sandbox map are each locked for every death.
+static void BM_LegacyProcessDeathStorm(benchmark::State& state)
+{
+    auto& fixture = GetFixture();
+    size_t index = static_cast<size_t>(state.thread_index()) * (STORM_SIZE / 16);
+    for (auto _ : state) {
+        const ProcessDeath& death = fixture.storm[index++ % STORM_SIZE];
+        bool isListener = false;
+        {
+            std::lock_guard<std::mutex> lock(fixture.legacy.callbackListLock);
+            isListener = fixture.legacy.callbackList.count(death.pid) > 0;
+        }
+        DlpSandboxInfo appInfo;
+        bool isSandbox = false;
+        {
+            std::lock_guard<std::mutex> lock(fixture.legacy.sandboxInfoLock);
+            auto iter = fixture.legacy.sandboxInfo.find(death.uid);
+            if (iter != fixture.legacy.sandboxInfo.end()) {
+                appInfo = iter->second;
+                isSandbox = true;
+            }
+        }
+        benchmark::DoNotOptimize(isListener);
+        benchmark::DoNotOptimize(isSandbox);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// OnProcessDied with the registry: the pid and uid filters turn away unrelated deaths without any lock.
+static void BM_RegistryProcessDeathStorm(benchmark::State& state)
+{
+    auto& fixture = GetFixture();
+    size_t index = static_cast<size_t>(state.thread_index()) * (STORM_SIZE / 16);
+    for (auto _ : state) {
+        const ProcessDeath& death = fixture.storm[index++ % STORM_SIZE];
+        bool isListener = false;
+        if (fixture.callbackPidFilter.MayContain(death.pid)) {
+            std::lock_guard<std::mutex> lock(fixture.legacy.callbackListLock);
+            isListener = fixture.legacy.callbackList.count(death.pid) > 0;
+        }
+        DlpSandboxInfo appInfo;
+        bool isSandbox = fixture.registry.MayContain(death.uid) && fixture.registry.Get(death.uid, appInfo);
+        benchmark::DoNotOptimize(isListener);
+        benchmark::DoNotOptimize(isSandbox);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+}  // namespace
+
+BENCHMARK(BM_LegacyProcessDeathStorm)->Threads(1)->Threads(4)->Threads(8);
+BENCHMARK(BM_RegistryProcessDeathStorm)->Threads(1)->Threads(4)->Threads(8);
+
+BENCHMARK_MAIN();
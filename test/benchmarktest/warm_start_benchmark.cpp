@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "warm_start_snapshot.h"
+
+using namespace OHOS::Security::DlpPermission;
+
+namespace {
+static const std::string CONFIG_PATH = "/data/local/tmp/dlp_config_benchmark.json";
+static const std::string SNAPSHOT_PATH = "/data/local/tmp/dlp_warm_start_benchmark.snapshot";
+static constexpr int32_t SUPPORT_FILE_TYPE_NUM = 64;
+
+static void PrepareFiles()
+{
+    std::vector<std::string> types;
+    for (int32_t i = 0; i < SUPPORT_FILE_TYPE_NUM; i++) {
+        types.emplace_back(".type" + std::to_string(i));
+    }
+    nlohmann::json config;
+    config["support_file_type"] = types;
+    std::ofstream(CONFIG_PATH) << config.dump();
+    (void)WarmStartSnapshot::Save(SNAPSHOT_PATH, WarmStartSnapshot::GetSourceStamp({ CONFIG_PATH }), types);
+}
+
+// What the first GetDlpSupportFileType after a cold start did: read the config file and parse the JSON.
+static void BM_ColdConfigParse(benchmark::State& state)
+{
+    PrepareFiles();
+    for (auto _ : state) {
+        std::ifstream in(CONFIG_PATH);
+        std::stringstream content;
+        content << in.rdbuf();
+        auto jsonObj = nlohmann::json::parse(content.str(), nullptr, false);
+        std::vector<std::string> types = jsonObj["support_file_type"].get<std::vector<std::string>>();
+        benchmark::DoNotOptimize(types);
+    }
+}
+
+// The same state from the warm start snapshot: stat the config for the stamp and map the snapshot.
+static void BM_WarmSnapshotLoad(benchmark::State& state)
+{
+    PrepareFiles();
+    for (auto _ : state) {
+        std::vector<std::string> types;
+        bool ret = WarmStartSnapshot::Load(SNAPSHOT_PATH, WarmStartSnapshot::GetSourceStamp({ CONFIG_PATH }), types);
+        benchmark::DoNotOptimize(ret);
+        benchmark::DoNotOptimize(types);
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_ColdConfigParse);
+BENCHMARK(BM_WarmSnapshotLoad);
+
+BENCHMARK_MAIN();
@@ -110,18 +110,23 @@ static void CallCertParcel2(FuzzedDataProvider& fdp)
 
     data1.WriteBool(fdp.ConsumeBool());
     data1.WriteString(fdp.ConsumeBytesAsString(STRING_LENGTH));
+    data1.WriteBool(false);
     data1.WriteUInt8Vector(std::vector<uint8_t>{0, 1, 2});
     (void)parcel->Unmarshalling(data1);
 
     data1.WriteBool(fdp.ConsumeBool());
     data1.WriteString(fdp.ConsumeBytesAsString(STRING_LENGTH));
+    data1.WriteBool(false);
     data1.WriteUInt8Vector(std::vector<uint8_t>{0, 1, 2});
+    data1.WriteBool(false);
     data1.WriteUInt8Vector(std::vector<uint8_t>{0, 1, 2});
     (void)parcel->Unmarshalling(data1);
 
     data1.WriteBool(fdp.ConsumeBool());
     data1.WriteString(fdp.ConsumeBytesAsString(STRING_LENGTH));
+    data1.WriteBool(false);
     data1.WriteUInt8Vector(std::vector<uint8_t>{0, 1, 2});
+    data1.WriteBool(false);
     data1.WriteUInt8Vector(std::vector<uint8_t>{0, 1, 2});
     data1.WriteBool(fdp.ConsumeBool());
     (void)parcel->Unmarshalling(data1);
@@ -16,7 +16,9 @@
 #include <chrono>
 #include <gtest/gtest.h>
 #include <securec.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/types.h>
 #include <thread>
 
@@ -43,6 +45,7 @@ static const fuse_ino_t ROOT_INODE = 1;
 static const int DEFAULT_ATTR_TIMEOUT = 10000;
 static const uint32_t MAX_FUSE_READ_BUFF_SIZE = 10 * 1024 * 1024; // 10M
 static const uint32_t MAX_READ_DIR_BUF_SIZE = 100 * 1024;  // 100K
+static const unsigned long MAX_FILE_NAME_LEN = 256;
 
 static int g_fuseReplyErr = 0;
 static struct fuse_file_info g_fuseReplyOpen;
@@ -51,6 +54,7 @@ static struct stat g_fuseReplyAttr;
 static double g_fuseReplyAttrTimeout = 0.0F;
 static size_t g_fuseReplyBufSize = 0;
 static bool g_fuseReplyNoneCalled = false;
+static struct statvfs g_fuseReplyStatfs;
 static const std::string DLP_TEST_DIR = "/data/dlpTest/";
 static DlpLinkManager* dlpLinkManager = nullptr;
 constexpr int WAIT_SECOND = 1;
@@ -90,6 +94,33 @@ static void FuseReplyNoneMock(fuse_req_t req)
     g_fuseReplyNoneCalled = true;
 }
 
+static int FuseReplyStatfsMock(fuse_req_t req, const struct statvfs *stbuf)
+{
+    (void)req;
+    g_fuseReplyStatfs = *stbuf;
+    return 0;
+}
+
+static void OpenLinkFile(fuse_ino_t ino, struct fuse_file_info& fi)
+{
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_open", condition);
+    SetMockCallback("fuse_reply_open", reinterpret_cast<CommonMockFuncT>(FuseReplyOpenMock));
+    FuseDaemon::fuseDaemonOper_.open(nullptr, ino, &fi);
+    CleanMockConditions();
+}
+
+static void ReleaseLinkFile(fuse_ino_t ino, struct fuse_file_info& fi)
+{
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    FuseDaemon::fuseDaemonOper_.release(nullptr, ino, &fi);
+    CleanMockConditions();
+}
+
 static DlpLinkFile* AddLinkFileToManager(const std::string& name, const std::shared_ptr<DlpFile>& dlpFile)
 {
     if (dlpLinkManager == nullptr || dlpFile == nullptr) {
@@ -99,6 +130,13 @@ static DlpLinkFile* AddLinkFileToManager(const std::string& name, const std::sha
     if (node == nullptr) {
         return nullptr;
     }
+    fuse_ino_t ino = 0;
+    uint64_t generation = 0;
+    if (!dlpLinkManager->inodeTable_.Insert(node, ino, generation)) {
+        delete node;
+        return nullptr;
+    }
+    node->SetInode(ino, generation);
     Utils::UniqueWriteGuard<Utils::RWLock> infoGuard(dlpLinkManager->dlpLinkMapLock_);
     dlpLinkManager->dlpLinkFileNameMap_[name] = node;
     return node;
@@ -114,7 +152,7 @@ static void RemoveLinkFileFromManager(const std::string& name)
     if (iter != dlpLinkManager->dlpLinkFileNameMap_.end()) {
         DlpLinkFile* node = iter->second;
         dlpLinkManager->dlpLinkFileNameMap_.erase(iter);
-        delete node;
+        dlpLinkManager->inodeTable_.Erase(node->GetInode());
     }
 }
 
@@ -352,7 +390,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonOpen001, TestSize.Level0)
     ASSERT_NE(dlpFile, nullptr);
     DlpLinkFile* linkFile = AddLinkFileToManager("test_open", dlpFile);
     ASSERT_NE(linkFile, nullptr);
-    fuse_ino_t ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(linkFile));
+    fuse_ino_t ino = linkFile->GetInode();
     struct fuse_file_info fi;
     fi.flags = O_TRUNC;
 
@@ -371,7 +409,11 @@ HWTEST_F(FuseDaemonTest, FuseDaemonOpen001, TestSize.Level0)
     (void)memset_s(&g_fuseReplyOpen, sizeof(g_fuseReplyOpen), 0, sizeof(g_fuseReplyOpen));
     FuseDaemon::fuseDaemonOper_.open(req, ino, &fi);
     EXPECT_EQ(O_RDWR, g_fuseReplyOpen.flags);
+    EXPECT_NE(0, g_fuseReplyOpen.fh);
+    EXPECT_EQ(1, g_fuseReplyOpen.keep_cache);
     CleanMockConditions();
+    ReleaseLinkFile(ino, fi);
+    EXPECT_EQ(0, fi.fh);
     RemoveLinkFileFromManager("test_open");
 }
 
@@ -452,7 +494,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonRead002, TestSize.Level0)
     ASSERT_NE(dlpFile, nullptr);
     DlpLinkFile* linkfile = AddLinkFileToManager("test_read", dlpFile);
     ASSERT_NE(linkfile, nullptr);
-    fuse_ino_t ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(linkfile));
+    fuse_ino_t ino = linkfile->GetInode();
 
     condition.mockSequence = { true };
     SetMockConditions("fuse_reply_err", condition);
@@ -517,7 +559,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonWrite001, TestSize.Level0)
     ASSERT_NE(dlpFile, nullptr);
     DlpLinkFile* linkfile = AddLinkFileToManager("test_write", dlpFile);
     ASSERT_NE(linkfile, nullptr);
-    fuse_ino_t ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(linkfile));
+    fuse_ino_t ino = linkfile->GetInode();
 
     condition.mockSequence = { true };
     SetMockConditions("fuse_reply_err", condition);
@@ -559,6 +601,91 @@ HWTEST_F(FuseDaemonTest, FuseDaemonForget001, TestSize.Level0)
     CleanMockConditions();
 }
 
+/**
+ * @tc.name: FuseDaemonForget002
+ * @tc.desc: test a forgotten link file frees its inode and the next link file gets a new one
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonForget002, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonForget002");
+    fuse_req_t req = nullptr;
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpZipFile>(-1, DLP_TEST_DIR, 0, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    ASSERT_EQ(DLP_OK, dlpLinkManager->AddDlpLinkFile(dlpFile, "test_forget"));
+
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_entry", condition);
+    SetMockCallback("fuse_reply_entry", reinterpret_cast<CommonMockFuncT>(FuseReplyEntryMock));
+    (void)memset_s(&g_fuseReplyEntry, sizeof(g_fuseReplyEntry), 0, sizeof(g_fuseReplyEntry));
+    FuseDaemon::fuseDaemonOper_.lookup(req, ROOT_INODE, "test_forget");
+    CleanMockConditions();
+    fuse_ino_t ino = g_fuseReplyEntry.ino;
+    EXPECT_NE(ROOT_INODE, ino);
+    EXPECT_NE(0U, g_fuseReplyEntry.generation);
+    EXPECT_EQ(ino, static_cast<fuse_ino_t>(g_fuseReplyEntry.attr.st_ino));
+    EXPECT_NE(dlpLinkManager->LookUpDlpLinkFileByIno(ino), nullptr);
+    dlpLinkManager->UnpinDlpLinkFile(ino);
+
+    // deleted but still looked up by the kernel
+    EXPECT_EQ(DLP_OK, dlpLinkManager->DeleteDlpLinkFile(dlpFile));
+    EXPECT_EQ(dlpLinkManager->LookUpDlpLinkFileByIno(ino), nullptr);
+    EXPECT_NE(dlpLinkManager->inodeTable_.Find(ino), nullptr);
+
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_none", condition);
+    SetMockCallback("fuse_reply_none", reinterpret_cast<CommonMockFuncT>(FuseReplyNoneMock));
+    g_fuseReplyNoneCalled = false;
+    FuseDaemon::fuseDaemonOper_.forget(req, ino, 1);
+    EXPECT_TRUE(g_fuseReplyNoneCalled);
+    CleanMockConditions();
+    EXPECT_EQ(dlpLinkManager->inodeTable_.Find(ino), nullptr);
+
+    // the stale inode does not reach the file linked after it
+    ASSERT_EQ(DLP_OK, dlpLinkManager->AddDlpLinkFile(dlpFile, "test_forget_new"));
+    DlpLinkFile* node = dlpLinkManager->LookUpDlpLinkFile("test_forget_new");
+    ASSERT_NE(node, nullptr);
+    EXPECT_NE(ino, node->GetInode());
+    EXPECT_EQ(dlpLinkManager->LookUpDlpLinkFileByIno(ino), nullptr);
+    EXPECT_EQ(node, dlpLinkManager->LookUpDlpLinkFileByIno(node->GetInode()));
+    dlpLinkManager->UnpinDlpLinkFile(node->GetInode());
+    (void)node->SubAndCheckZeroRef(1);
+    EXPECT_EQ(DLP_OK, dlpLinkManager->DeleteDlpLinkFile(dlpFile));
+}
+
+/**
+ * @tc.name: FuseDaemonForget003
+ * @tc.desc: test deleting a pinned link file does not wait, the last unpin frees its inode
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonForget003, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonForget003");
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpZipFile>(-1, DLP_TEST_DIR, 0, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    ASSERT_EQ(DLP_OK, dlpLinkManager->AddDlpLinkFile(dlpFile, "test_pinned_delete"));
+    DlpLinkFile* node = dlpLinkManager->LookUpDlpLinkFile("test_pinned_delete");
+    ASSERT_NE(node, nullptr);
+    (void)node->SubAndCheckZeroRef(1);
+    fuse_ino_t ino = node->GetInode();
+    ASSERT_EQ(node, dlpLinkManager->LookUpDlpLinkFileByIno(ino));
+    EXPECT_EQ(node, dlpLinkManager->LookUpDlpLinkFileByIno(ino));
+    size_t freeSlots = dlpLinkManager->inodeTable_.freeSlots_.size();
+
+    // the requests pinning the file run on this thread, so the delete must not wait for them
+    EXPECT_EQ(DLP_OK, dlpLinkManager->DeleteDlpLinkFile(dlpFile));
+    EXPECT_EQ(dlpLinkManager->inodeTable_.Find(ino), nullptr);
+    EXPECT_EQ(dlpLinkManager->LookUpDlpLinkFileByIno(ino), nullptr);
+    EXPECT_EQ(freeSlots, dlpLinkManager->inodeTable_.freeSlots_.size());
+    dlpLinkManager->UnpinDlpLinkFile(ino);
+    EXPECT_EQ(freeSlots, dlpLinkManager->inodeTable_.freeSlots_.size());
+    dlpLinkManager->UnpinDlpLinkFile(ino);
+    EXPECT_EQ(freeSlots + 1, dlpLinkManager->inodeTable_.freeSlots_.size());
+}
+
 /**
  * @tc.name: FuseDaemonReadDir001
  * @tc.desc: test fuse read dir callback abnormal branch
@@ -805,7 +932,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonSetAttr001, TestSize.Level0)
     ASSERT_NE(dlpFile, nullptr);
     DlpLinkFile* linkfile = AddLinkFileToManager("test_setattr1", dlpFile);
     ASSERT_NE(linkfile, nullptr);
-    fuse_ino_t ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(linkfile));
+    fuse_ino_t ino = linkfile->GetInode();
 
     condition.mockSequence = { true };
     SetMockConditions("fuse_reply_err", condition);
@@ -836,7 +963,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonSetAttr002, TestSize.Level0)
     ASSERT_NE(dlpFile, nullptr);
     DlpLinkFile* linkfile = AddLinkFileToManager("test_setattr2", dlpFile);
     ASSERT_NE(linkfile, nullptr);
-    fuse_ino_t ino = static_cast<fuse_ino_t>(reinterpret_cast<uintptr_t>(linkfile));
+    fuse_ino_t ino = linkfile->GetInode();
     struct stat attr;
     g_fuseReplyErr = 0;
 
@@ -858,6 +985,248 @@ HWTEST_F(FuseDaemonTest, FuseDaemonSetAttr002, TestSize.Level0)
     RemoveLinkFileFromManager("test_setattr2");
 }
 
+/**
+ * @tc.name: FuseDaemonFlush001
+ * @tc.desc: test fuse flush and release callback
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonFlush001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonFlush001");
+    fuse_req_t req = nullptr;
+
+    // no file handle
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = -1;
+    FuseDaemon::fuseDaemonOper_.flush(req, ROOT_INODE, nullptr);
+    EXPECT_EQ(0, g_fuseReplyErr);
+    CleanMockConditions();
+
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpZipFile>(-1, DLP_TEST_DIR, 0, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    DlpLinkFile* linkFile = AddLinkFileToManager("test_flush", dlpFile);
+    ASSERT_NE(linkFile, nullptr);
+    fuse_ino_t ino = linkFile->GetInode();
+
+    // read only open, nothing to commit
+    struct fuse_file_info readFi;
+    (void)memset_s(&readFi, sizeof(readFi), 0, sizeof(readFi));
+    readFi.flags = O_RDONLY;
+    OpenLinkFile(ino, readFi);
+    ASSERT_NE(0, readFi.fh);
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = -1;
+    FuseDaemon::fuseDaemonOper_.flush(req, ino, &readFi);
+    EXPECT_EQ(0, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // writable opens share one writer count, the content is unchanged
+    struct fuse_file_info writeFi;
+    (void)memset_s(&writeFi, sizeof(writeFi), 0, sizeof(writeFi));
+    writeFi.flags = O_WRONLY;
+    OpenLinkFile(ino, writeFi);
+    struct fuse_file_info rdwrFi = writeFi;
+    rdwrFi.flags = O_RDWR;
+    OpenLinkFile(ino, rdwrFi);
+    EXPECT_EQ(2, linkFile->openWriters_);
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = -1;
+    FuseDaemon::fuseDaemonOper_.flush(req, ino, &writeFi);
+    EXPECT_EQ(0, g_fuseReplyErr);
+    CleanMockConditions();
+
+    ReleaseLinkFile(ino, readFi);
+    ReleaseLinkFile(ino, writeFi);
+    EXPECT_EQ(1, linkFile->openWriters_);
+    ReleaseLinkFile(ino, rdwrFi);
+    EXPECT_EQ(0, linkFile->openWriters_);
+
+    // a deleted link file counts no writers, later opens commit at once
+    EXPECT_EQ(DLP_OK, linkFile->FinishWriters());
+    OpenLinkFile(ino, writeFi);
+    EXPECT_EQ(0, linkFile->openWriters_);
+    ReleaseLinkFile(ino, writeFi);
+    RemoveLinkFileFromManager("test_flush");
+}
+
+/**
+ * @tc.name: FuseDaemonFsync001
+ * @tc.desc: test fuse fsync callback abnormal branch
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonFsync001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonFsync001");
+    fuse_req_t req = nullptr;
+
+    // ino ROOT_INODE
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fsync(req, ROOT_INODE, 0, nullptr);
+    EXPECT_EQ(ENOENT, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // can not sync dlp file
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpZipFile>(-1, DLP_TEST_DIR, 0, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    DlpLinkFile* linkFile = AddLinkFileToManager("test_fsync", dlpFile);
+    ASSERT_NE(linkFile, nullptr);
+    fuse_ino_t ino = linkFile->GetInode();
+
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fsync(req, ino, 1, nullptr);
+    EXPECT_EQ(EIO, g_fuseReplyErr);
+    CleanMockConditions();
+    RemoveLinkFileFromManager("test_fsync");
+}
+
+/**
+ * @tc.name: FuseDaemonStatfs001
+ * @tc.desc: test fuse statfs callback
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonStatfs001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonStatfs001");
+    fuse_req_t req = nullptr;
+
+    // root reports the content limit
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_statfs", condition);
+    SetMockCallback("fuse_reply_statfs", reinterpret_cast<CommonMockFuncT>(FuseReplyStatfsMock));
+    (void)memset_s(&g_fuseReplyStatfs, sizeof(g_fuseReplyStatfs), 0, sizeof(g_fuseReplyStatfs));
+    FuseDaemon::fuseDaemonOper_.statfs(req, ROOT_INODE);
+    EXPECT_EQ(FUSE_MAX_IO_SIZE, g_fuseReplyStatfs.f_bsize);
+    EXPECT_EQ(FUSE_MAX_IO_SIZE, g_fuseReplyStatfs.f_frsize);
+    EXPECT_EQ(DLP_MAX_CONTENT_SIZE / FUSE_MAX_IO_SIZE, g_fuseReplyStatfs.f_blocks);
+    EXPECT_EQ(MAX_FILE_NAME_LEN, g_fuseReplyStatfs.f_namemax);
+    CleanMockConditions();
+
+    // link file reports the file system of its dlp file
+    int fd = open("/data/fuse_statfs_test.dlp", O_CREAT | O_RDWR | O_TRUNC, S_IRWXU);
+    ASSERT_GE(fd, 0);
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpRawFile>(fd, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    DlpLinkFile* linkFile = AddLinkFileToManager("test_statfs", dlpFile);
+    ASSERT_NE(linkFile, nullptr);
+    struct statvfs fsStat;
+    ASSERT_EQ(0, fstatvfs(fd, &fsStat));
+
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_statfs", condition);
+    SetMockCallback("fuse_reply_statfs", reinterpret_cast<CommonMockFuncT>(FuseReplyStatfsMock));
+    (void)memset_s(&g_fuseReplyStatfs, sizeof(g_fuseReplyStatfs), 0, sizeof(g_fuseReplyStatfs));
+    FuseDaemon::fuseDaemonOper_.statfs(req, linkFile->GetInode());
+    EXPECT_EQ(fsStat.f_frsize, g_fuseReplyStatfs.f_frsize);
+    EXPECT_EQ(fsStat.f_blocks, g_fuseReplyStatfs.f_blocks);
+    EXPECT_EQ(FUSE_MAX_IO_SIZE, g_fuseReplyStatfs.f_bsize);
+    CleanMockConditions();
+    RemoveLinkFileFromManager("test_statfs");
+    close(fd);
+    unlink("/data/fuse_statfs_test.dlp");
+}
+
+/**
+ * @tc.name: FuseDaemonFallocate001
+ * @tc.desc: test fuse fallocate callback abnormal branch
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(FuseDaemonTest, FuseDaemonFallocate001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "FuseDaemonFallocate001");
+    fuse_req_t req = nullptr;
+
+    // punch hole is not supported
+    DlpCMockCondition condition;
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ROOT_INODE, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, 1,
+        nullptr);
+    EXPECT_EQ(EOPNOTSUPP, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // negative range
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ROOT_INODE, 0, -1, 1, nullptr);
+    EXPECT_EQ(EINVAL, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // range ends at the content size limit, the link file could not take it
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ROOT_INODE, 0, DLP_MAX_CONTENT_SIZE - 1, 1, nullptr);
+    EXPECT_EQ(EFBIG, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // range too large to be summed in off_t
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ROOT_INODE, 0, INT64_MAX, INT64_MAX, nullptr);
+    EXPECT_EQ(EFBIG, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // ino ROOT_INODE
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ROOT_INODE, 0, 0, 1, nullptr);
+    EXPECT_EQ(ENOENT, g_fuseReplyErr);
+    CleanMockConditions();
+
+    std::shared_ptr<DlpFile> dlpFile = std::make_shared<DlpZipFile>(-1, DLP_TEST_DIR, 0, "txt");
+    ASSERT_NE(dlpFile, nullptr);
+    DlpLinkFile* linkFile = AddLinkFileToManager("test_fallocate", dlpFile);
+    ASSERT_NE(linkFile, nullptr);
+    fuse_ino_t ino = linkFile->GetInode();
+
+    // keep size has nothing to reserve
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = -1;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ino, FALLOC_FL_KEEP_SIZE, 0, 1, nullptr);
+    EXPECT_EQ(0, g_fuseReplyErr);
+    CleanMockConditions();
+
+    // can not grow dlp file
+    condition.mockSequence = { true };
+    SetMockConditions("fuse_reply_err", condition);
+    SetMockCallback("fuse_reply_err", reinterpret_cast<CommonMockFuncT>(FuseReplyErrMock));
+    g_fuseReplyErr = 0;
+    FuseDaemon::fuseDaemonOper_.fallocate(req, ino, 0, 0, 1, nullptr);
+    EXPECT_EQ(EIO, g_fuseReplyErr);
+    CleanMockConditions();
+    RemoveLinkFileFromManager("test_fallocate");
+}
+
 /**
  * @tc.name: InitFuseFs001
  * @tc.desc: test fuse daemon init
@@ -973,6 +1342,7 @@ HWTEST_F(FuseDaemonTest, FuseDaemonInit001, TestSize.Level0)
     fuse_conn_info conn = { 0 };
     FuseDaemon::fuseDaemonOper_.init(nullptr, &conn);
     EXPECT_EQ(FUSE_CAP_WRITEBACK_CACHE, conn.want);
+    EXPECT_EQ(FUSE_MAX_IO_SIZE, conn.max_write);
 }
 
 /**
@@ -17,6 +17,7 @@
 #include <dlfcn.h>
 #include <fuse_lowlevel.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include "securec.h"
@@ -40,6 +41,9 @@ typedef int (*FuseReplyAttrT)(fuse_req_t req, const struct stat *attr, double at
 typedef int (*FuseReplyOpenT)(fuse_req_t req, const struct fuse_file_info *f);
 typedef int (*FuseReplyBufT)(fuse_req_t req, const char *buf, size_t size);
 typedef int (*FuseReplyWriteT)(fuse_req_t req, size_t count);
+typedef int (*FuseReplyStatfsT)(fuse_req_t req, const struct statvfs *stbuf);
+typedef int (*NotifyInvalInodeT)(struct fuse_session *se, fuse_ino_t ino, off_t off, off_t len);
+typedef int (*NotifyInvalEntryT)(struct fuse_session *se, fuse_ino_t parent, const char *name, size_t namelen);
 typedef void (*FuseReplyNoneT)(fuse_req_t req);
 typedef size_t (*FuseAddDirentryT)(fuse_req_t req, char *buf, size_t bufsize,
     const char *name, const struct stat *stbuf, off_t off);
@@ -245,6 +249,57 @@ int fuse_reply_write(fuse_req_t req, size_t count)
     return (*func)(req, count);
 }
 
+int fuse_reply_statfs(fuse_req_t req, const struct statvfs *stbuf)
+{
+    if (IsFuncNeedMock(__func__)) {
+        CommonMockFuncT rawFunc = GetMockFunc(__func__);
+        if (rawFunc != nullptr) {
+            return (*reinterpret_cast<FuseReplyStatfsT>(rawFunc))(req, stbuf);
+        }
+        return -1;
+    }
+
+    FuseReplyStatfsT func = reinterpret_cast<FuseReplyStatfsT>(GetLibfuseLibFunc(__func__));
+    if (func == nullptr) {
+        return -1;
+    }
+    return (*func)(req, stbuf);
+}
+
+int fuse_lowlevel_notify_inval_inode(struct fuse_session *se, fuse_ino_t ino, off_t off, off_t len)
+{
+    if (IsFuncNeedMock(__func__)) {
+        CommonMockFuncT rawFunc = GetMockFunc(__func__);
+        if (rawFunc != nullptr) {
+            return (*reinterpret_cast<NotifyInvalInodeT>(rawFunc))(se, ino, off, len);
+        }
+        return -1;
+    }
+
+    NotifyInvalInodeT func = reinterpret_cast<NotifyInvalInodeT>(GetLibfuseLibFunc(__func__));
+    if (func == nullptr) {
+        return -1;
+    }
+    return (*func)(se, ino, off, len);
+}
+
+int fuse_lowlevel_notify_inval_entry(struct fuse_session *se, fuse_ino_t parent, const char *name, size_t namelen)
+{
+    if (IsFuncNeedMock(__func__)) {
+        CommonMockFuncT rawFunc = GetMockFunc(__func__);
+        if (rawFunc != nullptr) {
+            return (*reinterpret_cast<NotifyInvalEntryT>(rawFunc))(se, parent, name, namelen);
+        }
+        return -1;
+    }
+
+    NotifyInvalEntryT func = reinterpret_cast<NotifyInvalEntryT>(GetLibfuseLibFunc(__func__));
+    if (func == nullptr) {
+        return -1;
+    }
+    return (*func)(se, parent, name, namelen);
+}
+
 void fuse_reply_none(fuse_req_t req)
 {
     if (IsFuncNeedMock(__func__)) {
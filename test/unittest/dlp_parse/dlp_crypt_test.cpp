@@ -806,6 +806,52 @@ HWTEST_F(DlpCryptTest, DlpHmacEncodeForRaw003, TestSize.Level0)
     unlink("/data/fuse_test.txt");
 }
 
+/**
+ * @tc.name: DlpHmacEncode001
+ * @tc.desc: test DlpHmacEncode covers the file from the current offset and leaves the offset at the end
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCryptTest, DlpHmacEncode001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "DlpHmacEncode001");
+
+    int fd = open("/data/fuse_test.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fd, -1);
+    uint8_t buffer[SIXTEEN] = {0x1, 0x2, 0x3};
+    ASSERT_EQ(write(fd, buffer, SIXTEEN), SIXTEEN);
+
+    uint8_t hmacKeyData[HMAC_SIZE] = {0x5};
+    struct DlpBlob key = {
+        .size = HMAC_SIZE,
+        .data = hmacKeyData,
+    };
+    uint8_t rawOut[HMAC_SIZE] = {0};
+    struct DlpBlob rawHmac = {
+        .size = HMAC_SIZE,
+        .data = rawOut,
+    };
+    lseek(fd, 1, SEEK_SET);
+    ASSERT_EQ(DLP_OK, DlpHmacEncodeForRaw(key, fd, SIXTEEN - 1, rawHmac));
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), SIXTEEN);
+
+    uint8_t fileOut[HMAC_SIZE] = {0};
+    struct DlpBlob fileHmac = {
+        .size = HMAC_SIZE,
+        .data = fileOut,
+    };
+    lseek(fd, 1, SEEK_SET);
+    ASSERT_EQ(DLP_OK, DlpHmacEncode(key, fd, fileHmac));
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), SIXTEEN);
+    EXPECT_EQ(0, memcmp(rawOut, fileOut, HMAC_SIZE));
+
+    lseek(fd, 0, SEEK_SET);
+    EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, DlpHmacEncodeForRaw(key, fd, SIXTEEN + 1, rawHmac));
+
+    close(fd);
+    unlink("/data/fuse_test.txt");
+}
+
 /**
  * @tc.name: DlpHIAECryptTest
  * @tc.desc: test DlpHIAECrypt
@@ -1017,3 +1063,52 @@ HWTEST_F(DlpCryptTest, DlpOpensslAesEncryptAndDecrypt009, TestSize.Level0)
     ret = DlpOpensslAesDecrypt(&key, &usage, &mIn, &mEnc);
     EXPECT_EQ(DLP_PARSE_ERROR_VALUE_INVALID, ret);
 }
+
+/**
+ * @tc.name: DlpHmacStream001
+ * @tc.desc: test streaming hmac over split input matches DlpHmacEncode over the whole file
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCryptTest, DlpHmacStream001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "DlpHmacStream001");
+    uint8_t buffer[SIXTEEN * 2] = {0};
+    for (uint32_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = static_cast<uint8_t>(i);
+    }
+    int fd = open("/data/fuse_test.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(write(fd, buffer, sizeof(buffer)), static_cast<ssize_t>(sizeof(buffer)));
+    lseek(fd, 0, SEEK_SET);
+
+    uint8_t hmacKeyData[HMAC_SIZE] = {0x5};
+    struct DlpBlob key = {
+        .size = HMAC_SIZE,
+        .data = hmacKeyData,
+    };
+    uint8_t fileOut[HMAC_SIZE] = {0};
+    struct DlpBlob fileHmac = {
+        .size = HMAC_SIZE,
+        .data = fileOut,
+    };
+    ASSERT_EQ(DLP_OK, DlpHmacEncode(key, fd, fileHmac));
+
+    void* ctx = nullptr;
+    EXPECT_EQ(DLP_PARSE_ERROR_DIGEST_INVALID, DlpHmacStreamInit(key, nullptr));
+    ASSERT_EQ(DLP_OK, DlpHmacStreamInit(key, &ctx));
+    EXPECT_EQ(DLP_OK, DlpHmacStreamUpdate(ctx, buffer, SIXTEEN - 1));
+    EXPECT_EQ(DLP_OK, DlpHmacStreamUpdate(ctx, buffer + SIXTEEN - 1, SIXTEEN + 1));
+    uint8_t streamOut[HMAC_SIZE] = {0};
+    struct DlpBlob streamHmac = {
+        .size = HMAC_SIZE,
+        .data = streamOut,
+    };
+    EXPECT_EQ(DLP_OK, DlpHmacStreamFinal(ctx, streamHmac));
+    DlpHmacStreamFree(ctx);
+    ASSERT_EQ(streamHmac.size, fileHmac.size);
+    EXPECT_EQ(0, memcmp(streamHmac.data, fileHmac.data, fileHmac.size));
+
+    close(fd);
+    unlink("/data/fuse_test.txt");
+}
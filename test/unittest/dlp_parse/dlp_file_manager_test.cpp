@@ -23,6 +23,7 @@
 #include "c_mock_common.h"
 #define private public
 #include "dlp_file_manager.h"
+#include "dlp_file_registry.h"
 #include "dlp_permission_client.h"
 #undef private
 #include "dlp_raw_file.h"
@@ -213,9 +214,10 @@ HWTEST_F(DlpFileManagerTest, OperDlpFileNode001, TestSize.Level0)
     EXPECT_EQ(DlpFileManager::GetInstance().GetDlpFile(2), nullptr);
     EXPECT_EQ(DlpFileManager::GetInstance().RemoveDlpFileNode(filePtr), DLP_OK);
     EXPECT_EQ(DlpFileManager::GetInstance().GetDlpFile(1), nullptr);
-    DlpFileManager::GetInstance().g_DlpFileMap_[1] = filePtr;
+    EXPECT_EQ(DlpFileManager::GetInstance().dlpFileRegistry_->Add(filePtr), DLP_OK);
     EXPECT_EQ(DlpFileManager::GetInstance().GetDlpFile(1), filePtr);
-    DlpFileManager::GetInstance().g_DlpFileMap_.clear();
+    DlpFileManager::GetInstance().dlpFileRegistry_->Clear();
+    EXPECT_EQ(DlpFileManager::GetInstance().dlpFileRegistry_->Size(), 0U);
     EXPECT_EQ(DlpFileManager::GetInstance().RemoveDlpFileNode(filePtr), DLP_PARSE_ERROR_FILE_NOT_OPENED);
 }
 
@@ -245,6 +247,30 @@ HWTEST_F(DlpFileManagerTest, OperDlpFileNode002, TestSize.Level0)
     }
 }
 
+/**
+ * @tc.name: OperDlpFileNode003
+ * @tc.desc: test a stale dlp file object can not remove the file opened on its fd since.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpFileManagerTest, OperDlpFileNode003, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "OperDlpFileNode003");
+
+    std::shared_ptr<DlpFile> stalePtr = std::make_shared<DlpZipFile>(17, DLP_TEST_DIR, 0, "txt");
+    std::shared_ptr<DlpFile> filePtr = std::make_shared<DlpZipFile>(17, DLP_TEST_DIR, 1, "txt");
+    ASSERT_NE(stalePtr, nullptr);
+    ASSERT_NE(filePtr, nullptr);
+    EXPECT_EQ(DlpFileManager::GetInstance().AddDlpFileNode(stalePtr), DLP_OK);
+    EXPECT_EQ(DlpFileManager::GetInstance().RemoveDlpFileNode(stalePtr), DLP_OK);
+    EXPECT_EQ(DlpFileManager::GetInstance().AddDlpFileNode(filePtr), DLP_OK);
+    EXPECT_EQ(DlpFileManager::GetInstance().RemoveDlpFileNode(stalePtr), DLP_PARSE_ERROR_FILE_NOT_OPENED);
+    EXPECT_EQ(DlpFileManager::GetInstance().GetDlpFile(17), filePtr);
+    EXPECT_EQ(DlpFileManager::GetInstance().RemoveDlpFileNode(filePtr), DLP_OK);
+    EXPECT_EQ(DlpFileManager::GetInstance().GetDlpFile(17), nullptr);
+    EXPECT_EQ(DlpFileManager::GetInstance().dlpFileRegistry_->Size(), 0U);
+}
+
 /**
  * @tc.name: GenerateCertData001
  * @tc.desc: Generate cert data
@@ -809,6 +835,37 @@ HWTEST_F(DlpFileManagerTest, GenerateDlpFile003, TestSize.Level0)
     close(plainFileFd);
 }
 
+/**
+ * @tc.name: GenerateDlpFile004
+ * @tc.desc: test generate dlp file from a non-seekable plain fd
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpFileManagerTest, GenerateDlpFile004, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "GenerateDlpFile004");
+    std::shared_ptr<DlpFile> filePtr;
+    DlpProperty property;
+    property.ownerAccount = "owner";
+    property.ownerAccountId = "owner";
+    property.contactAccount = "owner";
+    property.ownerAccountType = CLOUD_ACCOUNT;
+
+    int pipeFd[2] = {-1, -1};
+    ASSERT_EQ(pipe(pipeFd), 0);
+    char buffer[] = "123456";
+    ASSERT_NE(write(pipeFd[1], buffer, sizeof(buffer)), -1);
+    close(pipeFd[1]);
+
+    DlpFdPlainSource source(pipeFd[0]);
+    EXPECT_EQ(DLP_PARSE_ERROR_FD_ERROR,
+        DlpFileManager::GetInstance().GenerateDlpFileFromSource(source, -1, property, filePtr, DLP_TEST_DIR));
+    // the pipe is routed to the stream path and fails on the invalid dlp fd, not on sizing the plain fd
+    EXPECT_EQ(DLP_PARSE_ERROR_FD_ERROR,
+        DlpFileManager::GetInstance().GenerateDlpFile(pipeFd[0], 1000, property, filePtr, DLP_TEST_DIR));
+    close(pipeFd[0]);
+}
+
 /**
  * @tc.name: OpenDlpFile001
  * @tc.desc: test open dlp file params with wrong params
@@ -1526,7 +1526,7 @@ HWTEST_F(DlpFileTest, DlpFileRead001, TestSize.Level0)
 
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pread", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DlpFileRead(0, buffer, 16, hasRead, uid));
     CleanMockConditions();
 
@@ -1594,17 +1594,15 @@ HWTEST_F(DlpFileTest, WriteFirstBlockData001, TestSize.Level0)
     EXPECT_EQ(DLP_PARSE_ERROR_CRYPT_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     CleanMockConditions();
 
-    // lseek fail
-    lseek(fdDlp, 0, SEEK_SET);
+    // read prefixing fail
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pread", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     CleanMockConditions();
 
     // write fail
-    lseek(fdDlp, 0, SEEK_SET);
     condition.mockSequence = { true };
-    SetMockConditions("write", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     CleanMockConditions();
 
@@ -1633,7 +1631,7 @@ HWTEST_F(DlpFileTest, DoDlpFileWrite001, TestSize.Level0)
 
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpFileWrite(0, writeBuffer, 18));
     CleanMockConditions();
 
@@ -1657,7 +1655,7 @@ HWTEST_F(DlpFileTest, DoDlpFileWrite001, TestSize.Level0)
 
     condition.mockSequence = { false, true };
     lseek(fdDlp, 0, SEEK_SET);
-    SetMockConditions("write", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpFileWrite(0, writeBuffer, 18));
     CleanMockConditions();
 
@@ -1781,7 +1779,7 @@ HWTEST_F(DlpFileTest, DlpFileWrite001, TestSize.Level0)
     // fill hole data fail
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DlpFileWrite(16, writeBuffer, 16));
     CleanMockConditions();
 
@@ -1824,7 +1822,7 @@ HWTEST_F(DlpFileTest, Truncate001, TestSize.Level0)
     // fill hole data fail
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.Truncate(16));
     CleanMockConditions();
     close(fdPlain);
@@ -1833,42 +1831,6 @@ HWTEST_F(DlpFileTest, Truncate001, TestSize.Level0)
     unlink("/data/fuse_test_dlp.txt");
 }
 
-/**
- * @tc.name: DoDlpContentCopyOperation001
- * @tc.desc: DoDlpContentCopyOperation
- * @tc.type: FUNC
- * @tc.require:
- */
-HWTEST_F(DlpFileTest, DoDlpContentCopyOperation001, TestSize.Level0)
-{
-    DLP_LOG_INFO(LABEL, "DoDlpContentCopyOperation001");
-    DlpZipFile testFile(1000, DLP_TEST_DIR, 0, "txt");
-    uint8_t ivData[16] = {};
-
-    struct DlpCipherParam param = {
-        .iv = {
-            .data = ivData,
-            .size = 16
-        }
-    };
-    struct DlpUsageSpec spec = {
-        .mode = DLP_MODE_CTR,
-        .algParam = &param
-    };
-    testFile.cipher_.usageSpec = spec;
-
-    ASSERT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpContentCopyOperation(0, 0, 100, 10));
-    int fd = open("/data/fuse_test.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
-    ASSERT_NE(fd, -1);
-    uint8_t buffer[40] = {1};
-    write(fd, buffer, 40);
-    lseek(fd, 0, SEEK_SET);
-    ASSERT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpContentCopyOperation(fd, 0, 10, 100));
-    int fd2 = open("/data/fuse_test2.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
-    ASSERT_NE(fd2, -1);
-    ASSERT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpContentCopyOperation(fd, fd2, 10, 100));
-}
-
 /**
  * @tc.name: CheckDlpFile001
  * @tc.desc: CheckDlpFile
@@ -2529,34 +2491,26 @@ HWTEST_F(DlpFileTest, GenFileInZip001, TestSize.Level0)
 }
 
 /**
- * @tc.name: GenEncData001
- * @tc.desc: test gen file when io api exception
+ * @tc.name: CreateEncDataFile001
+ * @tc.desc: test create the opened encrypted data of a new zip dlp file
  * @tc.type: FUNC
  * @tc.require:
  */
-HWTEST_F(DlpFileTest, GenEncData001, TestSize.Level0)
+HWTEST_F(DlpFileTest, CreateEncDataFile001, TestSize.Level0)
 {
-    DLP_LOG_INFO(LABEL, "GenEncData001");
-    int fdPlain = open("/data/fuse_test_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
-    EXPECT_NE(fdPlain, -1);
+    DLP_LOG_INFO(LABEL, "CreateEncDataFile001");
     int fdDlp = open("/data/fuse_test_dlp.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
     EXPECT_NE(fdDlp, -1);
 
-    DlpZipFile testFile(fdDlp, DLP_TEST_DIR, 0, "txt");
-    initDlpFileCiper(testFile);
-    testFile.contactAccount_ = "aa";
-    EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.GenEncData(-1));
+    DlpZipFile testFile(fdDlp, "/data/dlp_test_not_exist/", 0, "txt");
+    EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.CreateEncDataFile());
+    EXPECT_EQ(-1, testFile.encDataFd_);
 
     DlpZipFile testFile2(fdDlp, DLP_TEST_DIR, 1, "txt");
-    initDlpFileCiper(testFile2);
-    testFile2.contactAccount_ = "aa";
-    EXPECT_EQ(true, testFile2.GenEncData(fdPlain) >= 0);
-    (void)unlink(DLP_OPENING_ENC_DATA.c_str());
+    EXPECT_EQ(DLP_OK, testFile2.CreateEncDataFile());
+    EXPECT_NE(-1, testFile2.encDataFd_);
 
-    close(fdPlain);
     close(fdDlp);
-
-    unlink("/data/fuse_test_plain.txt");
     unlink("/data/fuse_test_dlp.txt");
 }
 
@@ -2765,7 +2719,7 @@ HWTEST_F(DlpFileTest, TruncateZeroSize002, TestSize.Level0)
 
 /**
  * @tc.name: TruncateFillHoleDataFail002
- * @tc.desc: test Truncate with lseek fail returns INVALID after GetFsContentSize invalid
+ * @tc.desc: test Truncate with pwrite fail returns INVALID after GetFsContentSize invalid
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -2786,7 +2740,7 @@ HWTEST_F(DlpFileTest, TruncateFillHoleDataFail002, TestSize.Level0)
 
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.Truncate(16));
     CleanMockConditions();
     close(fdPlain);
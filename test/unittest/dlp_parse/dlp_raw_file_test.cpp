@@ -28,9 +28,17 @@
 #include "dlp_raw_file.h"
 #include "dlp_zip_file.h"
 #include "dlp_file_manager.h"
+#include "dlp_io_backend.h"
+#include "dlp_chunk_table.h"
+#include "dlp_hiae_engine.h"
+#include "dlp_job_control.h"
+#include "dlp_mapped_content.h"
+#include "dlp_raw_metadata_reader.h"
+#include "dlp_sparse_map.h"
 #undef private
 #include "dlp_crypt.h"
 #include "dlp_permission.h"
+#include "dlp_permission_public_interface.h"
 
 using namespace testing::ext;
 using namespace OHOS::Security::DlpPermission;
@@ -43,6 +51,7 @@ static const std::string DLP_TEST_DIR = "/data/dlpTest/";
 static constexpr int32_t SECOND = 2;
 static const uint32_t FILE_HEAD = 8;
 static const uint32_t MAX_CERT_SIZE = 30 * 1024;
+static const uint32_t PIPE_READ_LEN = 4096;
 
 void initDlpRawFileCiper(DlpRawFile &testFile)
 {
@@ -81,6 +90,40 @@ void initDlpRawFileCiper(DlpRawFile &testFile)
     certKey.data = nullptr;
     certKey.size = 0;
 }
+
+// Stands in for the HIAE library: xors each byte with its block iv, its key byte and its position in the block.
+int32_t FakeHIAEInit(HIAE_CipherCtx *ctx, const uint8_t *key, const uint32_t keyLen, const uint8_t *iv,
+    const uint32_t ivLen)
+{
+    if (ctx->msgLen != 0 || keyLen == 0 || ivLen != IV_SIZE) {
+        return -1;
+    }
+    (void)memcpy_s(ctx->state, HIAE_STATE_SIZE, iv, ivLen);
+    (void)memcpy_s(ctx->state + ivLen, HIAE_STATE_SIZE - ivLen, key, 1);
+    ctx->msgLen = 1;
+    return 0;
+}
+
+int32_t FakeHIAEClear(HIAE_CipherCtx *ctx)
+{
+    (void)memset_s(ctx, sizeof(HIAE_CipherCtx), 0, sizeof(HIAE_CipherCtx));
+    return 0;
+}
+
+int32_t FakeHIAEUpdate(HIAE_CipherCtx *ctx, const uint8_t *in, const uint32_t inLen, uint8_t *out, uint32_t *outLen)
+{
+    for (uint32_t i = 0; i < inLen; i++) {
+        out[i] = in[i] ^ ctx->state[i % IV_SIZE] ^ ctx->state[IV_SIZE] ^ static_cast<uint8_t>(i / IV_SIZE);
+    }
+    *outLen = inLen;
+    return 0;
+}
+
+int32_t FakeHIAEFailedInit(HIAE_CipherCtx *ctx, const uint8_t *key, const uint32_t keyLen, const uint8_t *iv,
+    const uint32_t ivLen)
+{
+    return -1;
+}
 }
 
 void DlpRawFileTest::SetUpTestCase() {}
@@ -674,7 +717,7 @@ HWTEST_F(DlpRawFileTest, ComputeContentHmacTest_InvalidFd, TestSize.Level0)
     ASSERT_NE(filePtr, nullptr);
  
     std::string hmacHexStr;
-    // ComputeContentHmac should return error when lseek fails on invalid fd
+    // ComputeContentHmac should return error when pread fails on invalid fd
     ASSERT_EQ(filePtr->ComputeContentHmac(100, hmacHexStr), DLP_PARSE_ERROR_FILE_OPERATE_FAIL);
 }
  
@@ -693,4 +736,788 @@ HWTEST_F(DlpRawFileTest, WriteRawFileTailAndHeaderTest_InvalidFd, TestSize.Level
     std::string hmacStr = "test";
     // WriteRawFileTailAndHeader should return error when ftruncate fails on invalid fd
     ASSERT_EQ(filePtr->WriteRawFileTailAndHeader(hmacStr, hmacStr.size()), DLP_PARSE_ERROR_FILE_OPERATE_FAIL);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: GenFileFromSourceTest001
+ * @tc.desc: test GenFileFromSource with invalid params
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, GenFileFromSourceTest001, TestSize.Level0)
+{
+    int pipeFd[2] = {-1, -1};
+    ASSERT_EQ(pipe(pipeFd), 0);
+    DlpFdPlainSource source(pipeFd[0]);
+
+    DlpRawFile invalidFdFile(-1, "txt");
+    initDlpRawFileCiper(invalidFdFile);
+    EXPECT_EQ(DLP_PARSE_ERROR_VALUE_INVALID, invalidFdFile.GenFileFromSource(source));
+
+    int fdDlp = open("/data/fuse_test_stream.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+    DlpRawFile noCipherFile(fdDlp, "txt");
+    EXPECT_EQ(DLP_PARSE_ERROR_VALUE_INVALID, noCipherFile.GenFileFromSource(source));
+
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    close(fdDlp);
+    unlink("/data/fuse_test_stream.txt.dlp");
+}
+
+/**
+ * @tc.name: GenFileFromSourceTest002
+ * @tc.desc: test GenFileFromSource from a pipe matches GenFile from a regular file
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, GenFileFromSourceTest002, TestSize.Level0)
+{
+    const uint32_t plainSize = 4096 + 7;
+    std::vector<uint8_t> plain(plainSize);
+    for (uint32_t i = 0; i < plainSize; i++) {
+        plain[i] = static_cast<uint8_t>(i);
+    }
+    int fdPlain = open("/data/fuse_test_stream_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_stream_file.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+    int fdStreamDlp = open("/data/fuse_test_stream_pipe.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdStreamDlp, -1);
+
+    DlpRawFile fileFromFd(fdDlp, "txt");
+    initDlpRawFileCiper(fileFromFd);
+    ASSERT_EQ(DLP_OK, fileFromFd.SetContactAccount("testAccount"));
+    EXPECT_EQ(DLP_OK, fileFromFd.GenFile(fdPlain));
+
+    int pipeFd[2] = {-1, -1};
+    ASSERT_EQ(pipe(pipeFd), 0);
+    std::thread writer([&pipeFd, &plain]() {
+        (void)write(pipeFd[1], plain.data(), plain.size());
+        close(pipeFd[1]);
+    });
+    DlpFdPlainSource source(pipeFd[0]);
+    DlpRawFile fileFromStream(fdStreamDlp, "txt");
+    initDlpRawFileCiper(fileFromStream);
+    ASSERT_EQ(DLP_OK, fileFromStream.SetContactAccount("testAccount"));
+    EXPECT_EQ(DLP_OK, fileFromStream.GenFileFromSource(source));
+    writer.join();
+    close(pipeFd[0]);
+
+    EXPECT_EQ(fileFromStream.head_.txtSize, plainSize);
+    EXPECT_EQ(fileFromStream.head_.txtOffset, fileFromFd.head_.txtOffset);
+    EXPECT_EQ(fileFromStream.head_.certOffset, fileFromFd.head_.certOffset);
+    ASSERT_EQ(fileFromStream.hmac_.size, fileFromFd.hmac_.size);
+    EXPECT_EQ(0, memcmp(fileFromStream.hmac_.data, fileFromFd.hmac_.data, fileFromFd.hmac_.size));
+    EXPECT_EQ(DLP_OK, fileFromStream.HmacCheck());
+
+    close(fdPlain);
+    close(fdDlp);
+    close(fdStreamDlp);
+    unlink("/data/fuse_test_stream_plain.txt");
+    unlink("/data/fuse_test_stream_file.txt.dlp");
+    unlink("/data/fuse_test_stream_pipe.txt.dlp");
+}
+
+/**
+ * @tc.name: JobControlTest001
+ * @tc.desc: test GenFile reports progress through the job control
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, JobControlTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = DLP_BUFF_LEN + 10;
+    std::vector<uint8_t> plain(plainSize, 'a');
+    int fdPlain = open("/data/fuse_test_job_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_job.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    auto jobControl = std::make_shared<DlpJobControl>();
+    uint32_t reportCount = 0;
+    DlpJobProgress lastProgress;
+    jobControl->SetProgressCallback([&reportCount, &lastProgress](const DlpJobProgress& progress) {
+        reportCount++;
+        lastProgress = progress;
+    });
+    DlpRawFile filePtr(fdDlp, "txt");
+    initDlpRawFileCiper(filePtr);
+    ASSERT_EQ(DLP_OK, filePtr.SetContactAccount("testAccount"));
+    filePtr.SetJobControl(jobControl);
+    EXPECT_EQ(DLP_OK, filePtr.GenFile(fdPlain));
+    EXPECT_EQ(reportCount, 2);
+    EXPECT_EQ(lastProgress.processedSize, plainSize);
+    EXPECT_EQ(lastProgress.totalSize, plainSize);
+
+    close(fdPlain);
+    close(fdDlp);
+    unlink("/data/fuse_test_job_plain.txt");
+    unlink("/data/fuse_test_job.txt.dlp");
+}
+
+/**
+ * @tc.name: JobControlTest002
+ * @tc.desc: test GenFile and GenFileFromSource stop when the job is cancelled
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, JobControlTest002, TestSize.Level0)
+{
+    const uint32_t plainSize = DLP_BUFF_LEN * 2;
+    std::vector<uint8_t> plain(plainSize, 'a');
+    int fdPlain = open("/data/fuse_test_job_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_job.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    auto jobControl = std::make_shared<DlpJobControl>();
+    uint32_t reportCount = 0;
+    jobControl->SetProgressCallback([&reportCount, &jobControl](const DlpJobProgress& progress) {
+        reportCount++;
+        jobControl->Cancel();
+    });
+    DlpRawFile filePtr(fdDlp, "txt");
+    initDlpRawFileCiper(filePtr);
+    ASSERT_EQ(DLP_OK, filePtr.SetContactAccount("testAccount"));
+    filePtr.SetJobControl(jobControl);
+    EXPECT_EQ(DLP_PARSE_ERROR_OPERATION_CANCELED, filePtr.GenFile(fdPlain));
+    EXPECT_EQ(reportCount, 1);
+
+    int pipeFd[2] = {-1, -1};
+    ASSERT_EQ(pipe(pipeFd), 0);
+    DlpFdPlainSource source(pipeFd[0]);
+    EXPECT_EQ(DLP_PARSE_ERROR_OPERATION_CANCELED, filePtr.GenFileFromSource(source));
+    filePtr.SetJobControl(nullptr);
+
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    close(fdPlain);
+    close(fdDlp);
+    unlink("/data/fuse_test_job_plain.txt");
+    unlink("/data/fuse_test_job.txt.dlp");
+}
+
+/**
+ * @tc.name: ProcessDlpFileReadCountTest001
+ * @tc.desc: test ProcessDlpFile parses a raw file from at most three reads
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, ProcessDlpFileReadCountTest001, TestSize.Level0)
+{
+    const std::string contactAccount = "test@example.com";
+    const uint32_t contactSize = static_cast<uint32_t>(contactAccount.size());
+    const uint32_t txtOffset = sizeof(struct DlpHeader) + FILE_HEAD + contactSize;
+    const uint32_t txtSize = 64 * 1024;
+    const uint32_t hmacSize = 64;
+    const uint32_t certSize = 256;
+    struct DlpHeader header = {
+        .magic = DLP_FILE_MAGIC,
+        .fileType = 0,
+        .offlineAccess = 0,
+        .algType = DLP_MODE_CTR,
+        .certSize = certSize,
+        .hmacSize = hmacSize,
+        .contactAccountOffset = sizeof(struct DlpHeader) + FILE_HEAD,
+        .contactAccountSize = contactSize,
+        .offlineCertSize = certSize,
+        .txtOffset = txtOffset,
+        .txtSize = txtSize,
+        .certOffset = txtOffset + txtSize + hmacSize,
+        .hmacOffset = txtOffset + txtSize,
+        .offlineCertOffset = txtOffset + txtSize + hmacSize
+    };
+    std::vector<uint8_t> file;
+    auto append = [&file](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        file.insert(file.end(), bytes, bytes + size);
+    };
+    uint32_t version = CURRENT_VERSION;
+    uint32_t headerSize = sizeof(struct DlpHeader);
+    append(&version, sizeof(version));
+    append(&headerSize, sizeof(headerSize));
+    append(&header, sizeof(header));
+    append(contactAccount.data(), contactAccount.size());
+    file.resize(file.size() + txtSize, 0);
+    std::string hmacStr(hmacSize, 'a');
+    append(hmacStr.data(), hmacStr.size());
+    file.resize(file.size() + certSize, 0x5a);
+    file.resize(file.size() + MAX_CERT_SIZE - certSize, 0);
+    // nickNameMask countdown waterMark flag allowedOpenCount fileId
+    std::string nickNameMask(40, '\0');
+    nickNameMask.replace(0, 4, "nick");
+    append(nickNameMask.data(), nickNameMask.size());
+    int32_t trailerFields[] = { 0, 1, 1, 3 };
+    append(trailerFields, sizeof(trailerFields));
+    std::string fileId(46, '1');
+    append(fileId.data(), fileId.size());
+
+    int fd = open("/data/fuse_test_read_count.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(write(fd, file.data(), file.size()), static_cast<ssize_t>(file.size()));
+
+    DlpRawFile testFile(fd, "txt");
+    EXPECT_EQ(DLP_OK, testFile.ProcessDlpFile());
+    EXPECT_LE(testFile.metaReader_->GetReadCount(), 3);
+    EXPECT_FALSE(testFile.metaReader_->IsOpen());
+    EXPECT_EQ(testFile.contactAccount_, contactAccount);
+    ASSERT_EQ(testFile.cert_.size, certSize);
+    EXPECT_EQ(testFile.cert_.data[0], 0x5a);
+    EXPECT_EQ(testFile.offlineCert_.size, certSize);
+    ASSERT_EQ(testFile.hmac_.size, hmacSize / 2);
+    EXPECT_EQ(testFile.hmac_.data[0], 0xaa);
+    EXPECT_EQ(testFile.nickNameMask_, nickNameMask);
+    EXPECT_TRUE(testFile.waterMarkConfig_);
+    EXPECT_EQ(testFile.allowedOpenCount_, 3);
+    EXPECT_EQ(testFile.fileIdPlaintext_, fileId);
+
+    DlpRawMetadataReader reader;
+    ASSERT_TRUE(reader.Open(fd));
+    DlpRawTrailer trailer;
+    EXPECT_TRUE(reader.ReadTrailer(trailer));
+    EXPECT_EQ(reader.GetReadCount(), 1);
+    EXPECT_EQ(trailer.allowedOpenCount, 3);
+    EXPECT_TRUE(trailer.waterMarkConfig);
+    close(fd);
+    unlink("/data/fuse_test_read_count.txt.dlp");
+}
+
+namespace {
+class DlpBatchIoBackend : public DlpPosixIoBackend {
+public:
+    uint32_t GetQueueDepth() const override
+    {
+        return BATCH_DEPTH;
+    }
+
+private:
+    static constexpr uint32_t BATCH_DEPTH = 3;
+};
+}
+
+/**
+ * @tc.name: DoDlpContentCryptyOperationIoBackendTest001
+ * @tc.desc: test content crypt with a batching io backend matches the default backend and round trips
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, DoDlpContentCryptyOperationIoBackendTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = DLP_BUFF_LEN * 5 / 2 + 5;
+    std::vector<uint8_t> plain(plainSize);
+    for (uint32_t i = 0; i < plainSize; i++) {
+        plain[i] = static_cast<uint8_t>(i * 7);
+    }
+    int fdPlain = open("/data/fuse_test_io_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdEnc = open("/data/fuse_test_io_enc.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdEnc, -1);
+    int fdDefaultEnc = open("/data/fuse_test_io_default_enc.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDefaultEnc, -1);
+    int fdDec = open("/data/fuse_test_io_dec.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDec, -1);
+
+    DlpRawFile batchFile(-1, "txt");
+    initDlpRawFileCiper(batchFile);
+    batchFile.head_.algType = DLP_MODE_CTR;
+    batchFile.SetIoBackend(std::make_shared<DlpBatchIoBackend>());
+    DlpRawFile defaultFile(-1, "txt");
+    initDlpRawFileCiper(defaultFile);
+    defaultFile.head_.algType = DLP_MODE_CTR;
+
+    lseek(fdPlain, 0, SEEK_SET);
+    EXPECT_EQ(DLP_OK, batchFile.DoDlpContentCryptyOperation(fdPlain, fdEnc, 0, plainSize, true));
+    EXPECT_EQ(lseek(fdPlain, 0, SEEK_CUR), static_cast<off_t>(plainSize));
+    EXPECT_EQ(lseek(fdEnc, 0, SEEK_CUR), static_cast<off_t>(plainSize));
+    lseek(fdPlain, 0, SEEK_SET);
+    EXPECT_EQ(DLP_OK, defaultFile.DoDlpContentCryptyOperation(fdPlain, fdDefaultEnc, 0, plainSize, true));
+
+    std::vector<uint8_t> enc(plainSize);
+    std::vector<uint8_t> defaultEnc(plainSize);
+    ASSERT_EQ(pread(fdEnc, enc.data(), plainSize, 0), static_cast<ssize_t>(plainSize));
+    ASSERT_EQ(pread(fdDefaultEnc, defaultEnc.data(), plainSize, 0), static_cast<ssize_t>(plainSize));
+    EXPECT_EQ(enc, defaultEnc);
+    EXPECT_NE(enc, plain);
+
+    lseek(fdEnc, 0, SEEK_SET);
+    EXPECT_EQ(DLP_OK, batchFile.DoDlpContentCryptyOperation(fdEnc, fdDec, 0, plainSize, false));
+    std::vector<uint8_t> dec(plainSize);
+    ASSERT_EQ(pread(fdDec, dec.data(), plainSize, 0), static_cast<ssize_t>(plainSize));
+    EXPECT_EQ(dec, plain);
+
+    close(fdPlain);
+    close(fdEnc);
+    close(fdDefaultEnc);
+    close(fdDec);
+    unlink("/data/fuse_test_io_plain.txt");
+    unlink("/data/fuse_test_io_enc.txt");
+    unlink("/data/fuse_test_io_default_enc.txt");
+    unlink("/data/fuse_test_io_dec.txt");
+}
+
+/**
+ * @tc.name: DoDlpContentCryptyOperationPipeTest001
+ * @tc.desc: test content crypt reads from and writes to a pipe in order when the fd cannot seek
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, DoDlpContentCryptyOperationPipeTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = DLP_BUFF_LEN + 5;
+    std::vector<uint8_t> plain(plainSize);
+    for (uint32_t i = 0; i < plainSize; i++) {
+        plain[i] = static_cast<uint8_t>(i * 7);
+    }
+    int fdPlain = open("/data/fuse_test_pipe_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    lseek(fdPlain, 0, SEEK_SET);
+    int fdEnc = open("/data/fuse_test_pipe_enc.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdEnc, -1);
+    int fdPipeEnc = open("/data/fuse_test_pipe_pipe_enc.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPipeEnc, -1);
+
+    DlpRawFile testFile(-1, "txt");
+    initDlpRawFileCiper(testFile);
+    testFile.head_.algType = DLP_MODE_CTR;
+    EXPECT_EQ(DLP_OK, testFile.DoDlpContentCryptyOperation(fdPlain, fdEnc, 0, plainSize, true));
+
+    // CTR mode: the cipher text of a prefix is the prefix of the cipher text.
+    int inPipe[SECOND] = { -1, -1 };
+    ASSERT_EQ(pipe(inPipe), 0);
+    ASSERT_EQ(write(inPipe[1], plain.data(), PIPE_READ_LEN), static_cast<ssize_t>(PIPE_READ_LEN));
+    close(inPipe[1]);
+    EXPECT_EQ(DLP_OK, testFile.DoDlpContentCryptyOperation(inPipe[0], fdPipeEnc, 0, PIPE_READ_LEN, true));
+    close(inPipe[0]);
+    std::vector<uint8_t> enc(PIPE_READ_LEN);
+    std::vector<uint8_t> pipeEnc(PIPE_READ_LEN);
+    ASSERT_EQ(pread(fdEnc, enc.data(), PIPE_READ_LEN, 0), static_cast<ssize_t>(PIPE_READ_LEN));
+    ASSERT_EQ(pread(fdPipeEnc, pipeEnc.data(), PIPE_READ_LEN, 0), static_cast<ssize_t>(PIPE_READ_LEN));
+    EXPECT_EQ(enc, pipeEnc);
+
+    int outPipe[SECOND] = { -1, -1 };
+    ASSERT_EQ(pipe(outPipe), 0);
+    std::vector<uint8_t> dec;
+    std::thread reader([&outPipe, &dec] {
+        uint8_t buf[PIPE_READ_LEN];
+        ssize_t len;
+        while ((len = read(outPipe[0], buf, sizeof(buf))) > 0) {
+            dec.insert(dec.end(), buf, buf + len);
+        }
+    });
+    lseek(fdEnc, 0, SEEK_SET);
+    EXPECT_EQ(DLP_OK, testFile.DoDlpContentCryptyOperation(fdEnc, outPipe[1], 0, plainSize, false));
+    close(outPipe[1]);
+    reader.join();
+    close(outPipe[0]);
+    EXPECT_EQ(dec, plain);
+
+    close(fdPlain);
+    close(fdEnc);
+    close(fdPipeEnc);
+    unlink("/data/fuse_test_pipe_plain.txt");
+    unlink("/data/fuse_test_pipe_enc.txt");
+    unlink("/data/fuse_test_pipe_pipe_enc.txt");
+}
+
+/**
+ * @tc.name: SparseHoleTest001
+ * @tc.desc: test a write far past the end leaves a hole that reads as zeros and survives reopening
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, SparseHoleTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = 100;
+    const uint64_t writeOffset = 1024 * 1024;
+    std::vector<uint8_t> plain(plainSize, 'p');
+    std::vector<uint8_t> tail(DLP_BLOCK_SIZE, 't');
+    int fdPlain = open("/data/fuse_test_sparse_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_sparse.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    DlpRawFile testFile(fdDlp, "txt");
+    initDlpRawFileCiper(testFile);
+    ASSERT_EQ(DLP_OK, testFile.SetContactAccount("testAccount"));
+    ASSERT_EQ(DLP_OK, testFile.GenFile(fdPlain));
+    testFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    EXPECT_EQ(static_cast<int32_t>(tail.size()), testFile.DlpFileWrite(writeOffset, tail.data(), tail.size()));
+    ASSERT_EQ(testFile.sparse_->GetRegions().size(), 1);
+    EXPECT_EQ(testFile.sparse_->GetRegions()[0].start, plainSize);
+    EXPECT_EQ(testFile.sparse_->GetRegions()[0].end, writeOffset);
+    uint32_t version = 0;
+    ASSERT_EQ(pread(fdDlp, &version, sizeof(version), 0), static_cast<ssize_t>(sizeof(version)));
+    EXPECT_EQ(version, RAW_TAIL_MAP_VERSION);
+
+    bool hasRead = true;
+    std::vector<uint8_t> buf(DLP_BLOCK_SIZE, 0xff);
+    EXPECT_EQ(DLP_BLOCK_SIZE, testFile.DlpFileRead(writeOffset / 2, buf.data(), DLP_BLOCK_SIZE, hasRead, 0));
+    EXPECT_EQ(buf, std::vector<uint8_t>(DLP_BLOCK_SIZE, 0));
+    EXPECT_EQ(DLP_BLOCK_SIZE, testFile.DlpFileRead(plainSize - 4, buf.data(), DLP_BLOCK_SIZE, hasRead, 0));
+    EXPECT_EQ(0, memcmp(buf.data(), plain.data(), 4));
+    EXPECT_EQ(buf[4], 0);
+    EXPECT_EQ(DLP_BLOCK_SIZE, testFile.DlpFileRead(writeOffset, buf.data(), DLP_BLOCK_SIZE, hasRead, 0));
+    EXPECT_EQ(buf, tail);
+    EXPECT_EQ(DLP_OK, testFile.HmacCheck());
+
+    // A write into the hole splits it.
+    EXPECT_EQ(static_cast<int32_t>(tail.size()), testFile.DlpFileWrite(writeOffset / 2, tail.data(), tail.size()));
+    EXPECT_EQ(testFile.sparse_->GetRegions().size(), 2);
+
+    DlpRawFile reopened(fdDlp, "txt");
+    initDlpRawFileCiper(reopened);
+    ASSERT_EQ(DLP_OK, reopened.ProcessDlpFile());
+    ASSERT_EQ(reopened.sparse_->GetRegions().size(), 2);
+    EXPECT_EQ(reopened.sparse_->GetRegions()[1].end, writeOffset);
+    EXPECT_EQ(DLP_OK, reopened.HmacCheck());
+
+    int fdOut = open("/data/fuse_test_sparse_out.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdOut, -1);
+    reopened.authPerm_ = DLPFileAccess::FULL_CONTROL;
+    EXPECT_EQ(DLP_OK, reopened.RemoveDlpPermission(fdOut));
+    std::vector<uint8_t> expected(writeOffset + tail.size(), 0);
+    std::copy(plain.begin(), plain.end(), expected.begin());
+    std::copy(tail.begin(), tail.end(), expected.begin() + writeOffset / 2);
+    std::copy(tail.begin(), tail.end(), expected.begin() + writeOffset);
+    std::vector<uint8_t> out(expected.size());
+    ASSERT_EQ(pread(fdOut, out.data(), out.size(), 0), static_cast<ssize_t>(out.size()));
+    EXPECT_EQ(out, expected);
+
+    close(fdPlain);
+    close(fdDlp);
+    close(fdOut);
+    unlink("/data/fuse_test_sparse_plain.txt");
+    unlink("/data/fuse_test_sparse.txt.dlp");
+    unlink("/data/fuse_test_sparse_out.txt");
+}
+
+/**
+ * @tc.name: ChunkGenerationTest001
+ * @tc.desc: test an overwrite re-encrypts only its chunks with a fresh key stream and survives reopening
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, ChunkGenerationTest001, TestSize.Level0)
+{
+    const uint32_t chunkSize = DlpChunkTable::CHUNK_SIZE;
+    const uint32_t plainSize = 4 * chunkSize;
+    std::vector<uint8_t> plain(plainSize, 'p');
+    std::vector<uint8_t> data(chunkSize, 'd');
+    int fdPlain = open("/data/fuse_test_chunk_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_chunk.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    DlpRawFile testFile(fdDlp, "txt");
+    initDlpRawFileCiper(testFile);
+    ASSERT_EQ(DLP_OK, testFile.SetContactAccount("testAccount"));
+    ASSERT_EQ(DLP_OK, testFile.GenFile(fdPlain));
+    EXPECT_FALSE(testFile.chunks_->IsUsed());
+    testFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    uint64_t txtOffset = testFile.head_.txtOffset;
+    std::vector<uint8_t> before(plainSize);
+    ASSERT_EQ(pread(fdDlp, before.data(), plainSize, txtOffset), static_cast<ssize_t>(plainSize));
+
+    // Overwriting chunk 1 changes only its cipher text, and not by the plain text difference.
+    EXPECT_EQ(static_cast<int32_t>(chunkSize), testFile.DlpFileWrite(chunkSize, data.data(), chunkSize));
+    ASSERT_EQ(testFile.chunks_->GetRuns().size(), 1);
+    EXPECT_EQ(testFile.chunks_->GetGeneration(0), 0);
+    EXPECT_NE(testFile.chunks_->GetGeneration(1), 0);
+    std::vector<uint8_t> after(plainSize);
+    ASSERT_EQ(pread(fdDlp, after.data(), plainSize, txtOffset), static_cast<ssize_t>(plainSize));
+    EXPECT_TRUE(std::equal(before.begin(), before.begin() + chunkSize, after.begin()));
+    EXPECT_TRUE(std::equal(before.begin() + 2 * chunkSize, before.end(), after.begin() + 2 * chunkSize));
+    bool reused = true;
+    for (uint32_t i = chunkSize; i < 2 * chunkSize; i++) {
+        reused = reused && ((before[i] ^ after[i]) == ('p' ^ 'd'));
+    }
+    EXPECT_FALSE(reused);
+
+    // Rewriting the same chunk takes another generation, an append keeps extending the last one.
+    uint32_t generation = testFile.chunks_->GetGeneration(1);
+    EXPECT_EQ(static_cast<int32_t>(chunkSize), testFile.DlpFileWrite(chunkSize, data.data(), chunkSize));
+    EXPECT_NE(testFile.chunks_->GetGeneration(1), generation);
+    generation = testFile.chunks_->GetGeneration(1);
+    EXPECT_EQ(static_cast<int32_t>(chunkSize), testFile.DlpFileWrite(plainSize, data.data(), chunkSize));
+    EXPECT_EQ(static_cast<int32_t>(chunkSize), testFile.DlpFileWrite(plainSize + chunkSize, data.data(), chunkSize));
+    EXPECT_EQ(testFile.chunks_->GetGenerationEnd(plainSize / chunkSize), plainSize / chunkSize + 2);
+
+    DlpRawFile reopened(fdDlp, "txt");
+    initDlpRawFileCiper(reopened);
+    ASSERT_EQ(DLP_OK, reopened.ProcessDlpFile());
+    EXPECT_EQ(reopened.chunks_->GetRuns().size(), testFile.chunks_->GetRuns().size());
+    EXPECT_EQ(reopened.chunks_->GetGeneration(1), generation);
+    EXPECT_EQ(DLP_OK, reopened.HmacCheck());
+
+    int fdOut = open("/data/fuse_test_chunk_out.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdOut, -1);
+    reopened.authPerm_ = DLPFileAccess::FULL_CONTROL;
+    EXPECT_EQ(DLP_OK, reopened.RemoveDlpPermission(fdOut));
+    std::vector<uint8_t> expected(plain);
+    std::copy(data.begin(), data.end(), expected.begin() + chunkSize);
+    expected.insert(expected.end(), 2 * chunkSize, 'd');
+    std::vector<uint8_t> out(expected.size());
+    ASSERT_EQ(pread(fdOut, out.data(), out.size(), 0), static_cast<ssize_t>(out.size()));
+    EXPECT_EQ(out, expected);
+
+    close(fdPlain);
+    close(fdDlp);
+    close(fdOut);
+    unlink("/data/fuse_test_chunk_plain.txt");
+    unlink("/data/fuse_test_chunk.txt.dlp");
+    unlink("/data/fuse_test_chunk_out.txt");
+}
+
+/**
+ * @tc.name: TailMapVersionTest001
+ * @tc.desc: test a file without tail maps keeps its version and is upgraded by the first write that needs them
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, TailMapVersionTest001, TestSize.Level0)
+{
+    const uint32_t chunkSize = DlpChunkTable::CHUNK_SIZE;
+    const uint32_t plainSize = 2 * chunkSize;
+    std::vector<uint8_t> plain(plainSize, 'p');
+    std::vector<uint8_t> data(chunkSize, 'd');
+    int fdPlain = open("/data/fuse_test_version_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_version.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    DlpRawFile testFile(fdDlp, "txt");
+    initDlpRawFileCiper(testFile);
+    ASSERT_EQ(DLP_OK, testFile.SetContactAccount("testAccount"));
+    ASSERT_EQ(DLP_OK, testFile.GenFile(fdPlain));
+    uint32_t version = 0;
+    ASSERT_EQ(pread(fdDlp, &version, sizeof(version), 0), static_cast<ssize_t>(sizeof(version)));
+    EXPECT_EQ(version, CURRENT_VERSION);
+
+    DlpRawFile oldFile(fdDlp, "txt");
+    initDlpRawFileCiper(oldFile);
+    ASSERT_EQ(DLP_OK, oldFile.ProcessDlpFile());
+    EXPECT_FALSE(oldFile.hasTailMaps_);
+    EXPECT_EQ(DLP_OK, oldFile.HmacCheck());
+    oldFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    EXPECT_EQ(static_cast<int32_t>(chunkSize), oldFile.DlpFileWrite(chunkSize, data.data(), chunkSize));
+    ASSERT_EQ(pread(fdDlp, &version, sizeof(version), 0), static_cast<ssize_t>(sizeof(version)));
+    EXPECT_EQ(version, RAW_TAIL_MAP_VERSION);
+
+    DlpRawFile reopened(fdDlp, "txt");
+    initDlpRawFileCiper(reopened);
+    ASSERT_EQ(DLP_OK, reopened.ProcessDlpFile());
+    EXPECT_TRUE(reopened.hasTailMaps_);
+    EXPECT_EQ(reopened.version_, CURRENT_VERSION);
+    EXPECT_EQ(reopened.chunks_->GetGeneration(1), oldFile.chunks_->GetGeneration(1));
+    EXPECT_EQ(DLP_OK, reopened.HmacCheck());
+
+    // A version past the tail maps is refused before anything else is read.
+    version = RAW_TAIL_MAP_VERSION + 1;
+    ASSERT_EQ(pwrite(fdDlp, &version, sizeof(version), 0), static_cast<ssize_t>(sizeof(version)));
+    DlpRawFile newer(fdDlp, "txt");
+    initDlpRawFileCiper(newer);
+    EXPECT_EQ(DLP_PARSE_ERROR_FILE_VERSION_BIGGER_THAN_CURRENT, newer.ProcessDlpFile());
+
+    close(fdPlain);
+    close(fdDlp);
+    unlink("/data/fuse_test_version_plain.txt");
+    unlink("/data/fuse_test_version.txt.dlp");
+}
+
+/**
+ * @tc.name: HIAEEngineTest001
+ * @tc.desc: test the HIAE engine crypts a window block by block with the block ivs, on one or several kept threads
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, HIAEEngineTest001, TestSize.Level0)
+{
+    const uint32_t windowSize = DLP_BUFF_LEN - 100;
+    const uint64_t offset = 3 * DlpHIAEEngine::BLOCK_SIZE + DLP_BLOCK_SIZE;
+    uint8_t keyData[16] = { 0x5a };
+    uint8_t ivData[IV_SIZE] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0xf0 };
+    struct DlpBlob key = { .size = sizeof(keyData), .data = keyData };
+    struct DlpBlob iv = { .size = IV_SIZE, .data = ivData };
+    DlpHIAEFuncTable funcs = { FakeHIAEInit, FakeHIAEClear, FakeHIAEUpdate, FakeHIAEUpdate };
+    std::vector<uint8_t> plain(windowSize);
+    for (uint32_t i = 0; i < windowSize; i++) {
+        plain[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // What one library call per block, with the iv advanced to the block offset, produces.
+    std::vector<uint8_t> expected(windowSize);
+    for (uint32_t pos = 0; pos < windowSize; pos += DlpHIAEEngine::BLOCK_SIZE) {
+        uint8_t blockIvData[IV_SIZE];
+        (void)memcpy_s(blockIvData, IV_SIZE, ivData, IV_SIZE);
+        struct DlpBlob blockIv = { .size = IV_SIZE, .data = blockIvData };
+        DlpCtrModeIncreaeIvCounter(blockIv, (offset + pos) / DLP_BLOCK_SIZE);
+        HIAE_CipherCtx ctx = { { 0 }, 0, 0 };
+        uint32_t blockLen = std::min(windowSize - pos, DlpHIAEEngine::BLOCK_SIZE);
+        uint32_t outLen = blockLen;
+        ASSERT_EQ(0, FakeHIAEInit(&ctx, keyData, sizeof(keyData), blockIvData, IV_SIZE));
+        ASSERT_EQ(0, FakeHIAEUpdate(&ctx, plain.data() + pos, blockLen, expected.data() + pos, &outLen));
+    }
+
+    DlpHIAEEngine engine;
+    std::vector<uint8_t> out(windowSize);
+    EXPECT_EQ(DLP_PARSE_ERROR_VALUE_INVALID, engine.Crypt(plain.data(), out.data(), windowSize, offset, true));
+    ASSERT_EQ(DLP_OK, engine.Init(funcs, key, iv));
+    EXPECT_TRUE(engine.Matches(key, iv));
+    EXPECT_EQ(DLP_OK, engine.Crypt(plain.data(), out.data(), windowSize, offset, true));
+    EXPECT_EQ(out, expected);
+
+    engine.SetWorkers(DlpHIAEEngine::MAX_WORKERS);
+    std::fill(out.begin(), out.end(), 0);
+    EXPECT_EQ(DLP_OK, engine.Crypt(plain.data(), out.data(), windowSize, offset, true));
+    EXPECT_EQ(out, expected);
+    std::vector<uint8_t> dec(windowSize);
+    EXPECT_EQ(DLP_OK, engine.Crypt(out.data(), dec.data(), windowSize, offset, false));
+    EXPECT_EQ(dec, plain);
+    EXPECT_EQ(engine.pool_.size(), DlpHIAEEngine::MAX_WORKERS - 1);
+    EXPECT_EQ(DLP_PARSE_ERROR_VALUE_INVALID, engine.Crypt(plain.data(), out.data(), windowSize, offset + 1, true));
+
+    funcs.init = FakeHIAEFailedInit;
+    ASSERT_EQ(DLP_OK, engine.Init(funcs, key, iv));
+    EXPECT_EQ(DLP_PARSE_ERROR_CRYPTO_ENGINE_ERROR, engine.Crypt(plain.data(), out.data(), windowSize, offset, true));
+    engine.SetWorkers(1);
+    EXPECT_TRUE(engine.pool_.empty());
+}
+
+/**
+ * @tc.name: MappedReadTest001
+ * @tc.desc: test a read only file reads the same through the content mapping, and survives a truncate under it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, MappedReadTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = 5 * DlpChunkTable::CHUNK_SIZE + 100;
+    std::vector<uint8_t> plain(plainSize);
+    for (uint32_t i = 0; i < plainSize; i++) {
+        plain[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    int fdPlain = open("/data/fuse_test_mapped_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_mapped.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+    DlpRawFile genFile(fdDlp, "txt");
+    initDlpRawFileCiper(genFile);
+    ASSERT_EQ(DLP_OK, genFile.SetContactAccount("testAccount"));
+    ASSERT_EQ(DLP_OK, genFile.GenFile(fdPlain));
+    // A rewritten chunk has its own key stream, the mapped read must follow the chunk table too.
+    genFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    std::vector<uint8_t> data(DLP_BLOCK_SIZE * 3, 'd');
+    ASSERT_EQ(static_cast<int32_t>(data.size()), genFile.DlpFileWrite(DlpChunkTable::CHUNK_SIZE + 7, data.data(),
+        data.size()));
+    std::copy(data.begin(), data.end(), plain.begin() + DlpChunkTable::CHUNK_SIZE + 7);
+
+    DlpRawFile testFile(fdDlp, "txt");
+    initDlpRawFileCiper(testFile);
+    ASSERT_EQ(DLP_OK, testFile.ProcessDlpFile());
+    testFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+    EXPECT_NE(DLP_OK, testFile.EnableMappedRead());
+    testFile.authPerm_ = DLPFileAccess::READ_ONLY;
+    ASSERT_EQ(DLP_OK, testFile.EnableMappedRead());
+    EXPECT_TRUE(testFile.mapped_->IsMapped());
+
+    bool hasRead = true;
+    const std::vector<std::pair<uint64_t, uint32_t>> reads = { { 0, plainSize }, { 5, 10 }, { 30, 4096 },
+        { DlpChunkTable::CHUNK_SIZE, 64 }, { DlpChunkTable::CHUNK_SIZE + 3, 200 }, { plainSize - 50, 50 } };
+    for (const auto& read : reads) {
+        std::vector<uint8_t> buf(read.second, 0xff);
+        ASSERT_EQ(static_cast<int32_t>(read.second),
+            testFile.DlpFileRead(read.first, buf.data(), read.second, hasRead, 0));
+        EXPECT_TRUE(std::equal(buf.begin(), buf.end(), plain.begin() + read.first));
+    }
+    std::vector<uint8_t> buf(100, 0xff);
+    EXPECT_EQ(50, testFile.DlpFileRead(plainSize - 50, buf.data(), buf.size(), hasRead, 0));
+    EXPECT_EQ(0, testFile.DlpFileRead(plainSize, buf.data(), buf.size(), hasRead, 0));
+
+    // The pages past the new end raise SIGBUS in the mapping, the read falls back to the fd.
+    ASSERT_EQ(0, ftruncate(fdDlp, testFile.head_.txtOffset + DLP_BLOCK_SIZE));
+    EXPECT_EQ(0, testFile.DlpFileRead(4 * DlpChunkTable::CHUNK_SIZE, buf.data(), buf.size(), hasRead, 0));
+    EXPECT_FALSE(testFile.mapped_->IsMapped());
+
+    close(fdPlain);
+    close(fdDlp);
+    unlink("/data/fuse_test_mapped_plain.txt");
+    unlink("/data/fuse_test_mapped.txt.dlp");
+}
+
+/**
+ * @tc.name: DeferredCommitTest001
+ * @tc.desc: test deferred writes and truncates keep a valid tail, the commit only computes the hmac
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpRawFileTest, DeferredCommitTest001, TestSize.Level0)
+{
+    const uint32_t plainSize = 3 * DLP_BLOCK_SIZE;
+    std::vector<uint8_t> plain(plainSize, 'p');
+    std::vector<uint8_t> data(DLP_BLOCK_SIZE, 'd');
+    int fdPlain = open("/data/fuse_test_deferred_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    ASSERT_EQ(write(fdPlain, plain.data(), plainSize), static_cast<ssize_t>(plainSize));
+    int fdDlp = open("/data/fuse_test_deferred.txt.dlp", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+
+    DlpRawFile testFile(fdDlp, "txt");
+    initDlpRawFileCiper(testFile);
+    ASSERT_EQ(DLP_OK, testFile.SetContactAccount("testAccount"));
+    ASSERT_EQ(DLP_OK, testFile.GenFile(fdPlain));
+    testFile.authPerm_ = DLPFileAccess::CONTENT_EDIT;
+
+    // Writes past the end and a truncate write the tail back, with the hmac of the generated file.
+    ASSERT_EQ(DLP_OK, testFile.SetCommitDeferred(true));
+    EXPECT_EQ(static_cast<int32_t>(data.size()), testFile.DlpFileWrite(plainSize, data.data(), data.size()));
+    EXPECT_EQ(static_cast<int32_t>(data.size()), testFile.DlpFileWrite(0, data.data(), data.size()));
+    EXPECT_FALSE(testFile.tailCut_);
+    EXPECT_TRUE(testFile.hmacStale_);
+    EXPECT_EQ(plainSize + DLP_BLOCK_SIZE, testFile.GetFsContentSize());
+    EXPECT_EQ(DLP_OK, testFile.Truncate(plainSize));
+    EXPECT_EQ(plainSize, testFile.GetFsContentSize());
+
+    DlpRawFile pending(fdDlp, "txt");
+    initDlpRawFileCiper(pending);
+    ASSERT_EQ(DLP_OK, pending.ProcessDlpFile());
+    EXPECT_EQ(plainSize, pending.GetFsContentSize());
+    EXPECT_EQ(DLP_PARSE_ERROR_FILE_VERIFICATION_FAIL, pending.HmacCheck());
+
+    // Ending the deferral only computes the hmac.
+    ASSERT_EQ(DLP_OK, testFile.SetCommitDeferred(false));
+    EXPECT_FALSE(testFile.hmacStale_);
+    EXPECT_EQ(DLP_OK, testFile.DlpFileCommit());
+
+    DlpRawFile reopened(fdDlp, "txt");
+    initDlpRawFileCiper(reopened);
+    ASSERT_EQ(DLP_OK, reopened.ProcessDlpFile());
+    EXPECT_EQ(DLP_OK, reopened.HmacCheck());
+    EXPECT_EQ(plainSize, reopened.GetFsContentSize());
+
+    int fdOut = open("/data/fuse_test_deferred_out.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdOut, -1);
+    reopened.authPerm_ = DLPFileAccess::FULL_CONTROL;
+    EXPECT_EQ(DLP_OK, reopened.RemoveDlpPermission(fdOut));
+    std::vector<uint8_t> expected(plain);
+    std::copy(data.begin(), data.end(), expected.begin());
+    std::vector<uint8_t> out(expected.size());
+    ASSERT_EQ(pread(fdOut, out.data(), out.size(), 0), static_cast<ssize_t>(out.size()));
+    EXPECT_EQ(out, expected);
+
+    close(fdPlain);
+    close(fdDlp);
+    close(fdOut);
+    unlink("/data/fuse_test_deferred_plain.txt");
+    unlink("/data/fuse_test_deferred.txt.dlp");
+    unlink("/data/fuse_test_deferred_out.txt");
+}
@@ -141,6 +141,37 @@ HWTEST_F(DlpUtilsTest, GetFileTypeBySuffix, TestSize.Level0)
     ASSERT_EQ(DlpUtils::GetFileTypeBySuffix(fileType, false), "");
 }
 
+/**
+ * @tc.name: GetFileTypeIndex001
+ * @tc.desc: test GetFileTypeIndex lookups by suffix, prefix and feature
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpUtilsTest, GetFileTypeIndex001, TestSize.Level0)
+{
+    DLP_LOG_INFO(UT_LABEL, "GetFileTypeIndex001");
+    const DlpFileTypeIndex& index = DlpUtils::GetFileTypeIndex();
+    const DlpFileTypeIndex::Entry* entry = index.Find("DOCX", DlpFileTypeIndex::SUPPORT_DLP);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->suffix, "docx");
+    ASSERT_EQ(entry->fileType, "support_office_dlp");
+    ASSERT_EQ(entry->typeNum, TYPE_TO_NUM_MAP.at("docx"));
+
+    entry = index.FindPrefix("txt(1)", DlpFileTypeIndex::SUPPORT_DLP);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->suffix, "txt");
+    ASSERT_EQ(index.Find("txt(1)"), nullptr);
+    ASSERT_EQ(index.FindPrefix("t"), nullptr);
+    ASSERT_EQ(index.Find("averylongsuffix"), nullptr);
+
+    ASSERT_NE(index.FindPrefix("Mkv~", DlpFileTypeIndex::HIAE), nullptr);
+    ASSERT_EQ(index.FindPrefix("txt", DlpFileTypeIndex::HIAE), nullptr);
+    ASSERT_TRUE(DlpUtils::GetFileType("MKV"));
+    ASSERT_FALSE(DlpUtils::GetFileType("mk"));
+    ASSERT_EQ(DlpUtils::GetFileTypeBySuffix("PDFX", true), "support_pdf_dlp");
+    ASSERT_EQ(DlpUtils::GetFileTypeBySuffix("PDFX", false), "");
+}
+
 /**
  * @tc.name: GetDlpFileRealSuffix001
  * @tc.desc: test GetDlpFileRealSuffix
@@ -22,6 +22,8 @@
 #include <thread>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 #define private public
 #include "dlp_file.h"
 #include "dlp_raw_file.h"
@@ -30,6 +32,7 @@
 #undef private
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
+#include "dlp_permission_public_interface.h"
 #include "dlp_zip.h"
 #include "c_mock_common.h"
 #include "nlohmann/json.hpp"
@@ -83,6 +86,31 @@ void initDlpFileCiper(DlpZipFile &testFile)
     certKey.data = nullptr;
     certKey.size = 0;
 }
+
+std::vector<uint8_t> ReadWholeFile(int32_t fd)
+{
+    std::vector<uint8_t> content;
+    uint8_t buf[4096];
+    ssize_t readLen;
+    uint64_t offset = 0;
+    while ((readLen = pread(fd, buf, sizeof(buf), offset)) > 0) {
+        content.insert(content.end(), buf, buf + readLen);
+        offset += static_cast<uint64_t>(readLen);
+    }
+    return content;
+}
+
+// The encrypted_data entry of the archive in fdDlp holds the opened encrypted data of testFile.
+void CheckEncDataInZip(DlpZipFile& testFile, int32_t fdDlp)
+{
+    const std::string unzipPath = DLP_TEST_DIR + "unzip_encrypted_data";
+    ASSERT_EQ(0, UnzipSpecificFile(fdDlp, "encrypted_data", unzipPath.c_str()));
+    int32_t fdUnzip = open(unzipPath.c_str(), O_RDONLY);
+    ASSERT_NE(fdUnzip, -1);
+    EXPECT_EQ(ReadWholeFile(testFile.encDataFd_), ReadWholeFile(fdUnzip));
+    close(fdUnzip);
+    unlink(unzipPath.c_str());
+}
 }
 
 void DlpZipFileTest::SetUpTestCase() {}
@@ -406,16 +434,14 @@ HWTEST_F(DlpZipFileTest, WriteFirstBlockData001, TestSize.Level0)
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     testFile.dlpFd_ = fdDlp;
     DlpCMockCondition condition;
-    // lseek fail
-    lseek(fdDlp, 0, SEEK_SET);
+    // read prefixing fail
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pread", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     CleanMockConditions();
     // write fail
-    lseek(fdDlp, 0, SEEK_SET);
     condition.mockSequence = { true };
-    SetMockConditions("write", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.WriteFirstBlockData(4, writeBuffer, 16));
     CleanMockConditions();
 
@@ -446,7 +472,7 @@ HWTEST_F(DlpZipFileTest, DoDlpFileWrite001, TestSize.Level0)
     uint8_t writeBuffer[18] = {0x1};
     DlpCMockCondition condition;
     condition.mockSequence = { true };
-    SetMockConditions("lseek", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpFileWrite(0, writeBuffer, 18));
     CleanMockConditions();
     condition.mockSequence = { true };
@@ -466,7 +492,7 @@ HWTEST_F(DlpZipFileTest, DoDlpFileWrite001, TestSize.Level0)
     CleanMockConditions();
     condition.mockSequence = { false, true };
     lseek(fdDlp, 0, SEEK_SET);
-    SetMockConditions("write", condition);
+    SetMockConditions("pwrite", condition);
     EXPECT_EQ(DLP_PARSE_ERROR_FILE_OPERATE_FAIL, testFile.DoDlpFileWrite(0, writeBuffer, 18));
     CleanMockConditions();
 
@@ -575,4 +601,53 @@ HWTEST_F(DlpZipFileTest, Truncate002, TestSize.Level0)
 
     unlink("/data/fuse_test_plain.txt");
     unlink("/data/fuse_test_dlp.txt");
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: GenFileInZipStream001
+ * @tc.desc: test the archive generated in one pass holds the content and its hmac, also after a rewrite
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpZipFileTest, GenFileInZipStream001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "GenFileInZipStream001");
+    int fdPlain = open("/data/fuse_test_plain.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdPlain, -1);
+    int fdDlp = open("/data/fuse_test_dlp.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdDlp, -1);
+    // several full windows and a short one, so windows are read while others are consumed
+    std::vector<uint8_t> plain(3 * DLP_BUFF_LEN + 100);
+    for (size_t i = 0; i < plain.size(); i++) {
+        plain[i] = static_cast<uint8_t>(i % 251);
+    }
+    ASSERT_EQ(static_cast<ssize_t>(plain.size()), write(fdPlain, plain.data(), plain.size()));
+
+    DlpZipFile testFile(fdDlp, DLP_TEST_DIR, 3, "txt");
+    initDlpFileCiper(testFile);
+    testFile.version_ = HMAC_VERSION;
+    testFile.SetContactAccount("testAccount");
+    ASSERT_EQ(DLP_OK, testFile.GenFile(fdPlain));
+    ASSERT_NE(0, testFile.hmac_.size);
+    EXPECT_EQ(DLP_OK, testFile.HmacCheck());
+    EXPECT_EQ(true, IsZipFile(fdDlp));
+    CheckEncDataInZip(testFile, fdDlp);
+
+    int fdOut = open("/data/fuse_test_out.txt", O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    ASSERT_NE(fdOut, -1);
+    EXPECT_EQ(DLP_OK, testFile.DoDlpContentCryptyOperation(testFile.encDataFd_, fdOut, 0, plain.size(), false));
+    EXPECT_EQ(plain, ReadWholeFile(fdOut));
+
+    uint8_t writeBuffer[16] = {0x1};
+    testFile.authPerm_ = DLPFileAccess::FULL_CONTROL;
+    EXPECT_EQ(16, testFile.DlpFileWrite(DLP_BUFF_LEN + 16, writeBuffer, 16));
+    EXPECT_EQ(DLP_OK, testFile.HmacCheck());
+    CheckEncDataInZip(testFile, fdDlp);
+
+    close(fdOut);
+    close(fdPlain);
+    close(fdDlp);
+    unlink("/data/fuse_test_out.txt");
+    unlink("/data/fuse_test_plain.txt");
+    unlink("/data/fuse_test_dlp.txt");
+}
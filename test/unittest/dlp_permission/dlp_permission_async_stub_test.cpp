@@ -300,12 +300,34 @@ HWTEST_F(DlpPermissionAsyncStubTest, OnGenerateDlpCertificateStub003, TestSize.L
     MessageParcel data;
     MessageParcel reply;
     ASSERT_TRUE(data.WriteInt32(DLP_OK));
+    ASSERT_TRUE(data.WriteBool(false));
     ASSERT_TRUE(data.WriteUInt8Vector(cert));
 
     int32_t ret = callback->OnGenerateDlpCertificateStub(data, reply);
     ASSERT_EQ(DLP_OK, ret);
 }
 
+/**
+ * @tc.name: OnGenerateDlpCertificateStub004
+ * @tc.desc: OnGenerateDlpCertificateStub rejects an oversized cert as invalid.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionAsyncStubTest, OnGenerateDlpCertificateStub004, TestSize.Level0)
+{
+    auto callbackImpl = std::make_shared<ClientGenerateDlpCertificateCallback>();
+    sptr<DlpPermissionAsyncStub> callback = new (std::nothrow) DlpPermissionAsyncStub(callbackImpl);
+    ASSERT_NE(callback, nullptr);
+    MessageParcel data;
+    MessageParcel reply;
+    ASSERT_TRUE(data.WriteInt32(DLP_OK));
+    ASSERT_TRUE(data.WriteBool(true));
+    ASSERT_TRUE(data.WriteUint32(UINT32_MAX));
+
+    int32_t ret = callback->OnGenerateDlpCertificateStub(data, reply);
+    ASSERT_EQ(DLP_SERVICE_ERROR_VALUE_INVALID, ret);
+}
+
 /**
  * @tc.name: OnParseDlpCertificateStub002
  * @tc.desc: OnParseDlpCertificateStub returns DLP_OK when result != DLP_OK.
@@ -392,6 +414,7 @@ HWTEST_F(DlpPermissionAsyncStubTest, OnParseDlpCertificateStub005, TestSize.Leve
     MessageParcel reply;
     ASSERT_TRUE(data.WriteInt32(DLP_OK));
     ASSERT_TRUE(data.WriteParcelable(policyParcel));
+    ASSERT_TRUE(data.WriteBool(false));
     ASSERT_TRUE(data.WriteUInt8Vector(cert));
 
     int32_t ret = callback->OnParseDlpCertificateStub(data, reply);
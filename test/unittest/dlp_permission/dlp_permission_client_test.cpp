@@ -342,6 +342,25 @@ HWTEST_F(DlpPermissionClientTest, GetDlpSupportFileType001, TestSize.Level1)
     int32_t ret = client.GetDlpSupportFileType(types);
     ASSERT_TRUE(ret != DLP_CALLBACK_SA_WORK_ABNORMAL);
 }
+
+/**
+ * @tc.name: GetDlpSupportFileType002
+ * @tc.desc: Test GetDlpSupportFileType answers from the cached list until the service dies
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionClientTest, GetDlpSupportFileType002, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "GetDlpSupportFileType002");
+    auto& client = DlpPermissionClient::GetInstance();
+    client.supportFileTypes_ = { "txt", "pdf" };
+    std::vector<std::string> types;
+    ASSERT_EQ(client.GetDlpSupportFileType(types), DLP_OK);
+    ASSERT_EQ(types, client.supportFileTypes_);
+
+    client.OnRemoteDiedHandle();
+    ASSERT_TRUE(client.supportFileTypes_.empty());
+}
  
 /**
  * @tc.name: GetDlpGatheringPolicy001
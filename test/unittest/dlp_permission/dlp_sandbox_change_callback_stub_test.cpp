@@ -30,6 +30,9 @@ namespace {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {
     LOG_CORE, SECURITY_DOMAIN_DLP_PERMISSION, "DlpSandboxChangeCallbackStubTest"};
 constexpr uint32_t DLP_SANDBOX_STATE_CHANGE = 0;
+constexpr uint32_t DLP_SANDBOX_STATE_CHANGE_BATCH = 1;
+constexpr uint32_t BATCH_SIZE = 2;
+constexpr uint32_t OVERSIZED_BATCH_SIZE = 1025;
 }
 
 void DlpSandboxChangeCallbackStubTest::SetUpTestCase() {}
@@ -46,9 +49,14 @@ public:
     virtual ~DlpSandboxChangeCallbackTest() = default;
 
     void DlpSandboxStateChangeCallback(DlpSandboxCallbackInfo& result) override;
+
+    uint32_t changeCount_ = 0;
 };
 
-void DlpSandboxChangeCallbackTest::DlpSandboxStateChangeCallback(DlpSandboxCallbackInfo& result) {}
+void DlpSandboxChangeCallbackTest::DlpSandboxStateChangeCallback(DlpSandboxCallbackInfo& result)
+{
+    changeCount_++;
+}
 
 /**
  * @tc.name: OnLoadSystemAbilityFail001
@@ -120,7 +128,7 @@ HWTEST_F(DlpSandboxChangeCallbackStubTest, OnLoadSystemAbilityFail003, TestSize.
 {
     DLP_LOG_INFO(LABEL, "OnLoadSystemAbilityFail003");
 
-    uint32_t code = DLP_SANDBOX_STATE_CHANGE + 1;
+    uint32_t code = DLP_SANDBOX_STATE_CHANGE_BATCH + 1;
     MessageParcel data;
     MessageParcel reply;
     MessageOption option;
@@ -136,3 +144,42 @@ HWTEST_F(DlpSandboxChangeCallbackStubTest, OnLoadSystemAbilityFail003, TestSize.
 
     delete stub;
 }
+
+/**
+ * @tc.name: OnStateChangeBatch001
+ * @tc.desc: a batch request delivers every change and rejects an oversized count
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpSandboxChangeCallbackStubTest, OnStateChangeBatch001, TestSize.Level0)
+{
+    DLP_LOG_INFO(LABEL, "OnStateChangeBatch001");
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    auto stub = new (std::nothrow) DlpSandboxChangeCallbackTest();
+    ASSERT_FALSE(stub == nullptr);
+
+    std::u16string descriptor = IDlpSandboxStateChangeCallback::GetDescriptor();
+    data.WriteInterfaceToken(descriptor);
+    data.WriteUint32(BATCH_SIZE);
+    for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+        sptr<DlpSandboxCallbackInfoParcel> infoParcel = new (std::nothrow) DlpSandboxCallbackInfoParcel();
+        ASSERT_FALSE(infoParcel == nullptr);
+        data.WriteParcelable(infoParcel);
+    }
+    int32_t ret = stub->OnRemoteRequest(DLP_SANDBOX_STATE_CHANGE_BATCH, data, reply, option);
+    ASSERT_EQ(DLP_OK, ret);
+    ASSERT_EQ(BATCH_SIZE, stub->changeCount_);
+
+    MessageParcel oversized;
+    oversized.WriteInterfaceToken(descriptor);
+    oversized.WriteUint32(OVERSIZED_BATCH_SIZE);
+    ret = stub->OnRemoteRequest(DLP_SANDBOX_STATE_CHANGE_BATCH, oversized, reply, option);
+    ASSERT_EQ(DLP_SERVICE_ERROR_PARCEL_OPERATE_FAIL, ret);
+    ASSERT_EQ(BATCH_SIZE, stub->changeCount_);
+
+    delete stub;
+}
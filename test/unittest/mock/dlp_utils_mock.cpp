@@ -175,6 +175,12 @@ bool DlpUtils::GetFileType(const std::string& realFileType)
     return false;
 }
 
+const DlpFileTypeIndex& DlpUtils::GetFileTypeIndex()
+{
+    static const DlpFileTypeIndex index(FILE_TYPE_MAP, TYPE_TO_NUM_MAP, { DLP_HIAE_TYPE });
+    return index;
+}
+
 std::string DlpUtils::GetDlpFileRealSuffix(const std::string& dlpFileName, bool& isFromUriName)
 {
     uint32_t dlpSuffixLen = DLP_FILE_SUFFIXS.size();
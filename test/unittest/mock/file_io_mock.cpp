@@ -28,6 +28,8 @@ typedef ssize_t (*WriteFuncT)(int fd, const void *buf, size_t count);
 typedef int (*FtruncateFuncT)(int fd, off_t length);
 typedef errno_t (*MemcpyFuncT)(void *dest, size_t destMax, const void *src, size_t count);
 typedef ssize_t (*ReadFuncT)(int fd, void *dest, size_t maxCount);
+typedef ssize_t (*PreadFuncT)(int fd, void *dest, size_t count, off_t offset);
+typedef ssize_t (*PwriteFuncT)(int fd, const void *buf, size_t count, off_t offset);
 
 off_t lseek(int fd, off_t offset, int whence)
 {
@@ -103,6 +105,36 @@ ssize_t read(int fd, void *dest, size_t maxCount)
     return (*func)(fd, dest, maxCount);
 }
 
+ssize_t pread(int fd, void *dest, size_t count, off_t offset)
+{
+    if (IsFuncNeedMock("pread")) {
+        CommonMockFuncT rawFunc = GetMockFunc(__func__);
+        if (rawFunc != nullptr) {
+            return (*reinterpret_cast<PreadFuncT>(rawFunc))(fd, dest, count, offset);
+        }
+        return -1;
+    }
+
+    PreadFuncT func = reinterpret_cast<PreadFuncT>(dlsym(RTLD_NEXT, "pread"));
+    if (func == nullptr) {
+        return -1;
+    }
+    return (*func)(fd, dest, count, offset);
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset)
+{
+    if (IsFuncNeedMock("pwrite")) {
+        return -1;
+    }
+
+    PwriteFuncT func = reinterpret_cast<PwriteFuncT>(dlsym(RTLD_NEXT, "pwrite"));
+    if (func == nullptr) {
+        return -1;
+    }
+    return (*func)(fd, buf, count, offset);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,13 @@ static const int UID_READ_ONCE = 301;
 static const int UID_LABEL_MISMATCH = 302;
 }
 
+static DlpSandboxInfo GetStoredSandboxInfo(AppStateObserver& observer, int32_t uid)
+{
+    DlpSandboxInfo appInfo;
+    (void)observer.GetSandboxInfo(uid, appInfo);
+    return appInfo;
+}
+
 static bool VectorContainsUri(const std::vector<std::string>& uris, const std::string& uri)
 {
     for (const auto& item : uris) {
@@ -559,7 +566,8 @@ HWTEST_F(AppStateObserverTest, QueryDlpFileAccessByUid001, TestSize.Level1)
     ASSERT_EQ(DLP_SERVICE_ERROR_APPOBSERVER_ERROR, ret);
     dlpFileAccess = DLPFileAccess::READ_ONLY;
     appInfo.dlpFileAccess = dlpFileAccess;
-    observer.sandboxInfo_[uid] = appInfo;
+    appInfo.uid = uid;
+    observer.sandboxRegistry_.Put(appInfo);
     ret = observer.QueryDlpFileAccessByUid(dlpFileAccess, uid);
     ASSERT_EQ(DLP_OK, ret);
 }
@@ -752,25 +760,25 @@ HWTEST_F(AppStateObserverTest, GetOpeningReadOnlySandbox001, TestSize.Level1)
     appInfo.appIndex = DEFAULT_NUM;
     appInfo.tokenId = DEFAULT_NUM;
     appInfo.userId = DEFAULT_USERID;
-    observer.sandboxInfo_[DEFAULT_NUM] = appInfo;
-    observer.tokenIdToUidMap_[DEFAULT_NUM] = DEFAULT_NUM;
+    observer.sandboxRegistry_.Put(appInfo);
+    observer.AddUidWithTokenId(DEFAULT_NUM, DEFAULT_NUM);
     observer.GetOpeningReadOnlySandbox(DLP_BUNDLENAME, DEFAULT_USERID, appIndex, bindAppIndex);
     ASSERT_EQ(appIndex, appInfo.appIndex);
     appInfo.dlpFileAccess = DLPFileAccess::CONTENT_EDIT;
-    observer.sandboxInfo_[DEFAULT_NUM] = appInfo;
+    observer.sandboxRegistry_.Put(appInfo);
     observer.GetOpeningReadOnlySandbox(DLP_BUNDLENAME, DEFAULT_USERID, appIndex, bindAppIndex);
     ASSERT_EQ(appIndex, -1);
     appInfo.dlpFileAccess = DLPFileAccess::READ_ONLY;
     appInfo.bundleName = "";
-    observer.sandboxInfo_[DEFAULT_NUM] = appInfo;
+    observer.sandboxRegistry_.Put(appInfo);
     observer.GetOpeningReadOnlySandbox(DLP_BUNDLENAME, DEFAULT_USERID, appIndex, bindAppIndex);
     ASSERT_EQ(appIndex, -1);
     appInfo.userId = 0;
     appInfo.bundleName = DLP_BUNDLENAME;
-    observer.sandboxInfo_[DEFAULT_NUM] = appInfo;
+    observer.sandboxRegistry_.Put(appInfo);
     observer.GetOpeningReadOnlySandbox(DLP_BUNDLENAME, DEFAULT_USERID, appIndex, bindAppIndex);
     ASSERT_EQ(appIndex, -1);
-    observer.sandboxInfo_.clear();
+    observer.sandboxRegistry_.Clear();
 }
 
 /**
@@ -818,7 +826,7 @@ HWTEST_F(AppStateObserverTest, GetOpeningReadOnlyBindSandbox001, TestSize.Level1
     observer.GetOpeningReadOnlySandbox(DLP_BUNDLENAME, DEFAULT_USERID, appIndex, bindAppIndex);
     observer.EraseSandboxInfo(appInfo.uid);
     ASSERT_EQ(bindAppIndex, -1);
-    observer.sandboxInfo_.clear();
+    observer.sandboxRegistry_.Clear();
 }
 /**
  * @tc.name: AddSandboxInfo001
@@ -835,7 +843,7 @@ HWTEST_F(AppStateObserverTest, AddSandboxInfo001, TestSize.Level1)
     DlpSandboxInfo appInfo;
     observer.AddSandboxInfo(appInfo);
     observer.UpdateReadFlag(uid);
-    ASSERT_FALSE(observer.sandboxInfo_[appInfo.uid].hasRead);
+    ASSERT_FALSE(GetStoredSandboxInfo(observer, appInfo.uid).hasRead);
 
     appInfo = {
         .uid = 1,
@@ -846,7 +854,7 @@ HWTEST_F(AppStateObserverTest, AddSandboxInfo001, TestSize.Level1)
     };
     observer.AddSandboxInfo(appInfo);
     observer.UpdateReadFlag(uid);
-    ASSERT_TRUE(observer.sandboxInfo_[appInfo.uid].hasRead);
+    ASSERT_TRUE(GetStoredSandboxInfo(observer, appInfo.uid).hasRead);
 }
 
 /**
@@ -876,7 +884,7 @@ HWTEST_F(AppStateObserverTest, AddSandboxInfo002, TestSize.Level1)
     };
     observer.AddSandboxInfo(appInfo1);
     observer.AddSandboxInfo(appInfo2);
-    ASSERT_FALSE(observer.sandboxInfo_[appInfo1.uid].hasRead);
+    ASSERT_FALSE(GetStoredSandboxInfo(observer, appInfo1.uid).hasRead);
 }
 
 /**
@@ -894,7 +902,7 @@ HWTEST_F(AppStateObserverTest, ExitSaAfterAllDlpManagerDie001, TestSize.Level1)
     DlpSandboxInfo appInfo;
     observer.AddSandboxInfo(appInfo);
     observer.UpdateReadFlag(uid);
-    ASSERT_FALSE(observer.sandboxInfo_[appInfo.uid].hasRead);
+    ASSERT_FALSE(GetStoredSandboxInfo(observer, appInfo.uid).hasRead);
     observer.ExitSaAfterAllDlpManagerDie();
 }
 
@@ -913,7 +921,7 @@ HWTEST_F(AppStateObserverTest, ExitSaAfterAllDlpManagerDie002, TestSize.Level1)
     DlpSandboxInfo appInfo;
     observer.AddSandboxInfo(appInfo);
     observer.UpdateReadFlag(uid);
-    ASSERT_FALSE(observer.sandboxInfo_[appInfo.uid].hasRead);
+    ASSERT_FALSE(GetStoredSandboxInfo(observer, appInfo.uid).hasRead);
     observer.ExitSaAfterAllDlpManagerDie();
     observer.AddCallbackListener(uid);
     observer.ExitSaAfterAllDlpManagerDie();
@@ -1361,34 +1369,66 @@ HWTEST_F(AppStateObserverTest, GetNeededDelEnterpriseSandbox001, TestSize.Level1
     sandboxInfo1.uid = UID_DEAD_PROC;
     sandboxInfo1.classificationLabel = "L1";
     sandboxInfo1.appIdentifier = "appA";
-    observer.sandboxInfo_[sandboxInfo1.uid] = sandboxInfo1;
+    observer.sandboxRegistry_.Put(sandboxInfo1);
 
     DlpSandboxInfo sandboxInfo2;
     sandboxInfo2.uid = UID_RUNNING_PROC;
     sandboxInfo2.classificationLabel = "L2";
     sandboxInfo2.appIdentifier = "appA";
-    observer.sandboxInfo_[sandboxInfo2.uid] = sandboxInfo2;
+    observer.sandboxRegistry_.Put(sandboxInfo2);
 
     EnterpriseInfo enterpriseInfo1;
     enterpriseInfo1.uid = UID_DEAD_PROC;
     enterpriseInfo1.fileId = "f1";
     enterpriseInfo1.classificationLabel = "L1";
     enterpriseInfo1.appIdentifier = "appA";
-    observer.enterpriseUriMap_["uri1"] = enterpriseInfo1;
+    observer.enterpriseFileTracker_.Put("uri1", enterpriseInfo1);
 
     EnterpriseInfo enterpriseInfo2;
     enterpriseInfo2.uid = UID_RUNNING_PROC;
     enterpriseInfo2.fileId = "f2";
     enterpriseInfo2.classificationLabel = "L2";
     enterpriseInfo2.appIdentifier = "appA";
-    observer.enterpriseUriMap_["uri2"] = enterpriseInfo2;
+    observer.enterpriseFileTracker_.Put("uri2", enterpriseInfo2);
 
     std::vector<DlpSandboxInfo> appInfos;
     observer.GetNeededDelEnterpriseSandbox("L1", "appA", appInfos);
     ASSERT_EQ(appInfos.size(), 1);
     ASSERT_EQ(appInfos[0].uid, UID_DEAD_PROC);
-    ASSERT_TRUE(observer.enterpriseUriMap_.find("uri1") == observer.enterpriseUriMap_.end());
-    ASSERT_TRUE(observer.enterpriseUriMap_.find("uri2") != observer.enterpriseUriMap_.end());
+    EnterpriseInfo queryInfo;
+    ASSERT_FALSE(observer.GetEnterpriseInfoByUri("uri1", queryInfo));
+    ASSERT_TRUE(observer.GetEnterpriseInfoByUri("uri2", queryInfo));
+}
+
+/**
+ * @tc.name: GetNeededDelEnterpriseSandbox002
+ * @tc.desc: a sandbox is selected by its own label, not by the labels of the files it opened
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AppStateObserverTest, GetNeededDelEnterpriseSandbox002, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "GetNeededDelEnterpriseSandbox002");
+    AppStateObserver observer;
+
+    DlpSandboxInfo sandboxInfo;
+    sandboxInfo.uid = UID_RUNNING_PROC;
+    sandboxInfo.classificationLabel = "L2";
+    sandboxInfo.appIdentifier = "appA";
+    observer.sandboxRegistry_.Put(sandboxInfo);
+
+    EnterpriseInfo enterpriseInfo;
+    enterpriseInfo.uid = UID_RUNNING_PROC;
+    enterpriseInfo.fileId = "f1";
+    enterpriseInfo.classificationLabel = "L1";
+    enterpriseInfo.appIdentifier = "appA";
+    observer.enterpriseFileTracker_.Put("uri1", enterpriseInfo);
+
+    std::vector<DlpSandboxInfo> appInfos;
+    observer.GetNeededDelEnterpriseSandbox("L1", "appA", appInfos);
+    ASSERT_TRUE(appInfos.empty());
+    EnterpriseInfo queryInfo;
+    ASSERT_TRUE(observer.GetEnterpriseInfoByUri("uri1", queryInfo));
 }
 
 /**
@@ -1552,7 +1592,7 @@ HWTEST_F(AppStateObserverTest, UpdatePidWhenSandboxExists001, TestSize.Level1)
         .pid = 1001
     };
     observer.AddSandboxInfo(appInfo);
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].pid, 1001);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).pid, 1001);
 
     // Add sandbox again with new PID=2002 (simulating DlpManager restart)
     DlpSandboxInfo newAppInfo = {
@@ -1566,7 +1606,7 @@ HWTEST_F(AppStateObserverTest, UpdatePidWhenSandboxExists001, TestSize.Level1)
     observer.AddSandboxInfo(newAppInfo);
 
     // Verify PID is updated to new value
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].pid, 2002);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).pid, 2002);
     DLP_LOG_INFO(LABEL, "PID updated from 1001 to 2002 successfully");
 }
 
@@ -1607,14 +1647,14 @@ HWTEST_F(AppStateObserverTest, UpdatePidWhenSandboxExists002, TestSize.Level1)
     observer.AddSandboxInfo(newAppInfo);
 
     // Verify only PID is updated, other fields remain unchanged
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].pid, 2002);
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].userId, 123);
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].appIndex, 2);
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].bundleName, "testbundle1");
-    ASSERT_TRUE(observer.sandboxInfo_[appInfo.uid].hasRead);
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].uri, "test_uri");
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].fileId, "test_file_id");
-    ASSERT_EQ(observer.sandboxInfo_[appInfo.uid].dlpFileAccess, DLPFileAccess::READ_ONLY);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).pid, 2002);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).userId, 123);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).appIndex, 2);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).bundleName, "testbundle1");
+    ASSERT_TRUE(GetStoredSandboxInfo(observer, appInfo.uid).hasRead);
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).uri, "test_uri");
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).fileId, "test_file_id");
+    ASSERT_EQ(GetStoredSandboxInfo(observer, appInfo.uid).dlpFileAccess, DLPFileAccess::READ_ONLY);
     DLP_LOG_INFO(LABEL, "Other fields remain unchanged when updating PID");
 }
 
@@ -1913,4 +1953,175 @@ HWTEST_F(AppStateObserverTest, GetOpeningEnterpriseReadOnlySandbox001, TestSize.
     observer.GetOpeningEnterpriseReadOnlySandbox(inputSandboxInfo, enterpriseInfo, dlpSandboxInfo);
     ASSERT_EQ(-1, dlpSandboxInfo.appIndex);
     ASSERT_EQ(-1, dlpSandboxInfo.bindAppIndex);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: IsSandboxUid001
+ * @tc.desc: IsSandboxUid follows AddSandboxInfo and EraseSandboxInfo
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AppStateObserverTest, IsSandboxUid001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "IsSandboxUid001");
+
+    AppStateObserver observer;
+    DlpSandboxInfo appInfo = {
+        .uid = 20010001,
+        .userId = 100,
+        .appIndex = 2,
+        .bundleName = "testbundle1",
+        .hasRead = false
+    };
+    ASSERT_FALSE(observer.IsSandboxUid(appInfo.uid));
+    observer.AddSandboxInfo(appInfo);
+    ASSERT_TRUE(observer.IsSandboxUid(appInfo.uid));
+    bool inSandbox = false;
+    observer.IsInDlpSandbox(inSandbox, appInfo.uid);
+    ASSERT_TRUE(inSandbox);
+
+    DlpSandboxInfo normalApp = appInfo;
+    normalApp.uid = 20010002;
+    normalApp.appIndex = 0;
+    observer.AddSandboxInfo(normalApp);
+    ASSERT_FALSE(observer.IsSandboxUid(normalApp.uid));
+
+    observer.EraseSandboxInfo(appInfo.uid);
+    ASSERT_FALSE(observer.IsSandboxUid(appInfo.uid));
+}
+
+/**
+ * @tc.name: GetCopyPolicyByTokenId001
+ * @tc.desc: copy policy is cached for non-sandbox tokens and dropped by sandbox lifecycle changes
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AppStateObserverTest, GetCopyPolicyByTokenId001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "GetCopyPolicyByTokenId001");
+
+    AppStateObserver observer;
+    uint32_t tokenId = 200;
+    int32_t uid = 200;
+    DlpCopyPolicy policy;
+    observer.GetCopyPolicyByTokenId(tokenId, policy);
+    ASSERT_FALSE(policy.inDlpSandbox);
+    ASSERT_FALSE(policy.copyable);
+    ASSERT_EQ(1, observer.copyPolicyCache_.count(tokenId));
+
+    DlpSandboxInfo appInfo = {
+        .uid = uid,
+        .bundleName = "test",
+        .appIndex = 1,
+        .userId = 100,
+        .dlpFileAccess = DLPFileAccess::CONTENT_EDIT
+    };
+    observer.AddUidWithTokenId(tokenId, uid);
+    observer.AddSandboxInfo(appInfo);
+    ASSERT_EQ(0, observer.copyPolicyCache_.count(tokenId));
+    observer.GetCopyPolicyByTokenId(tokenId, policy);
+    ASSERT_TRUE(policy.inDlpSandbox);
+    ASSERT_TRUE(policy.copyable);
+    ASSERT_EQ(DLP_OK, policy.result);
+
+    observer.EraseSandboxInfo(uid);
+    ASSERT_TRUE(observer.copyPolicyCache_.empty());
+    observer.GetCopyPolicyByTokenId(tokenId, policy);
+    ASSERT_FALSE(policy.copyable);
+}
+
+/**
+ * @tc.name: SandboxRegistry001
+ * @tc.desc: secondary indexes and the uid filter follow add, update and erase events
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AppStateObserverTest, SandboxRegistry001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "SandboxRegistry001");
+
+    AppStateObserver observer;
+    DlpSandboxInfo appInfo = {
+        .uid = 20010003,
+        .userId = DEFAULT_USERID,
+        .appIndex = 3,
+        .tokenId = 300,
+        .dlpFileAccess = DLPFileAccess::READ_ONLY,
+        .bundleName = "testbundle1",
+        .uri = "uri1",
+        .fileId = "file1",
+        .classificationLabel = "L1",
+        .appIdentifier = "appA"
+    };
+    ASSERT_FALSE(observer.sandboxRegistry_.MayContain(appInfo.uid));
+    observer.AddSandboxInfo(appInfo);
+    ASSERT_TRUE(observer.sandboxRegistry_.MayContain(appInfo.uid));
+
+    int32_t uid = 0;
+    ASSERT_TRUE(observer.GetUidByTokenId(appInfo.tokenId, uid));
+    ASSERT_EQ(appInfo.uid, uid);
+    DlpSandboxInfo stored;
+    ASSERT_TRUE(observer.GetSandboxInfoByAppIndex(appInfo.bundleName, appInfo.appIndex, stored));
+    ASSERT_EQ(appInfo.uid, stored.uid);
+    ASSERT_TRUE(observer.HasDlpSandboxForUser(DEFAULT_USERID));
+    int32_t appIndex = -1;
+    int32_t bindAppIndex = -1;
+    observer.GetOpeningReadOnlySandbox(appInfo.bundleName, DEFAULT_USERID, appIndex, bindAppIndex);
+    ASSERT_EQ(appInfo.appIndex, appIndex);
+    ASSERT_EQ(1, observer.sandboxRegistry_.GetByLabel("L1").size());
+    ASSERT_TRUE(observer.sandboxRegistry_.GetByLabel("L2").empty());
+
+    observer.UpdateReadFlag(appInfo.uid);
+    bool hasRead = false;
+    ASSERT_TRUE(observer.GetSandboxHasRead(appInfo.uid, hasRead));
+    ASSERT_TRUE(hasRead);
+
+    observer.EraseSandboxInfo(appInfo.uid);
+    ASSERT_FALSE(observer.sandboxRegistry_.MayContain(appInfo.uid));
+    ASSERT_FALSE(observer.GetUidByTokenId(appInfo.tokenId, uid));
+    ASSERT_FALSE(observer.GetSandboxInfoByAppIndex(appInfo.bundleName, appInfo.appIndex, stored));
+    ASSERT_FALSE(observer.HasDlpSandboxForUser(DEFAULT_USERID));
+    ASSERT_TRUE(observer.sandboxRegistry_.GetByLabel("L1").empty());
+}
+
+/**
+ * @tc.name: EnterpriseFileTracker001
+ * @tc.desc: label and level queries return opened files only, revocation closes whole sandboxes
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AppStateObserverTest, EnterpriseFileTracker001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "EnterpriseFileTracker001");
+
+    EnterpriseFileTracker tracker;
+    tracker.SetLevels({ "Public", "Internal", "Secret" });
+    auto addFile = [&tracker](const std::string& uri, const std::string& label, int32_t uid) {
+        EnterpriseInfo enterpriseInfo;
+        enterpriseInfo.classificationLabel = label;
+        enterpriseInfo.appIdentifier = "appA";
+        enterpriseInfo.fileId = uri;
+        enterpriseInfo.uid = uid;
+        tracker.Put(uri, enterpriseInfo);
+    };
+    addFile("uri1", "Secret", UID_DEAD_PROC);
+    addFile("uri2", "Internal", UID_RUNNING_PROC);
+    addFile("uri3", "Public", UID_DEAD_PROC);
+    addFile("uri4", "Secret", -1);
+
+    ASSERT_EQ(1, tracker.QueryOpened("Secret", "appA").size());
+    ASSERT_EQ(3, tracker.QueryOpened("", "appA").size());
+    ASSERT_TRUE(tracker.QueryOpened("Secret", "appB").empty());
+    ASSERT_EQ(2, tracker.QueryOpenedAtOrAbove("Internal", "appA").size());
+    ASSERT_EQ(3, tracker.QueryOpenedAtOrAbove("Public", "appA").size());
+
+    ASSERT_TRUE(tracker.UpdateUid("uri4", "uri4", UID_RUNNING_PROC));
+    ASSERT_EQ(2, tracker.QueryOpened("Secret", "appA").size());
+
+    // uri2 and uri3 share a sandbox with a Secret file, so they are closed with it.
+    std::vector<EnterpriseOpenFile> closed = tracker.Revoke("Secret", "appA");
+    ASSERT_EQ(4, closed.size());
+    ASSERT_EQ(0, tracker.Size());
+    EnterpriseInfo enterpriseInfo;
+    ASSERT_FALSE(tracker.GetByUid(UID_DEAD_PROC, enterpriseInfo));
+}
@@ -15,7 +15,11 @@
 
 #include "dlp_ability_adapter_test.h"
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <thread>
+#include <vector>
 #include <iremote_broker.h>
 
 #define private public
@@ -34,6 +38,10 @@ using namespace OHOS::Security::DlpPermission;
 namespace {
 const int32_t USER_ID = 100;
 const int32_t INVALID_USER_ID = -1;
+const int32_t FIRST_REQUEST = 1;
+const int32_t SECOND_REQUEST = 2;
+const int32_t WAIT_RETRY_TIMES = 100;
+const int32_t WAIT_INTERVAL_MS = 10;
 
 int32_t ReceiveDataFunc(int32_t errCode, uint64_t reqId, uint8_t *outData, uint32_t outDataLen)
 {
@@ -46,7 +54,7 @@ int32_t ReceiveDataFunc(int32_t errCode, uint64_t reqId, uint8_t *outData, uint3
 
 class TestRemoteObj : public IRemoteBroker {
 public:
-    DECLARE_INTERFACE_DESCRIPTOR(u"ohos.dlp.ability.adapter.test");
+    DECLARE_INTERFACE_DESCRIPTOR(u"ohos.dlp.ability.adapter->test");
 
     TestRemoteObj() = default;
     ~TestRemoteObj() override = default;
@@ -100,13 +108,13 @@ void DlpAbilityAdapterTest::TearDown()
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest001, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
 
     bool callbackCalled = false;
     sptr<IRemoteObject> callbackRemoteObj;
-    int32_t ret = adapter.ConnectPermServiceAbility(USER_ID,
+    int32_t ret = adapter->ConnectPermServiceAbility(USER_ID,
         [&callbackCalled, &callbackRemoteObj](sptr<IRemoteObject> remoteObj) {
             callbackCalled = true;
             callbackRemoteObj = remoteObj;
@@ -126,38 +134,39 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest001, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest002, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
 
-    adapter.SetIsDestroyFlag(true);
+    adapter->SetIsDestroyFlag(true);
 
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
-    EXPECT_FALSE(adapter.abilityConnection_->isDestroyFlag_);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
+    EXPECT_FALSE(adapter->abilityConnection_->isDestroyFlag_);
 
-    adapter.SetIsDestroyFlag(true);
-    EXPECT_TRUE(adapter.abilityConnection_->isDestroyFlag_);
+    adapter->SetIsDestroyFlag(true);
+    EXPECT_TRUE(adapter->abilityConnection_->isDestroyFlag_);
 }
 
 /**
  * @tc.name: DlpAbilityAdapterTest003
- * @tc.desc: HandleGetWaterMark on existing connection returns success and clears connection.
+ * @tc.desc: HandleGetWaterMark on existing connection returns success and keeps connection for reuse.
  * @tc.type: FUNC
  * @tc.require:
  */
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest003, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
 
     auto waterMarkInfoPtr = std::make_shared<WaterMarkInfo>();
     std::condition_variable waterMarkInfoCv;
-    int32_t ret = adapter.HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
+    int32_t ret = adapter->HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
 
     EXPECT_EQ(ret, DLP_OK);
     EXPECT_LT(waterMarkInfoPtr->waterMarkFd, 0);
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_TRUE(waterMarkInfoPtr->isReady.load());
+    EXPECT_NE(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -169,15 +178,15 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest003, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest004, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
     MockConnectCallback mockCallback;
     AAFwk::ExtensionManagerClient::SetConnectResult(DLP_ABILITY_CONNECT_ERROR);
 
-    int32_t ret = adapter.ConnectPermServiceAbility(INVALID_USER_ID, std::ref(mockCallback));
+    int32_t ret = adapter->ConnectPermServiceAbility(INVALID_USER_ID, std::ref(mockCallback));
 
     EXPECT_EQ(ret, DLP_ABILITY_CONNECT_ERROR);
     EXPECT_FALSE(mockCallback.called_);
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -189,18 +198,18 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest004, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest005, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = new (std::nothrow) DlpAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
-    EXPECT_FALSE(adapter.abilityConnection_->IsConnected());
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = new (std::nothrow) DlpAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
+    EXPECT_FALSE(adapter->abilityConnection_->IsConnected());
     AAFwk::ExtensionManagerClient::SetConnectResult(DLP_ABILITY_CONNECT_ERROR);
 
     MockConnectCallback mockCallback;
-    int32_t ret = adapter.ConnectPermServiceAbility(INVALID_USER_ID, std::ref(mockCallback));
+    int32_t ret = adapter->ConnectPermServiceAbility(INVALID_USER_ID, std::ref(mockCallback));
 
     EXPECT_EQ(ret, DLP_ABILITY_CONNECT_ERROR);
     EXPECT_FALSE(mockCallback.called_);
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -212,19 +221,19 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest005, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest012, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = nullptr;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = nullptr;
     AAFwk::ExtensionManagerClient::SetConnectResult(DLP_OK);
 
     bool callbackCalled = false;
-    int32_t ret = adapter.ConnectPermServiceAbility(USER_ID, [&callbackCalled](sptr<IRemoteObject> remoteObj) {
+    int32_t ret = adapter->ConnectPermServiceAbility(USER_ID, [&callbackCalled](sptr<IRemoteObject> remoteObj) {
         (void)remoteObj;
         callbackCalled = true;
     });
 
     EXPECT_EQ(ret, DLP_OK);
     EXPECT_FALSE(callbackCalled);
-    EXPECT_NE(adapter.abilityConnection_, nullptr);
+    EXPECT_NE(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -236,12 +245,12 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest012, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest006, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = nullptr;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = nullptr;
 
-    adapter.DisconnectPermServiceAbility();
+    adapter->DisconnectPermServiceAbility();
 
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -253,13 +262,13 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest006, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest007, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
 
-    adapter.DisconnectPermServiceAbility();
+    adapter->DisconnectPermServiceAbility();
 
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -271,12 +280,12 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest007, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest008, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = nullptr;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = nullptr;
 
-    adapter.SetIsDestroyFlag(true);
+    adapter->SetIsDestroyFlag(true);
 
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -288,17 +297,18 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest008, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest009, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
 
     auto waterMarkInfoPtr = std::make_shared<WaterMarkInfo>();
     std::condition_variable waterMarkInfoCv;
-    int32_t ret = adapter.HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
+    int32_t ret = adapter->HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
 
     EXPECT_EQ(ret, DLP_OK);
     EXPECT_LT(waterMarkInfoPtr->waterMarkFd, 0);
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_TRUE(waterMarkInfoPtr->isReady.load());
+    EXPECT_NE(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -310,7 +320,7 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest009, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest010, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
 
     WaterMarkInfo waterMarkInfo;
     std::condition_variable waterMarkInfoCv;
@@ -323,7 +333,7 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest010, TestSize.Level1)
                 break;
             }
             DlpAbilityProxy proxy(remoteObj);
-            sptr<DlpAbilityStub> stub = DlpAbilityStub::GetInstance(adapter.callback_);
+            sptr<DlpAbilityStub> stub = DlpAbilityStub::GetInstance(adapter->callback_);
             if (stub == nullptr) {
                 break;
             }
@@ -389,14 +399,14 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest010Part2, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest011, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
-    adapter.abilityConnection_ = BuildConnectedAbilityConnection();
-    ASSERT_NE(adapter.abilityConnection_, nullptr);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    adapter->abilityConnection_ = BuildConnectedAbilityConnection();
+    ASSERT_NE(adapter->abilityConnection_, nullptr);
 
     AAFwk::ExtensionManagerClient::SetDisconnectResult(DLP_ABILITY_CONNECT_ERROR);
-    adapter.DisconnectPermServiceAbility();
+    adapter->DisconnectPermServiceAbility();
 
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
 }
 
 /**
@@ -408,13 +418,175 @@ HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest011, TestSize.Level1)
 HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest013, TestSize.Level1)
 {
     ReceiveDataCallback callback = ReceiveDataFunc;
-    DlpAbilityAdapter adapter(callback);
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
     AAFwk::ExtensionManagerClient::SetConnectResult(DLP_ABILITY_CONNECT_ERROR);
 
     auto waterMarkInfoPtr = std::make_shared<WaterMarkInfo>();
     std::condition_variable waterMarkInfoCv;
-    int32_t ret = adapter.HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
+    int32_t ret = adapter->HandleGetWaterMark(USER_ID, waterMarkInfoPtr, waterMarkInfoCv);
 
     EXPECT_EQ(ret, DLP_ABILITY_CONNECT_ERROR);
-    EXPECT_EQ(adapter.abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
+}
+
+/**
+ * @tc.name: DlpAbilityAdapterTest014
+ * @tc.desc: Requests sent while connecting share one connect and run in order once connected.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest014, TestSize.Level1)
+{
+    ReceiveDataCallback callback = ReceiveDataFunc;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    AAFwk::ExtensionManagerClient::SetConnectResult(DLP_OK);
+
+    std::vector<int32_t> runOrder;
+    auto firstRequest = [&runOrder](sptr<IRemoteObject> remoteObj) {
+        if (remoteObj != nullptr) {
+            runOrder.emplace_back(FIRST_REQUEST);
+        }
+    };
+    auto secondRequest = [&runOrder](sptr<IRemoteObject> remoteObj) {
+        if (remoteObj != nullptr) {
+            runOrder.emplace_back(SECOND_REQUEST);
+        }
+    };
+    EXPECT_EQ(adapter->SendRequest(USER_ID, firstRequest), DLP_OK);
+    sptr<DlpAbilityConnection> connection = adapter->abilityConnection_;
+    ASSERT_NE(connection, nullptr);
+    EXPECT_EQ(adapter->SendRequest(USER_ID, secondRequest), DLP_OK);
+    EXPECT_EQ(adapter->abilityConnection_, connection);
+    EXPECT_EQ(adapter->queued_.size(), 2);
+
+    AppExecFwk::ElementName element;
+    sptr<TestRemoteObj> remoteObj = new (std::nothrow) IRemoteStub<TestRemoteObj>();
+    ASSERT_NE(remoteObj, nullptr);
+    connection->OnAbilityConnectDone(element, remoteObj->AsObject(), DLP_OK);
+    ASSERT_EQ(runOrder.size(), 2);
+    EXPECT_EQ(runOrder[0], FIRST_REQUEST);
+    EXPECT_EQ(runOrder[1], SECOND_REQUEST);
+    EXPECT_TRUE(adapter->queued_.empty());
+    EXPECT_TRUE(adapter->inflight_.empty());
+    EXPECT_FALSE(adapter->isConnecting_);
+}
+
+/**
+ * @tc.name: DlpAbilityAdapterTest015
+ * @tc.desc: A connect without remote object fails the queued requests, and a disconnect drops the channel.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest015, TestSize.Level1)
+{
+    ReceiveDataCallback callback = ReceiveDataFunc;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    AAFwk::ExtensionManagerClient::SetConnectResult(DLP_OK);
+
+    int32_t failedCnt = 0;
+    auto request = [&failedCnt](sptr<IRemoteObject> remoteObj) {
+        if (remoteObj == nullptr) {
+            failedCnt++;
+        }
+    };
+    EXPECT_EQ(adapter->SendRequest(USER_ID, request), DLP_OK);
+    EXPECT_EQ(adapter->SendRequest(USER_ID, request), DLP_OK);
+    sptr<DlpAbilityConnection> connection = adapter->abilityConnection_;
+    ASSERT_NE(connection, nullptr);
+    AppExecFwk::ElementName element;
+    connection->OnAbilityConnectDone(element, nullptr, DLP_ABILITY_CONNECT_ERROR);
+    EXPECT_EQ(failedCnt, 2);
+    EXPECT_FALSE(adapter->isConnecting_);
+    EXPECT_TRUE(adapter->queued_.empty());
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
+
+    EXPECT_EQ(adapter->SendRequest(USER_ID, request), DLP_OK);
+    connection = adapter->abilityConnection_;
+    ASSERT_NE(connection, nullptr);
+    sptr<TestRemoteObj> remoteObj = new (std::nothrow) IRemoteStub<TestRemoteObj>();
+    ASSERT_NE(remoteObj, nullptr);
+    connection->OnAbilityConnectDone(element, remoteObj->AsObject(), DLP_OK);
+    EXPECT_EQ(failedCnt, 2);
+    EXPECT_NE(adapter->remoteObj_, nullptr);
+
+    connection->OnAbilityDisconnectDone(element, DLP_OK);
+    EXPECT_EQ(adapter->abilityConnection_, nullptr);
+    EXPECT_EQ(adapter->remoteObj_, nullptr);
+    EXPECT_FALSE(connection->IsConnected());
+}
+
+/**
+ * @tc.name: DlpAbilityAdapterTest016
+ * @tc.desc: A connect that never completes is failed by the connect timeout.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest016, TestSize.Level1)
+{
+    ReceiveDataCallback callback = ReceiveDataFunc;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    AAFwk::ExtensionManagerClient::SetConnectResult(DLP_OK);
+
+    std::atomic<int32_t> failedCnt { 0 };
+    auto request = [&failedCnt](sptr<IRemoteObject> remoteObj) {
+        if (remoteObj == nullptr) {
+            failedCnt++;
+        }
+    };
+    EXPECT_EQ(adapter->SendRequest(USER_ID, request), DLP_OK);
+    sptr<DlpAbilityConnection> connection = adapter->abilityConnection_;
+    ASSERT_NE(connection, nullptr);
+    {
+        std::lock_guard<std::recursive_mutex> lock(adapter->mutex_);
+        adapter->connectDeadlineMs_ = 1;
+    }
+    adapter->timerCv_.notify_all();
+    for (int32_t i = 0; i < WAIT_RETRY_TIMES && failedCnt.load() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_INTERVAL_MS));
+    }
+    EXPECT_EQ(failedCnt.load(), 1);
+    {
+        std::lock_guard<std::recursive_mutex> lock(adapter->mutex_);
+        EXPECT_FALSE(adapter->isConnecting_);
+        EXPECT_EQ(adapter->abilityConnection_, nullptr);
+    }
+
+    // A late connect callback of the dropped connection is ignored.
+    AppExecFwk::ElementName element;
+    sptr<TestRemoteObj> remoteObj = new (std::nothrow) IRemoteStub<TestRemoteObj>();
+    ASSERT_NE(remoteObj, nullptr);
+    connection->SetIsDestroyFlag(false);
+    connection->OnAbilityConnectDone(element, remoteObj->AsObject(), DLP_OK);
+    EXPECT_EQ(adapter->remoteObj_, nullptr);
+}
+
+/**
+ * @tc.name: DlpAbilityAdapterTest017
+ * @tc.desc: Connection callbacks arriving after the adapter is released are ignored.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpAbilityAdapterTest, DlpAbilityAdapterTest017, TestSize.Level1)
+{
+    ReceiveDataCallback callback = ReceiveDataFunc;
+    auto adapter = std::make_shared<DlpAbilityAdapter>(callback);
+    AAFwk::ExtensionManagerClient::SetConnectResult(DLP_OK);
+
+    int32_t runCnt = 0;
+    auto request = [&runCnt](sptr<IRemoteObject> remoteObj) {
+        (void)remoteObj;
+        runCnt++;
+    };
+    EXPECT_EQ(adapter->SendRequest(USER_ID, request), DLP_OK);
+    sptr<DlpAbilityConnection> connection = adapter->abilityConnection_;
+    ASSERT_NE(connection, nullptr);
+    adapter.reset();
+
+    AppExecFwk::ElementName element;
+    sptr<TestRemoteObj> remoteObj = new (std::nothrow) IRemoteStub<TestRemoteObj>();
+    ASSERT_NE(remoteObj, nullptr);
+    connection->SetIsDestroyFlag(false);
+    connection->OnAbilityConnectDone(element, remoteObj->AsObject(), DLP_OK);
+    connection->OnAbilityDisconnectDone(element, DLP_OK);
+    EXPECT_EQ(runCnt, 0);
 }
@@ -151,6 +151,8 @@ HWTEST_F(DlpAbilityConnProxyStubTest, DlpAbilityConnection001, TestSize.Level1)
     connection.OnAbilityConnectDone(element, nullptr, DLP_OK);
     EXPECT_FALSE(connection.IsConnected());
     EXPECT_FALSE(connectCalled);
+    EXPECT_TRUE(g_disconnectCalled);
+    g_disconnectCalled = false;
 
     sptr<TestRemoteObj> remoteObj = new (std::nothrow) IRemoteStub<TestRemoteObj>();
     ASSERT_NE(remoteObj, nullptr);
@@ -14,7 +14,10 @@
  */
 #include "dlp_cert_parcel_test.h"
 #include <string>
+#include "dlp_permission.h"
 #include "dlp_permission_log.h"
+#include "dlp_shared_memory.h"
+#include "message_parcel.h"
 
 namespace OHOS {
 namespace Security {
@@ -91,6 +94,53 @@ HWTEST_F(DlpCertParcelTest, DlpCertParcelTest003, TestSize.Level1)
     ASSERT_NE(result, nullptr);
     delete result;
 }
+
+/**
+ * @tc.name: DlpCertParcelTest004
+ * @tc.desc: CertParcel passes large certs through shared memory
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCertParcelTest, DlpCertParcelTest004, TestSize.Level1)
+{
+    CertParcel info;
+    info.cert = std::vector<uint8_t>(DLP_SHARED_MEMORY_THRESHOLD + 1, 0x5a);
+    info.offlineCert = {1, 2, 3};
+    info.fileId = "fileId";
+    MessageParcel out;
+
+    EXPECT_EQ(true, info.Marshalling(out));
+    auto result = CertParcel::Unmarshalling(out);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(info.cert, result->cert);
+    EXPECT_EQ(info.offlineCert, result->offlineCert);
+    EXPECT_EQ(info.fileId, result->fileId);
+    delete result;
+}
+
+/**
+ * @tc.name: DlpCertParcelTest005
+ * @tc.desc: ReadSharedBuffer rejects buffers larger than the limit
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCertParcelTest, DlpCertParcelTest005, TestSize.Level1)
+{
+    std::vector<uint8_t> buff(DLP_SHARED_MEMORY_THRESHOLD, 0x5a);
+    std::shared_ptr<DlpSharedMemory> holder;
+    MessageParcel out;
+    ASSERT_TRUE(WriteSharedBuffer(out, buff, holder));
+    ASSERT_NE(holder, nullptr);
+
+    std::vector<uint8_t> result;
+    EXPECT_EQ(DLP_SERVICE_ERROR_VALUE_INVALID, ReadSharedBuffer(out, result, DLP_SHARED_MEMORY_THRESHOLD - 1));
+
+    Parcel small;
+    ASSERT_TRUE(WriteSharedBuffer(small, {1, 2, 3}, holder));
+    EXPECT_EQ(holder, nullptr);
+    EXPECT_EQ(DLP_OK, ReadSharedBuffer(small, result, DLP_SHARED_MEMORY_THRESHOLD));
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3}), result);
+}
 }  // namespace DlpPermission
 }  // namespace Security
 }  // namespace OHOS
@@ -178,4 +178,35 @@ HWTEST_F(DlpCommonFuncTest, CompareHMACValue001, TestSize.Level3)
     uint32_t bufLen = 0;
     ret = CompareHMACValue(&params, &buffer, &bufLen, nullptr);
     EXPECT_EQ(ret, DLP_SERVICE_ERROR_VALUE_INVALID);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: EnsureHMACKeyExist001
+ * @tc.desc: EnsureHMACKeyExist invalid params test
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCommonFuncTest, EnsureHMACKeyExist001, TestSize.Level3)
+{
+    DLP_LOG_INFO(LABEL, "EnsureHMACKeyExist001");
+
+    EXPECT_EQ(EnsureHMACKeyExist(nullptr), DLP_SERVICE_ERROR_VALUE_INVALID);
+    AlgKeyInfo keyInfo = { .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = 1, .keyAlias = { 0, nullptr } };
+    EXPECT_EQ(EnsureHMACKeyExist(&keyInfo), DLP_SERVICE_ERROR_VALUE_INVALID);
+}
+
+/**
+ * @tc.name: EnsureHMACKeyExist002
+ * @tc.desc: EnsureHMACKeyExist does not remember keys it failed to generate
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpCommonFuncTest, EnsureHMACKeyExist002, TestSize.Level3)
+{
+    DLP_LOG_INFO(LABEL, "EnsureHMACKeyExist002");
+
+    BlobData blob = { TEST_BLOB_SIZE, const_cast<uint8_t *>(TEST_BLOB) };
+    AlgKeyInfo keyInfo = { .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = 1, .keyAlias = blob };
+    EXPECT_EQ(EnsureHMACKeyExist(&keyInfo), DLP_ERROR_GENERATE_KEY_FAILED);
+    EXPECT_EQ(EnsureHMACKeyExist(&keyInfo), DLP_ERROR_GENERATE_KEY_FAILED);
+}
@@ -17,6 +17,7 @@
 #include <cerrno>
 #include <gtest/gtest.h>
 #include <securec.h>
+#include "dlp_cert_tlv.h"
 #include "dlp_os_account_mock.h"
 #include "dlp_permission.h"
 #include "dlp_permission_log.h"
@@ -643,3 +644,59 @@ HWTEST_F(DlpPermissionSerializerTest, DeserializeEveryoneInfoSupportEveryoneMove
         EXPECT_EQ(policy.everyonePerm_, DLPFileAccess::NO_PERMISSION);
     }
 }
+
+/**
+ * @tc.name: SerializeEncPolicyDataTlv001
+ * @tc.desc: tlv cert envelope round trip
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionSerializerTest, SerializeEncPolicyDataTlv001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "SerializeEncPolicyDataTlv001");
+    uint8_t data[] = {0x7b, 0x00, 0xff, 0x10, 0x7d};
+    DLP_EncPolicyData encData = {};
+    encData.data = data;
+    encData.dataLen = sizeof(data);
+    encData.accountType = static_cast<AccountType>(DlpAccountType::DOMAIN_ACCOUNT);
+    std::vector<uint8_t> cert;
+    ASSERT_EQ(DLP_OK, DlpPermissionSerializer::GetInstance().SerializeEncPolicyDataTlv(encData, cert));
+    ASSERT_TRUE(IsDlpCertTlv(cert.data(), cert.size()));
+
+    DLP_EncPolicyData outData = {};
+    ASSERT_EQ(DLP_OK, DlpPermissionSerializer::GetInstance().DeserializeEncPolicyDataTlv(cert, outData));
+    EXPECT_EQ(static_cast<AccountType>(DlpAccountType::DOMAIN_ACCOUNT), outData.accountType);
+    ASSERT_EQ(sizeof(data), outData.dataLen);
+    EXPECT_EQ(0, memcmp(data, outData.data, sizeof(data)));
+    delete[] outData.data;
+}
+
+/**
+ * @tc.name: DeserializeEncPolicyDataTlv001
+ * @tc.desc: truncated or json certs are rejected by the tlv decoder
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionSerializerTest, DeserializeEncPolicyDataTlv001, TestSize.Level1)
+{
+    DLP_LOG_INFO(LABEL, "DeserializeEncPolicyDataTlv001");
+    uint8_t data[] = {1, 2, 3, 4};
+    DLP_EncPolicyData encData = {};
+    encData.data = data;
+    encData.dataLen = sizeof(data);
+    encData.accountType = static_cast<AccountType>(DlpAccountType::CLOUD_ACCOUNT);
+    std::vector<uint8_t> cert;
+    ASSERT_EQ(DLP_OK, DlpPermissionSerializer::GetInstance().SerializeEncPolicyDataTlv(encData, cert));
+
+    cert.pop_back();
+    DLP_EncPolicyData outData = {};
+    EXPECT_EQ(DLP_SERVICE_ERROR_VALUE_INVALID,
+        DlpPermissionSerializer::GetInstance().DeserializeEncPolicyDataTlv(cert, outData));
+    EXPECT_EQ(nullptr, outData.data);
+
+    std::string jsonCert = "{\"encData\":\"01020304\"}";
+    std::vector<uint8_t> jsonVec(jsonCert.begin(), jsonCert.end());
+    EXPECT_FALSE(IsDlpCertTlv(jsonVec.data(), jsonVec.size()));
+    EXPECT_EQ(DLP_SERVICE_ERROR_VALUE_INVALID,
+        DlpPermissionSerializer::GetInstance().DeserializeEncPolicyDataTlv(jsonVec, outData));
+}
@@ -43,8 +43,10 @@
 #include "permission_policy.h"
 #include "retention_file_manager.h"
 #include "sandbox_json_manager.h"
+#include "sandbox_pool.h"
 #include "token_setproc.h"
 #include "visited_dlp_file_info.h"
+#include "warm_start_snapshot.h"
 #include "want.h"
 #define private public
 #include "visit_record_file_manager.h"
@@ -1928,6 +1930,33 @@ HWTEST_F(DlpPermissionServiceTest, CriticalHelper001, TestSize.Level1)
     EXPECT_EQ(GetCriticalCnt(), 0);
 }
 
+/**
+ * @tc.name: CriticalHelper002
+ * @tc.desc: critical state is kept across calls and released by the idle check
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionServiceTest, CriticalHelper002, TestSize.Level1)
+{
+    DLP_LOG_DEBUG(LABEL, "CriticalHelper002");
+    SetHasBackgroundTask(false);
+    {
+        CriticalHelper criticalHelper("test");
+        EXPECT_EQ(GetCriticalCnt(), 1);
+        EXPECT_TRUE(IsCriticalHeldByCalls());
+        EXPECT_FALSE(IsCriticalReleasePending());
+    }
+    EXPECT_EQ(GetCriticalCnt(), 0);
+    EXPECT_TRUE(IsCriticalReleasePending());
+    EXPECT_GT(ReleaseCriticalIfIdle(INT32_MAX), 0);
+    EXPECT_TRUE(IsCriticalReleasePending());
+    EXPECT_EQ(ReleaseCriticalIfIdle(0), 0);
+    EXPECT_FALSE(IsCriticalReleasePending());
+    EXPECT_FALSE(IsCriticalHeldByCalls());
+    DecreaseCriticalCnt();
+    EXPECT_EQ(GetCriticalCnt(), 0);
+}
+
 /**
  * @tc.name: QueryDlpFileCopyableByTokenId001
  * @tc.desc: QueryDlpFileCopyableByTokenId test
@@ -2054,4 +2083,83 @@ HWTEST_F(DlpPermissionServiceTest, ChangeWaterMarkInfo001, TestSize.Level1)
     dlpPermissionService_->waterMarkInfo_.accountAndUserId = WATERMARK_NAME;
     res = dlpPermissionService_->ChangeWaterMarkInfo();
     ASSERT_NE(DLP_OK, res);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: WarmStartSnapshot001
+ * @tc.desc: warm start snapshot round trip, stale source and damaged file
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionServiceTest, WarmStartSnapshot001, TestSize.Level1)
+{
+    DLP_LOG_DEBUG(LABEL, "WarmStartSnapshot001");
+    const std::string path = "/data/local/tmp/dlp_warm_start.snapshot";
+    std::vector<std::string> types = { ".txt", ".docx", ".pdf" };
+    uint64_t stamp = WarmStartSnapshot::GetSourceStamp({ "/system/etc/dlp_config.json" });
+    ASSERT_TRUE(WarmStartSnapshot::Save(path, stamp, types));
+
+    std::vector<std::string> loaded;
+    ASSERT_TRUE(WarmStartSnapshot::Load(path, stamp, loaded));
+    ASSERT_EQ(types, loaded);
+    ASSERT_FALSE(WarmStartSnapshot::Load(path, stamp + 1, loaded));
+
+    FILE* file = fopen(path.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    (void)fseek(file, -1, SEEK_END);
+    (void)fputc('X', file);
+    (void)fclose(file);
+    ASSERT_FALSE(WarmStartSnapshot::Load(path, stamp, loaded));
+    (void)unlink(path.c_str());
+}
+
+/**
+ * @tc.name: SandboxPool001
+ * @tc.desc: sandbox pool hit, miss, per user budget and drain
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DlpPermissionServiceTest, SandboxPool001, TestSize.Level1)
+{
+    DLP_LOG_DEBUG(LABEL, "SandboxPool001");
+    SandboxPool pool;
+    SandboxPoolKey keyA = { "com.ohos.note", static_cast<int32_t>(DLPFileAccess::READ_ONLY), 100 };
+    SandboxPoolKey keyB = { "com.ohos.photos", static_cast<int32_t>(DLPFileAccess::READ_ONLY), 100 };
+    SandboxPoolEntry entry;
+    ASSERT_FALSE(pool.Acquire(keyA, entry));
+    ASSERT_EQ(0, pool.GetStats().misses);
+
+    pool.SetPolicy({ 1, 1 });
+    ASSERT_FALSE(pool.Acquire(keyA, entry));
+    std::vector<SandboxPoolKey> toInstall;
+    std::vector<std::pair<SandboxPoolKey, SandboxPoolEntry>> toUninstall;
+    pool.CollectWork(toInstall, toUninstall);
+    ASSERT_EQ(1, toInstall.size());
+    ASSERT_TRUE(pool.Provisioned(keyA, { 1001, -1 }));
+    ASSERT_FALSE(pool.Provisioned(keyA, { 1002, -1 }));
+
+    ASSERT_FALSE(pool.Acquire(keyB, entry));
+    toInstall.clear();
+    pool.CollectWork(toInstall, toUninstall);
+    ASSERT_EQ(1, toInstall.size());
+    ASSERT_EQ(keyB.bundleName, toInstall[0].bundleName);
+    ASSERT_EQ(1, toUninstall.size());
+    ASSERT_EQ(1001, toUninstall[0].second.appIndex);
+    pool.CancelProvision(keyB);
+
+    ASSERT_FALSE(pool.Acquire(keyA, entry));
+    toInstall.clear();
+    toUninstall.clear();
+    pool.CollectWork(toInstall, toUninstall);
+    ASSERT_TRUE(pool.Provisioned(keyA, { 1003, -1 }));
+    ASSERT_TRUE(pool.Acquire(keyA, entry));
+    ASSERT_EQ(1003, entry.appIndex);
+    ASSERT_EQ(1, pool.GetStats().hits);
+    ASSERT_EQ(3, pool.GetStats().misses);
+
+    toInstall.clear();
+    pool.CollectWork(toInstall, toUninstall);
+    ASSERT_TRUE(pool.Provisioned(keyA, { 1004, -1 }));
+    ASSERT_EQ(1, pool.Drain(-1).size());
+    ASSERT_FALSE(pool.Acquire(keyA, entry));
+}
@@ -268,4 +268,73 @@ HWTEST_F(AlgHuksTest, HuksGenerateHmac006, TestSize.Level3)
     };
     int32_t ret = HuksGenerateHmac(&keyInfo, &data, nullptr);
     EXPECT_EQ(ret, DLP_SERVICE_ERROR_VALUE_INVALID);
-}
\ No newline at end of file
+}
+
+/**
+ * @tc.name: HuksHmacSession001
+ * @tc.desc: HuksHmacSession absorbs successive updates like one contiguous buffer
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AlgHuksTest, HuksHmacSession001, TestSize.Level3)
+{
+    DLP_LOG_INFO(LABEL, "HuksHmacSession001");
+
+    BlobData keyAilas = { strlen(FILE_HMAC_KEY_ALIAS_TEST),
+        const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(FILE_HMAC_KEY_ALIAS_TEST)) };
+    AlgKeyInfo keyInfo = {
+        .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = MAIN_OS_ACCOUNT_ID, .keyAlias = keyAilas
+    };
+    uint8_t *dataPtr = const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(HMAC_DATA_TEST));
+    uint32_t dataLen = strlen(HMAC_DATA_TEST);
+    uint32_t half = dataLen / 2;
+    BlobData whole = { dataLen, dataPtr };
+    BlobData parts[] = { { half, dataPtr }, { 0, nullptr }, { dataLen - half, dataPtr + half } };
+
+    BlobData wholeOut = { 0, nullptr };
+    ASSERT_EQ(HuksGenerateHmac(&keyInfo, &whole, &wholeOut), DLP_OK);
+    HuksHmacSession session(&keyInfo);
+    ASSERT_EQ(session.Init(), DLP_OK);
+    for (const BlobData& part : parts) {
+        ASSERT_EQ(session.Update(&part), DLP_OK);
+    }
+    BlobData partsOut = { 0, nullptr };
+    ASSERT_EQ(session.Finish(&partsOut), DLP_OK);
+    ASSERT_EQ(wholeOut.dataSize, partsOut.dataSize);
+    EXPECT_EQ(memcmp(wholeOut.value, partsOut.value, wholeOut.dataSize), 0);
+    FreeBlobData(&wholeOut);
+    FreeBlobData(&partsOut);
+}
+
+/**
+ * @tc.name: HuksHmacSession002
+ * @tc.desc: HuksHmacSession rejects use before Init and after Finish
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(AlgHuksTest, HuksHmacSession002, TestSize.Level3)
+{
+    DLP_LOG_INFO(LABEL, "HuksHmacSession002");
+
+    BlobData data = { strlen(HMAC_DATA_TEST),
+        const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(HMAC_DATA_TEST)) };
+    BlobData outDataBlob = { 0, nullptr };
+    HuksHmacSession nullSession(nullptr);
+    EXPECT_EQ(nullSession.Init(), DLP_SERVICE_ERROR_VALUE_INVALID);
+    EXPECT_EQ(nullSession.Update(&data), DLP_SERVICE_ERROR_VALUE_INVALID);
+    EXPECT_EQ(nullSession.Finish(&outDataBlob), DLP_SERVICE_ERROR_VALUE_INVALID);
+
+    BlobData keyAilas = { strlen(FILE_HMAC_KEY_ALIAS_TEST),
+        const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(FILE_HMAC_KEY_ALIAS_TEST)) };
+    AlgKeyInfo keyInfo = {
+        .protectionLevel = PROTECT_LEVEL_DE, .osAccountId = MAIN_OS_ACCOUNT_ID, .keyAlias = keyAilas
+    };
+    HuksHmacSession session(&keyInfo);
+    ASSERT_EQ(session.Init(), DLP_OK);
+    EXPECT_EQ(session.Init(), DLP_SERVICE_ERROR_VALUE_INVALID);
+    EXPECT_EQ(session.Update(nullptr), DLP_SERVICE_ERROR_VALUE_INVALID);
+    EXPECT_EQ(session.Update(&data), DLP_OK);
+    EXPECT_EQ(session.Finish(&outDataBlob), DLP_OK);
+    FreeBlobData(&outDataBlob);
+    EXPECT_EQ(session.Update(&data), DLP_SERVICE_ERROR_VALUE_INVALID);
+}
@@ -434,3 +434,72 @@ HWTEST_F(SandboxJsonManagerTest, RemoveRetentionInfoByUserIdBranches001, TestSiz
     ret = manager.RemoveRetentionInfoByUserId(100, emptySet);
     ASSERT_TRUE(ret == DLP_OK || ret == DLP_FILE_NO_NEED_UPDATE);
 }
+
+/**
+ * @tc.name: RemoveRetentionStates001
+ * @tc.desc: RemoveRetentionStates removes every matching sandbox in one pass
+ * @tc.type: FUNC
+ */
+HWTEST_F(SandboxJsonManagerTest, RemoveRetentionStates001, TestSize.Level1)
+{
+    SandboxJsonManager manager;
+    std::vector<std::pair<std::string, int32_t>> sandboxes;
+    ASSERT_EQ(DLP_FILE_NO_NEED_UPDATE, manager.RemoveRetentionStates(sandboxes));
+
+    int32_t userId;
+    if (!GetUserIdByForegroundAccount(&userId)) {
+        sandboxes.emplace_back("bundle_a", 1);
+        ASSERT_EQ(DLP_SERVICE_ERROR_GET_ACCOUNT_FAIL, manager.RemoveRetentionStates(sandboxes));
+        return;
+    }
+    RetentionInfo info;
+    info.userId = userId;
+    info.bundleName = "bundle_a";
+    info.appIndex = 1;
+    manager.infoVec_.push_back(info);
+    info.appIndex = 2;
+    manager.infoVec_.push_back(info);
+    info.bundleName = "bundle_b";
+    info.appIndex = 1;
+    manager.infoVec_.push_back(info);
+
+    sandboxes = { {"bundle_a", 1}, {"bundle_b", -1}, {"bundle_c", 1} };
+    ASSERT_EQ(DLP_OK, manager.RemoveRetentionStates(sandboxes));
+    ASSERT_EQ(1, manager.infoVec_.size());
+    ASSERT_EQ(2, manager.infoVec_[0].appIndex);
+    ASSERT_EQ(DLP_FILE_NO_NEED_UPDATE, manager.RemoveRetentionStates(sandboxes));
+}
+
+/**
+ * @tc.name: PoolSandbox001
+ * @tc.desc: pooled sandboxes are kept apart from the retention records and survive a json round trip
+ * @tc.type: FUNC
+ */
+HWTEST_F(SandboxJsonManagerTest, PoolSandbox001, TestSize.Level1)
+{
+    SandboxJsonManager manager;
+    RetentionInfo info;
+    info.bundleName = "bundle_a";
+    info.dlpFileAccess = DLPFileAccess::READ_ONLY;
+    info.userId = 100;
+    ASSERT_EQ(DLP_INSERT_FILE_ERROR, manager.AddPoolSandbox(info));
+    info.appIndex = 1;
+    ASSERT_EQ(DLP_OK, manager.AddPoolSandbox(info));
+    info.appIndex = 2;
+    info.bindAppIndex = 1001;
+    ASSERT_EQ(DLP_OK, manager.AddPoolSandbox(info));
+    ASSERT_TRUE(manager.infoVec_.empty());
+
+    SandboxJsonManager restored;
+    restored.FromJson(Json::parse(manager.ToString()));
+    std::vector<RetentionInfo> pool = restored.GetPoolSandboxes();
+    ASSERT_EQ(2, pool.size());
+    ASSERT_EQ(2, pool[1].appIndex);
+    ASSERT_EQ(1001, pool[1].bindAppIndex);
+    ASSERT_EQ(DLPFileAccess::READ_ONLY, pool[1].dlpFileAccess);
+    ASSERT_TRUE(restored.infoVec_.empty());
+
+    ASSERT_EQ(DLP_OK, restored.RemovePoolSandboxes({ pool[0] }));
+    ASSERT_EQ(DLP_FILE_NO_NEED_UPDATE, restored.RemovePoolSandboxes({ pool[0] }));
+    ASSERT_EQ(1, restored.GetPoolSandboxes().size());
+}